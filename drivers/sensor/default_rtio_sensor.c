@@ -403,27 +403,38 @@ static int decode_three_axis(const struct sensor_data_generic_header *header, co
 			     struct sensor_three_axis_data *data_out, enum sensor_channel x,
 			     enum sensor_channel y, enum sensor_channel z, size_t channel_idx)
 {
-	int rc;
+	uint8_t found = 0;
+	int axis;
 
 	data_out->header.base_timestamp_ns = header->timestamp_ns;
 	data_out->header.reading_count = 1;
 	data_out->shift = header->shift;
 	data_out->readings[0].timestamp_delta = 0;
 
-	rc = get_q31_value(header, values, (struct sensor_chan_spec){x, channel_idx},
-			   &data_out->readings[0].values[0]);
-	if (rc < 0) {
-		return rc;
-	}
-	rc = get_q31_value(header, values, (struct sensor_chan_spec){y, channel_idx},
-			   &data_out->readings[0].values[1]);
-	if (rc < 0) {
-		return rc;
+	/* Collect all 3 axes in a single pass over the channels of the frame */
+	for (size_t i = 0; i < header->num_channels && found != BIT_MASK(3); ++i) {
+		if (header->channels[i].chan_idx != channel_idx) {
+			continue;
+		}
+
+		if (header->channels[i].chan_type == x) {
+			axis = 0;
+		} else if (header->channels[i].chan_type == y) {
+			axis = 1;
+		} else if (header->channels[i].chan_type == z) {
+			axis = 2;
+		} else {
+			continue;
+		}
+
+		if ((found & BIT(axis)) == 0) {
+			data_out->readings[0].values[axis] = values[i];
+			found |= BIT(axis);
+		}
 	}
-	rc = get_q31_value(header, values, (struct sensor_chan_spec){z, channel_idx},
-			   &data_out->readings[0].values[2]);
-	if (rc < 0) {
-		return rc;
+
+	if (found != BIT_MASK(3)) {
+		return -EINVAL;
 	}
 	return 1;
 }
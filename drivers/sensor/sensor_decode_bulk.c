@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/dsp/types.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_CMSIS_DSP_BASICMATH) && defined(CONFIG_CMSIS_DSP_SUPPORT)
+#include <arm_math.h>
+#define SENSOR_DECODE_BULK_CMSIS 1
+#endif
+
+/* Number of readings decoded at once before being converted to the output arrays */
+#define DECODE_CHUNK 16
+
+union decode_chunk {
+	struct sensor_three_axis_data three_axis;
+	struct sensor_q31_data q31;
+	uint8_t raw[MAX(sizeof(struct sensor_three_axis_data) +
+				(DECODE_CHUNK - 1) * sizeof(struct sensor_three_axis_sample_data),
+			sizeof(struct sensor_q31_data) +
+				(DECODE_CHUNK - 1) * sizeof(struct sensor_q31_sample_data))];
+};
+
+struct bulk_out {
+	/* Output arrays, one per axis, of q31_t or float */
+	void *axes[3];
+	int8_t shift;
+	bool is_float;
+};
+
+/**
+ * @brief Convert a strided array of q31 values to a contiguous array with another shift
+ *
+ * Left shifts saturate, like those of the DSP libraries.
+ */
+static void convert_q31(const q31_t *src, size_t stride, int8_t src_shift, int8_t dst_shift,
+			q31_t *dst, size_t count)
+{
+	int shift = src_shift - dst_shift;
+
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = src[i * stride];
+	}
+
+	if (shift == 0) {
+		return;
+	}
+
+#ifdef SENSOR_DECODE_BULK_CMSIS
+	arm_shift_q31(dst, (int8_t)CLAMP(shift, -31, 31), dst, count);
+#else
+	if (shift < 0) {
+		shift = MIN(-shift, 31);
+		for (size_t i = 0; i < count; i++) {
+			dst[i] >>= shift;
+		}
+	} else {
+		shift = MIN(shift, 32);
+		for (size_t i = 0; i < count; i++) {
+			int64_t value = (int64_t)dst[i] << shift;
+
+			dst[i] = (q31_t)CLAMP(value, INT32_MIN, INT32_MAX);
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Convert a strided array of q31 values to a contiguous array of floats
+ */
+static void convert_float(const q31_t *src, size_t stride, int8_t src_shift, float *dst,
+			  size_t count)
+{
+	/* A q31 value represents value * 2^shift / 2^31 */
+	const float shift_scale = src_shift >= 0 ? (float)BIT64(src_shift)
+						 : 1.0f / (float)BIT64(-src_shift);
+
+#ifdef SENSOR_DECODE_BULK_CMSIS
+	q31_t tmp[DECODE_CHUNK];
+
+	__ASSERT_NO_MSG(count <= DECODE_CHUNK);
+
+	for (size_t i = 0; i < count; i++) {
+		tmp[i] = src[i * stride];
+	}
+	arm_q31_to_float(tmp, dst, count);
+	arm_scale_f32(dst, shift_scale, dst, count);
+#else
+	const float scale = shift_scale / (float)BIT64(31);
+
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = (float)src[i * stride] * scale;
+	}
+#endif
+}
+
+static void store_axis(const struct bulk_out *out, int axis, const q31_t *src, size_t stride,
+		       int8_t src_shift, size_t offset, size_t count)
+{
+	if (out->is_float) {
+		convert_float(src, stride, src_shift, (float *)out->axes[axis] + offset, count);
+	} else {
+		convert_q31(src, stride, src_shift, out->shift, (q31_t *)out->axes[axis] + offset,
+			    count);
+	}
+}
+
+static int decode_bulk(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+		       struct sensor_chan_spec chan_spec, uint16_t max_count,
+		       const struct bulk_out *out)
+{
+	const bool three_axis = SENSOR_CHANNEL_3_AXIS(chan_spec.chan_type);
+	union decode_chunk decoded;
+	size_t base_size, frame_size;
+	uint16_t frame_count;
+	uint32_t fit = 0;
+	uint16_t total = 0;
+	int rc;
+
+	rc = decoder->get_size_info(chan_spec, &base_size, &frame_size);
+	if (rc < 0) {
+		return rc;
+	}
+	if (base_size != (three_axis ? sizeof(struct sensor_three_axis_data)
+				     : sizeof(struct sensor_q31_data))) {
+		return -ENOTSUP;
+	}
+
+	rc = decoder->get_frame_count(buffer, chan_spec, &frame_count);
+	if (rc < 0) {
+		return rc;
+	}
+	max_count = MIN(max_count, frame_count);
+
+	while (total < max_count) {
+		uint16_t chunk = MIN(max_count - total, DECODE_CHUNK);
+
+		rc = decoder->decode(buffer, chan_spec, &fit, chunk, decoded.raw);
+		if (rc < 0) {
+			return rc;
+		}
+		if (rc == 0) {
+			break;
+		}
+
+		rc = MIN(rc, chunk);
+		if (three_axis) {
+			const struct sensor_three_axis_data *data = &decoded.three_axis;
+
+			for (int axis = 0; axis < 3; axis++) {
+				store_axis(out, axis, &data->readings[0].values[axis],
+					   sizeof(data->readings[0]) / sizeof(q31_t), data->shift,
+					   total, rc);
+			}
+		} else {
+			const struct sensor_q31_data *data = &decoded.q31;
+
+			store_axis(out, 0, &data->readings[0].value,
+				   sizeof(data->readings[0]) / sizeof(q31_t), data->shift, total, rc);
+		}
+		total += rc;
+	}
+
+	return total;
+}
+
+int sensor_decode_three_axis_q31(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+				 struct sensor_chan_spec chan_spec, int8_t shift, q31_t *x,
+				 q31_t *y, q31_t *z, uint16_t max_count)
+{
+	const struct bulk_out out = {
+		.axes = {x, y, z},
+		.shift = shift,
+		.is_float = false,
+	};
+
+	if (!SENSOR_CHANNEL_3_AXIS(chan_spec.chan_type)) {
+		return -EINVAL;
+	}
+
+	return decode_bulk(decoder, buffer, chan_spec, max_count, &out);
+}
+
+int sensor_decode_three_axis_float(const struct sensor_decoder_api *decoder,
+				   const uint8_t *buffer, struct sensor_chan_spec chan_spec,
+				   float *x, float *y, float *z, uint16_t max_count)
+{
+	const struct bulk_out out = {
+		.axes = {x, y, z},
+		.is_float = true,
+	};
+
+	if (!SENSOR_CHANNEL_3_AXIS(chan_spec.chan_type)) {
+		return -EINVAL;
+	}
+
+	return decode_bulk(decoder, buffer, chan_spec, max_count, &out);
+}
+
+int sensor_decode_q31(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+		      struct sensor_chan_spec chan_spec, int8_t shift, q31_t *values,
+		      uint16_t max_count)
+{
+	const struct bulk_out out = {
+		.axes = {values},
+		.shift = shift,
+		.is_float = false,
+	};
+
+	if (SENSOR_CHANNEL_3_AXIS(chan_spec.chan_type)) {
+		return -EINVAL;
+	}
+
+	return decode_bulk(decoder, buffer, chan_spec, max_count, &out);
+}
+
+int sensor_decode_float(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+			struct sensor_chan_spec chan_spec, float *values, uint16_t max_count)
+{
+	const struct bulk_out out = {
+		.axes = {values},
+		.is_float = true,
+	};
+
+	if (SENSOR_CHANNEL_3_AXIS(chan_spec.chan_type)) {
+		return -EINVAL;
+	}
+
+	return decode_bulk(decoder, buffer, chan_spec, max_count, &out);
+}
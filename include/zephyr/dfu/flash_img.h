@@ -31,6 +31,9 @@ extern "C" {
 
 struct flash_img_context {
 	uint8_t buf[CONFIG_IMG_BLOCK_BUF_SIZE];
+#ifdef CONFIG_IMG_WRITE_ASYNC
+	uint8_t buf_async[CONFIG_IMG_BLOCK_BUF_SIZE];
+#endif
 	const struct flash_area *flash_area;
 	struct stream_flash_ctx stream;
 };
@@ -97,6 +97,10 @@ struct disk_info {
 	const struct device *dev;
 	/** Internally used disk reference count */
 	uint16_t refcnt;
+#if defined(CONFIG_DISK_ACCESS_CACHE) || defined(CONFIG_DISK_ACCESS_QUEUE)
+	/** Internally used sector size, queried by the block layer on first use */
+	uint32_t sector_size;
+#endif
 };
 
 /**
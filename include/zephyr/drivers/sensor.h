@@ -584,6 +584,54 @@ static inline int sensor_decode(struct sensor_decode_context *ctx, void *out, ui
 	return ctx->decoder->decode(ctx->buffer, ctx->channel, &ctx->fit, max_count, out);
 }
 
+/**
+ * @brief Decode the frames of a three axis channel into one q31 array per axis
+ *
+ * All the frames of @p buffer are decoded at once, up to @p max_count, and rescaled to @p shift
+ * so that the arrays can be passed directly to DSP routines. Left shifts saturate.
+ *
+ * @param[in]  decoder The decoder of the sensor that produced @p buffer
+ * @param[in]  buffer The buffer provided on the @ref rtio context
+ * @param[in]  chan_spec A three axis channel, such as @ref SENSOR_CHAN_ACCEL_XYZ
+ * @param[in]  shift The shift of the decoded values
+ * @param[out] x Array of at least @p max_count values for the X axis
+ * @param[out] y Array of at least @p max_count values for the Y axis
+ * @param[out] z Array of at least @p max_count values for the Z axis
+ * @param[in]  max_count Maximum number of readings to decode
+ * @return The number of readings decoded, or a negative error code
+ */
+int sensor_decode_three_axis_q31(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+				 struct sensor_chan_spec chan_spec, int8_t shift, q31_t *x,
+				 q31_t *y, q31_t *z, uint16_t max_count);
+
+/**
+ * @brief Decode the frames of a three axis channel into one float array per axis
+ *
+ * @see sensor_decode_three_axis_q31()
+ */
+int sensor_decode_three_axis_float(const struct sensor_decoder_api *decoder,
+				   const uint8_t *buffer, struct sensor_chan_spec chan_spec,
+				   float *x, float *y, float *z, uint16_t max_count);
+
+/**
+ * @brief Decode the frames of a single axis channel into a q31 array
+ *
+ * Only channels decoded as @ref sensor_q31_data are supported.
+ *
+ * @see sensor_decode_three_axis_q31()
+ */
+int sensor_decode_q31(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+		      struct sensor_chan_spec chan_spec, int8_t shift, q31_t *values,
+		      uint16_t max_count);
+
+/**
+ * @brief Decode the frames of a single axis channel into a float array
+ *
+ * @see sensor_decode_q31()
+ */
+int sensor_decode_float(const struct sensor_decoder_api *decoder, const uint8_t *buffer,
+			struct sensor_chan_spec chan_spec, float *values, uint16_t max_count);
+
 int sensor_natively_supported_channel_size_info(struct sensor_chan_spec channel, size_t *base_size,
 						size_t *frame_size);
 
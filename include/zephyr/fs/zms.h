@@ -64,6 +64,18 @@ struct zms_fs {
 	/** Lookup table used to cache ATE addresses of written IDs */
 	uint64_t lookup_cache[CONFIG_ZMS_LOOKUP_CACHE_SIZE];
 #endif
+#if CONFIG_ZMS_GC_INCREMENTAL
+	/** Address of the next ATE to collect in the oldest sector */
+	uint64_t gc_addr;
+	/** Address of the last ATE to collect in the oldest sector */
+	uint64_t gc_stop_addr;
+	/** Offset below which the data of the ATEs left to collect is stored */
+	uint32_t gc_data_end;
+	/** Cycle counter of the oldest sector */
+	uint8_t gc_cycle;
+	/** Flag indicating that the oldest sector is being garbage collected */
+	bool gc_pending;
+#endif
 };
 
 /**
@@ -200,6 +212,40 @@ size_t zms_active_sector_free_space(struct zms_fs *fs);
  */
 int zms_sector_use_next(struct zms_fs *fs);
 
+#if defined(CONFIG_ZMS_GC_INCREMENTAL) || defined(__DOXYGEN__)
+
+/**
+ * @brief Run one step of the pending garbage collection.
+ *
+ * The step handles at most @kconfig{CONFIG_ZMS_GC_STEP_ENTRIES} ATEs of the sector being garbage
+ * collected. When it handles the last one, the sector is erased.
+ * Running steps ahead of writes, for example from a work item, keeps them from having to run
+ * the garbage collection themselves.
+ *
+ * @param fs Pointer to the file system.
+ *
+ * @retval 0 No garbage collection is pending.
+ * @retval 1 The garbage collection still needs more steps.
+ * @retval -ERRNO Negative errno code on error.
+ */
+int zms_gc_step(struct zms_fs *fs);
+
+/**
+ * @brief Get the garbage collection pressure.
+ *
+ * The pressure is the share of the free space of the active sector that is held back for the
+ * entries the pending garbage collection may still copy. At 100, a write has to run the garbage
+ * collection until it makes room for the new entry.
+ *
+ * @param fs Pointer to the file system.
+ *
+ * @return Pressure from 0 (no garbage collection pending) to 100. On error, returns negative
+ * value of error codes defined in `errno.h`.
+ */
+int zms_gc_pressure(struct zms_fs *fs);
+
+#endif /* CONFIG_ZMS_GC_INCREMENTAL */
+
 /**
  * @}
  */
@@ -223,6 +223,52 @@ int pbuf_write(struct pbuf *pb, const char *buf, uint16_t len);
  */
 int pbuf_read(struct pbuf *pb, char *buf, uint16_t len);
 
+/**
+ * @brief Get the next packet from the packet buffer without copying it.
+ *
+ * The packet is accessed in place, in the memory of the packet buffer. It
+ * stays in the buffer, and no more packets can be read, until it is released
+ * with @ref pbuf_release_rx_buffer. Packets wrapped around the end of the
+ * buffer can not be accessed in place and must be read with @ref pbuf_read.
+ *
+ * @param pb	A buffer from which data will be read.
+ * @param buf	Location where the pointer to the packet data is stored.
+ * @retval int	Length of the packet, negative error code on fail.
+ *		0, if the buffer is empty.
+ *		-EINVAL, if any of input parameter is incorrect.
+ *		-EAGAIN, if not whole message is ready yet.
+ *		-ENOTSUP, if the packet is wrapped around the end of the buffer.
+ */
+int pbuf_get_rx_buffer(struct pbuf *pb, const char **buf);
+
+/**
+ * @brief Release a packet obtained with @ref pbuf_get_rx_buffer.
+ *
+ * The memory of the packet is given back to the writer.
+ *
+ * @param pb	A buffer from which the packet was obtained.
+ * @param len	Length of the packet, as returned by @ref pbuf_get_rx_buffer.
+ * @retval 0 on success.
+ * @retval -EINVAL when the input parameter is incorrect.
+ */
+int pbuf_release_rx_buffer(struct pbuf *pb, uint16_t len);
+
+/**
+ * @brief Check if the reader has read all packets written up to an index.
+ *
+ * Used by the writer to find out if the reader may have stopped reading
+ * before the packets following @p wr_idx were written. It must be called
+ * after these packets were written, the reader is expected to check for new
+ * packets after each read.
+ *
+ * @param pb	A buffer to which the packets were written.
+ * @param wr_idx	Value of the local write index before the packets were
+ *			written.
+ * @retval true if the read index of the reader is equal to @p wr_idx.
+ * @retval false otherwise.
+ */
+bool pbuf_tx_consumed(struct pbuf *pb, uint32_t wr_idx);
+
 /**
  * @}
  */
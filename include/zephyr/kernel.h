@@ -2994,14 +2994,20 @@ extern struct k_work_q k_sys_work_q;
 struct k_mutex {
 	/** Mutex wait queue */
 	_wait_q_t wait_q;
-	/** Mutex owner */
+	/** Protects the slow paths of this mutex */
+	struct k_spinlock lock;
+	/** Mutex owner, taken and released with atomic operations */
 	struct k_thread *owner;
+	/** Non-zero once a thread has had to wait for the mutex */
+	atomic_t contended;
 
 	/** Current lock count */
 	uint32_t lock_count;
 
 	/** Original thread priority */
 	int owner_orig_prio;
+	/** Owner whose priority owner_orig_prio holds, NULL if not recorded yet */
+	struct k_thread *prio_owner;
 
 	SYS_PORT_TRACING_TRACKING_FIELD(k_mutex)
 
@@ -3016,9 +3022,12 @@ struct k_mutex {
 #define Z_MUTEX_INITIALIZER(obj) \
 	{ \
 	.wait_q = Z_WAIT_Q_INIT(&(obj).wait_q), \
+	.lock = { }, \
 	.owner = NULL, \
+	.contended = ATOMIC_INIT(0), \
 	.lock_count = 0, \
 	.owner_orig_prio = K_LOWEST_APPLICATION_THREAD_PRIO, \
+	.prio_owner = NULL, \
 	}
 
 /**
@@ -3105,6 +3114,7 @@ __syscall int k_mutex_unlock(struct k_mutex *mutex);
 
 struct k_condvar {
 	_wait_q_t wait_q;
+	struct k_spinlock lock;
 
 #ifdef CONFIG_OBJ_CORE_CONDVAR
 	struct k_obj_core  obj_core;
@@ -3114,6 +3124,7 @@ struct k_condvar {
 #define Z_CONDVAR_INITIALIZER(obj)                                             \
 	{                                                                      \
 		.wait_q = Z_WAIT_Q_INIT(&obj.wait_q),                          \
+		.lock = { },                                                   \
 	}
 
 /**
@@ -3190,7 +3201,9 @@ __syscall int k_condvar_wait(struct k_condvar *condvar, struct k_mutex *mutex,
 
 struct k_sem {
 	_wait_q_t wait_q;
-	unsigned int count;
+	struct k_spinlock lock;
+	/* Available units, or -1 if none are and threads may be waiting */
+	atomic_t count;
 	unsigned int limit;
 
 	Z_DECL_POLL_EVENT
@@ -3205,7 +3218,8 @@ struct k_sem {
 #define Z_SEM_INITIALIZER(obj, initial_count, count_limit) \
 	{ \
 	.wait_q = Z_WAIT_Q_INIT(&(obj).wait_q), \
-	.count = (initial_count), \
+	.lock = { }, \
+	.count = ATOMIC_INIT(initial_count), \
 	.limit = (count_limit), \
 	Z_POLL_EVENT_OBJ_INIT(obj) \
 	}
@@ -3225,7 +3239,7 @@ struct k_sem {
  *
  * This is intended for use when a semaphore does not have
  * an explicit maximum limit, and instead is just used for
- * counting purposes.
+ * counting purposes. Semaphore counts saturate at INT_MAX.
  *
  */
 #define K_SEM_MAX_LIMIT UINT_MAX
@@ -3307,7 +3321,9 @@ __syscall unsigned int k_sem_count_get(struct k_sem *sem);
  */
 static inline unsigned int z_impl_k_sem_count_get(struct k_sem *sem)
 {
-	return sem->count;
+	atomic_val_t count = atomic_get(&sem->count);
+
+	return (count > 0) ? (unsigned int)count : 0U;
 }
 
 /**
@@ -4972,6 +4988,8 @@ struct k_pipe {
  * @cond INTERNAL_HIDDEN
  */
 #define K_PIPE_FLAG_ALLOC	BIT(0)	/** Buffer was allocated */
+#define K_PIPE_FLAG_PUT_CLAIM	BIT(1)	/** Buffer space is claimed for writing */
+#define K_PIPE_FLAG_GET_CLAIM	BIT(2)	/** Buffer data is claimed for reading */
 
 #define Z_PIPE_INITIALIZER(obj, pipe_buffer, pipe_buffer_size)     \
 	{                                                           \
@@ -5128,6 +5146,11 @@ __syscall size_t k_pipe_write_avail(struct k_pipe *pipe);
  * that pipe into a large temporary buffer and discarding the buffer. Any
  * writers that were previously pended become unpended.
  *
+ * While a read claim is outstanding, the data in the pipe's buffer is left
+ * alone and only the data of the pended writers is discarded. While a write
+ * claim is outstanding, the claimed space stays claimed and can still be
+ * committed.
+ *
  * @param pipe Address of the pipe.
  */
 __syscall void k_pipe_flush(struct k_pipe *pipe);
@@ -5141,10 +5164,104 @@ __syscall void k_pipe_flush(struct k_pipe *pipe);
  * were writers previously pending, then some may unpend as they try to fill
  * up the pipe's emptied buffer.
  *
+ * While a read claim is outstanding, the pipe's buffer is left alone, as is
+ * the space claimed by an outstanding write claim.
+ *
  * @param pipe Address of the pipe.
  */
 __syscall void k_pipe_buffer_flush(struct k_pipe *pipe);
 
+/**
+ * @brief Claim contiguous free space in a pipe's buffer for writing.
+ *
+ * This routine gives direct access to the free space following the data in
+ * @a pipe's ring buffer, so that a producer can build data in place instead
+ * of copying it in with k_pipe_put(). The data is handed over to readers by
+ * k_pipe_put_commit(). The claimed region does not wrap around the end of the
+ * buffer, so it may be smaller than the total free space.
+ *
+ * Only one write claim may be outstanding at a time. While it is, k_pipe_put()
+ * only copies data directly to waiting readers, never into the buffer.
+ *
+ * @note Not available to user mode threads, as the claimed region is in
+ *       kernel memory.
+ *
+ * @param pipe Address of the pipe, which must have a buffer.
+ * @param data Address of area to hold the address of the claimed region.
+ * @param size On entry, the maximum number of bytes to claim. On return, the
+ *             number of bytes claimed, at least 1.
+ * @param timeout Waiting period to wait for free space in the buffer,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Space was claimed.
+ * @retval -EINVAL invalid parameters supplied, or pipe without buffer
+ * @retval -EBUSY Space is already claimed.
+ * @retval -EIO Returned without waiting; the buffer is full.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Commit data written in place into a pipe's buffer.
+ *
+ * This routine ends the claim made with k_pipe_put_claim(), making the first
+ * @a size bytes of the claimed region available to readers. Waiting readers
+ * and pollers are woken up.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes written, up to the number of bytes claimed.
+ *
+ * @retval 0 Data was committed.
+ * @retval -EINVAL No space is claimed, or @a size exceeds the claimed space.
+ */
+int k_pipe_put_commit(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim contiguous data in a pipe's buffer for reading.
+ *
+ * This routine gives direct access to the oldest data in @a pipe's ring
+ * buffer, so that a consumer can process it in place instead of copying it
+ * out with k_pipe_get(). The data is released by k_pipe_get_commit(). The
+ * claimed region does not wrap around the end of the buffer, so it may be
+ * smaller than the total amount of buffered data.
+ *
+ * Only one read claim may be outstanding at a time. While it is, k_pipe_get()
+ * only copies data directly from waiting writers, never from the buffer.
+ *
+ * @note Not available to user mode threads, as the claimed region is in
+ *       kernel memory.
+ *
+ * @param pipe Address of the pipe, which must have a buffer.
+ * @param data Address of area to hold the address of the claimed region.
+ * @param size On entry, the maximum number of bytes to claim. On return, the
+ *             number of bytes claimed, at least 1.
+ * @param timeout Waiting period to wait for data in the buffer,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Data was claimed.
+ * @retval -EINVAL invalid parameters supplied, or pipe without buffer
+ * @retval -EBUSY Data is already claimed.
+ * @retval -EIO Returned without waiting; the buffer is empty.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Release data read in place from a pipe's buffer.
+ *
+ * This routine ends the claim made with k_pipe_get_claim(), freeing the first
+ * @a size bytes of the claimed region. Waiting writers are woken up.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes consumed, up to the number of bytes claimed.
+ *
+ * @retval 0 Data was released.
+ * @retval -EINVAL No data is claimed, or @a size exceeds the claimed data.
+ */
+int k_pipe_get_commit(struct k_pipe *pipe, size_t size);
+
 /** @} */
 
 /**
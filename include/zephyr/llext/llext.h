@@ -12,6 +12,7 @@
 #include <zephyr/llext/elf.h>
 #include <zephyr/llext/symbol.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/mem_stats.h>
 #include <sys/types.h>
 #include <stdbool.h>
 
@@ -120,6 +121,17 @@ struct llext {
 
 	/** Array of extensions, whose symbols this extension accesses */
 	struct llext *dependency[LLEXT_MAX_DEPENDENCIES];
+
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+	/** @cond ignore */
+	/* ELF identity and data snapshot used to revive a cached image */
+	elf_ehdr_t cache_hdr;
+	uint32_t cache_crc;
+	elf_shdr_t cache_sects[LLEXT_MEM_COUNT];
+	void *data_snapshot;
+	bool cacheable;
+	/** @endcond */
+#endif
 };
 
 /**
@@ -188,10 +200,34 @@ int llext_load(struct llext_loader *loader, const char *name, struct llext **ext
 /**
  * @brief Unload an extension
  *
+ * With @kconfig{CONFIG_LLEXT_IMAGE_CACHE} enabled, the relocated image of an
+ * extension whose use count drops to zero is kept in a cache, so that it can
+ * be revived by a later @ref llext_load call with the same name.
+ *
  * @param[in] ext Extension to unload
  */
 int llext_unload(struct llext **ext);
 
+/**
+ * @brief Free all unloaded extension images kept in the image cache
+ *
+ * Does nothing unless @kconfig{CONFIG_LLEXT_IMAGE_CACHE} is enabled.
+ */
+void llext_cache_flush(void);
+
+/**
+ * @brief Get usage statistics of the memory holding extension sections
+ *
+ * Reports the section pool usage if @kconfig{CONFIG_LLEXT_SECTION_POOL} is
+ * enabled, or the llext heap usage otherwise.
+ *
+ * @param[out] stats Memory usage statistics
+ *
+ * @retval 0 on success
+ * @retval -ENOTSUP runtime statistics are not enabled for the allocator
+ */
+int llext_get_section_mem_stats(struct sys_memory_stats *stats);
+
 /** @brief Entry point function signature for an extension. */
 typedef void (*llext_entry_fn_t)(void *user_data);
 
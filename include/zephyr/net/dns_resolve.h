@@ -420,6 +420,13 @@ struct dns_resolve_context {
 		 * cannot be used to find correct pending query.
 		 */
 		uint16_t query_hash;
+
+#if defined(CONFIG_DNS_RESOLVER_COALESCE_QUERIES)
+		/** Index of the query in flight whose answer is given to this
+		 * query, or -1 if this query was sent to the servers.
+		 */
+		int leader;
+#endif
 	} queries[DNS_NUM_CONCUR_QUERIES];
 
 	/** Is this context in use */
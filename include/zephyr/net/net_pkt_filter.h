@@ -16,6 +16,7 @@
 
 #include <limits.h>
 #include <stdbool.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/slist.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/ethernet.h>
@@ -59,10 +60,46 @@ extern struct npf_rule npf_default_ok;
 /** @brief Default rule list termination for rejecting a packet */
 extern struct npf_rule npf_default_drop;
 
+/** @cond INTERNAL_HIDDEN */
+
+#ifdef CONFIG_NET_PKT_FILTER_COMPILED
+
+#define NPF_COMPILED_MAX_RULES CONFIG_NET_PKT_FILTER_COMPILED_MAX_RULES
+#define NPF_COMPILED_BUCKETS (2 * NPF_COMPILED_MAX_RULES)
+
+/* Rules sharing the value of an exact match test */
+struct npf_rule_bucket {
+	uintptr_t key;
+	uint16_t head;
+	uint8_t kind;
+};
+
+/* Rule list compiled into chains of rules, one per exact match value */
+struct npf_rule_set {
+	atomic_t readers;
+	uint16_t nb_rules;
+	uint16_t wildcard_head;
+	uint8_t kinds;
+	struct npf_rule *rules[NPF_COMPILED_MAX_RULES];
+	uint16_t next[NPF_COMPILED_MAX_RULES];
+	int8_t key_test[NPF_COMPILED_MAX_RULES];
+	struct npf_rule_bucket buckets[NPF_COMPILED_BUCKETS];
+};
+
+#endif /* CONFIG_NET_PKT_FILTER_COMPILED */
+
+/** @endcond */
+
 /** @brief rule set for a given test location */
 struct npf_rule_list {
 	sys_slist_t rule_head;   /**< List head */
 	struct k_spinlock lock;  /**< Lock protecting the list access */
+#ifdef CONFIG_NET_PKT_FILTER_COMPILED
+	/** @cond INTERNAL_HIDDEN */
+	struct npf_rule_set sets[2];
+	atomic_ptr_t active;
+	/** @endcond */
+#endif
 };
 
 /** @brief  rule list applied to outgoing packets */
@@ -79,6 +116,10 @@ extern struct npf_rule_list npf_ipv6_recv_rules;
 /**
  * @brief Insert a rule at the front of given rule list
  *
+ * With @kconfig{CONFIG_NET_PKT_FILTER_COMPILED}, the rule management
+ * functions must be called from thread context, as they wait for the
+ * evaluations using the previous rules to complete before returning.
+ *
  * @param rules the affected rule list
  * @param rule the rule to be inserted
  */
@@ -525,6 +566,9 @@ struct npf_test_eth_type {
 extern npf_test_fn_t npf_eth_type_match;
 extern npf_test_fn_t npf_eth_type_unmatch;
 
+/* Whether the Ethernet type of the packet can be read from its head */
+bool npf_eth_hdr_present(struct net_pkt *pkt);
+
 /** @endcond */
 
 /**
@@ -0,0 +1,200 @@
+/**
+ * @file
+ * @brief RTIO socket API
+ *
+ * Network connections exposed as RTIO iodevs, so that accepts, connects,
+ * receives and sends on many connections can be driven from a single RTIO
+ * context by one thread.
+ */
+
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_RTIO_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_RTIO_H_
+
+/**
+ * @brief RTIO socket API
+ * @defgroup socket_rtio RTIO socket API
+ * @since 4.1
+ * @version 0.1.0
+ * @ingroup networking
+ * @{
+ */
+
+#include <zephyr/net/net_ip.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/sys/mpsc_lockfree.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+
+struct net_context;
+
+struct socket_rtio_data {
+	/* Network context, NULL while the iodev is unused */
+	struct net_context *ctx;
+	/* Pending RTIO_OP_RX submissions */
+	struct mpsc rx_q;
+	/* Pending RTIO_OP_NET_ACCEPT submissions */
+	struct mpsc accept_q;
+	/* Pending RTIO_OP_NET_CONNECT submission */
+	struct rtio_iodev_sqe *connect_sqe;
+	/* Connection error, reported once the received data is consumed */
+	int error;
+	/* Given when rx_busy is cleared while rx_wait is set */
+	struct k_sem rx_idle;
+	/* Set while a thread is completing receive submissions */
+	bool rx_busy;
+	/* Set while closing waits for rx_busy to be cleared */
+	bool rx_wait;
+};
+
+extern const struct rtio_iodev_api socket_rtio_iodev_api;
+
+/** @endcond */
+
+/**
+ * @brief Statically define an RTIO socket iodev.
+ *
+ * The iodev is unused until either a socket is opened on it with
+ * socket_rtio_open() or an accepted connection is attached to it by an
+ * @ref RTIO_OP_NET_ACCEPT submission.
+ *
+ * Supported operations are:
+ *
+ * - @ref RTIO_OP_RX: receive into the buffer of the submission, or into a
+ *   buffer of the RTIO memory pool. Stream sockets complete with the number
+ *   of bytes received, or 0 once the peer closed the connection. Datagram
+ *   sockets complete with one datagram per submission, truncated to the
+ *   buffer size. Multishot submissions stay armed until the connection is
+ *   closed or fails, or the memory pool is exhausted, in which case they
+ *   complete with -ENOMEM.
+ * - @ref RTIO_OP_TX: send the buffer of the submission. Completes once the
+ *   data has been queued with the number of bytes queued, which may be
+ *   smaller than the buffer for stream sockets, or with -EAGAIN if nothing
+ *   could be queued.
+ * - @ref RTIO_OP_NET_ACCEPT: accept a connection on a listening socket and
+ *   attach it to an unused iodev.
+ * - @ref RTIO_OP_NET_CONNECT: connect the socket.
+ *
+ * Submissions to a socket iodev must be made from thread context.
+ *
+ * @param name Symbol name of the iodev
+ */
+#define SOCKET_RTIO_IODEV_DEFINE(name)                                                             \
+	static struct socket_rtio_data _socket_rtio_data_##name;                                   \
+	RTIO_IODEV_DEFINE(name, &socket_rtio_iodev_api, &_socket_rtio_data_##name)
+
+/**
+ * @brief Open a socket on an unused RTIO socket iodev.
+ *
+ * @param iodev Iodev defined with SOCKET_RTIO_IODEV_DEFINE()
+ * @param family Address family, AF_INET or AF_INET6
+ * @param type SOCK_STREAM or SOCK_DGRAM
+ * @param proto Protocol, 0 for the default protocol of @p type
+ *
+ * @retval 0 on success
+ * @retval -EBUSY if the iodev is in use
+ * @retval <0 other negative errno code if the socket could not be created
+ */
+int socket_rtio_open(const struct rtio_iodev *iodev, int family, int type, int proto);
+
+/**
+ * @brief Bind the socket of an RTIO socket iodev to a local address.
+ *
+ * @param iodev Iodev with an open socket
+ * @param addr Local address
+ * @param addrlen Length of @p addr
+ *
+ * @retval 0 on success
+ * @retval <0 negative errno code on failure
+ */
+int socket_rtio_bind(const struct rtio_iodev *iodev, const struct sockaddr *addr,
+		     socklen_t addrlen);
+
+/**
+ * @brief Mark the socket of an RTIO socket iodev as listening.
+ *
+ * Connections are queued as they are established and attached to iodevs by
+ * @ref RTIO_OP_NET_ACCEPT submissions.
+ *
+ * @param iodev Iodev with an open and bound stream socket
+ * @param backlog Maximum number of pending connections
+ *
+ * @retval 0 on success
+ * @retval <0 negative errno code on failure
+ */
+int socket_rtio_listen(const struct rtio_iodev *iodev, int backlog);
+
+/**
+ * @brief Close the socket of an RTIO socket iodev.
+ *
+ * Pending submissions complete with -ECANCELED and the iodev becomes
+ * unused.
+ *
+ * @param iodev Iodev with an open socket
+ *
+ * @retval 0 on success
+ * @retval -EBADF if the iodev is unused
+ */
+int socket_rtio_close(const struct rtio_iodev *iodev);
+
+/**
+ * @brief Prepare an accept submission.
+ *
+ * Completes with 0 once a connection has been attached to @p conn_iodev.
+ *
+ * @param sqe Submission to prepare
+ * @param iodev Iodev with a listening socket
+ * @param conn_iodev Unused iodev the connection is attached to
+ * @param userdata User data returned in the completion
+ */
+static inline void socket_rtio_prep_accept(struct rtio_sqe *sqe, const struct rtio_iodev *iodev,
+					   const struct rtio_iodev *conn_iodev, void *userdata)
+{
+	memset(sqe, 0, sizeof(struct rtio_sqe));
+	sqe->op = RTIO_OP_NET_ACCEPT;
+	sqe->iodev = iodev;
+	sqe->accept.iodev = conn_iodev;
+	sqe->userdata = userdata;
+}
+
+/**
+ * @brief Prepare a connect submission.
+ *
+ * Completes with 0 once the connection is established.
+ *
+ * @param sqe Submission to prepare
+ * @param iodev Iodev with an open socket
+ * @param addr Remote address, must stay valid until the submission completes
+ * @param addrlen Length of @p addr
+ * @param userdata User data returned in the completion
+ */
+static inline void socket_rtio_prep_connect(struct rtio_sqe *sqe, const struct rtio_iodev *iodev,
+					    const struct sockaddr *addr, socklen_t addrlen,
+					    void *userdata)
+{
+	memset(sqe, 0, sizeof(struct rtio_sqe));
+	sqe->op = RTIO_OP_NET_CONNECT;
+	sqe->iodev = iodev;
+	sqe->connect.addr = addr;
+	sqe->connect.addrlen = addrlen;
+	sqe->userdata = userdata;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_RTIO_H_ */
@@ -27,6 +27,17 @@ struct aiocb {
 
 #if _POSIX_C_SOURCE >= 200112L
 
+#define AIO_ALLDONE     0
+#define AIO_CANCELED    1
+#define AIO_NOTCANCELED 2
+
+#define LIO_NOP   0
+#define LIO_READ  1
+#define LIO_WRITE 2
+
+#define LIO_NOWAIT 0
+#define LIO_WAIT   1
+
 int aio_cancel(int fildes, struct aiocb *aiocbp);
 int aio_error(const struct aiocb *aiocbp);
 int aio_fsync(int filedes, struct aiocb *aiocbp);
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Perf profiler continuous mode API
+ */
+
+#ifndef ZEPHYR_INCLUDE_PROFILING_PERF_H_
+#define ZEPHYR_INCLUDE_PROFILING_PERF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Perf profiler
+ * @defgroup profiling_perf Perf profiler
+ * @ingroup os_services
+ * @{
+ */
+
+/** @brief Aggregated call stack */
+struct perf_stack {
+	/** Sampled thread, which may have exited since */
+	k_tid_t tid;
+	/** Name of the sampled thread, or NULL if it has none */
+	const char *thread;
+	/** CPU the thread was running on */
+	uint8_t cpu;
+	/** Number of frames in @a frames */
+	uint8_t depth;
+	/** Number of samples of this call stack */
+	uint32_t count;
+	/** Program counter, followed by return addresses, innermost first */
+	const uintptr_t *frames;
+};
+
+/** @brief Continuous mode statistics */
+struct perf_continuous_stats {
+	/** Number of samples aggregated in the call stack table */
+	uint32_t samples;
+	/**
+	 * Number of samples lost, either because the call stack table was full
+	 * or because the call stack was deeper than
+	 * CONFIG_PROFILING_PERF_CONTINUOUS_DEPTH frames
+	 */
+	uint32_t dropped;
+	/** Number of distinct call stacks in the table */
+	uint32_t stacks;
+};
+
+/**
+ * @brief Callback for each aggregated call stack
+ *
+ * @param stack Call stack, only valid during the call
+ * @param user_data User data passed to perf_continuous_foreach()
+ */
+typedef void (*perf_stack_cb_t)(const struct perf_stack *stack, void *user_data);
+
+/**
+ * @brief Start sampling in continuous mode
+ *
+ * Samples are aggregated per call stack, thread and CPU in a table of
+ * @kconfig{CONFIG_PROFILING_PERF_CONTINUOUS_STACKS} entries, so sampling can
+ * go on indefinitely in bounded memory.
+ *
+ * @param frequency Sampling frequency in Hz
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if @a frequency is 0
+ * @retval -EINPROGRESS if continuous sampling is already running
+ */
+int perf_continuous_start(uint32_t frequency);
+
+/**
+ * @brief Stop sampling in continuous mode
+ *
+ * The aggregated samples are kept until perf_continuous_reset() is called.
+ */
+void perf_continuous_stop(void);
+
+/**
+ * @brief Discard all aggregated samples
+ *
+ * @retval 0 on success
+ * @retval -EINPROGRESS if continuous sampling is running
+ */
+int perf_continuous_reset(void);
+
+/**
+ * @brief Get continuous mode statistics
+ *
+ * @param stats Where to store the statistics
+ */
+void perf_continuous_stats_get(struct perf_continuous_stats *stats);
+
+/**
+ * @brief Iterate over the aggregated call stacks
+ *
+ * Can be called while sampling is running, each stack is then a consistent
+ * snapshot of its entry.
+ *
+ * @param cb Function called for each call stack
+ * @param user_data User data passed to @a cb
+ */
+void perf_continuous_foreach(perf_stack_cb_t cb, void *user_data);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_PROFILING_PERF_H_ */
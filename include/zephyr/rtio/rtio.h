@@ -140,6 +140,16 @@ extern "C" {
  */
 #define RTIO_SQE_NO_RESPONSE BIT(5)
 
+/**
+ * @brief The timeout bounds the preceding submission
+ *
+ * Only valid on an @ref RTIO_OP_TIMEOUT submission directly following a submission flagged with
+ * @ref RTIO_SQE_CHAINED. The timeout is started along with the preceding submission instead of
+ * after it. If it expires first, the timeout completes with -ETIME and the preceding submission
+ * and the rest of the chain are canceled. Otherwise the timeout completes with -ECANCELED.
+ */
+#define RTIO_SQE_LINK_TIMEOUT BIT(6)
+
 /**
  * @}
  */
@@ -215,6 +225,7 @@ struct rtio_sqe_pool;
 struct rtio_cqe_pool;
 struct rtio_iodev;
 struct rtio_iodev_sqe;
+struct rtio_timeout;
 /** @endcond */
 
 /**
@@ -286,6 +297,27 @@ struct rtio_sqe {
 
 		/** OP_I2C_CONFIGURE */
 		uint32_t i2c_config;
+
+		/** OP_NET_ACCEPT */
+		struct {
+			/** Unused iodev the accepted connection is attached to */
+			const struct rtio_iodev *iodev;
+		} accept;
+
+		/** OP_NET_CONNECT */
+		struct {
+			uint32_t addrlen; /**< Length of the address */
+			const void *addr; /**< Address to connect to */
+		} connect;
+
+		/** OP_TIMEOUT */
+		struct {
+			k_timeout_t timeout; /**< Time to wait */
+			/** @cond INTERNAL_HIDDEN */
+			/* Timer taken from the executor pool once started */
+			struct rtio_timeout *timer;
+			/** @endcond */
+		} timeout;
 	};
 };
 
@@ -483,6 +515,15 @@ struct rtio_iodev {
 /** An operation to configure I2C buses */
 #define RTIO_OP_I2C_CONFIGURE (RTIO_OP_I2C_RECOVER+1)
 
+/** An operation that accepts a network connection */
+#define RTIO_OP_NET_ACCEPT (RTIO_OP_I2C_CONFIGURE+1)
+
+/** An operation that connects a network socket */
+#define RTIO_OP_NET_CONNECT (RTIO_OP_NET_ACCEPT+1)
+
+/** An operation that completes once a timeout expires */
+#define RTIO_OP_TIMEOUT (RTIO_OP_NET_CONNECT+1)
+
 /**
  * @brief Prepare a nop (no op) submission
  */
@@ -624,6 +665,42 @@ static inline void rtio_sqe_prep_callback_no_cqe(struct rtio_sqe *sqe,
 	sqe->flags |= RTIO_SQE_NO_RESPONSE;
 }
 
+/**
+ * @brief Prepare a timeout op submission
+ *
+ * Completes with 0 once @p timeout expires. When flagged with @ref RTIO_SQE_LINK_TIMEOUT, bounds
+ * the time taken by the preceding submission instead. Running timeouts use timers from a pool of
+ * CONFIG_RTIO_TIMEOUT_COUNT shared by all RTIO contexts. A timeout that finds none free completes
+ * with -ENOMEM.
+ *
+ * @param sqe Submission to prepare
+ * @param timeout Time to wait, K_FOREVER is not allowed
+ * @param userdata User data returned in the completion
+ */
+static inline void rtio_sqe_prep_timeout(struct rtio_sqe *sqe, k_timeout_t timeout,
+					 void *userdata)
+{
+	memset(sqe, 0, sizeof(struct rtio_sqe));
+	sqe->op = RTIO_OP_TIMEOUT;
+	sqe->timeout.timeout = timeout;
+	sqe->userdata = userdata;
+}
+
+/**
+ * @brief Prepare a linked timeout op submission
+ *
+ * The submission must directly follow the one it bounds, which must be flagged with
+ * @ref RTIO_SQE_CHAINED.
+ *
+ * @see rtio_sqe_prep_timeout()
+ */
+static inline void rtio_sqe_prep_link_timeout(struct rtio_sqe *sqe, k_timeout_t timeout,
+					      void *userdata)
+{
+	rtio_sqe_prep_timeout(sqe, timeout, userdata);
+	sqe->flags = RTIO_SQE_LINK_TIMEOUT;
+}
+
 /**
  * @brief Prepare a transceive op submission
  */
@@ -1040,6 +1117,47 @@ static inline struct rtio_cqe *rtio_cqe_consume_block(struct rtio *r)
 	return cqe;
 }
 
+/**
+ * @brief Consume the completion queue events available, up to a maximum
+ *
+ * The completion queue is drained in a single pass, which is cheaper than calling
+ * rtio_cqe_consume() for each completion queue event. The completion queue events returned
+ * must be released with rtio_cqe_release_batch() or rtio_cqe_release() at some point.
+ *
+ * @param r RTIO context
+ * @param cqes Array receiving the completion queue events
+ * @param max Size of @p cqes
+ *
+ * @return Number of completion queue events consumed, 0 if none was available
+ */
+static inline size_t rtio_cqe_consume_batch(struct rtio *r, struct rtio_cqe **cqes, size_t max)
+{
+	struct mpsc_node *node;
+	size_t count = 0;
+
+#ifdef CONFIG_RTIO_CONSUME_SEM
+	/* Given for each completion once it is queued, the count bounds the batch */
+	max = MIN(max, (size_t)k_sem_count_get(r->consume_sem));
+#endif
+
+	while (count < max) {
+		node = mpsc_pop(&r->cq);
+		if (node == NULL) {
+			break;
+		}
+		cqes[count++] = CONTAINER_OF(node, struct rtio_cqe, q);
+	}
+
+#ifdef CONFIG_RTIO_CONSUME_SEM
+	/* The consumer is the only one taking the semaphore, none of these takes blocks */
+	for (size_t i = 0; i < count; i++) {
+		(void)k_sem_take(r->consume_sem, K_NO_WAIT);
+	}
+#endif
+
+	return count;
+}
+
 /**
  * @brief Release consumed completion queue event
  *
@@ -1051,6 +1169,22 @@ static inline void rtio_cqe_release(struct rtio *r, struct rtio_cqe *cqe)
 	rtio_cqe_pool_free(r->cqe_pool, cqe);
 }
 
+/**
+ * @brief Release consumed completion queue events
+ *
+ * @param r RTIO context
+ * @param cqes Completion queue entries
+ * @param count Number of entries in @p cqes
+ */
+static inline void rtio_cqe_release_batch(struct rtio *r, struct rtio_cqe **cqes, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		mpsc_push(&r->cqe_pool->free_q, &cqes[i]->q);
+	}
+
+	r->cqe_pool->pool_free += (uint16_t)count;
+}
+
 /**
  * @brief Compute the CQE flags from the rtio_iodev_sqe entry
  *
@@ -1407,6 +1541,13 @@ static inline int z_impl_rtio_cqe_copy_out(struct rtio *r,
 	k_timepoint_t end = sys_timepoint_calc(timeout);
 
 	do {
+#ifdef CONFIG_RTIO_CONSUME_SEM
+		/* Sleep until a completion is produced rather than polling for one */
+		if (!K_TIMEOUT_EQ(timeout, K_FOREVER) &&
+		    k_sem_take(r->consume_sem, sys_timepoint_timeout(end)) == 0) {
+			k_sem_give(r->consume_sem);
+		}
+#endif
 		cqe = K_TIMEOUT_EQ(timeout, K_FOREVER) ? rtio_cqe_consume_block(r)
 						       : rtio_cqe_consume(r);
 		if (cqe == NULL) {
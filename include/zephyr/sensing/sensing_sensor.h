@@ -91,6 +91,14 @@ struct sensing_connection {
 	/** Next consume time of the connection. Unit is micro seconds. */
 	uint64_t next_consume_time;
 	struct sensing_callback_list *callback_list; /**< Callback list of the connection. */
+	/** Maximum time samples are batched before being reported. Unit is micro seconds. */
+	uint64_t latency;
+	/** Readings batched for the connection, NULL if batching was never enabled. */
+	void *batch;
+	/** Timestamp of the last batched reading. Unit is micro seconds. */
+	uint64_t batch_timestamp;
+	/** Time by which the batched readings must be reported. Unit is micro seconds. */
+	uint64_t batch_deadline;
 };
 
 /**
@@ -110,6 +118,7 @@ struct sensing_sensor {
 	const uint16_t reporter_num; /**< Reporter number of the sensor instance. */
 	sys_slist_t client_list;     /**< List of the sensor clients. */
 	uint32_t interval;           /**< Report interval of the sensor sample in micro seconds. */
+	uint64_t latency;            /**< Batching latency of the sensor in micro seconds. */
 	uint8_t sensitivity_count;   /**< Sensitivity count of the sensor instance. */
 	/** Sensitivity array of the sensor instance. */
 	int sensitivity[CONFIG_SENSING_MAX_SENSITIVITY_COUNT];
@@ -113,6 +113,61 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+#if defined(CONFIG_DISK_ACCESS_QUEUE) || defined(__DOXYGEN__)
+
+struct disk_access_req;
+
+/**
+ * @brief Completion callback of an asynchronous disk request
+ *
+ * Called from the disk queue thread once the request has been served.
+ *
+ * @param[in] req           The completed request
+ * @param[in] result        0 on success, negative errno code on fail
+ */
+typedef void (*disk_access_req_cb_t)(struct disk_access_req *req, int result);
+
+/**
+ * @brief Asynchronous disk request
+ *
+ * The request, and the buffer it points to, must stay valid and untouched
+ * until its callback has been called.
+ */
+struct disk_access_req {
+	/** Reserved for the disk queue */
+	void *fifo_reserved;
+	/** Disk name */
+	const char *pdrv;
+	/** Buffer to read into or to write from */
+	uint8_t *buf;
+	/** Start disk sector */
+	uint32_t start_sector;
+	/** Number of disk sectors */
+	uint32_t num_sector;
+	/** true to write @a buf to the disk, false to read into it */
+	bool write;
+	/** Completion callback, may be NULL */
+	disk_access_req_cb_t cb;
+	/** User data, not used by the disk queue */
+	void *user_data;
+};
+
+/**
+ * @brief Queue a read or write request
+ *
+ * Requests are served in submission order by the disk queue thread. Queued
+ * requests that continue each other on the same disk, in the same direction
+ * and in contiguous memory are merged into a single multi-sector transfer,
+ * so callers can pipeline sequential I/O without waiting for each sector.
+ *
+ * @param[in] req           Request to queue
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_submit(struct disk_access_req *req);
+
+#endif /* CONFIG_DISK_ACCESS_QUEUE */
+
 #ifdef __cplusplus
 }
 #endif
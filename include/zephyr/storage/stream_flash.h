@@ -25,6 +25,9 @@
 
 #include <stdbool.h>
 #include <zephyr/drivers/flash.h>
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+#include <zephyr/kernel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +44,10 @@ extern "C" {
  * instance by using a SHA function). The write buffer 'buf' provided in
  * stream_flash_init is used as a read buffer for this purpose.
  *
+ * When asynchronous writes are enabled with @ref stream_flash_set_async,
+ * the callback is invoked from the stream flash work queue, with the write
+ * buffer that was programmed.
+ *
  * @param buf Pointer to the data read.
  * @param len The length of the data read.
  * @param offset The offset the data was read from.
@@ -67,6 +74,17 @@ struct stream_flash_ctx {
 #endif
 	size_t write_block_size;	/* Offset/size device write alignment */
 	uint8_t erase_value;
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	struct {
+		struct k_work work; /* Programs the buffer in flight */
+		struct k_work erase_work; /* Erases the page of the next buffer */
+		uint8_t *buf; /* Buffer in flight, or spare buffer, NULL if sync */
+		size_t bytes; /* Number of bytes in flight */
+		size_t addr; /* Offset the buffer in flight is written to */
+		size_t erase_addr; /* Offset the next buffer is written to */
+		int rc; /* Result of the work done since the last wait */
+	} async;
+#endif
 };
 
 /**
@@ -88,9 +106,39 @@ struct stream_flash_ctx {
 int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 		      uint8_t *buf, size_t buf_len, size_t offset, size_t size,
 		      stream_flash_callback_t cb);
+/**
+ * @brief Enable asynchronous writes with a second write buffer.
+ *
+ * Once enabled, a full write buffer is erased, programmed and verified on
+ * the stream flash work queue while the caller fills the other buffer, and
+ * the page a new buffer starts in is erased ahead of time. The result of
+ * programming a buffer is returned by the next call to
+ * @ref stream_flash_buffered_write, which also waits for all buffers to be
+ * programmed when it flushes the context.
+ *
+ * Must be called after @ref stream_flash_init and before any write. The
+ * context must not be erased with @ref stream_flash_erase_page while a
+ * buffer is in flight. If programming a buffer fails, the context has to be
+ * re-initialized. Re-initializing the context, or calling this function
+ * again, cancels the buffers still in flight and waits for the one being
+ * programmed. With asynchronous writes enabled, a context must be zeroed
+ * before it is initialized for the first time.
+ *
+ * @param ctx context
+ * @param buf Second write buffer
+ * @param buf_len Length of the second write buffer, which must be the length
+ *                of the write buffer given to @ref stream_flash_init.
+ *
+ * @return non-negative on success, negative errno code on fail
+ */
+int stream_flash_set_async(struct stream_flash_ctx *ctx, uint8_t *buf, size_t buf_len);
+
 /**
  * @brief Read number of bytes written to the flash.
  *
+ * With asynchronous writes, the bytes of the buffer being programmed are
+ * included.
+ *
  * @note api-tags: pre-kernel-ok isr-ok
  *
  * @param ctx context
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API for the region heap
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_REGION_HEAP_H_
+#define ZEPHYR_INCLUDE_SYS_REGION_HEAP_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/multi_heap.h>
+#include <zephyr/sys/sys_heap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Region heap
+ * @defgroup region_heap Region heap
+ * @ingroup heaps
+ * @{
+ *
+ * The region heap manages memory regions with different attributes, for
+ * example tightly coupled memory, internal SRAM and external PSRAM, under a
+ * single allocation API.
+ *
+ * Allocations request a mask of attributes. The region serving a request is
+ * looked up in a table, built at initialization, indexed by the attribute
+ * mask and the size class of the request. The table holds the first region,
+ * in configuration order, providing all the requested attributes and
+ * accepting the size. When that region is exhausted, the allocation follows
+ * the fallback chain of the regions, skipping those not providing the
+ * attributes or not accepting the size.
+ *
+ * Each region can carve a slab cache for small allocations out of its end,
+ * which serves the allocations that fit in a block without walking the heap.
+ */
+
+/** Number of size classes of the region lookup table. */
+#define SYS_REGION_HEAP_SIZE_CLASSES 8
+
+/** Largest size of the first size class, each class doubles the size. */
+#define SYS_REGION_HEAP_MIN_CLASS_SIZE 16
+
+/** Number of distinct attribute masks of the region lookup table. */
+#define SYS_REGION_HEAP_ATTR_MASKS BIT(CONFIG_REGION_HEAP_ATTR_BITS)
+
+/** No region. */
+#define SYS_REGION_HEAP_NONE UINT8_MAX
+
+/**
+ * @brief Region heap region configuration
+ */
+struct sys_region_heap_config {
+	/** Start address of the region */
+	uintptr_t addr;
+	/** Size of the region in bytes */
+	size_t size;
+	/** Attributes provided by the region, one bit per attribute */
+	uint32_t attr;
+	/**
+	 * Largest allocation served by the region, or 0 for no limit. The
+	 * region serves a size class only if it accepts its largest size.
+	 */
+	size_t max_alloc;
+	/** Block size of the slab cache, or 0 for no slab cache */
+	size_t slab_block_size;
+	/** Number of blocks of the slab cache */
+	uint32_t slab_num_blocks;
+	/** Index of the region tried when this one is exhausted, or @ref SYS_REGION_HEAP_NONE */
+	uint8_t fallback;
+};
+
+/**
+ * @brief Region heap region statistics
+ */
+struct sys_region_heap_stats {
+	/** Bytes allocated from the heap of the region */
+	size_t heap_allocated;
+	/** Size of the heap of the region in bytes */
+	size_t heap_size;
+	/** Blocks allocated from the slab cache of the region */
+	uint32_t slab_used;
+	/** Blocks of the slab cache of the region */
+	uint32_t slab_blocks;
+	/** Allocations served by the region */
+	uint32_t allocs;
+	/** Allocations the region was selected for, but served by a fallback */
+	uint32_t fallbacks;
+	/** Allocations the region was selected for, but that failed */
+	uint32_t failures;
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+struct sys_region_heap_region {
+	const struct sys_region_heap_config *cfg;
+	struct sys_heap heap;
+	struct k_mem_slab slab;
+	uintptr_t slab_start;
+	uintptr_t slab_end;
+	size_t heap_size;
+	size_t heap_allocated;
+	uint32_t allocs;
+	uint32_t fallbacks;
+	uint32_t failures;
+};
+
+/** @endcond */
+
+/**
+ * @brief Region heap
+ */
+struct sys_region_heap {
+	/** @cond INTERNAL_HIDDEN */
+	struct sys_multi_heap mheap;
+	struct k_spinlock lock;
+	uint8_t nregions;
+	struct sys_region_heap_region regions[MAX_MULTI_HEAPS];
+	uint8_t table[SYS_REGION_HEAP_ATTR_MASKS][SYS_REGION_HEAP_SIZE_CLASSES];
+	/** @endcond */
+};
+
+/**
+ * @brief Initialize a region heap
+ *
+ * The configuration of the regions must be preserved while the region heap
+ * is used. The index of a region in @p regions is used to refer to it, both
+ * by the fallback chains and by @ref sys_region_heap_stats_get.
+ *
+ * @param rheap Region heap to initialize
+ * @param regions Configuration of the regions, in order of preference
+ * @param count Number of regions, at most MAX_MULTI_HEAPS
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the configuration is invalid
+ */
+int sys_region_heap_init(struct sys_region_heap *rheap,
+			 const struct sys_region_heap_config *regions, size_t count);
+
+/**
+ * @brief Allocate memory from a region heap
+ *
+ * @param rheap Region heap
+ * @param attr Mask of the attributes the memory must provide
+ * @param bytes Size of the allocation in bytes
+ *
+ * @return A valid pointer to memory, or NULL if no region providing the
+ *         attributes has memory available
+ */
+void *sys_region_heap_alloc(struct sys_region_heap *rheap, uint32_t attr, size_t bytes);
+
+/**
+ * @brief Allocate aligned memory from a region heap
+ *
+ * @param rheap Region heap
+ * @param attr Mask of the attributes the memory must provide
+ * @param align Power of two alignment of the memory in bytes
+ * @param bytes Size of the allocation in bytes
+ *
+ * @return A valid pointer to memory, or NULL if no region providing the
+ *         attributes has memory available
+ */
+void *sys_region_heap_aligned_alloc(struct sys_region_heap *rheap, uint32_t attr, size_t align,
+				    size_t bytes);
+
+/**
+ * @brief Free memory allocated from a region heap
+ *
+ * @param rheap Region heap
+ * @param block Memory allocated from @p rheap, or NULL
+ */
+void sys_region_heap_free(struct sys_region_heap *rheap, void *block);
+
+/**
+ * @brief Get the region of a region heap holding memory
+ *
+ * @param rheap Region heap
+ * @param block Memory allocated from @p rheap
+ *
+ * @return Index of the region, or -ENOENT if @p block is not in a region
+ */
+int sys_region_heap_region_get(struct sys_region_heap *rheap, void *block);
+
+/**
+ * @brief Get the statistics of a region of a region heap
+ *
+ * @param rheap Region heap
+ * @param region Index of the region
+ * @param stats Statistics of the region
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the region does not exist
+ */
+int sys_region_heap_stats_get(struct sys_region_heap *rheap, int region,
+			      struct sys_region_heap_stats *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_REGION_HEAP_H_ */
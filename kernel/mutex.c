@@ -41,12 +41,24 @@
 #include <zephyr/llext/symbol.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
-/* We use a global spinlock here because some of the synchronization
- * is protecting things like owner thread priorities which aren't
- * "part of" a single k_mutex.  Should move those bits of the API
- * under the scheduler lock so we can break this up.
+/* An uncontended mutex is taken and released by swapping its owner with
+ * atomic compare-and-set operations, without taking any lock.
+ *
+ * Everything else runs under the per-mutex spinlock. A thread about to
+ * wait sets mutex->contended under that lock before it checks the owner
+ * one last time, and an owner releasing the mutex on the fast path checks
+ * mutex->contended after clearing the owner: either the waiter sees the
+ * mutex free, or the owner sees the waiter and hands the mutex over under
+ * the lock, which the waiter only drops once it is pended. The owner
+ * priority changes made for priority inheritance are serialized with the
+ * rest of the scheduler state by z_thread_prio_set().
+ *
+ * The fast path does not touch the original priority of the owner: the
+ * first waiter records it under the lock, together with the owner it
+ * belongs to, before boosting that owner. The record is dropped with the
+ * last waiter, so only an owner boosted through this mutex is lowered
+ * back, and never to the priority of a previous owner.
  */
-static struct k_spinlock lock;
 
 #ifdef CONFIG_OBJ_CORE_MUTEX
 static struct k_obj_type obj_type_mutex;
@@ -54,8 +66,11 @@ static struct k_obj_type obj_type_mutex;
 
 int z_impl_k_mutex_init(struct k_mutex *mutex)
 {
+	mutex->lock = (struct k_spinlock) {};
 	mutex->owner = NULL;
+	(void)atomic_set(&mutex->contended, 0);
 	mutex->lock_count = 0U;
+	mutex->prio_owner = NULL;
 
 	z_waitq_init(&mutex->wait_q);
 
@@ -88,22 +103,104 @@ static int32_t new_prio_for_inheritance(int32_t target, int32_t limit)
 	return new_prio;
 }
 
-static bool adjust_owner_prio(struct k_mutex *mutex, int32_t new_prio)
+static bool adjust_owner_prio(struct k_thread *owner, int32_t new_prio)
 {
-	if (mutex->owner->base.prio != new_prio) {
+	if (owner->base.prio != new_prio) {
 
 		LOG_DBG("%p (ready (y/n): %c) prio changed to %d (was %d)",
-			mutex->owner, z_is_thread_ready(mutex->owner) ?
-			'y' : 'n',
-			new_prio, mutex->owner->base.prio);
+			owner, z_is_thread_ready(owner) ? 'y' : 'n',
+			new_prio, owner->base.prio);
 
-		return z_thread_prio_set(mutex->owner, new_prio);
+		return z_thread_prio_set(owner, new_prio);
 	}
 	return false;
 }
 
+static inline struct k_thread *mutex_owner(struct k_mutex *mutex)
+{
+	return atomic_ptr_get((atomic_ptr_t *)&mutex->owner);
+}
+
+/* Take a free mutex for the current thread, returns false if it is owned */
+static inline bool mutex_try_take(struct k_mutex *mutex)
+{
+	if (!atomic_ptr_cas((atomic_ptr_t *)&mutex->owner, NULL, _current)) {
+		return false;
+	}
+
+	mutex->lock_count = 1U;
+
+	LOG_DBG("%p took mutex %p, count: %d", _current, mutex, mutex->lock_count);
+
+	return true;
+}
+
+/* Record the priority of the owner before boosting it, with the mutex lock held */
+static void mutex_record_prio(struct k_mutex *mutex, struct k_thread *owner)
+{
+	if (mutex->prio_owner != owner) {
+		mutex->prio_owner = owner;
+		mutex->owner_orig_prio = owner->base.prio;
+	}
+}
+
+/* Lower the current thread back if it was boosted, with the mutex lock held */
+static bool mutex_restore_prio(struct k_mutex *mutex)
+{
+	if (mutex->prio_owner != _current) {
+		return false;
+	}
+
+	mutex->prio_owner = NULL;
+
+	return adjust_owner_prio(_current, mutex->owner_orig_prio);
+}
+
+/* Drop the contention once no thread waits anymore, with the mutex lock held */
+static void mutex_uncontend(struct k_mutex *mutex)
+{
+	if (z_waitq_head(&mutex->wait_q) == NULL) {
+		mutex->prio_owner = NULL;
+		(void)atomic_set(&mutex->contended, 0);
+	}
+}
+
+/* Hand the mutex to its first waiter, with the mutex lock held */
+static bool mutex_hand_over(struct k_mutex *mutex)
+{
+	struct k_thread *new_owner = z_unpend_first_thread(&mutex->wait_q);
+
+	LOG_DBG("new owner of mutex %p: %p (prio: %d)",
+		mutex, new_owner, new_owner ? new_owner->base.prio : -1000);
+
+	mutex->prio_owner = NULL;
+	mutex_uncontend(mutex);
+
+	if (new_owner == NULL) {
+		mutex->lock_count = 0U;
+		(void)atomic_ptr_set((atomic_ptr_t *)&mutex->owner, NULL);
+		return false;
+	}
+
+	/*
+	 * new owner is already of higher or equal prio than first
+	 * waiter since the wait queue is priority-based: no need to
+	 * adjust its priority, only to record it for the waiters left
+	 */
+	mutex->lock_count = 1U;
+	if (atomic_get(&mutex->contended) != 0) {
+		mutex_record_prio(mutex, new_owner);
+	}
+	(void)atomic_ptr_set((atomic_ptr_t *)&mutex->owner, new_owner);
+	arch_thread_return_value_set(new_owner, 0);
+	z_ready_thread(new_owner);
+
+	return true;
+}
+
 int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 {
+	struct k_thread *owner;
 	int new_prio;
 	k_spinlock_key_t key;
 	bool resched = false;
@@ -112,48 +209,63 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mutex, lock, mutex, timeout);
 
-	key = k_spin_lock(&lock);
-
-	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
-
-		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
-					_current->base.prio :
-					mutex->owner_orig_prio;
-
+	/* Only the owner itself can have set the owner to _current */
+	if (mutex->owner == _current) {
 		mutex->lock_count++;
-		mutex->owner = _current;
 
-		LOG_DBG("%p took mutex %p, count: %d, orig prio: %d",
-			_current, mutex, mutex->lock_count,
-			mutex->owner_orig_prio);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, 0);
 
-		k_spin_unlock(&lock, key);
+		return 0;
+	}
 
+	if (likely(mutex_try_take(mutex))) {
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, 0);
 
 		return 0;
 	}
 
 	if (unlikely(K_TIMEOUT_EQ(timeout, K_NO_WAIT))) {
-		k_spin_unlock(&lock, key);
-
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, -EBUSY);
 
 		return -EBUSY;
 	}
 
+	key = k_spin_lock(&mutex->lock);
+
+	/*
+	 * Once contended is set, an owner releasing the mutex takes the lock
+	 * to hand it over, so a non-NULL owner read here stays valid until
+	 * this thread is pended.
+	 */
+	do {
+		(void)atomic_set(&mutex->contended, 1);
+
+		if (mutex_try_take(mutex)) {
+			mutex_uncontend(mutex);
+			k_spin_unlock(&mutex->lock, key);
+
+			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, 0);
+
+			return 0;
+		}
+
+		owner = mutex_owner(mutex);
+	} while (owner == NULL);
+
 	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_mutex, lock, mutex, timeout);
 
+	mutex_record_prio(mutex, owner);
+
 	new_prio = new_prio_for_inheritance(_current->base.prio,
-					    mutex->owner->base.prio);
+					    owner->base.prio);
 
 	LOG_DBG("adjusting prio up on mutex %p", mutex);
 
-	if (z_is_prio_higher(new_prio, mutex->owner->base.prio)) {
-		resched = adjust_owner_prio(mutex, new_prio);
+	if (z_is_prio_higher(new_prio, owner->base.prio)) {
+		resched = adjust_owner_prio(owner, new_prio);
 	}
 
-	int got_mutex = z_pend_curr(&lock, key, &mutex->wait_q, timeout);
+	int got_mutex = z_pend_curr(&mutex->lock, key, &mutex->wait_q, timeout);
 
 	LOG_DBG("on mutex %p got_mutex value: %d", mutex, got_mutex);
 
@@ -169,13 +281,15 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 
 	LOG_DBG("%p timeout on mutex %p", _current, mutex);
 
-	key = k_spin_lock(&lock);
+	key = k_spin_lock(&mutex->lock);
 
 	/*
-	 * Check if mutex was unlocked after this thread was unpended.
-	 * If so, skip adjusting owner's priority down.
+	 * Check if mutex was unlocked after this thread was unpended, or
+	 * taken by a thread no waiter has boosted yet. If so, skip adjusting
+	 * owner's priority down.
 	 */
-	if (likely(mutex->owner != NULL)) {
+	owner = mutex_owner(mutex);
+	if (likely((owner != NULL) && (owner == mutex->prio_owner))) {
 		struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
 
 		new_prio = (waiter != NULL) ?
@@ -184,13 +298,15 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 
 		LOG_DBG("adjusting prio down on mutex %p", mutex);
 
-		resched = adjust_owner_prio(mutex, new_prio) || resched;
+		resched = adjust_owner_prio(owner, new_prio) || resched;
 	}
 
+	mutex_uncontend(mutex);
+
 	if (resched) {
-		z_reschedule(&lock, key);
+		z_reschedule(&mutex->lock, key);
 	} else {
-		k_spin_unlock(&lock, key);
+		k_spin_unlock(&mutex->lock, key);
 	}
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, -EAGAIN);
@@ -210,7 +326,8 @@ static inline int z_vrfy_k_mutex_lock(struct k_mutex *mutex,
 
 int z_impl_k_mutex_unlock(struct k_mutex *mutex)
 {
-	struct k_thread *new_owner;
+	struct k_thread *owner;
+	k_spinlock_key_t key;
 
 	__ASSERT(!arch_is_in_isr(), "mutexes cannot be used inside ISRs");
 
@@ -249,31 +366,56 @@ int z_impl_k_mutex_unlock(struct k_mutex *mutex)
 		goto k_mutex_unlock_return;
 	}
 
-	k_spinlock_key_t key = k_spin_lock(&lock);
-
-	adjust_owner_prio(mutex, mutex->owner_orig_prio);
-
-	/* Get the new owner, if any */
-	new_owner = z_unpend_first_thread(&mutex->wait_q);
-
-	mutex->owner = new_owner;
+	/* Without any waiter, no thread has boosted the owner through this mutex */
+	if (likely(atomic_get(&mutex->contended) == 0)) {
+		mutex->lock_count = 0U;
+		(void)atomic_ptr_set((atomic_ptr_t *)&mutex->owner, NULL);
 
-	LOG_DBG("new owner of mutex %p: %p (prio: %d)",
-		mutex, new_owner, new_owner ? new_owner->base.prio : -1000);
+		if (likely(atomic_get(&mutex->contended) == 0)) {
+			goto k_mutex_unlock_return;
+		}
 
-	if (unlikely(new_owner != NULL)) {
 		/*
-		 * new owner is already of higher or equal prio than first
-		 * waiter since the wait queue is priority-based: no need to
-		 * adjust its priority
+		 * A thread started waiting meanwhile and may have boosted this
+		 * one: take the mutex back to hand it over, unless another
+		 * thread took it first and will hand it over itself.
 		 */
-		mutex->owner_orig_prio = new_owner->base.prio;
-		arch_thread_return_value_set(new_owner, 0);
-		z_ready_thread(new_owner);
-		z_reschedule(&lock, key);
+		key = k_spin_lock(&mutex->lock);
+
+		if (!atomic_ptr_cas((atomic_ptr_t *)&mutex->owner, NULL, _current)) {
+			struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
+			bool resched = mutex_restore_prio(mutex);
+
+			owner = mutex_owner(mutex);
+			if ((owner != NULL) && (waiter != NULL)) {
+				int new_prio;
+
+				mutex_record_prio(mutex, owner);
+				new_prio = new_prio_for_inheritance(waiter->base.prio,
+								    owner->base.prio);
+
+				if (z_is_prio_higher(new_prio, owner->base.prio)) {
+					resched = adjust_owner_prio(owner, new_prio) || resched;
+				}
+			}
+
+			if (resched) {
+				z_reschedule(&mutex->lock, key);
+			} else {
+				k_spin_unlock(&mutex->lock, key);
+			}
+			goto k_mutex_unlock_return;
+		}
 	} else {
-		mutex->lock_count = 0U;
-		k_spin_unlock(&lock, key);
+		key = k_spin_lock(&mutex->lock);
+	}
+
+	(void)mutex_restore_prio(mutex);
+
+	if (unlikely(mutex_hand_over(mutex))) {
+		z_reschedule(&mutex->lock, key);
+	} else {
+		k_spin_unlock(&mutex->lock, key);
 	}
 
 
@@ -360,6 +360,7 @@ static size_t pipe_write(struct k_pipe *pipe, sys_dlist_t *src_list,
 			/* The thread's read request has been satisfied. */
 
 			z_unpend_thread(dest->thread);
+			arch_thread_return_value_set(dest->thread, 0);
 			z_ready_thread(dest->thread);
 
 			*reschedule = true;
@@ -377,6 +378,112 @@ static size_t pipe_write(struct k_pipe *pipe, sys_dlist_t *src_list,
 	return num_bytes_written;
 }
 
+/**
+ * @brief Ready the waiters at the head of @a wait_q whose request is complete
+ *
+ * Waiters are served in order, so the satisfied ones are at the head. This
+ * includes zero length requests, which are only waiting for a change of the
+ * pipe buffer (claims).
+ */
+static void pipe_wake_satisfied(_wait_q_t *wait_q, bool *reschedule)
+{
+	struct k_thread *thread;
+	struct _pipe_desc *desc;
+
+	while ((thread = z_waitq_head(wait_q)) != NULL) {
+		desc = (struct _pipe_desc *)thread->base.swap_data;
+		if (desc->bytes_to_xfer != 0U) {
+			break;
+		}
+
+		z_unpend_thread(thread);
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+
+		*reschedule = true;
+	}
+}
+
+/**
+ * @brief Move data from the waiting writers into the pipe buffer
+ */
+static void pipe_refill_from_writers(struct k_pipe *pipe, bool *reschedule)
+{
+	struct _pipe_desc pipe_desc[2];
+	sys_dlist_t src_list;
+	sys_dlist_t pipe_list;
+
+	if ((pipe->bytes_used == pipe->size) ||
+	    ((pipe->flags & K_PIPE_FLAG_PUT_CLAIM) != 0U)) {
+		return;
+	}
+
+	/*
+	 * The pipe is not full. If there are any waiting writers,
+	 * refill the pipe.
+	 */
+
+	sys_dlist_init(&src_list);
+	sys_dlist_init(&pipe_list);
+
+	(void) pipe_waiter_list_populate(&src_list, &pipe->wait_q.writers,
+					 pipe->size - pipe->bytes_used);
+
+	(void) pipe_buffer_list_populate(&pipe_list, pipe_desc,
+					 pipe->buffer, pipe->size,
+					 pipe->write_index,
+					 pipe->read_index);
+
+	(void) pipe_write(pipe, &src_list, &pipe_list, reschedule);
+
+	/* Writers whose data now all sits in the buffer are done */
+	pipe_wake_satisfied(&pipe->wait_q.writers, reschedule);
+}
+
+/**
+ * @brief Move data from the pipe buffer to the waiting readers
+ */
+static void pipe_feed_readers(struct k_pipe *pipe, bool *reschedule)
+{
+	struct _pipe_desc *dest;
+	sys_dlist_t dest_list;
+	size_t bytes_copied;
+
+	if ((pipe->flags & K_PIPE_FLAG_GET_CLAIM) != 0U) {
+		return;
+	}
+
+	sys_dlist_init(&dest_list);
+
+	(void) pipe_waiter_list_populate(&dest_list, &pipe->wait_q.readers,
+					 pipe->bytes_used);
+
+	dest = (struct _pipe_desc *)sys_dlist_get(&dest_list);
+	while ((dest != NULL) && (pipe->bytes_used != 0U)) {
+		bytes_copied = pipe_xfer(dest->buffer, dest->bytes_to_xfer,
+					 &pipe->buffer[pipe->read_index],
+					 MIN(pipe->bytes_used,
+					     pipe->size - pipe->read_index));
+
+		if (dest->buffer != NULL) {
+			dest->buffer += bytes_copied;
+		}
+		dest->bytes_to_xfer -= bytes_copied;
+
+		pipe->bytes_used -= bytes_copied;
+		pipe->read_index += bytes_copied;
+		if (pipe->read_index >= pipe->size) {
+			pipe->read_index -= pipe->size;
+		}
+
+		if (dest->bytes_to_xfer == 0U) {
+			dest = (struct _pipe_desc *)sys_dlist_get(&dest_list);
+		}
+	}
+
+	pipe_wake_satisfied(&pipe->wait_q.readers, reschedule);
+}
+
 int z_impl_k_pipe_put(struct k_pipe *pipe, const void *data,
 		      size_t bytes_to_write, size_t *bytes_written,
 		      size_t min_xfer, k_timeout_t timeout)
@@ -415,7 +522,8 @@ int z_impl_k_pipe_put(struct k_pipe *pipe, const void *data,
 						    &pipe->wait_q.readers,
 						    bytes_to_write);
 
-	if (pipe->bytes_used != pipe->size) {
+	if ((pipe->bytes_used != pipe->size) &&
+	    ((pipe->flags & K_PIPE_FLAG_PUT_CLAIM) == 0U)) {
 		bytes_can_write += pipe_buffer_list_populate(&dest_list,
 							     pipe_desc,
 							     pipe->buffer,
@@ -552,7 +660,8 @@ static int pipe_get_internal(k_spinlock_key_t key, struct k_pipe *pipe,
 
 	sys_dlist_init(&src_list);
 
-	if (pipe->bytes_used != 0) {
+	if ((pipe->bytes_used != 0) &&
+	    ((pipe->flags & K_PIPE_FLAG_GET_CLAIM) == 0U)) {
 		bytes_can_read = pipe_buffer_list_populate(&src_list,
 							   pipe_desc,
 							   pipe->buffer,
@@ -618,6 +727,7 @@ static int pipe_get_internal(k_spinlock_key_t key, struct k_pipe *pipe,
 			/* The thread's write request has been satisfied. */
 
 			z_unpend_thread(src_desc->thread);
+			arch_thread_return_value_set(src_desc->thread, 0);
 			z_ready_thread(src_desc->thread);
 
 			reschedule_needed = true;
@@ -625,29 +735,7 @@ static int pipe_get_internal(k_spinlock_key_t key, struct k_pipe *pipe,
 		src_desc = (struct _pipe_desc *)sys_dlist_get(&src_list);
 	}
 
-	if (pipe->bytes_used != pipe->size) {
-		sys_dlist_t         pipe_list;
-
-		/*
-		 * The pipe is not full. If there are any waiting writers,
-		 * refill the pipe.
-		 */
-
-		sys_dlist_init(&src_list);
-		sys_dlist_init(&pipe_list);
-
-		(void) pipe_waiter_list_populate(&src_list,
-						 &pipe->wait_q.writers,
-						 pipe->size - pipe->bytes_used);
-
-		(void) pipe_buffer_list_populate(&pipe_list, pipe_desc,
-						 pipe->buffer, pipe->size,
-						 pipe->write_index,
-						 pipe->read_index);
-
-		(void) pipe_write(pipe, &src_list,
-				  &pipe_list, &reschedule_needed);
-	}
+	pipe_refill_from_writers(pipe, &reschedule_needed);
 
 	/*
 	 * The immediate success conditions below are backwards
@@ -736,6 +824,209 @@ int z_vrfy_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 #include <zephyr/syscalls/k_pipe_get_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+/**
+ * @brief Wait for the next change of the pipe buffer
+ *
+ * The caller pends with a zero length request, which the next transfer
+ * through the pipe completes, as would any other satisfied request.
+ */
+static int pipe_claim_wait(struct k_pipe *pipe, k_spinlock_key_t key,
+			   _wait_q_t *wait_q, k_timeout_t timeout)
+{
+	struct _pipe_desc *desc = &_current->pipe_desc;
+
+	desc->buffer = NULL;
+	desc->bytes_to_xfer = 0U;
+	desc->thread = _current;
+
+	_current->base.swap_data = desc;
+
+	return z_sched_wait(&pipe->lock, key, wait_q, timeout, NULL);
+}
+
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout)
+{
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	k_spinlock_key_t key;
+	bool waited = false;
+	size_t free_bytes;
+	int ret;
+
+	__ASSERT(((arch_is_in_isr() == false) ||
+		  K_TIMEOUT_EQ(timeout, K_NO_WAIT)), "");
+
+	CHECKIF((pipe->buffer == NULL) || (data == NULL) || (size == NULL) ||
+		(*size == 0U)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	while (true) {
+		if ((pipe->flags & K_PIPE_FLAG_PUT_CLAIM) != 0U) {
+			ret = -EBUSY;
+			break;
+		}
+
+		free_bytes = pipe->size - pipe->bytes_used;
+		if (free_bytes != 0U) {
+			*data = &pipe->buffer[pipe->write_index];
+			*size = MIN(*size, MIN(free_bytes,
+					       pipe->size - pipe->write_index));
+			pipe->flags |= K_PIPE_FLAG_PUT_CLAIM;
+			ret = 0;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			ret = waited ? -EAGAIN : -EIO;
+			break;
+		}
+
+		ret = pipe_claim_wait(pipe, key, &pipe->wait_q.writers, timeout);
+		key = k_spin_lock(&pipe->lock);
+		if (ret != 0) {
+			break;
+		}
+
+		waited = true;
+		timeout = sys_timepoint_timeout(end);
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return ret;
+}
+
+int k_pipe_put_commit(struct k_pipe *pipe, size_t size)
+{
+	bool reschedule_needed = false;
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	CHECKIF(((pipe->flags & K_PIPE_FLAG_PUT_CLAIM) == 0U) ||
+		(size > MIN(pipe->size - pipe->bytes_used,
+			    pipe->size - pipe->write_index))) {
+		k_spin_unlock(&pipe->lock, key);
+
+		return -EINVAL;
+	}
+
+	pipe->flags &= ~K_PIPE_FLAG_PUT_CLAIM;
+
+	pipe->bytes_used += size;
+	pipe->write_index += size;
+	if (pipe->write_index >= pipe->size) {
+		pipe->write_index -= pipe->size;
+	}
+
+	/* Readers waiting in k_pipe_get() are first in line for the data */
+	pipe_feed_readers(pipe, &reschedule_needed);
+
+	/* Writers may have been kept out of the buffer by the claim */
+	pipe_refill_from_writers(pipe, &reschedule_needed);
+
+	if (pipe->bytes_used != 0U) {
+		handle_poll_events(pipe);
+	}
+
+	if (reschedule_needed) {
+		z_reschedule(&pipe->lock, key);
+	} else {
+		k_spin_unlock(&pipe->lock, key);
+	}
+
+	return 0;
+}
+
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout)
+{
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	k_spinlock_key_t key;
+	bool waited = false;
+	int ret;
+
+	__ASSERT(((arch_is_in_isr() == false) ||
+		  K_TIMEOUT_EQ(timeout, K_NO_WAIT)), "");
+
+	CHECKIF((pipe->buffer == NULL) || (data == NULL) || (size == NULL) ||
+		(*size == 0U)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	while (true) {
+		if ((pipe->flags & K_PIPE_FLAG_GET_CLAIM) != 0U) {
+			ret = -EBUSY;
+			break;
+		}
+
+		if (pipe->bytes_used != 0U) {
+			*data = &pipe->buffer[pipe->read_index];
+			*size = MIN(*size, MIN(pipe->bytes_used,
+					       pipe->size - pipe->read_index));
+			pipe->flags |= K_PIPE_FLAG_GET_CLAIM;
+			ret = 0;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			ret = waited ? -EAGAIN : -EIO;
+			break;
+		}
+
+		ret = pipe_claim_wait(pipe, key, &pipe->wait_q.readers, timeout);
+		key = k_spin_lock(&pipe->lock);
+		if (ret != 0) {
+			break;
+		}
+
+		waited = true;
+		timeout = sys_timepoint_timeout(end);
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return ret;
+}
+
+int k_pipe_get_commit(struct k_pipe *pipe, size_t size)
+{
+	bool reschedule_needed = false;
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	CHECKIF(((pipe->flags & K_PIPE_FLAG_GET_CLAIM) == 0U) ||
+		(size > MIN(pipe->bytes_used,
+			    pipe->size - pipe->read_index))) {
+		k_spin_unlock(&pipe->lock, key);
+
+		return -EINVAL;
+	}
+
+	pipe->flags &= ~K_PIPE_FLAG_GET_CLAIM;
+
+	pipe->bytes_used -= size;
+	pipe->read_index += size;
+	if (pipe->read_index >= pipe->size) {
+		pipe->read_index -= pipe->size;
+	}
+
+	pipe_refill_from_writers(pipe, &reschedule_needed);
+
+	/* Readers may have been kept out of the buffer by the claim */
+	pipe_feed_readers(pipe, &reschedule_needed);
+
+	if (reschedule_needed) {
+		z_reschedule(&pipe->lock, key);
+	} else {
+		k_spin_unlock(&pipe->lock, key);
+	}
+
+	return 0;
+}
+
 size_t z_impl_k_pipe_read_avail(struct k_pipe *pipe)
 {
 	size_t res;
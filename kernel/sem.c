@@ -29,14 +29,19 @@
 #include <zephyr/tracing/tracing.h>
 #include <zephyr/sys/check.h>
 
-/* We use a system-wide lock to synchronize semaphores, which has
- * unfortunate performance impact vs. using a per-object lock
- * (semaphores are *very* widely used).  But per-object locks require
- * significant extra RAM.  A properly spin-aware semaphore
- * implementation would spin on atomic access to the count variable,
- * and not a spinlock per se.  Useful optimization for the future...
+/* Uncontended takes and gives only update the count with atomic
+ * operations. The per-semaphore lock is taken when the count has to be
+ * changed together with the wait queue: a thread about to wait sets the
+ * count to SEM_CONTENDED under the lock, which sends every give to the
+ * slow path until the lock holder has pended and can be woken.
  */
-static struct k_spinlock lock;
+#define SEM_CONTENDED (-1)
+
+/* The count is signed, limits above INT_MAX saturate at INT_MAX */
+static inline atomic_val_t sem_limit(struct k_sem *sem)
+{
+	return (atomic_val_t)MIN(sem->limit, (unsigned int)INT_MAX);
+}
 
 #ifdef CONFIG_OBJ_CORE_SEM
 static struct k_obj_type obj_type_sem;
@@ -54,7 +59,8 @@ int z_impl_k_sem_init(struct k_sem *sem, unsigned int initial_count,
 		return -EINVAL;
 	}
 
-	sem->count = initial_count;
+	sem->lock = (struct k_spinlock) {};
+	(void)atomic_set(&sem->count, MIN(initial_count, (unsigned int)INT_MAX));
 	sem->limit = limit;
 
 	SYS_PORT_TRACING_OBJ_FUNC(k_sem, init, sem, 0);
@@ -93,30 +99,91 @@ static inline bool handle_poll_events(struct k_sem *sem)
 #endif /* CONFIG_POLL */
 }
 
-void z_impl_k_sem_give(struct k_sem *sem)
+static inline bool has_poll_events(struct k_sem *sem)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+#ifdef CONFIG_POLL
+	return !sys_dlist_is_empty(&sem->poll_events);
+#else
+	ARG_UNUSED(sem);
+	return false;
+#endif /* CONFIG_POLL */
+}
+
+/* Take a unit if one is available, returns false otherwise */
+static inline bool sem_try_take(struct k_sem *sem)
+{
+	atomic_val_t count;
+
+	do {
+		count = atomic_get(&sem->count);
+		if (count <= 0) {
+			return false;
+		}
+	} while (!atomic_cas(&sem->count, count, count - 1));
+
+	return true;
+}
+
+static void sem_give_slow(struct k_sem *sem)
+{
+	k_spinlock_key_t key = k_spin_lock(&sem->lock);
 	struct k_thread *thread;
+	atomic_val_t count;
 	bool resched = true;
 
-	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_sem, give, sem);
-
 	thread = z_unpend_first_thread(&sem->wait_q);
 
 	if (unlikely(thread != NULL)) {
 		arch_thread_return_value_set(thread, 0);
 		z_ready_thread(thread);
+		/* Waiters keep the count contended, so nothing else changed it */
+		if (z_waitq_head(&sem->wait_q) == NULL) {
+			(void)atomic_set(&sem->count, 0);
+		}
 	} else {
-		sem->count += (sem->count != sem->limit) ? 1U : 0U;
+		/*
+		 * Waiters may have timed out, leaving the count contended, or
+		 * another give may have cleared it, letting fast paths back in.
+		 */
+		do {
+			count = atomic_get(&sem->count);
+		} while (!atomic_cas(&sem->count, count,
+				     MIN(MAX(count, 0) + 1, sem_limit(sem))));
 		resched = handle_poll_events(sem);
 	}
 
 	if (unlikely(resched)) {
-		z_reschedule(&lock, key);
+		z_reschedule(&sem->lock, key);
 	} else {
-		k_spin_unlock(&lock, key);
+		k_spin_unlock(&sem->lock, key);
 	}
+}
+
+void z_impl_k_sem_give(struct k_sem *sem)
+{
+	atomic_val_t count;
+
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_sem, give, sem);
+
+	do {
+		count = atomic_get(&sem->count);
+		if (count < 0) {
+			sem_give_slow(sem);
+			goto out;
+		}
+		if (count >= sem_limit(sem)) {
+			break;
+		}
+	} while (!atomic_cas(&sem->count, count, count + 1));
 
+	if (unlikely(has_poll_events(sem))) {
+		k_spinlock_key_t key = k_spin_lock(&sem->lock);
+
+		handle_poll_events(sem);
+		z_reschedule(&sem->lock, key);
+	}
+
+out:
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_sem, give, sem);
 }
 
@@ -136,26 +203,40 @@ int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 	__ASSERT(((arch_is_in_isr() == false) ||
 		  K_TIMEOUT_EQ(timeout, K_NO_WAIT)), "");
 
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
+	atomic_val_t count;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_sem, take, sem, timeout);
 
-	if (likely(sem->count > 0U)) {
-		sem->count--;
-		k_spin_unlock(&lock, key);
+	if (likely(sem_try_take(sem))) {
 		ret = 0;
 		goto out;
 	}
 
 	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
-		k_spin_unlock(&lock, key);
 		ret = -EBUSY;
 		goto out;
 	}
 
+	key = k_spin_lock(&sem->lock);
+
+	/* Either take a unit given meanwhile, or mark the count contended */
+	while (true) {
+		count = atomic_get(&sem->count);
+		if (count > 0) {
+			if (atomic_cas(&sem->count, count, count - 1)) {
+				k_spin_unlock(&sem->lock, key);
+				ret = 0;
+				goto out;
+			}
+		} else if (atomic_cas(&sem->count, count, SEM_CONTENDED)) {
+			break;
+		}
+	}
+
 	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_sem, take, sem, timeout);
 
-	ret = z_pend_curr(&lock, key, &sem->wait_q, timeout);
+	ret = z_pend_curr(&sem->lock, key, &sem->wait_q, timeout);
 
 out:
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_sem, take, sem, timeout, ret);
@@ -166,7 +247,7 @@ out:
 void z_impl_k_sem_reset(struct k_sem *sem)
 {
 	struct k_thread *thread;
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key = k_spin_lock(&sem->lock);
 
 	while (true) {
 		thread = z_unpend_first_thread(&sem->wait_q);
@@ -176,13 +257,13 @@ void z_impl_k_sem_reset(struct k_sem *sem)
 		arch_thread_return_value_set(thread, -EAGAIN);
 		z_ready_thread(thread);
 	}
-	sem->count = 0;
+	(void)atomic_set(&sem->count, 0);
 
 	SYS_PORT_TRACING_OBJ_FUNC(k_sem, reset, sem);
 
 	handle_poll_events(sem);
 
-	z_reschedule(&lock, key);
+	z_reschedule(&sem->lock, key);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -54,29 +54,28 @@ void *sys_multi_heap_aligned_alloc(struct sys_multi_heap *mheap,
 const struct sys_multi_heap_rec *sys_multi_heap_get_heap(const struct sys_multi_heap *mheap,
 							 void *addr)
 {
-	uintptr_t haddr, baddr = (uintptr_t) addr;
-	int i;
-
-	/* Search the heaps array to find the correct heap
-	 *
-	 * FIXME: just a linear search currently, as the list is
-	 * always short for reasonable apps and this code is very
-	 * quick.  The array is stored in sorted order though, so a
-	 * binary search based on the block address is the design
-	 * goal.
+	uintptr_t baddr = (uintptr_t) addr;
+	int lo = 0, hi = mheap->nheaps;
+
+	/* The heaps array is sorted by address: find the last heap
+	 * starting at or below the block address.
 	 */
-	for (i = 0; i < mheap->nheaps; i++) {
-		haddr = (uintptr_t)mheap->heaps[i].heap->heap;
-		if (baddr < haddr) {
-			break;
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+
+		if (baddr < (uintptr_t)mheap->heaps[mid].heap->heap) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
 		}
 	}
 
-	/* Now i stores the index of the heap after our target (even
-	 * if it's invalid and our target is the last!)
-	 * FIXME: return -ENOENT when a proper heap is not found
-	 */
-	return &mheap->heaps[i-1];
+	/* Now lo stores the index of the heap after our target */
+	if (lo == 0) {
+		return NULL;
+	}
+
+	return &mheap->heaps[lo - 1];
 }
 
 
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/multi_heap.h>
+#include <zephyr/sys/region_heap.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zephyr/sys/util.h>
+
+/* Alignment of the slab caches and of their blocks */
+#define SLAB_ALIGN sizeof(void *)
+
+static unsigned int size_class(size_t bytes)
+{
+	unsigned int bits;
+
+	if (bytes <= SYS_REGION_HEAP_MIN_CLASS_SIZE) {
+		return 0;
+	}
+
+	if (bytes > (SYS_REGION_HEAP_MIN_CLASS_SIZE << (SYS_REGION_HEAP_SIZE_CLASSES - 2))) {
+		return SYS_REGION_HEAP_SIZE_CLASSES - 1;
+	}
+
+	/* Number of bits of bytes - 1, which is the log2 of bytes rounded up */
+	bits = 32 - u32_count_leading_zeros((uint32_t)bytes - 1);
+
+	return bits - LOG2(SYS_REGION_HEAP_MIN_CLASS_SIZE);
+}
+
+static bool region_has_attr(const struct sys_region_heap_region *region, uint32_t attr)
+{
+	return (region->cfg->attr & attr) == attr;
+}
+
+static bool region_accepts(const struct sys_region_heap_region *region, uint32_t attr,
+			   size_t bytes)
+{
+	return region_has_attr(region, attr) &&
+	       (region->cfg->max_alloc == 0 || bytes <= region->cfg->max_alloc);
+}
+
+static bool region_accepts_class(const struct sys_region_heap_region *region, uint32_t attr,
+				 unsigned int class)
+{
+	if (!region_has_attr(region, attr)) {
+		return false;
+	}
+
+	if (region->cfg->max_alloc == 0) {
+		return true;
+	}
+
+	/* The last class has no largest size */
+	return class < SYS_REGION_HEAP_SIZE_CLASSES - 1 &&
+	       region->cfg->max_alloc >= (SYS_REGION_HEAP_MIN_CLASS_SIZE << class);
+}
+
+static bool region_in_slab(const struct sys_region_heap_region *region, void *block)
+{
+	uintptr_t addr = (uintptr_t)block;
+
+	return addr >= region->slab_start && addr < region->slab_end;
+}
+
+/* The slab is only initialized when both its block size and count are set */
+static bool region_has_slab(const struct sys_region_heap_region *region)
+{
+	return region->cfg->slab_block_size != 0 && region->cfg->slab_num_blocks != 0;
+}
+
+static void *region_alloc(struct sys_region_heap_region *region, size_t align, size_t bytes)
+{
+	void *block;
+
+	if (region_has_slab(region) && bytes <= region->cfg->slab_block_size &&
+	    align <= SLAB_ALIGN &&
+	    k_mem_slab_alloc(&region->slab, &block, K_NO_WAIT) == 0) {
+		return block;
+	}
+
+	block = sys_heap_aligned_alloc(&region->heap, align, bytes);
+	if (block != NULL) {
+		region->heap_allocated += sys_heap_usable_size(&region->heap, block);
+	}
+
+	return block;
+}
+
+void *sys_region_heap_aligned_alloc(struct sys_region_heap *rheap, uint32_t attr, size_t align,
+				    size_t bytes)
+{
+	k_spinlock_key_t key;
+	uint8_t first, idx;
+	void *block = NULL;
+
+	if (bytes == 0 || attr >= SYS_REGION_HEAP_ATTR_MASKS) {
+		return NULL;
+	}
+
+	key = k_spin_lock(&rheap->lock);
+
+	first = rheap->table[attr][size_class(bytes)];
+	idx = first;
+
+	for (int i = 0; idx != SYS_REGION_HEAP_NONE && i < rheap->nregions; i++) {
+		struct sys_region_heap_region *region = &rheap->regions[idx];
+
+		if (region_accepts(region, attr, bytes)) {
+			block = region_alloc(region, align, bytes);
+			if (block != NULL) {
+				region->allocs++;
+				break;
+			}
+		}
+
+		idx = region->cfg->fallback;
+	}
+
+	if (first != SYS_REGION_HEAP_NONE) {
+		if (block == NULL) {
+			rheap->regions[first].failures++;
+		} else if (idx != first) {
+			rheap->regions[first].fallbacks++;
+		}
+	}
+
+	k_spin_unlock(&rheap->lock, key);
+
+	return block;
+}
+
+void *sys_region_heap_alloc(struct sys_region_heap *rheap, uint32_t attr, size_t bytes)
+{
+	return sys_region_heap_aligned_alloc(rheap, attr, 0, bytes);
+}
+
+void sys_region_heap_free(struct sys_region_heap *rheap, void *block)
+{
+	const struct sys_multi_heap_rec *rec;
+	struct sys_region_heap_region *region;
+	k_spinlock_key_t key;
+
+	if (block == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&rheap->lock);
+
+	rec = sys_multi_heap_get_heap(&rheap->mheap, block);
+	__ASSERT(rec != NULL, "%p not allocated from the region heap", block);
+	if (rec != NULL) {
+		region = rec->user_data;
+
+		if (region_in_slab(region, block)) {
+			k_mem_slab_free(&region->slab, block);
+		} else {
+			region->heap_allocated -= sys_heap_usable_size(&region->heap, block);
+			sys_heap_free(&region->heap, block);
+		}
+	}
+
+	k_spin_unlock(&rheap->lock, key);
+}
+
+int sys_region_heap_region_get(struct sys_region_heap *rheap, void *block)
+{
+	const struct sys_multi_heap_rec *rec;
+	const struct sys_region_heap_region *region;
+
+	rec = sys_multi_heap_get_heap(&rheap->mheap, block);
+	if (rec == NULL) {
+		return -ENOENT;
+	}
+
+	region = rec->user_data;
+	if ((uintptr_t)block >= region->cfg->addr + region->cfg->size) {
+		return -ENOENT;
+	}
+
+	return region - rheap->regions;
+}
+
+int sys_region_heap_stats_get(struct sys_region_heap *rheap, int region,
+			      struct sys_region_heap_stats *stats)
+{
+	struct sys_region_heap_region *r;
+	k_spinlock_key_t key;
+
+	if (region < 0 || region >= rheap->nregions) {
+		return -EINVAL;
+	}
+
+	r = &rheap->regions[region];
+
+	key = k_spin_lock(&rheap->lock);
+
+	stats->heap_allocated = r->heap_allocated;
+	stats->heap_size = r->heap_size;
+	stats->slab_blocks = region_has_slab(r) ? r->cfg->slab_num_blocks : 0;
+	stats->slab_used = stats->slab_blocks != 0 ? k_mem_slab_num_used_get(&r->slab) : 0;
+	stats->allocs = r->allocs;
+	stats->fallbacks = r->fallbacks;
+	stats->failures = r->failures;
+
+	k_spin_unlock(&rheap->lock, key);
+
+	return 0;
+}
+
+static void *region_heap_choice(struct sys_multi_heap *mheap, void *cfg, size_t align,
+				size_t size)
+{
+	struct sys_region_heap *rheap = CONTAINER_OF(mheap, struct sys_region_heap, mheap);
+
+	return sys_region_heap_aligned_alloc(rheap, (uint32_t)(uintptr_t)cfg, align, size);
+}
+
+static int region_init(struct sys_region_heap_region *region,
+		       const struct sys_region_heap_config *cfg)
+{
+	size_t block_size = ROUND_UP(cfg->slab_block_size, SLAB_ALIGN);
+	uintptr_t end = cfg->addr + cfg->size;
+	int ret;
+
+	region->cfg = cfg;
+	region->slab_start = end;
+	region->slab_end = end;
+
+	if (region_has_slab(region)) {
+		size_t slab_size = block_size * cfg->slab_num_blocks;
+
+		if (slab_size >= cfg->size) {
+			return -EINVAL;
+		}
+
+		/* The slab cache is carved out of the end of the region, so that
+		 * its blocks are found in the region by address.
+		 */
+		region->slab_start = ROUND_DOWN(end - slab_size, SLAB_ALIGN);
+		region->slab_end = region->slab_start + slab_size;
+
+		ret = k_mem_slab_init(&region->slab, (void *)region->slab_start, block_size,
+				      cfg->slab_num_blocks);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	region->heap_size = region->slab_start - cfg->addr;
+	region->heap_allocated = 0;
+	region->allocs = 0;
+	region->fallbacks = 0;
+	region->failures = 0;
+
+	sys_heap_init(&region->heap, (void *)cfg->addr, region->heap_size);
+
+	return 0;
+}
+
+int sys_region_heap_init(struct sys_region_heap *rheap,
+			 const struct sys_region_heap_config *regions, size_t count)
+{
+	int ret;
+
+	if (count == 0 || count > ARRAY_SIZE(rheap->regions)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (regions[i].attr >= SYS_REGION_HEAP_ATTR_MASKS ||
+		    (regions[i].fallback != SYS_REGION_HEAP_NONE && regions[i].fallback >= count)) {
+			return -EINVAL;
+		}
+	}
+
+	sys_multi_heap_init(&rheap->mheap, region_heap_choice);
+	rheap->nregions = count;
+
+	for (size_t i = 0; i < count; i++) {
+		ret = region_init(&rheap->regions[i], &regions[i]);
+		if (ret < 0) {
+			return ret;
+		}
+
+		sys_multi_heap_add_heap(&rheap->mheap, &rheap->regions[i].heap,
+					&rheap->regions[i]);
+	}
+
+	/* The first region, in order of preference, of each attribute mask and
+	 * size class.
+	 */
+	for (uint32_t attr = 0; attr < SYS_REGION_HEAP_ATTR_MASKS; attr++) {
+		for (unsigned int class = 0; class < SYS_REGION_HEAP_SIZE_CLASSES; class++) {
+			rheap->table[attr][class] = SYS_REGION_HEAP_NONE;
+
+			for (size_t i = 0; i < count; i++) {
+				if (region_accepts_class(&rheap->regions[i], attr, class)) {
+					rheap->table[attr][class] = i;
+					break;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -313,6 +313,50 @@ static bool supports_pread_pwrite(uint32_t mode)
 	}
 }
 
+static bool supports_seek(uint32_t mode)
+{
+	switch (mode & ZVFS_MODE_IFMT) {
+	case ZVFS_MODE_IFREG:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Positional I/O on files which keep their own position, with the fd lock
+ * held. The position is moved around the access, which the other users of
+ * the fd cannot observe since they all take the same lock.
+ */
+static ssize_t zvfs_rw_at(int fd, void *buf, size_t sz, bool is_write, size_t offset)
+{
+	const struct fd_op_vtable *vtable = fdtable[fd].vtable;
+	void *obj = fdtable[fd].obj;
+	ssize_t res;
+	off_t pos;
+	int err;
+
+	pos = zvfs_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_LSEEK, (off_t)0, SEEK_CUR,
+				      fdtable[fd].offset);
+	if (pos < 0 || zvfs_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_LSEEK, (off_t)offset,
+					       SEEK_SET, fdtable[fd].offset) < 0) {
+		return -1;
+	}
+
+	if (is_write) {
+		res = vtable->write(obj, buf, sz);
+	} else {
+		res = vtable->read(obj, buf, sz);
+	}
+
+	err = errno;
+	(void)zvfs_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_LSEEK, pos, SEEK_SET,
+				      fdtable[fd].offset);
+	errno = err;
+
+	return res;
+}
+
 static ssize_t zvfs_rw(int fd, void *buf, size_t sz, bool is_write, const size_t *from_offset)
 {
 	bool prw;
@@ -326,7 +370,10 @@ static ssize_t zvfs_rw(int fd, void *buf, size_t sz, bool is_write, const size_t
 	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
 
 	prw = supports_pread_pwrite(fdtable[fd].mode);
-	if (from_offset != NULL && !prw) {
+	if (from_offset != NULL && !prw && supports_seek(fdtable[fd].mode)) {
+		res = zvfs_rw_at(fd, buf, sz, is_write, *from_offset);
+		goto unlock;
+	} else if (from_offset != NULL && !prw) {
 		/*
 		 * Seekable file types should support pread() / pwrite() and per-fd offset passing.
 		 * Otherwise, it's a bug.
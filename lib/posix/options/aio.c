@@ -4,79 +4,567 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+/*
+ * Asynchronous I/O on top of RTIO.
+ *
+ * Every request is submitted to a private RTIO context as an RX (read), TX
+ * (write) or NOP (fsync) operation on the AIO iodev. The iodev hands the
+ * operation to the RTIO work queue, where it is performed with the regular,
+ * blocking file descriptor calls, so that several requests can be in flight
+ * while the caller keeps running.
+ *
+ * Requests are tracked in a fixed table, from submission until their status
+ * is reaped with aio_return().
+ */
+
 #include <errno.h>
 #include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
 
+#include <zephyr/kernel.h>
 #include <zephyr/posix/aio.h>
+#include <zephyr/posix/unistd.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/rtio/work.h>
+
+/* prototypes for external, not-yet-public, functions in fdtable.c */
+ssize_t zvfs_read(int fd, void *buf, size_t sz, const size_t *from_offset);
+ssize_t zvfs_write(int fd, const void *buf, size_t sz, const size_t *from_offset);
+int zvfs_fsync(int fd);
+
+struct posix_aio_list {
+	/* Requests of the list which are still in progress */
+	int pending;
+	bool used;
+	bool wait;
+	struct sigevent sig;
+};
+
+struct posix_aio_req {
+	/* NULL for a free slot */
+	struct aiocb *aiocbp;
+	struct rtio_work_req *work;
+	struct posix_aio_list *list;
+	struct sigevent sig;
+	int fildes;
+	off_t offset;
+	ssize_t result;
+	/* EINPROGRESS until the request completes */
+	int error;
+};
+
+static void posix_aio_submit(struct rtio_iodev_sqe *iodev_sqe);
+
+static const struct rtio_iodev_api posix_aio_iodev_api = {
+	.submit = posix_aio_submit,
+};
+
+RTIO_IODEV_DEFINE(posix_aio_iodev, &posix_aio_iodev_api, NULL);
+RTIO_DEFINE(posix_aio_rtio, CONFIG_POSIX_AIO_MAX, CONFIG_POSIX_AIO_MAX);
+
+static struct posix_aio_req posix_aio_reqs[CONFIG_POSIX_AIO_MAX];
+static struct posix_aio_list posix_aio_lists[CONFIG_POSIX_AIO_MAX];
+
+/* Protects the tables above and serializes submissions to the RTIO context */
+static K_MUTEX_DEFINE(aio_lock);
+/* Signalled whenever a request completes */
+static K_CONDVAR_DEFINE(aio_done);
+
+static struct posix_aio_req *aio_find(const struct aiocb *aiocbp)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(posix_aio_reqs); i++) {
+		if (posix_aio_reqs[i].aiocbp == aiocbp) {
+			return &posix_aio_reqs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool aio_sigevent_valid(const struct sigevent *sig)
+{
+	switch (sig->sigev_notify) {
+	case SIGEV_NONE:
+		return true;
+	case SIGEV_THREAD:
+		if (sig->sigev_notify_function == NULL) {
+			errno = EINVAL;
+			return false;
+		}
+		return true;
+	case SIGEV_SIGNAL:
+		/* Signal delivery is not supported, like with message queues */
+		errno = ENOSYS;
+		return false;
+	default:
+		errno = EINVAL;
+		return false;
+	}
+}
+
+static void aio_notify(const struct sigevent *sig)
+{
+	if (sig->sigev_notify == SIGEV_THREAD) {
+		/* Called from the work queue, thread attributes are ignored */
+		sig->sigev_notify_function(sig->sigev_value);
+	}
+}
+
+static ssize_t aio_rw(struct posix_aio_req *req, struct rtio_sqe *sqe)
+{
+	const bool is_write = sqe->op == RTIO_OP_TX;
+	size_t offset = req->offset;
+	ssize_t rc;
+
+	if (is_write) {
+		rc = zvfs_write(req->fildes, sqe->tx.buf, sqe->tx.buf_len, &offset);
+	} else {
+		rc = zvfs_read(req->fildes, sqe->rx.buf, sqe->rx.buf_len, &offset);
+	}
+	if (rc >= 0 || errno != ENOTSUP) {
+		return rc;
+	}
+
+	/* Non-seekable files are accessed at their current position */
+	if (is_write) {
+		return zvfs_write(req->fildes, sqe->tx.buf, sqe->tx.buf_len, NULL);
+	}
+
+	return zvfs_read(req->fildes, sqe->rx.buf, sqe->rx.buf_len, NULL);
+}
+
+static void posix_aio_work(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_sqe *sqe = &iodev_sqe->sqe;
+	struct posix_aio_req *req = sqe->userdata;
+	struct posix_aio_list *list;
+	struct sigevent list_sig = {
+		.sigev_notify = SIGEV_NONE,
+	};
+	struct sigevent sig;
+	ssize_t rc;
+	int err = 0;
+
+	if (sqe->op == RTIO_OP_NOP) {
+		rc = zvfs_fsync(req->fildes);
+	} else {
+		rc = aio_rw(req, sqe);
+	}
+	if (rc < 0) {
+		err = errno;
+		rtio_iodev_sqe_err(iodev_sqe, -err);
+	} else {
+		rtio_iodev_sqe_ok(iodev_sqe, 0);
+	}
+
+	k_mutex_lock(&aio_lock, K_FOREVER);
+
+	sig = req->sig;
+	list = req->list;
+	req->list = NULL;
+	req->work = NULL;
+	req->result = rc;
+	req->error = err;
+
+	if (list != NULL && --list->pending == 0 && !list->wait) {
+		/* Nobody waits for this list, release it */
+		list_sig = list->sig;
+		list->used = false;
+	}
+
+	k_condvar_broadcast(&aio_done);
+	k_mutex_unlock(&aio_lock);
+
+	/* Callbacks may query or reap requests, so they run unlocked */
+	aio_notify(&sig);
+	aio_notify(&list_sig);
+}
+
+static void posix_aio_submit(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct posix_aio_req *req = iodev_sqe->sqe.userdata;
+
+	rtio_work_req_submit(req->work, iodev_sqe, posix_aio_work);
+}
+
+/* Called with aio_lock held */
+static int aio_enqueue(struct aiocb *aiocbp, uint8_t op, struct posix_aio_list *list)
+{
+	struct posix_aio_req *req;
+	struct rtio_sqe *sqe;
+
+	if (aiocbp == NULL || aiocbp->aio_fildes < 0) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (aiocbp->aio_reqprio < 0 || aiocbp->aio_reqprio > AIO_PRIO_DELTA_MAX ||
+	    (op != RTIO_OP_NOP &&
+	     (aiocbp->aio_offset < 0 || aiocbp->aio_nbytes > UINT32_MAX))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (!aio_sigevent_valid(&aiocbp->aio_sigevent)) {
+		return -1;
+	}
+
+	if (aio_find(aiocbp) != NULL) {
+		/* The control block is still in use by another request */
+		errno = EINVAL;
+		return -1;
+	}
+
+	req = aio_find(NULL);
+	if (req == NULL) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	req->work = rtio_work_req_alloc();
+	if (req->work == NULL) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	/* There is an SQE for every request slot */
+	sqe = rtio_sqe_acquire(&posix_aio_rtio);
+	__ASSERT_NO_MSG(sqe != NULL);
+
+	switch (op) {
+	case RTIO_OP_RX:
+		rtio_sqe_prep_read(sqe, &posix_aio_iodev, RTIO_PRIO_NORM,
+				   (uint8_t *)aiocbp->aio_buf, aiocbp->aio_nbytes, req);
+		break;
+	case RTIO_OP_TX:
+		rtio_sqe_prep_write(sqe, &posix_aio_iodev, RTIO_PRIO_NORM,
+				    (const uint8_t *)aiocbp->aio_buf, aiocbp->aio_nbytes, req);
+		break;
+	default:
+		rtio_sqe_prep_nop(sqe, &posix_aio_iodev, req);
+		break;
+	}
+	/* Completions are tracked in the request table, not in the CQ */
+	sqe->flags |= RTIO_SQE_NO_RESPONSE;
+
+	req->aiocbp = aiocbp;
+	req->list = list;
+	req->sig = aiocbp->aio_sigevent;
+	req->fildes = aiocbp->aio_fildes;
+	req->offset = aiocbp->aio_offset;
+	req->result = -1;
+	req->error = EINPROGRESS;
+
+	if (list != NULL) {
+		list->pending++;
+	}
+
+	return 0;
+}
+
+/* Called with aio_lock held, keeps the status of a request which failed to queue */
+static void aio_fail(struct aiocb *aiocbp, int err)
+{
+	struct posix_aio_req *req;
+
+	if (aio_find(aiocbp) != NULL) {
+		/* The status is the one of the request using the control block */
+		return;
+	}
+
+	/* lio_listio() made sure there is a slot for every request */
+	req = aio_find(NULL);
+	__ASSERT_NO_MSG(req != NULL);
+
+	*req = (struct posix_aio_req) {
+		.aiocbp = aiocbp,
+		.fildes = aiocbp->aio_fildes,
+		.offset = aiocbp->aio_offset,
+		.result = -1,
+		.error = err,
+	};
+}
+
+static int aio_submit(struct aiocb *aiocbp, uint8_t op)
+{
+	int ret;
+
+	k_mutex_lock(&aio_lock, K_FOREVER);
+	ret = aio_enqueue(aiocbp, op, NULL);
+	if (ret == 0) {
+		(void)rtio_submit(&posix_aio_rtio, 0);
+	}
+	k_mutex_unlock(&aio_lock);
+
+	return ret;
+}
 
 int aio_cancel(int fildes, struct aiocb *aiocbp)
 {
-	ARG_UNUSED(fildes);
-	ARG_UNUSED(aiocbp);
+	int ret = AIO_ALLDONE;
+
+	if (fildes < 0 || (aiocbp != NULL && aiocbp->aio_fildes != fildes)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/*
+	 * Requests are handed to the work queue as soon as they are submitted,
+	 * so only the ones that already completed can be reported.
+	 */
+	k_mutex_lock(&aio_lock, K_FOREVER);
+	for (size_t i = 0; i < ARRAY_SIZE(posix_aio_reqs); i++) {
+		struct posix_aio_req *req = &posix_aio_reqs[i];
 
-	errno = ENOSYS;
-	return -1;
+		if (req->aiocbp == NULL || req->fildes != fildes ||
+		    (aiocbp != NULL && req->aiocbp != aiocbp)) {
+			continue;
+		}
+
+		if (req->error == EINPROGRESS) {
+			ret = AIO_NOTCANCELED;
+			break;
+		}
+	}
+	k_mutex_unlock(&aio_lock);
+
+	return ret;
 }
 
 int aio_error(const struct aiocb *aiocbp)
 {
-	ARG_UNUSED(aiocbp);
+	struct posix_aio_req *req;
+	int ret;
+
+	k_mutex_lock(&aio_lock, K_FOREVER);
+	req = aiocbp != NULL ? aio_find(aiocbp) : NULL;
+	if (req == NULL) {
+		errno = EINVAL;
+		ret = -1;
+	} else {
+		ret = req->error;
+	}
+	k_mutex_unlock(&aio_lock);
 
-	errno = ENOSYS;
-	return -1;
+	return ret;
 }
 
 int aio_fsync(int fildes, struct aiocb *aiocbp)
 {
-	ARG_UNUSED(fildes);
-	ARG_UNUSED(aiocbp);
+	if (aiocbp == NULL || aiocbp->aio_fildes != fildes) {
+		errno = EBADF;
+		return -1;
+	}
 
-	errno = ENOSYS;
-	return -1;
+	return aio_submit(aiocbp, RTIO_OP_NOP);
 }
 
 int aio_read(struct aiocb *aiocbp)
 {
-	ARG_UNUSED(aiocbp);
-
-	errno = ENOSYS;
-	return -1;
+	return aio_submit(aiocbp, RTIO_OP_RX);
 }
 
 ssize_t aio_return(struct aiocb *aiocbp)
 {
-	ARG_UNUSED(aiocbp);
+	struct posix_aio_req *req;
+	ssize_t ret;
+
+	k_mutex_lock(&aio_lock, K_FOREVER);
+	req = aiocbp != NULL ? aio_find(aiocbp) : NULL;
+	if (req == NULL || req->error == EINPROGRESS) {
+		errno = EINVAL;
+		ret = -1;
+	} else {
+		ret = req->result;
+		if (ret < 0) {
+			errno = req->error;
+		}
+		req->aiocbp = NULL;
+	}
+	k_mutex_unlock(&aio_lock);
 
-	errno = ENOSYS;
-	return -1;
+	return ret;
+}
+
+/* Called with aio_lock held */
+static bool aio_any_done(const struct aiocb *const list[], int nent)
+{
+	for (int i = 0; i < nent; i++) {
+		struct posix_aio_req *req;
+
+		if (list[i] == NULL) {
+			continue;
+		}
+
+		req = aio_find(list[i]);
+		if (req == NULL || req->error != EINPROGRESS) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 int aio_suspend(const struct aiocb *const list[], int nent, const struct timespec *timeout)
 {
-	ARG_UNUSED(list);
-	ARG_UNUSED(nent);
-	ARG_UNUSED(timeout);
+	k_timepoint_t end = sys_timepoint_calc(K_FOREVER);
+	int ret = 0;
+
+	if (list == NULL || nent <= 0 || nent > AIO_LISTIO_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
 
-	errno = ENOSYS;
-	return -1;
+	if (timeout != NULL) {
+		if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+		    timeout->tv_nsec >= NSEC_PER_SEC) {
+			errno = EINVAL;
+			return -1;
+		}
+		end = sys_timepoint_calc(K_MSEC((int64_t)timeout->tv_sec * MSEC_PER_SEC +
+						timeout->tv_nsec / NSEC_PER_MSEC));
+	}
+
+	k_mutex_lock(&aio_lock, K_FOREVER);
+	while (!aio_any_done(list, nent)) {
+		if (k_condvar_wait(&aio_done, &aio_lock, sys_timepoint_timeout(end)) != 0 &&
+		    !aio_any_done(list, nent)) {
+			errno = EAGAIN;
+			ret = -1;
+			break;
+		}
+	}
+	k_mutex_unlock(&aio_lock);
+
+	return ret;
 }
 
 int aio_write(struct aiocb *aiocbp)
 {
-	ARG_UNUSED(aiocbp);
-
-	errno = ENOSYS;
-	return -1;
+	return aio_submit(aiocbp, RTIO_OP_TX);
 }
 
 int lio_listio(int mode, struct aiocb *const ZRESTRICT list[], int nent,
 	       struct sigevent *ZRESTRICT sig)
 {
-	ARG_UNUSED(mode);
-	ARG_UNUSED(list);
-	ARG_UNUSED(nent);
-	ARG_UNUSED(sig);
+	struct posix_aio_list wait_list = {
+		.used = true,
+		.wait = true,
+	};
+	struct posix_aio_list *lio = NULL;
+	bool notify = false;
+	int slots = 0;
+	int ret = 0;
+	int err = 0;
+
+	if ((mode != LIO_WAIT && mode != LIO_NOWAIT) || list == NULL || nent <= 0 ||
+	    nent > AIO_LISTIO_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (mode == LIO_NOWAIT && sig != NULL && !aio_sigevent_valid(sig)) {
+		return -1;
+	}
+
+	k_mutex_lock(&aio_lock, K_FOREVER);
+
+	if (mode == LIO_WAIT) {
+		lio = &wait_list;
+	} else if (sig != NULL && sig->sigev_notify != SIGEV_NONE) {
+		for (size_t i = 0; i < ARRAY_SIZE(posix_aio_lists); i++) {
+			if (!posix_aio_lists[i].used) {
+				lio = &posix_aio_lists[i];
+				*lio = (struct posix_aio_list) {
+					.used = true,
+					.sig = *sig,
+				};
+				break;
+			}
+		}
+		if (lio == NULL) {
+			k_mutex_unlock(&aio_lock);
+			errno = EAGAIN;
+			return -1;
+		}
+	}
+
+	/* Every request needs a slot, to be queued or to report why it was not */
+	for (int i = 0; i < nent; i++) {
+		if (list[i] != NULL && list[i]->aio_lio_opcode != LIO_NOP) {
+			slots++;
+		}
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(posix_aio_reqs); i++) {
+		if (posix_aio_reqs[i].aiocbp == NULL) {
+			slots--;
+		}
+	}
+	if (slots > 0) {
+		if (lio != NULL && lio != &wait_list) {
+			lio->used = false;
+		}
+		k_mutex_unlock(&aio_lock);
+		errno = EAGAIN;
+		return -1;
+	}
+
+	/* Hold the list open until every request is queued */
+	if (lio != NULL) {
+		lio->pending++;
+	}
+
+	for (int i = 0; i < nent; i++) {
+		struct aiocb *aiocbp = list[i];
+		uint8_t op;
+
+		if (aiocbp == NULL || aiocbp->aio_lio_opcode == LIO_NOP) {
+			continue;
+		}
+
+		if (aiocbp->aio_lio_opcode == LIO_READ) {
+			op = RTIO_OP_RX;
+		} else if (aiocbp->aio_lio_opcode == LIO_WRITE) {
+			op = RTIO_OP_TX;
+		} else {
+			aio_fail(aiocbp, EINVAL);
+			err = EIO;
+			continue;
+		}
+
+		if (aio_enqueue(aiocbp, op, lio) != 0) {
+			/* The status of each request is reported through aio_error() */
+			aio_fail(aiocbp, errno);
+			err = errno == EAGAIN ? EAGAIN : EIO;
+		}
+	}
+
+	(void)rtio_submit(&posix_aio_rtio, 0);
+
+	if (lio != NULL) {
+		lio->pending--;
+		if (mode == LIO_WAIT) {
+			while (lio->pending > 0) {
+				k_condvar_wait(&aio_done, &aio_lock, K_FOREVER);
+			}
+		} else if (lio->pending == 0) {
+			/* Every request failed to queue, or already completed */
+			notify = true;
+			lio->used = false;
+		}
+	}
+
+	k_mutex_unlock(&aio_lock);
+
+	if (notify) {
+		aio_notify(sig);
+	}
+
+	if (err != 0) {
+		errno = err;
+		ret = -1;
+	}
 
-	errno = ENOSYS;
-	return -1;
+	return ret;
 }
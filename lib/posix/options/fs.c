@@ -126,7 +126,8 @@ int zvfs_open(const char *name, int flags, int mode)
 		goto out_err;
 	}
 
-	zvfs_finalize_fd(fd, ptr, &fs_fd_op_vtable);
+	/* Regular files get positional I/O from the fd table */
+	zvfs_finalize_typed_fd(fd, ptr, &fs_fd_op_vtable, ZVFS_MODE_IFREG);
 
 	goto out;
 
@@ -13,13 +13,38 @@
 
 #define SIGEV_MASK (SIGEV_NONE | SIGEV_SIGNAL | SIGEV_THREAD)
 
+#define MQ_PRIO_WORDS   DIV_ROUND_UP(MQ_PRIO_MAX, 32)
+#define MQ_HASH_BUCKETS 8
+
+struct mq_msg {
+	sys_snode_t node;
+	size_t len;
+	unsigned int prio;
+	char data[];
+};
+
 typedef struct mqueue_object {
 	sys_snode_t snode;
 	char *mem_buffer;
 	char *mem_obj;
-	struct k_msgq queue;
+	/* Protects the message lists and the notification */
+	struct k_spinlock lock;
+	/* Counts free message slots, senders block on it */
+	struct k_sem free_sem;
+	/* Counts queued messages, receivers block on it */
+	struct k_sem used_sem;
+	sys_slist_t free_list;
+	/* One FIFO per priority, with a bit set in prio_mask for non-empty ones */
+	sys_slist_t prio_list[MQ_PRIO_MAX];
+	uint32_t prio_mask[MQ_PRIO_WORDS];
+	size_t msg_size;
+	long max_msgs;
+	long cur_msgs;
+	/* Receivers blocked on the queue, which take precedence over notification */
+	atomic_t receivers;
 	atomic_t ref_count;
 	char *name;
+	uint32_t hash;
 	struct sigevent not;
 } mqueue_object;
 
@@ -29,20 +54,32 @@ typedef struct mqueue_desc {
 	uint32_t  flags;
 } mqueue_desc;
 
+struct mq_notification {
+	void (*function)(union sigval);
+	union sigval value;
+};
+
 K_SEM_DEFINE(mq_sem, 1, 1);
 
-/* Initialize the list */
-sys_slist_t mq_list = SYS_SLIST_STATIC_INIT(&mq_list);
+/* Message queues by name, protected by mq_sem */
+static sys_slist_t mq_hash[MQ_HASH_BUCKETS];
+
+/* Notifications waiting for a thread of the pool */
+static K_MSGQ_DEFINE(mq_notify_msgq, sizeof(struct mq_notification),
+		     CONFIG_POSIX_MQ_NOTIFY_QUEUE_SIZE, 4);
+static int mq_notify_pool_threads;
 
 int64_t timespec_to_timeoutms(const struct timespec *abstime);
 static mqueue_object *find_in_list(const char *name);
 static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
-			  k_timeout_t timeout);
+			    unsigned int msg_prio, k_timeout_t timeout);
 static int32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
-			   k_timeout_t timeout);
+			       unsigned int *msg_prio, k_timeout_t timeout);
 static void remove_notification(mqueue_object *msg_queue);
 static void remove_mq(mqueue_object *msg_queue);
 static void *mq_notify_thread(void *arg);
+static int mq_notify_pool_start(void);
+static uint32_t mq_name_hash(const char *name);
 
 /**
  * @brief Open a message queue.
@@ -86,19 +123,20 @@ mqd_t mq_open(const char *name, int oflags, ...)
 		return (mqd_t)mqd;
 	}
 
-	/* Check if queue already exists */
+	/* Lookup and creation must not race with another mq_open() */
 	k_sem_take(&mq_sem, K_FOREVER);
 	msg_queue = find_in_list(name);
-	k_sem_give(&mq_sem);
 
 	if ((msg_queue != NULL) && (oflags & O_CREAT) != 0 &&
 	    (oflags & O_EXCL) != 0) {
 		/* Message queue has already been opened and O_EXCL is set */
+		k_sem_give(&mq_sem);
 		errno = EEXIST;
 		return (mqd_t)mqd;
 	}
 
 	if ((msg_queue == NULL) && (oflags & O_CREAT) == 0) {
+		k_sem_give(&mq_sem);
 		errno = ENOENT;
 		return (mqd_t)mqd;
 	}
@@ -115,6 +153,7 @@ mqd_t mq_open(const char *name, int oflags, ...)
 
 	/* Allocate mqueue object for new message queue */
 	if (msg_queue == NULL) {
+		size_t slot_size = ROUND_UP(sizeof(struct mq_msg) + msg_size, sizeof(void *));
 
 		/* Check for message quantity and size in message queue */
 		if (attrs->mq_msgsize > CONFIG_MSG_SIZE_MAX &&
@@ -142,28 +181,38 @@ mqd_t mq_open(const char *name, int oflags, ...)
 		}
 
 		strcpy(msg_queue->name, name);
+		msg_queue->hash = mq_name_hash(name);
 
-		mq_buf_ptr = k_malloc(msg_size * max_msgs * sizeof(uint8_t));
+		mq_buf_ptr = k_malloc(slot_size * max_msgs);
 		if (mq_buf_ptr != NULL) {
-			(void)memset(mq_buf_ptr, 0,
-				     msg_size * max_msgs * sizeof(uint8_t));
+			(void)memset(mq_buf_ptr, 0, slot_size * max_msgs);
 			msg_queue->mem_buffer = mq_buf_ptr;
 		} else {
 			goto free_mq_buffer;
 		}
 
 		(void)atomic_set(&msg_queue->ref_count, 1);
-		/* initialize zephyr message queue */
-		k_msgq_init(&msg_queue->queue, msg_queue->mem_buffer, msg_size,
-			    max_msgs);
-		k_sem_take(&mq_sem, K_FOREVER);
-		sys_slist_append(&mq_list, (sys_snode_t *)&(msg_queue->snode));
-		k_sem_give(&mq_sem);
+		msg_queue->msg_size = msg_size;
+		msg_queue->max_msgs = max_msgs;
+		k_sem_init(&msg_queue->free_sem, max_msgs, max_msgs);
+		k_sem_init(&msg_queue->used_sem, 0, max_msgs);
+		sys_slist_init(&msg_queue->free_list);
+		for (long i = 0; i < max_msgs; i++) {
+			sys_slist_append(&msg_queue->free_list,
+					 (sys_snode_t *)&msg_queue->mem_buffer[i * slot_size]);
+		}
+		for (int i = 0; i < MQ_PRIO_MAX; i++) {
+			sys_slist_init(&msg_queue->prio_list[i]);
+		}
+		sys_slist_append(&mq_hash[msg_queue->hash % MQ_HASH_BUCKETS],
+				 &msg_queue->snode);
 
 	} else {
 		atomic_inc(&msg_queue->ref_count);
 	}
 
+	k_sem_give(&mq_sem);
+
 	msg_queue_desc->mqueue = msg_queue;
 	msg_queue_desc->flags = (oflags & O_NONBLOCK) != 0 ? O_NONBLOCK : 0;
 	return (mqd_t)msg_queue_desc;
@@ -175,6 +224,7 @@ free_mq_name:
 free_mq_object:
 	k_free(mq_desc_ptr);
 free_mq_desc:
+	k_sem_give(&mq_sem);
 	errno = ENOSPC;
 	return (mqd_t)mqd;
 }
@@ -222,6 +272,9 @@ int mq_unlink(const char *name)
 		return -1;
 	}
 
+	/* The name can no longer be opened, the queue lives on until closed */
+	sys_slist_find_and_remove(&mq_hash[msg_queue->hash % MQ_HASH_BUCKETS],
+				  &msg_queue->snode);
 	k_free(msg_queue->name);
 	msg_queue->name = NULL;
 	k_sem_give(&mq_sem);
@@ -232,7 +285,8 @@ int mq_unlink(const char *name)
 /**
  * @brief Send a message to a message queue.
  *
- * All messages in message queue are of equal priority.
+ * Messages are queued in order of decreasing priority, and in FIFO order
+ * within a priority.
  *
  * See IEEE 1003.1
  */
@@ -241,13 +295,14 @@ int mq_send(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
 {
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
 
-	return send_message(mqd, msg_ptr, msg_len, K_FOREVER);
+	return send_message(mqd, msg_ptr, msg_len, msg_prio, K_FOREVER);
 }
 
 /**
  * @brief Send message to a message queue within abstime time.
  *
- * All messages in message queue are of equal priority.
+ * Messages are queued in order of decreasing priority, and in FIFO order
+ * within a priority.
  *
  * See IEEE 1003.1
  */
@@ -257,13 +312,13 @@ int mq_timedsend(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
 	int32_t timeout = (int32_t) timespec_to_timeoutms(abstime);
 
-	return send_message(mqd, msg_ptr, msg_len, K_MSEC(timeout));
+	return send_message(mqd, msg_ptr, msg_len, msg_prio, K_MSEC(timeout));
 }
 
 /**
  * @brief Receive a message from a message queue.
  *
- * All messages in message queue are of equal priority.
+ * The oldest of the highest priority messages is received.
  *
  * See IEEE 1003.1
  */
@@ -272,13 +327,13 @@ int mq_receive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 {
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
 
-	return receive_message(mqd, msg_ptr, msg_len, K_FOREVER);
+	return receive_message(mqd, msg_ptr, msg_len, msg_prio, K_FOREVER);
 }
 
 /**
  * @brief Receive message from a message queue within abstime time.
  *
- * All messages in message queue are of equal priority.
+ * The oldest of the highest priority messages is received.
  *
  * See IEEE 1003.1
  */
@@ -288,7 +343,7 @@ int mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
 	int32_t timeout = (int32_t) timespec_to_timeoutms(abstime);
 
-	return receive_message(mqd, msg_ptr, msg_len, K_MSEC(timeout));
+	return receive_message(mqd, msg_ptr, msg_len, msg_prio, K_MSEC(timeout));
 }
 
 /**
@@ -299,19 +354,23 @@ int mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 int mq_getattr(mqd_t mqdes, struct mq_attr *mqstat)
 {
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
-	struct k_msgq_attrs attrs;
+	mqueue_object *msg_queue;
+	k_spinlock_key_t key;
 
 	if (mqd == NULL) {
 		errno = EBADF;
 		return -1;
 	}
 
+	msg_queue = mqd->mqueue;
+
 	k_sem_take(&mq_sem, K_FOREVER);
-	k_msgq_get_attrs(&mqd->mqueue->queue, &attrs);
 	mqstat->mq_flags = mqd->flags;
-	mqstat->mq_maxmsg = attrs.max_msgs;
-	mqstat->mq_msgsize = attrs.msg_size;
-	mqstat->mq_curmsgs = attrs.used_msgs;
+	mqstat->mq_maxmsg = msg_queue->max_msgs;
+	mqstat->mq_msgsize = msg_queue->msg_size;
+	key = k_spin_lock(&msg_queue->lock);
+	mqstat->mq_curmsgs = msg_queue->cur_msgs;
+	k_spin_unlock(&msg_queue->lock, key);
 	k_sem_give(&mq_sem);
 	return 0;
 }
@@ -362,6 +421,8 @@ int mq_notify(mqd_t mqdes, const struct sigevent *notification)
 	}
 
 	mqueue_object *msg_queue = mqd->mqueue;
+	k_spinlock_key_t key;
+	int ret = 0;
 
 	if (notification == NULL) {
 		if ((msg_queue->not.sigev_notify & SIGEV_MASK) == 0) {
@@ -381,138 +442,299 @@ int mq_notify(mqd_t mqdes, const struct sigevent *notification)
 		return -1;
 	}
 	if (notification->sigev_notify_attributes != NULL) {
-		int ret = pthread_attr_setdetachstate(notification->sigev_notify_attributes,
-						      PTHREAD_CREATE_DETACHED);
-		if (ret != 0) {
-			errno = ret;
-			return -1;
-		}
+		ret = pthread_attr_setdetachstate(notification->sigev_notify_attributes,
+						  PTHREAD_CREATE_DETACHED);
+	} else if (notification->sigev_notify == SIGEV_THREAD) {
+		ret = mq_notify_pool_start();
+	}
+	if (ret != 0) {
+		errno = ret;
+		return -1;
 	}
 
-	k_sem_take(&mq_sem, K_FOREVER);
-	memcpy(&msg_queue->not, notification, sizeof(struct sigevent));
-	k_sem_give(&mq_sem);
+	key = k_spin_lock(&msg_queue->lock);
+	if ((msg_queue->not.sigev_notify & SIGEV_MASK) != 0) {
+		ret = EBUSY;
+	} else {
+		memcpy(&msg_queue->not, notification, sizeof(struct sigevent));
+	}
+	k_spin_unlock(&msg_queue->lock, key);
+
+	if (ret != 0) {
+		errno = ret;
+		return -1;
+	}
 
 	return 0;
 }
 
 static void *mq_notify_thread(void *arg)
 {
-	mqueue_object *mqueue = (mqueue_object *)arg;
-	struct sigevent *sevp = &mqueue->not;
+	struct mq_notification notification = *(struct mq_notification *)arg;
+
+	k_free(arg);
 
 	pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
 
-	if (sevp->sigev_notify_attributes == NULL) {
-		pthread_detach(pthread_self());
-	}
+	notification.function(notification.value);
+
+	return NULL;
+}
+
+static void *mq_notify_worker(void *arg)
+{
+	struct mq_notification notification;
 
-	sevp->sigev_notify_function(sevp->sigev_value);
+	ARG_UNUSED(arg);
 
-	remove_notification(mqueue);
+	while (true) {
+		(void)k_msgq_get(&mq_notify_msgq, &notification, K_FOREVER);
+		notification.function(notification.value);
+	}
 
 	return NULL;
 }
 
+/*
+ * Threads of the pool are created with the first SIGEV_THREAD notification
+ * registered without attributes, and are kept around afterwards.
+ */
+static int mq_notify_pool_start(void)
+{
+	pthread_t th;
+	int ret = 0;
+
+	k_sem_take(&mq_sem, K_FOREVER);
+	for (int i = mq_notify_pool_threads; i < CONFIG_POSIX_MQ_NOTIFY_THREADS; i++) {
+		ret = pthread_create(&th, NULL, mq_notify_worker, NULL);
+		if (ret != 0) {
+			break;
+		}
+		(void)pthread_detach(th);
+		mq_notify_pool_threads++;
+	}
+	k_sem_give(&mq_sem);
+
+	/* A partial pool still works */
+	return mq_notify_pool_threads > 0 ? 0 : ret;
+}
+
+static void mq_notify_deliver(const struct sigevent *sevp)
+{
+	struct mq_notification notification = {
+		.function = sevp->sigev_notify_function,
+		.value = sevp->sigev_value,
+	};
+	struct mq_notification *arg;
+	pthread_t th;
+
+	if (notification.function == NULL) {
+		return;
+	}
+
+	if (sevp->sigev_notify == SIGEV_NONE) {
+		/* Called right away, from the sending thread */
+		notification.function(notification.value);
+		return;
+	}
+
+	if (sevp->sigev_notify_attributes == NULL &&
+	    k_msgq_put(&mq_notify_msgq, &notification, K_NO_WAIT) == 0) {
+		return;
+	}
+
+	/* Specific thread attributes were requested, or the pool is backlogged */
+	arg = k_malloc(sizeof(*arg));
+	if (arg == NULL) {
+		return;
+	}
+	*arg = notification;
+
+	if (pthread_create(&th, sevp->sigev_notify_attributes, mq_notify_thread, arg) != 0) {
+		k_free(arg);
+		return;
+	}
+
+	if (sevp->sigev_notify_attributes == NULL) {
+		(void)pthread_detach(th);
+	}
+}
+
 /* Internal functions */
+static uint32_t mq_name_hash(const char *name)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash = (hash ^ (uint8_t)*name++) * 16777619U;
+	}
+
+	return hash;
+}
+
 static mqueue_object *find_in_list(const char *name)
 {
-	sys_snode_t *mq;
+	uint32_t hash = mq_name_hash(name);
 	mqueue_object *msg_queue;
 
-	mq = mq_list.head;
-
-	while (mq != NULL) {
-		msg_queue = (mqueue_object *)mq;
-		if (strcmp(msg_queue->name, name) == 0) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&mq_hash[hash % MQ_HASH_BUCKETS], msg_queue, snode) {
+		if (msg_queue->hash == hash && strcmp(msg_queue->name, name) == 0) {
 			return msg_queue;
 		}
+	}
+
+	return NULL;
+}
+
+static struct mq_msg *mq_take_highest(mqueue_object *msg_queue)
+{
+	struct mq_msg *msg;
+	unsigned int prio;
+
+	for (int w = MQ_PRIO_WORDS - 1; w >= 0; w--) {
+		if (msg_queue->prio_mask[w] == 0U) {
+			continue;
+		}
+
+		prio = w * 32U + find_msb_set(msg_queue->prio_mask[w]) - 1U;
+		msg = CONTAINER_OF(sys_slist_get_not_empty(&msg_queue->prio_list[prio]),
+				   struct mq_msg, node);
+		if (sys_slist_is_empty(&msg_queue->prio_list[prio])) {
+			msg_queue->prio_mask[w] &= ~BIT(prio % 32U);
+		}
 
-		mq = mq->next;
+		return msg;
 	}
 
 	return NULL;
 }
 
 static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
-			  k_timeout_t timeout)
+			    unsigned int msg_prio, k_timeout_t timeout)
 {
-	int32_t ret = -1;
+	mqueue_object *msg_queue;
+	struct sigevent not = {0};
+	struct mq_msg *msg;
+	k_spinlock_key_t key;
+	bool notify;
 
 	if (mqd == NULL) {
 		errno = EBADF;
-		return ret;
+		return -1;
+	}
+
+	msg_queue = mqd->mqueue;
+
+	if (msg_prio >= MQ_PRIO_MAX) {
+		errno = EINVAL;
+		return -1;
 	}
 
 	if ((mqd->flags & O_NONBLOCK) != 0U) {
 		timeout = K_NO_WAIT;
 	}
 
-	if (msg_len >  mqd->mqueue->queue.msg_size) {
+	if (msg_len > msg_queue->msg_size) {
 		errno = EMSGSIZE;
-		return ret;
+		return -1;
 	}
 
-	uint32_t msgq_num = k_msgq_num_used_get(&mqd->mqueue->queue);
-
-	if (k_msgq_put(&mqd->mqueue->queue, (void *)msg_ptr, timeout) != 0) {
+	if (k_sem_take(&msg_queue->free_sem, timeout) != 0) {
 		errno = K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? EAGAIN : ETIMEDOUT;
-		return ret;
+		return -1;
 	}
 
-	if (k_msgq_num_used_get(&mqd->mqueue->queue) - msgq_num > 0) {
-		struct sigevent *sevp = &mqd->mqueue->not;
+	/* The slot belongs to this thread until queued, copy outside of the lock */
+	key = k_spin_lock(&msg_queue->lock);
+	msg = CONTAINER_OF(sys_slist_get_not_empty(&msg_queue->free_list), struct mq_msg, node);
+	k_spin_unlock(&msg_queue->lock, key);
 
-		if (sevp->sigev_notify == SIGEV_NONE) {
-			sevp->sigev_notify_function(sevp->sigev_value);
-		} else if (sevp->sigev_notify == SIGEV_THREAD) {
-			pthread_t th;
+	memcpy(msg->data, msg_ptr, msg_len);
+	msg->len = msg_len;
+	msg->prio = msg_prio;
 
-			ret = pthread_create(&th,
-					     sevp->sigev_notify_attributes,
-					     mq_notify_thread,
-					     mqd->mqueue);
-		}
+	key = k_spin_lock(&msg_queue->lock);
+	sys_slist_append(&msg_queue->prio_list[msg_prio], &msg->node);
+	msg_queue->prio_mask[msg_prio / 32U] |= BIT(msg_prio % 32U);
+
+	/* Notify when the queue becomes non-empty, unless a receiver is waiting */
+	notify = msg_queue->cur_msgs++ == 0 &&
+		 (msg_queue->not.sigev_notify & SIGEV_MASK) != 0 &&
+		 atomic_get(&msg_queue->receivers) == 0;
+	if (notify) {
+		/* Delivering the notification removes the registration */
+		not = msg_queue->not;
+		memset(&msg_queue->not, 0, sizeof(struct sigevent));
+	}
+	k_spin_unlock(&msg_queue->lock, key);
+
+	k_sem_give(&msg_queue->used_sem);
+
+	if (notify) {
+		mq_notify_deliver(&not);
 	}
 
 	return 0;
 }
 
 static int32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
-			     k_timeout_t timeout)
+			       unsigned int *msg_prio, k_timeout_t timeout)
 {
-	int ret = -1;
+	mqueue_object *msg_queue;
+	struct mq_msg *msg;
+	k_spinlock_key_t key;
+	int32_t ret;
+	int rc;
 
 	if (mqd == NULL) {
 		errno = EBADF;
-		return ret;
+		return -1;
 	}
 
-	if (msg_len < mqd->mqueue->queue.msg_size) {
+	msg_queue = mqd->mqueue;
+
+	if (msg_len < msg_queue->msg_size) {
 		errno = EMSGSIZE;
-		return ret;
+		return -1;
 	}
 
 	if ((mqd->flags & O_NONBLOCK) != 0U) {
 		timeout = K_NO_WAIT;
 	}
 
-	if (k_msgq_get(&mqd->mqueue->queue, (void *)msg_ptr, timeout) != 0) {
+	atomic_inc(&msg_queue->receivers);
+	rc = k_sem_take(&msg_queue->used_sem, timeout);
+	atomic_dec(&msg_queue->receivers);
+
+	if (rc != 0) {
 		errno = K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? EAGAIN : ETIMEDOUT;
-	} else {
-		ret = mqd->mqueue->queue.msg_size;
+		return -1;
+	}
+
+	key = k_spin_lock(&msg_queue->lock);
+	msg = mq_take_highest(msg_queue);
+	msg_queue->cur_msgs--;
+	k_spin_unlock(&msg_queue->lock, key);
+
+	memcpy(msg_ptr, msg->data, msg->len);
+	ret = msg->len;
+	if (msg_prio != NULL) {
+		*msg_prio = msg->prio;
 	}
 
+	key = k_spin_lock(&msg_queue->lock);
+	sys_slist_prepend(&msg_queue->free_list, &msg->node);
+	k_spin_unlock(&msg_queue->lock, key);
+
+	k_sem_give(&msg_queue->free_sem);
+
 	return ret;
 }
 
 static void remove_mq(mqueue_object *msg_queue)
 {
 	if (atomic_cas(&msg_queue->ref_count, 0, 0)) {
-		k_sem_take(&mq_sem, K_FOREVER);
-		sys_slist_find_and_remove(&mq_list, (sys_snode_t *) msg_queue);
-		k_sem_give(&mq_sem);
-
 		/* Free mq buffer and pbject */
 		k_free(msg_queue->mem_buffer);
 		k_free(msg_queue->mem_obj);
@@ -521,7 +743,8 @@ static void remove_mq(mqueue_object *msg_queue)
 
 static void remove_notification(mqueue_object *msg_queue)
 {
-	k_sem_take(&mq_sem, K_FOREVER);
+	k_spinlock_key_t key = k_spin_lock(&msg_queue->lock);
+
 	memset(&msg_queue->not, 0, sizeof(struct sigevent));
-	k_sem_give(&mq_sem);
+	k_spin_unlock(&msg_queue->lock, key);
 }
@@ -14,6 +14,8 @@
 #include <errno.h>
 #include <zephyr/device.h>
 
+#include "disk_access_priv.h"
+
 #define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(disk);
@@ -98,7 +100,7 @@ int disk_access_read(const char *pdrv, uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->read != NULL)) {
-		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		rc = disk_cache_read(disk, data_buf, start_sector, num_sector);
 	}
 
 	return rc;
@@ -112,7 +114,7 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->write != NULL)) {
-		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		rc = disk_cache_write(disk, data_buf, start_sector, num_sector);
 	}
 
 	return rc;
@@ -142,10 +144,17 @@ int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 		case DISK_IOCTL_CTRL_DEINIT:
 			if ((buf != NULL) && (*((bool *)buf))) {
 				/* Force deinit disk */
+				(void)disk_cache_flush(disk);
+				disk_cache_invalidate(disk);
 				disk->refcnt = 0U;
 				disk->ops->ioctl(disk, cmd, buf);
 				rc = 0;
 			} else if (disk->refcnt == 1U) {
+				rc = disk_cache_flush(disk);
+				if (rc != 0) {
+					break;
+				}
+				disk_cache_invalidate(disk);
 				rc = disk->ops->ioctl(disk, cmd, buf);
 				if (rc == 0) {
 					disk->refcnt--;
@@ -157,6 +166,12 @@ int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 				LOG_WRN("Disk is already deinitialized");
 			}
 			break;
+		case DISK_IOCTL_CTRL_SYNC:
+			rc = disk_cache_flush(disk);
+			if (rc == 0) {
+				rc = disk->ops->ioctl(disk, cmd, buf);
+			}
+			break;
 		default:
 			rc = disk->ops->ioctl(disk, cmd, buf);
 		}
@@ -181,6 +196,9 @@ int disk_access_register(struct disk_info *disk)
 
 	/* Initialize reference count to zero */
 	disk->refcnt = 0U;
+#if defined(CONFIG_DISK_ACCESS_CACHE) || defined(CONFIG_DISK_ACCESS_QUEUE)
+	disk->sector_size = 0U;
+#endif
 
 	spinlock_key = k_spin_lock(&lock);
 	/*  append to the disk list */
@@ -204,6 +222,10 @@ int disk_access_unregister(struct disk_info *disk)
 		return -EINVAL;
 	}
 
+	/* write back and forget anything the block layer holds for the disk */
+	(void)disk_cache_flush(disk);
+	disk_cache_invalidate(disk);
+
 	spinlock_key = k_spin_lock(&lock);
 	/* remove disk node from the list */
 	sys_dlist_remove(&disk->node);
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DISK_DISK_ACCESS_PRIV_H_
+#define ZEPHYR_SUBSYS_DISK_DISK_ACCESS_PRIV_H_
+
+#include <zephyr/drivers/disk.h>
+#include <zephyr/sys/util.h>
+
+/* Registered disk of the given name, or NULL (disk_access.c) */
+struct disk_info *disk_access_get_di(const char *name);
+
+/*
+ * Sector cache (disk_cache.c)
+ *
+ * When the cache is disabled, these directly call the disk driver.
+ */
+
+#ifdef CONFIG_DISK_ACCESS_CACHE
+
+int disk_cache_read(struct disk_info *disk, uint8_t *buf,
+		    uint32_t start_sector, uint32_t num_sector);
+int disk_cache_write(struct disk_info *disk, const uint8_t *buf,
+		     uint32_t start_sector, uint32_t num_sector);
+int disk_cache_flush(struct disk_info *disk);
+void disk_cache_invalidate(struct disk_info *disk);
+
+#else
+
+static inline int disk_cache_read(struct disk_info *disk, uint8_t *buf,
+				  uint32_t start_sector, uint32_t num_sector)
+{
+	return disk->ops->read(disk, buf, start_sector, num_sector);
+}
+
+static inline int disk_cache_write(struct disk_info *disk, const uint8_t *buf,
+				   uint32_t start_sector, uint32_t num_sector)
+{
+	return disk->ops->write(disk, buf, start_sector, num_sector);
+}
+
+static inline int disk_cache_flush(struct disk_info *disk)
+{
+	ARG_UNUSED(disk);
+	return 0;
+}
+
+static inline void disk_cache_invalidate(struct disk_info *disk)
+{
+	ARG_UNUSED(disk);
+}
+
+#endif /* CONFIG_DISK_ACCESS_CACHE */
+
+#if defined(CONFIG_DISK_ACCESS_CACHE) || defined(CONFIG_DISK_ACCESS_QUEUE)
+/* Sector size of the disk, or 0 if the driver can't report it */
+static inline uint32_t disk_sector_size(struct disk_info *disk)
+{
+	uint32_t size;
+
+	if (disk->sector_size == 0U && disk->ops->ioctl != NULL &&
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &size) == 0) {
+		disk->sector_size = size;
+	}
+
+	return disk->sector_size;
+}
+#endif
+
+#endif /* ZEPHYR_SUBSYS_DISK_DISK_ACCESS_PRIV_H_ */
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Sector cache shared by all disks registered with the disk access layer.
+ *
+ * Sectors are looked up by (disk, sector) in a small hash table and recycled
+ * in LRU order. Small writes are kept dirty in the cache until the disk is
+ * synced, deinitialized or unregistered, or until the sector is evicted.
+ * Adjacent dirty sectors are merged into a single driver write on flush, and
+ * adjacent missing sectors are merged into a single driver read.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/util.h>
+
+#include "disk_access_priv.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define CACHE_SECTORS     CONFIG_DISK_ACCESS_CACHE_SECTORS
+#define CACHE_SECTOR_SIZE CONFIG_DISK_ACCESS_CACHE_SECTOR_SIZE
+#define CACHE_FILL_MAX    CONFIG_DISK_ACCESS_CACHE_FILL_MAX
+#define CACHE_MERGE_MAX   CONFIG_DISK_ACCESS_CACHE_MERGE_MAX
+#define CACHE_BUCKETS     MAX(CACHE_SECTORS / 4, 1)
+
+struct disk_cache_entry {
+	sys_dnode_t hash_node;
+	sys_dnode_t lru_node;
+	struct disk_info *disk;
+	uint32_t sector;
+	bool dirty;
+};
+
+static struct disk_cache_entry entries[CACHE_SECTORS];
+static uint8_t cache_data[CACHE_SECTORS][CACHE_SECTOR_SIZE] __aligned(4);
+static uint8_t merge_buf[CACHE_MERGE_MAX * CACHE_SECTOR_SIZE] __aligned(4);
+
+static sys_dlist_t buckets[CACHE_BUCKETS];
+/* Least recently used entry at the head, unused entries are kept there too */
+static sys_dlist_t lru_list;
+static bool cache_ready;
+
+/*
+ * Recursive for the owning thread: a disk backed by a file system on another
+ * disk (loopback) reenters the cache from its driver. Nested calls must not
+ * recycle entries or use the merge buffer, as the outer call may be using
+ * them, so they only read and update sectors that are already cached.
+ */
+static K_MUTEX_DEFINE(cache_lock);
+static int cache_depth;
+
+static inline uint8_t *entry_data(struct disk_cache_entry *e)
+{
+	return cache_data[e - entries];
+}
+
+static inline sys_dlist_t *bucket_of(struct disk_info *disk, uint32_t sector)
+{
+	return &buckets[(sector ^ ((uintptr_t)disk >> 4)) % CACHE_BUCKETS];
+}
+
+static void cache_init(void)
+{
+	sys_dlist_init(&lru_list);
+	for (int i = 0; i < CACHE_BUCKETS; i++) {
+		sys_dlist_init(&buckets[i]);
+	}
+	for (int i = 0; i < CACHE_SECTORS; i++) {
+		sys_dnode_init(&entries[i].hash_node);
+		sys_dlist_append(&lru_list, &entries[i].lru_node);
+	}
+	cache_ready = true;
+}
+
+static void cache_lock_take(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	if (!cache_ready) {
+		cache_init();
+	}
+	cache_depth++;
+}
+
+static void cache_lock_give(void)
+{
+	cache_depth--;
+	k_mutex_unlock(&cache_lock);
+}
+
+static inline bool cache_nested(void)
+{
+	return cache_depth > 1;
+}
+
+static struct disk_cache_entry *cache_lookup(struct disk_info *disk, uint32_t sector)
+{
+	struct disk_cache_entry *e;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(bucket_of(disk, sector), e, hash_node) {
+		if (e->disk == disk && e->sector == sector) {
+			return e;
+		}
+	}
+
+	return NULL;
+}
+
+static void cache_touch(struct disk_cache_entry *e)
+{
+	sys_dlist_remove(&e->lru_node);
+	sys_dlist_append(&lru_list, &e->lru_node);
+}
+
+static void cache_drop(struct disk_cache_entry *e)
+{
+	if (sys_dnode_is_linked(&e->hash_node)) {
+		sys_dlist_remove(&e->hash_node);
+	}
+	e->disk = NULL;
+	e->dirty = false;
+	sys_dlist_remove(&e->lru_node);
+	sys_dlist_prepend(&lru_list, &e->lru_node);
+}
+
+static struct disk_cache_entry *cache_lowest_dirty(struct disk_info *disk)
+{
+	struct disk_cache_entry *lowest = NULL;
+
+	for (int i = 0; i < CACHE_SECTORS; i++) {
+		struct disk_cache_entry *e = &entries[i];
+
+		if (e->disk == disk && e->dirty &&
+		    (lowest == NULL || e->sector < lowest->sector)) {
+			lowest = e;
+		}
+	}
+
+	return lowest;
+}
+
+static int cache_flush_locked(struct disk_info *disk)
+{
+	uint32_t ssize = disk->sector_size;
+	struct disk_cache_entry *run[CACHE_MERGE_MAX];
+	struct disk_cache_entry *e;
+	uint32_t count;
+	int rc;
+
+	while ((e = cache_lowest_dirty(disk)) != NULL) {
+		run[0] = e;
+		count = 1;
+		while (count < CACHE_MERGE_MAX && !cache_nested()) {
+			e = cache_lookup(disk, run[0]->sector + count);
+			if (e == NULL || !e->dirty) {
+				break;
+			}
+			run[count++] = e;
+		}
+
+		if (count == 1) {
+			rc = disk->ops->write(disk, entry_data(run[0]), run[0]->sector, 1);
+		} else {
+			for (uint32_t i = 0; i < count; i++) {
+				memcpy(&merge_buf[i * ssize], entry_data(run[i]), ssize);
+			}
+			rc = disk->ops->write(disk, merge_buf, run[0]->sector, count);
+		}
+
+		if (rc != 0) {
+			LOG_ERR("%s: failed to write back sectors %u-%u (%d)", disk->name,
+				run[0]->sector, run[0]->sector + count - 1, rc);
+			return rc;
+		}
+
+		for (uint32_t i = 0; i < count; i++) {
+			run[i]->dirty = false;
+		}
+	}
+
+	return 0;
+}
+
+/* Get an entry to hold a new sector, writing back dirty data if needed. */
+static struct disk_cache_entry *cache_alloc(struct disk_info *disk, uint32_t sector)
+{
+	struct disk_cache_entry *e;
+
+	e = CONTAINER_OF(sys_dlist_peek_head(&lru_list), struct disk_cache_entry, lru_node);
+	if (e->dirty && cache_flush_locked(e->disk) != 0) {
+		return NULL;
+	}
+
+	if (sys_dnode_is_linked(&e->hash_node)) {
+		sys_dlist_remove(&e->hash_node);
+	}
+	e->disk = disk;
+	e->sector = sector;
+	e->dirty = false;
+	sys_dlist_append(bucket_of(disk, sector), &e->hash_node);
+	cache_touch(e);
+
+	return e;
+}
+
+static bool cache_usable(struct disk_info *disk)
+{
+	uint32_t ssize = disk_sector_size(disk);
+
+	return ssize != 0U && ssize <= CACHE_SECTOR_SIZE &&
+	       disk->ops->write != NULL;
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t ssize;
+	uint32_t i = 0;
+	int rc = 0;
+
+	if (!cache_usable(disk)) {
+		return disk->ops->read(disk, buf, start_sector, num_sector);
+	}
+
+	ssize = disk->sector_size;
+	cache_lock_take();
+
+	while (i < num_sector) {
+		struct disk_cache_entry *e = cache_lookup(disk, start_sector + i);
+		uint32_t miss;
+
+		if (e != NULL) {
+			memcpy(&buf[i * ssize], entry_data(e), ssize);
+			cache_touch(e);
+			i++;
+			continue;
+		}
+
+		/* Read the whole run of missing sectors at once */
+		miss = 1;
+		while (i + miss < num_sector && cache_lookup(disk, start_sector + i + miss) == NULL) {
+			miss++;
+		}
+
+		rc = disk->ops->read(disk, &buf[i * ssize], start_sector + i, miss);
+		if (rc != 0) {
+			break;
+		}
+
+		/* Large transfers are streaming I/O, keep them from flushing the cache */
+		if (miss <= CACHE_FILL_MAX && !cache_nested()) {
+			for (uint32_t j = i; j < i + miss; j++) {
+				e = cache_alloc(disk, start_sector + j);
+				if (e == NULL) {
+					break;
+				}
+				memcpy(entry_data(e), &buf[j * ssize], ssize);
+			}
+		}
+
+		i += miss;
+	}
+
+	cache_lock_give();
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_entry *e;
+	uint32_t ssize;
+	int rc = 0;
+
+	if (!cache_usable(disk)) {
+		return disk->ops->write(disk, buf, start_sector, num_sector);
+	}
+
+	ssize = disk->sector_size;
+	cache_lock_take();
+
+	if (num_sector > CACHE_FILL_MAX || cache_nested()) {
+		/* Write through, keeping cached copies of the range coherent */
+		rc = disk->ops->write(disk, buf, start_sector, num_sector);
+		if (rc == 0) {
+			for (uint32_t i = 0; i < num_sector; i++) {
+				e = cache_lookup(disk, start_sector + i);
+				if (e != NULL) {
+					memcpy(entry_data(e), &buf[i * ssize], ssize);
+					e->dirty = false;
+				}
+			}
+		}
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		e = cache_lookup(disk, start_sector + i);
+		if (e == NULL) {
+			e = cache_alloc(disk, start_sector + i);
+		}
+		if (e == NULL) {
+			rc = disk->ops->write(disk, &buf[i * ssize], start_sector + i, 1);
+			if (rc != 0) {
+				break;
+			}
+			continue;
+		}
+
+		memcpy(entry_data(e), &buf[i * ssize], ssize);
+		e->dirty = true;
+		cache_touch(e);
+	}
+
+out:
+	cache_lock_give();
+
+	return rc;
+}
+
+int disk_cache_flush(struct disk_info *disk)
+{
+	int rc;
+
+	if (!cache_usable(disk)) {
+		return 0;
+	}
+
+	cache_lock_take();
+	rc = cache_flush_locked(disk);
+	cache_lock_give();
+
+	return rc;
+}
+
+void disk_cache_invalidate(struct disk_info *disk)
+{
+	cache_lock_take();
+	for (int i = 0; i < CACHE_SECTORS; i++) {
+		if (entries[i].disk == disk) {
+			if (entries[i].dirty) {
+				LOG_WRN("%s: dropping dirty sector %u", disk->name,
+					entries[i].sector);
+			}
+			cache_drop(&entries[i]);
+		}
+	}
+	cache_lock_give();
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Asynchronous disk request queue.
+ *
+ * Requests are served in submission order by a dedicated thread. Requests
+ * waiting in the queue that continue the one being served, on the same disk,
+ * in the same direction and with their buffer right after the previous one,
+ * are merged into a single multi-sector transfer.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/disk_access.h>
+
+#include "disk_access_priv.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define QUEUE_MERGE_MAX CONFIG_DISK_ACCESS_QUEUE_MERGE_MAX
+
+static K_FIFO_DEFINE(disk_queue);
+
+static bool disk_req_continues(const struct disk_access_req *prev,
+			       const struct disk_access_req *next,
+			       uint32_t ssize)
+{
+	return next->write == prev->write &&
+	       next->start_sector == prev->start_sector + prev->num_sector &&
+	       next->buf == prev->buf + prev->num_sector * ssize &&
+	       strcmp(next->pdrv, prev->pdrv) == 0;
+}
+
+static void disk_queue_serve(struct disk_access_req *first)
+{
+	struct disk_access_req *batch[QUEUE_MERGE_MAX];
+	struct disk_access_req *next;
+	struct disk_info *disk;
+	uint32_t num_sector = first->num_sector;
+	uint32_t ssize = 0U;
+	int count = 1;
+	int rc;
+
+	batch[0] = first;
+
+	disk = disk_access_get_di(first->pdrv);
+	if (disk != NULL && disk->ops != NULL) {
+		ssize = disk_sector_size(disk);
+	}
+
+	/* Only this thread takes requests out, so a peeked request stays at the head */
+	while (ssize != 0U && count < QUEUE_MERGE_MAX) {
+		next = k_fifo_peek_head(&disk_queue);
+		if (next == NULL || !disk_req_continues(batch[count - 1], next, ssize)) {
+			break;
+		}
+		batch[count++] = k_fifo_get(&disk_queue, K_NO_WAIT);
+		num_sector += next->num_sector;
+	}
+
+	if (first->write) {
+		rc = disk_access_write(first->pdrv, first->buf, first->start_sector, num_sector);
+	} else {
+		rc = disk_access_read(first->pdrv, first->buf, first->start_sector, num_sector);
+	}
+
+	if (count > 1) {
+		LOG_DBG("%s: merged %d requests into %u sectors at %u", first->pdrv, count,
+			num_sector, first->start_sector);
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (batch[i]->cb != NULL) {
+			batch[i]->cb(batch[i], rc);
+		}
+	}
+}
+
+static void disk_queue_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		disk_queue_serve(k_fifo_get(&disk_queue, K_FOREVER));
+	}
+}
+
+K_THREAD_DEFINE(disk_queue_tid, CONFIG_DISK_ACCESS_QUEUE_STACK_SIZE,
+		disk_queue_thread, NULL, NULL, NULL,
+		CONFIG_DISK_ACCESS_QUEUE_PRIORITY, 0, 0);
+
+int disk_access_submit(struct disk_access_req *req)
+{
+	if ((req == NULL) || (req->pdrv == NULL) || (req->buf == NULL) ||
+	    (req->num_sector == 0U)) {
+		return -EINVAL;
+	}
+
+	if (disk_access_get_di(req->pdrv) == NULL) {
+		return -ENODEV;
+	}
+
+	k_fifo_put(&disk_queue, req);
+
+	return 0;
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/dlist.h>
+
+#include "ext2_struct.h"
+#include "ext2_cache.h"
+
+LOG_MODULE_DECLARE(ext2, CONFIG_EXT2_LOG_LEVEL);
+
+#define CACHE_BLOCKS    CONFIG_EXT2_BLOCK_CACHE_SIZE
+#define CACHE_BUCKETS   CONFIG_EXT2_BLOCK_CACHE_SIZE
+#define READ_AHEAD      CONFIG_EXT2_BLOCK_CACHE_READ_AHEAD
+
+BUILD_ASSERT(READ_AHEAD <= CACHE_BLOCKS, "Read-ahead can not exceed the cache size");
+
+struct ext2_cache_entry {
+	sys_dnode_t lru_node;  /* position in LRU list, most recently used first */
+	sys_dnode_t hash_node; /* position in the bucket of its block number */
+	uint8_t *data;
+	uint32_t num;
+	bool valid;
+	bool dirty;
+};
+
+static struct ext2_cache_entry entries[CACHE_BLOCKS];
+static sys_dlist_t lru_list;
+static sys_dlist_t buckets[CACHE_BUCKETS];
+
+static uint8_t __aligned(sizeof(void *)) cache_data[CACHE_BLOCKS * CONFIG_EXT2_MAX_BLOCK_SIZE];
+#if READ_AHEAD > 0
+static uint8_t __aligned(sizeof(void *)) read_ahead_buf[READ_AHEAD * CONFIG_EXT2_MAX_BLOCK_SIZE];
+#endif
+
+/* Protects the cache against concurrent file system calls and the write-back work */
+static K_MUTEX_DEFINE(cache_lock);
+static struct ext2_data *cache_fs;
+
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+static void flush_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+#endif
+
+static struct ext2_cache_entry *cache_find(uint32_t num)
+{
+	struct ext2_cache_entry *e;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&buckets[num % CACHE_BUCKETS], e, hash_node) {
+		if (e->num == num) {
+			return e;
+		}
+	}
+	return NULL;
+}
+
+static void cache_touch(struct ext2_cache_entry *e)
+{
+	sys_dlist_remove(&e->lru_node);
+	sys_dlist_prepend(&lru_list, &e->lru_node);
+}
+
+static void cache_insert(struct ext2_cache_entry *e, uint32_t num)
+{
+	e->num = num;
+	e->valid = true;
+	e->dirty = false;
+	sys_dlist_append(&buckets[num % CACHE_BUCKETS], &e->hash_node);
+	cache_touch(e);
+}
+
+static int cache_writeback(struct ext2_data *fs, struct ext2_cache_entry *e)
+{
+	int ret = fs->backend_ops->write_block(fs, e->data, e->num);
+
+	if (ret < 0) {
+		LOG_ERR("cache: write back of block %d failed (%d)", e->num, ret);
+		return ret;
+	}
+	e->dirty = false;
+	return 0;
+}
+
+/* Take the least recently used entry out of the cache, writing it back first if dirty. */
+static struct ext2_cache_entry *cache_evict(struct ext2_data *fs, int *err)
+{
+	struct ext2_cache_entry *e;
+
+	e = CONTAINER_OF(sys_dlist_peek_tail(&lru_list), struct ext2_cache_entry, lru_node);
+	if (e->valid) {
+		if (e->dirty) {
+			*err = cache_writeback(fs, e);
+			if (*err < 0) {
+				return NULL;
+			}
+		}
+		sys_dlist_remove(&e->hash_node);
+		e->valid = false;
+	}
+	return e;
+}
+
+/*
+ * Write back all the dirty blocks with a single backend request, in ascending
+ * order to keep the device access sequential. Must be called with cache_lock
+ * held.
+ */
+static int cache_writeback_all(struct ext2_data *fs)
+{
+	static struct ext2_cache_entry *dirty[CACHE_BLOCKS];
+	static const void *bufs[CACHE_BLOCKS];
+	static uint32_t nums[CACHE_BLOCKS];
+	struct ext2_cache_entry *e;
+	uint32_t count = 0;
+	uint32_t j;
+	int ret;
+
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		if (!entries[i].valid || !entries[i].dirty) {
+			continue;
+		}
+
+		/* Insertion sort on the block number */
+		e = &entries[i];
+		j = count++;
+		while (j > 0 && dirty[j - 1]->num > e->num) {
+			dirty[j] = dirty[j - 1];
+			j--;
+		}
+		dirty[j] = e;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		bufs[i] = dirty[i]->data;
+		nums[i] = dirty[i]->num;
+	}
+
+	ret = fs->backend_ops->write_blocks(fs, bufs, nums, count);
+	if (ret < 0) {
+		LOG_ERR("cache: write back of %u blocks failed (%d)", count, ret);
+		return ret;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		dirty[i]->dirty = false;
+	}
+	return 0;
+}
+
+#if READ_AHEAD > 0
+/*
+ * Read block num and the following blocks with a single backend request and put
+ * all those that are not cached yet into the cache.
+ */
+static int cache_read_ahead(struct ext2_data *fs, uint32_t num)
+{
+	uint64_t dev_blocks = fs->device_size / fs->block_size;
+	uint32_t count = num < dev_blocks ? MIN(READ_AHEAD, dev_blocks - num) : 0;
+	struct ext2_cache_entry *e;
+	int ret;
+
+	if (count < 2 || fs->backend_ops->read_blocks == NULL) {
+		return -ENOTSUP;
+	}
+
+	ret = fs->backend_ops->read_blocks(fs, read_ahead_buf, num, count);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Fill in reverse order so that block num ends up most recently used. */
+	for (int i = count - 1; i >= 0; i--) {
+		if (cache_find(num + i) != NULL) {
+			continue;
+		}
+		e = cache_evict(fs, &ret);
+		if (e == NULL) {
+			return ret;
+		}
+		memcpy(e->data, read_ahead_buf + i * fs->block_size, fs->block_size);
+		cache_insert(e, num + i);
+	}
+	return 0;
+}
+#endif
+
+void ext2_cache_init(struct ext2_data *fs)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	cache_fs = fs;
+	sys_dlist_init(&lru_list);
+	for (int i = 0; i < CACHE_BUCKETS; i++) {
+		sys_dlist_init(&buckets[i]);
+	}
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		entries[i].data = cache_data + i * CONFIG_EXT2_MAX_BLOCK_SIZE;
+		entries[i].valid = false;
+		entries[i].dirty = false;
+		sys_dnode_init(&entries[i].hash_node);
+		sys_dlist_append(&lru_list, &entries[i].lru_node);
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+int ext2_cache_read(struct ext2_data *fs, void *buf, uint32_t num)
+{
+	struct ext2_cache_entry *e;
+	int ret = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	e = cache_find(num);
+	if (e != NULL) {
+		goto hit;
+	}
+
+#if READ_AHEAD > 0
+	/* The previous block being cached hints at a sequential reader. */
+	if (num > 0 && cache_find(num - 1) != NULL && cache_read_ahead(fs, num) == 0) {
+		e = cache_find(num);
+		goto hit;
+	}
+#endif
+
+	e = cache_evict(fs, &ret);
+	if (e == NULL) {
+		goto out;
+	}
+
+	ret = fs->backend_ops->read_block(fs, e->data, num);
+	if (ret < 0) {
+		goto out;
+	}
+	cache_insert(e, num);
+
+hit:
+	memcpy(buf, e->data, fs->block_size);
+	cache_touch(e);
+out:
+	k_mutex_unlock(&cache_lock);
+	return ret;
+}
+
+int ext2_cache_write(struct ext2_data *fs, const void *buf, uint32_t num)
+{
+	struct ext2_cache_entry *e;
+	int ret = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	e = cache_find(num);
+	if (e == NULL) {
+		e = cache_evict(fs, &ret);
+		if (e == NULL) {
+			goto out;
+		}
+		cache_insert(e, num);
+	}
+
+	memcpy(e->data, buf, fs->block_size);
+	e->dirty = true;
+	cache_touch(e);
+
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+	/* Does nothing if the write-back is already scheduled. */
+	k_work_schedule(&flush_work, K_MSEC(CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL));
+#endif
+out:
+	k_mutex_unlock(&cache_lock);
+	return ret;
+}
+
+int ext2_cache_flush(struct ext2_data *fs)
+{
+	struct ext2_cache_entry *e;
+	int ret = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (fs->backend_ops->write_blocks != NULL) {
+		ret = cache_writeback_all(fs);
+		goto out;
+	}
+
+	/* Write dirty blocks in ascending order to keep the device access sequential. */
+	do {
+		e = NULL;
+		for (int i = 0; i < CACHE_BLOCKS; i++) {
+			if (entries[i].valid && entries[i].dirty &&
+			    (e == NULL || entries[i].num < e->num)) {
+				e = &entries[i];
+			}
+		}
+		if (e != NULL) {
+			ret = cache_writeback(fs, e);
+		}
+	} while (e != NULL && ret == 0);
+
+out:
+	k_mutex_unlock(&cache_lock);
+	return ret;
+}
+
+void ext2_cache_release(struct ext2_data *fs)
+{
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+	struct k_work_sync sync;
+
+	k_work_cancel_delayable_sync(&flush_work, &sync);
+#endif
+
+	if (cache_fs != fs) {
+		return;
+	}
+
+	(void)ext2_cache_flush(fs);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		if (entries[i].valid) {
+			sys_dlist_remove(&entries[i].hash_node);
+			entries[i].valid = false;
+		}
+	}
+	cache_fs = NULL;
+	k_mutex_unlock(&cache_lock);
+}
+
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+static void flush_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (cache_fs != NULL && ext2_cache_flush(cache_fs) < 0) {
+		LOG_ERR("cache: periodic write back failed");
+	}
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __EXT2_CACHE_H__
+#define __EXT2_CACHE_H__
+
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#include "ext2_struct.h"
+
+/* Block cache placed between the ext2 implementation and its storage backend.
+ *
+ * All block reads and writes go through these functions. When the cache is
+ * disabled they directly call the backend operations.
+ */
+
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+
+/**
+ * @brief Prepare the cache for a file system with given block size.
+ */
+void ext2_cache_init(struct ext2_data *fs);
+
+/**
+ * @brief Read block from the cache, fetching it from the backend on a miss.
+ *
+ * @retval 0 on success
+ * @retval <0 error
+ */
+int ext2_cache_read(struct ext2_data *fs, void *buf, uint32_t num);
+
+/**
+ * @brief Store block in the cache and mark it dirty.
+ *
+ * The block is written to the backend when it is evicted, when the cache is
+ * flushed or when the periodic write-back runs.
+ *
+ * @retval 0 on success
+ * @retval <0 error
+ */
+int ext2_cache_write(struct ext2_data *fs, const void *buf, uint32_t num);
+
+/**
+ * @brief Write all dirty blocks to the backend.
+ *
+ * @retval 0 on success
+ * @retval <0 error
+ */
+int ext2_cache_flush(struct ext2_data *fs);
+
+/**
+ * @brief Flush the cache and drop all cached blocks.
+ */
+void ext2_cache_release(struct ext2_data *fs);
+
+#else
+
+static inline void ext2_cache_init(struct ext2_data *fs)
+{
+	ARG_UNUSED(fs);
+}
+
+static inline int ext2_cache_read(struct ext2_data *fs, void *buf, uint32_t num)
+{
+	return fs->backend_ops->read_block(fs, buf, num);
+}
+
+static inline int ext2_cache_write(struct ext2_data *fs, const void *buf, uint32_t num)
+{
+	return fs->backend_ops->write_block(fs, buf, num);
+}
+
+static inline int ext2_cache_flush(struct ext2_data *fs)
+{
+	ARG_UNUSED(fs);
+	return 0;
+}
+
+static inline void ext2_cache_release(struct ext2_data *fs)
+{
+	ARG_UNUSED(fs);
+}
+
+#endif /* CONFIG_EXT2_BLOCK_CACHE */
+
+/**
+ * @brief Write all dirty blocks and synchronize the storage device.
+ *
+ * @retval 0 on success
+ * @retval <0 error
+ */
+static inline int ext2_cache_sync(struct ext2_data *fs)
+{
+	int ret = ext2_cache_flush(fs);
+
+	if (ret < 0) {
+		return ret;
+	}
+	return fs->backend_ops->sync(fs);
+}
+
+#endif /* __EXT2_CACHE_H__ */
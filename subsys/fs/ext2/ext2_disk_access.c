@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/device.h>
 #include <zephyr/storage/disk_access.h>
@@ -86,13 +87,14 @@ static int disk_prepare_range(struct disk_data *disk, uint32_t addr, uint32_t si
 	return 0;
 }
 
-static int disk_access_read_block(struct ext2_data *fs, void *buf, uint32_t block)
+static int disk_access_read_blocks(struct ext2_data *fs, void *buf, uint32_t block,
+		uint32_t count)
 {
 	int rc;
 	struct disk_data *disk = fs->backend;
 	uint32_t sector_start, sector_count;
 
-	rc = disk_prepare_range(disk, block * fs->block_size, fs->block_size,
+	rc = disk_prepare_range(disk, block * fs->block_size, count * fs->block_size,
 			&sector_start, &sector_count);
 	if (rc < 0) {
 		return rc;
@@ -100,6 +102,11 @@ static int disk_access_read_block(struct ext2_data *fs, void *buf, uint32_t bloc
 	return disk_read(disk->name, buf, sector_start, sector_count);
 }
 
+static int disk_access_read_block(struct ext2_data *fs, void *buf, uint32_t block)
+{
+	return disk_access_read_blocks(fs, buf, block, 1);
+}
+
 static int disk_access_write_block(struct ext2_data *fs, const void *buf, uint32_t block)
 {
 	int rc;
@@ -114,6 +121,86 @@ static int disk_access_write_block(struct ext2_data *fs, const void *buf, uint32
 	return disk_write(disk->name, buf, sector_start, sector_count);
 }
 
+#ifdef CONFIG_DISK_ACCESS_QUEUE
+/* Number of block writes queued at once */
+#define WRITE_BATCH 8
+
+struct write_batch {
+	struct disk_access_req reqs[WRITE_BATCH];
+	struct k_sem done;
+	int rc[WRITE_BATCH];
+};
+
+static void write_done(struct disk_access_req *req, int result)
+{
+	struct write_batch *batch = req->user_data;
+
+	batch->rc[req - batch->reqs] = result;
+	k_sem_give(&batch->done);
+}
+
+/*
+ * Queue the writes of a batch of blocks on the disk queue and wait for all of
+ * them, so that the disk is kept busy without a round trip per block and
+ * writes that continue each other are merged by the queue.
+ */
+static int disk_access_write_blocks(struct ext2_data *fs, const void *const *bufs,
+		const uint32_t *nums, uint32_t count)
+{
+	struct disk_data *disk = fs->backend;
+	struct write_batch batch;
+	uint32_t sector_start, sector_count;
+	uint32_t n, queued;
+	int rc, ret = 0;
+
+	k_sem_init(&batch.done, 0, WRITE_BATCH);
+
+	for (uint32_t first = 0; first < count && ret == 0; first += n) {
+		n = MIN(count - first, WRITE_BATCH);
+
+		for (queued = 0; queued < n; queued++) {
+			rc = disk_prepare_range(disk, nums[first + queued] * fs->block_size,
+					fs->block_size, &sector_start, &sector_count);
+			if (rc == 0) {
+				batch.reqs[queued] = (struct disk_access_req) {
+					.pdrv = disk->name,
+					.buf = (uint8_t *)bufs[first + queued],
+					.start_sector = sector_start,
+					.num_sector = sector_count,
+					.write = true,
+					.cb = write_done,
+					.user_data = &batch,
+				};
+				rc = disk_access_submit(&batch.reqs[queued]);
+			}
+			if (rc < 0) {
+				ret = rc;
+				break;
+			}
+		}
+
+		for (uint32_t i = 0; i < queued; i++) {
+			k_sem_take(&batch.done, K_FOREVER);
+		}
+
+		for (uint32_t i = 0; i < queued; i++) {
+			/* A busy disk is retried synchronously, like single block writes */
+			if (batch.rc[i] == -EBUSY) {
+				batch.rc[i] = disk_write(disk->name, batch.reqs[i].buf,
+						batch.reqs[i].start_sector, batch.reqs[i].num_sector);
+			}
+			if (batch.rc[i] < 0 && ret == 0) {
+				LOG_ERR("disk queued write: (start:%d) (ret: %d)",
+						batch.reqs[i].start_sector, batch.rc[i]);
+				ret = batch.rc[i];
+			}
+		}
+	}
+
+	return ret;
+}
+#endif
+
 static int disk_access_read_superblock(struct ext2_data *fs, struct ext2_disk_superblock *sb)
 {
 	int rc;
@@ -140,7 +227,11 @@ static const struct ext2_backend_ops disk_access_ops = {
 	.get_device_size = disk_access_device_size,
 	.get_write_size = disk_access_write_size,
 	.read_block = disk_access_read_block,
+	.read_blocks = disk_access_read_blocks,
 	.write_block = disk_access_write_block,
+#ifdef CONFIG_DISK_ACCESS_QUEUE
+	.write_blocks = disk_access_write_blocks,
+#endif
 	.read_superblock = disk_access_read_superblock,
 	.sync = disk_access_sync,
 };
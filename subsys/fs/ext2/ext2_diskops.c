@@ -18,6 +18,7 @@
 #include "ext2_impl.h"
 #include "ext2_diskops.h"
 #include "ext2_bitmap.h"
+#include "ext2_cache.h"
 
 LOG_MODULE_DECLARE(ext2);
 
@@ -1154,7 +1155,7 @@ int ext2_free_inode(struct ext2_data *fs, uint32_t ino, bool directory)
 		LOG_DBG("block bitmap write returned: %d", rc);
 		return -EIO;
 	}
-	rc = fs->backend_ops->sync(fs);
+	rc = ext2_cache_sync(fs);
 	if (rc < 0) {
 		return -EIO;
 	}
@@ -13,6 +13,7 @@
 #include "ext2_impl.h"
 #include "ext2_struct.h"
 #include "ext2_diskops.h"
+#include "ext2_cache.h"
 
 LOG_MODULE_DECLARE(ext2, LOG_LEVEL_DBG);
 
@@ -434,7 +435,7 @@ out:
 	ext2_drop_block(itable_block2);
 	ext2_drop_block(root_dir_blk);
 	ext2_drop_block(lost_found_dir_blk);
-	if ((ret >= 0) && (fs->backend_ops->sync(fs)) < 0) {
+	if ((ret >= 0) && ext2_cache_sync(fs) < 0) {
 		ret = -EIO;
 	}
 	return ret;
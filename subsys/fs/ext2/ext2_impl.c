@@ -16,6 +16,7 @@
 #include "ext2_struct.h"
 #include "ext2_diskops.h"
 #include "ext2_bitmap.h"
+#include "ext2_cache.h"
 
 LOG_MODULE_REGISTER(ext2, CONFIG_EXT2_LOG_LEVEL);
 
@@ -96,7 +97,7 @@ struct ext2_block *ext2_get_block(struct ext2_data *fs, uint32_t block)
 	}
 	b->num = block;
 	b->flags = EXT2_BLOCK_ASSIGNED;
-	ret = fs->backend_ops->read_block(fs, b->data, block);
+	ret = ext2_cache_read(fs, b->data, block);
 	if (ret < 0) {
 		LOG_ERR("get block: read block error %d", ret);
 		ext2_drop_block(b);
@@ -126,7 +127,7 @@ int ext2_write_block(struct ext2_data *fs, struct ext2_block *b)
 		return -EINVAL;
 	}
 
-	ret = fs->backend_ops->write_block(fs, b->data, b->num);
+	ret = ext2_cache_write(fs, b->data, b->num);
 	if (ret < 0) {
 		return ret;
 	}
@@ -157,6 +158,8 @@ void ext2_init_blocks_slab(struct ext2_data *fs)
 
 	k_mem_slab_init(&ext2_block_memory_slab, __ext2_block_memory_buffer, fs->block_size,
 			CONFIG_EXT2_MAX_BLOCK_COUNT);
+
+	ext2_cache_init(fs);
 }
 
 int ext2_assign_block_num(struct ext2_data *fs, struct ext2_block *b)
@@ -384,7 +387,7 @@ int ext2_close_fs(struct ext2_data *fs)
 	ext2_drop_block(fs->bgroup.inode_bitmap);
 	ext2_drop_block(fs->bgroup.block_bitmap);
 
-	if (fs->backend_ops->sync(fs) < 0) {
+	if (ext2_cache_sync(fs) < 0) {
 		return -EIO;
 	}
 	return 0;
@@ -392,6 +395,7 @@ int ext2_close_fs(struct ext2_data *fs)
 
 int ext2_close_struct(struct ext2_data *fs)
 {
+	ext2_cache_release(fs);
 	memset(fs, 0, sizeof(struct ext2_data));
 	initialized = false;
 	return 0;
@@ -788,7 +792,7 @@ int ext2_inode_sync(struct ext2_inode *inode)
 		if (ret < 0) {
 			return ret;
 		}
-		ret = fs->backend_ops->sync(fs);
+		ret = ext2_cache_sync(fs);
 		if (ret < 0) {
 			return ret;
 		}
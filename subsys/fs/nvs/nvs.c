@@ -18,6 +18,9 @@ LOG_MODULE_REGISTER(fs_nvs, CONFIG_NVS_LOG_LEVEL);
 
 static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate);
 static int nvs_ate_valid(struct nvs_fs *fs, const struct nvs_ate *entry);
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+static bool nvs_summary_skip(struct nvs_fs *fs, uint32_t *addr);
+#endif
 
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 
@@ -65,6 +68,15 @@ static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
 		if (addr == fs->ate_wra) {
 			break;
 		}
+
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+		/* addr moved to the last ATE of a closed sector, which might
+		 * not hold anything missing from the cache.
+		 */
+		if ((addr & ADDR_SECT_MASK) != (ate_addr & ADDR_SECT_MASK)) {
+			(void)nvs_summary_skip(fs, &addr);
+		}
+#endif
 	}
 
 	return 0;
@@ -95,6 +107,19 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 	}
 	return (len + (write_block_size - 1U)) & ~(write_block_size - 1U);
 }
+
+/* nvs_summary_size returns the room reserved in each sector for its summary */
+static inline size_t nvs_summary_size(struct nvs_fs *fs)
+{
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	return nvs_al_size(fs, sizeof(struct nvs_summary)) +
+	       nvs_al_size(fs, sizeof(struct nvs_ate));
+#else
+	ARG_UNUSED(fs);
+
+	return 0;
+#endif
+}
 /* end basic routines */
 
 /* flash routines */
@@ -569,6 +594,137 @@ static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate)
 	return nvs_recover_last_ate(fs, addr);
 }
 
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+static void nvs_summary_filter_set(uint8_t *filter, size_t cache_pos)
+{
+	cache_pos %= NVS_SUMMARY_FILTER_BITS;
+	filter[cache_pos / 8] |= BIT(cache_pos % 8);
+}
+
+static uint32_t nvs_summary_crc32(const struct nvs_summary *summary)
+{
+	return crc32_ieee((const uint8_t *)summary, offsetof(struct nvs_summary, crc32));
+}
+
+/* nvs_summary_write writes the summary of the sector that is being closed,
+ * when it has ATEs and there is room for the summary.
+ */
+static int nvs_summary_write(struct nvs_fs *fs)
+{
+	struct nvs_summary summary;
+	struct nvs_ate ate, summary_ate;
+	uint32_t addr, end_addr;
+	size_t ate_size;
+	int rc;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	addr = fs->ate_wra + ate_size;
+	end_addr = (fs->ate_wra & ADDR_SECT_MASK) + fs->sector_size - ate_size;
+
+	if ((addr >= end_addr) || (fs->ate_wra < fs->data_wra + nvs_summary_size(fs))) {
+		return 0;
+	}
+
+	memset(&summary, 0, sizeof(summary));
+	summary.ate_count = (end_addr - addr) / ate_size;
+	summary.ate_last = (uint16_t)(addr & ADDR_OFFS_MASK);
+	summary.cache_size = CONFIG_NVS_LOOKUP_CACHE_SIZE;
+
+	for (; addr < end_addr; addr += ate_size) {
+		rc = nvs_flash_ate_rd(fs, addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		if ((ate.id != 0xFFFF) && nvs_ate_valid(fs, &ate)) {
+			nvs_summary_filter_set(summary.filter, nvs_lookup_cache_pos(ate.id));
+		}
+	}
+
+	summary.crc32 = nvs_summary_crc32(&summary);
+
+	summary_ate.id = 0xFFFF;
+	summary_ate.offset = (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
+	summary_ate.len = sizeof(summary);
+	summary_ate.part = NVS_SUMMARY_PART;
+	nvs_ate_crc8_update(&summary_ate);
+
+	rc = nvs_flash_data_wrt(fs, &summary, sizeof(summary), false);
+	if (rc) {
+		return rc;
+	}
+
+	return nvs_flash_ate_wrt(fs, &summary_ate);
+}
+
+/* nvs_summary_ate checks if an ate is the ate of a sector summary */
+static bool nvs_summary_ate(struct nvs_fs *fs, const struct nvs_ate *entry)
+{
+	return (entry->id == 0xFFFF) && (entry->part == NVS_SUMMARY_PART) &&
+	       (entry->len == sizeof(struct nvs_summary)) && nvs_ate_valid(fs, entry);
+}
+
+/* nvs_summary_skip is called with addr pointing to the last ate of a closed
+ * sector while rebuilding the lookup cache. If the sector has a valid summary
+ * and none of its ids has a cache position that is still free, addr is moved
+ * to the first ate of the sector, so that its other ate's are not read.
+ * returns true if the sector is skipped, false otherwise.
+ */
+static bool nvs_summary_skip(struct nvs_fs *fs, uint32_t *addr)
+{
+	uint8_t missing[NVS_SUMMARY_FILTER_SIZE] = { 0 };
+	struct nvs_summary summary;
+	struct nvs_ate summary_ate;
+	size_t ate_size;
+	uint32_t ate_last;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	ate_last = *addr & ADDR_OFFS_MASK;
+
+	if ((ate_last < ate_size) || (ate_last > fs->sector_size - 2 * ate_size)) {
+		return false;
+	}
+
+	if (nvs_flash_ate_rd(fs, *addr - ate_size, &summary_ate) ||
+	    !nvs_summary_ate(fs, &summary_ate)) {
+		return false;
+	}
+
+	if (nvs_flash_rd(fs, (*addr & ADDR_SECT_MASK) + summary_ate.offset, &summary,
+			 sizeof(summary))) {
+		return false;
+	}
+
+	/* The summary must describe the ate's that follow it */
+	if ((summary.crc32 != nvs_summary_crc32(&summary)) ||
+	    (summary.cache_size != CONFIG_NVS_LOOKUP_CACHE_SIZE) ||
+	    (summary.ate_last != ate_last) ||
+	    (summary.ate_count != (fs->sector_size - ate_size - ate_last) / ate_size)) {
+		return false;
+	}
+
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if (fs->lookup_cache[i] == NVS_LOOKUP_CACHE_NO_ADDR) {
+			nvs_summary_filter_set(missing, i);
+		}
+	}
+
+	for (size_t i = 0; i < NVS_SUMMARY_FILTER_SIZE; i++) {
+		if (summary.filter[i] & missing[i]) {
+			return false;
+		}
+	}
+
+	/* The next nvs_prev_ate() reads the first ate, which cannot fill the
+	 * cache either, and moves on to the previous sector.
+	 */
+	*addr &= ADDR_SECT_MASK;
+	*addr += fs->sector_size - 2 * ate_size;
+
+	return true;
+}
+#endif /* CONFIG_NVS_SECTOR_SUMMARY */
+
 static void nvs_sector_advance(struct nvs_fs *fs, uint32_t *addr)
 {
 	*addr += (1 << ADDR_SECT_SHIFT);
@@ -592,6 +748,11 @@ static int nvs_sector_close(struct nvs_fs *fs)
 	close_ate.offset = (uint16_t)((fs->ate_wra + ate_size) & ADDR_OFFS_MASK);
 	close_ate.part = 0xff;
 
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	/* The summary is optional, the sector gets closed without it */
+	(void)nvs_summary_write(fs);
+#endif
+
 	fs->ate_wra &= ADDR_SECT_MASK;
 	fs->ate_wra += (fs->sector_size - ate_size);
 
@@ -673,6 +834,15 @@ static int nvs_gc(struct nvs_fs *fs)
 			continue;
 		}
 
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+		/* Reached when the close ate was recovered, a summary is only
+		 * valid in its own sector.
+		 */
+		if (nvs_summary_ate(fs, &gc_ate)) {
+			continue;
+		}
+#endif
+
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 		wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)];
 
@@ -1071,7 +1241,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	 * Also take into account the data CRC that is appended at the end of the data field,
 	 * if any.
 	 */
-	if ((len > (fs->sector_size - 4 * ate_size - NVS_DATA_CRC_SIZE)) ||
+	if ((len > (fs->sector_size - 4 * ate_size - NVS_DATA_CRC_SIZE - nvs_summary_size(fs))) ||
 	    ((len > 0) && (data == NULL))) {
 		return -EINVAL;
 	}
@@ -1137,8 +1307,8 @@ no_cached_entry:
 
 	/* calculate required space if the entry contains data */
 	if (data_size) {
-		/* Leave space for delete ate */
-		required_space = data_size + ate_size + NVS_DATA_CRC_SIZE;
+		/* Leave space for delete ate and the sector summary */
+		required_space = data_size + ate_size + NVS_DATA_CRC_SIZE + nvs_summary_size(fs);
 	}
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
@@ -1308,7 +1478,8 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 	 * Take into account one less sector because it is reserved for the
 	 * garbage collection.
 	 */
-	free_space = (fs->sector_count - 1) * (fs->sector_size - (2 * ate_size));
+	free_space = (fs->sector_count - 1) *
+		     (fs->sector_size - (2 * ate_size) - nvs_summary_size(fs));
 
 	step_addr = fs->ate_wra;
 
@@ -1362,7 +1533,11 @@ size_t nvs_sector_max_data_size(struct nvs_fs *fs)
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
-	return fs->ate_wra - fs->data_wra - ate_size - NVS_DATA_CRC_SIZE;
+	if (fs->ate_wra - fs->data_wra < ate_size + NVS_DATA_CRC_SIZE + nvs_summary_size(fs)) {
+		return 0;
+	}
+
+	return fs->ate_wra - fs->data_wra - ate_size - NVS_DATA_CRC_SIZE - nvs_summary_size(fs);
 }
 
 int nvs_sector_use_next(struct nvs_fs *fs)
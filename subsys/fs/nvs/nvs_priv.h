@@ -52,6 +52,27 @@ BUILD_ASSERT(offsetof(struct nvs_ate, crc8) ==
 		 sizeof(struct nvs_ate) - sizeof(uint8_t),
 		 "crc8 must be the last member");
 
+/*
+ * Sector summary: written with an ATE of id 0xFFFF and part NVS_SUMMARY_PART
+ * just before a sector is closed. The close ATE points after the summary
+ * ATE, so that walking the ATEs of a closed sector never reaches it.
+ */
+#define NVS_SUMMARY_PART 0x01
+#define NVS_SUMMARY_FILTER_SIZE 16
+#define NVS_SUMMARY_FILTER_BITS (NVS_SUMMARY_FILTER_SIZE * 8)
+
+struct nvs_summary {
+	uint16_t ate_count;	/* number of ATEs in the sector */
+	uint16_t ate_last;	/* offset of the last ATE, as in the close ATE */
+	uint32_t cache_size;	/* lookup cache size the filter was built for */
+	uint8_t filter[NVS_SUMMARY_FILTER_SIZE]; /* lookup cache positions of the ids */
+	uint32_t crc32;		/* crc32 check of the summary */
+} __packed;
+
+BUILD_ASSERT(offsetof(struct nvs_summary, crc32) ==
+		 sizeof(struct nvs_summary) - sizeof(uint32_t),
+		 "crc32 must be the last member");
+
 #ifdef __cplusplus
 }
 #endif
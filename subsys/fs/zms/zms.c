@@ -559,8 +559,8 @@ static int zms_recover_last_ate(struct zms_fs *fs, uint64_t *addr, uint64_t *dat
 
 	LOG_DBG("Recovering last ate from sector %llu", SECTOR_NUM(*addr));
 
-	/* skip close and empty ATE */
-	*addr -= 2 * fs->ate_size;
+	/* skip close ATE, the first ATE after it may hold data copied by the gc */
+	*addr -= fs->ate_size;
 
 	ate_end_addr = *addr;
 	data_end_addr = *addr & ADDR_SECT_MASK;
@@ -867,26 +867,12 @@ static int zms_find_ate_with_id(struct zms_fs *fs, uint32_t id, uint64_t start_a
 	return prev_found;
 }
 
-/* garbage collection: the address ate_wra has been updated to the new sector
- * that has just been started. The data to gc is in the sector after this new
- * sector.
+/* Make sure that the sector where the garbage collection copies entries, which is the
+ * new active sector, has a valid empty ATE and load its cycle counter.
  */
-static int zms_gc(struct zms_fs *fs)
+static int zms_gc_prepare(struct zms_fs *fs)
 {
 	int rc;
-	int sec_closed;
-	struct zms_ate close_ate;
-	struct zms_ate gc_ate;
-	struct zms_ate wlk_ate;
-	struct zms_ate empty_ate;
-	uint64_t sec_addr;
-	uint64_t gc_addr;
-	uint64_t gc_prev_addr;
-	uint64_t wlk_addr;
-	uint64_t wlk_prev_addr;
-	uint64_t data_addr;
-	uint64_t stop_addr;
-	uint8_t previous_cycle = 0;
 
 	rc = zms_get_sector_cycle(fs, fs->ate_wra, &fs->sector_cycle);
 	if (rc == -ENOENT) {
@@ -904,11 +890,123 @@ static int zms_gc(struct zms_fs *fs)
 		 * If not, then there is an I/O problem.
 		 */
 		rc = zms_get_sector_cycle(fs, fs->ate_wra, &fs->sector_cycle);
+	}
+
+	return rc;
+}
+
+/* Copy the valid ATE gc_ate, found at gc_prev_addr in the sector being garbage collected,
+ * and its data to the active sector when it is the most recent entry of its ID.
+ * The copy is written with the cycle counter cycle_cnt of the active sector.
+ */
+static int zms_gc_move_ate(struct zms_fs *fs, struct zms_ate *gc_ate, uint64_t gc_prev_addr,
+			   uint8_t cycle_cnt)
+{
+	int rc;
+	struct zms_ate wlk_ate;
+	uint64_t wlk_addr;
+	uint64_t wlk_prev_addr;
+	uint64_t data_addr;
+
+#ifdef CONFIG_ZMS_LOOKUP_CACHE
+	wlk_addr = fs->lookup_cache[zms_lookup_cache_pos(gc_ate->id)];
+
+	if (wlk_addr == ZMS_LOOKUP_CACHE_NO_ADDR) {
+		wlk_addr = fs->ate_wra;
+	}
+#else
+	wlk_addr = fs->ate_wra;
+#endif
+
+	/* Initialize the wlk_prev_addr as if no previous ID will be found */
+	wlk_prev_addr = gc_prev_addr;
+	/* Search for a previous valid ATE with the same ID. If it doesn't exist
+	 * then wlk_prev_addr will be equal to gc_prev_addr.
+	 */
+	rc = zms_find_ate_with_id(fs, gc_ate->id, wlk_addr, fs->ate_wra, &wlk_ate,
+				  &wlk_prev_addr);
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* if walk_addr has reached the same address as gc_addr, a copy is
+	 * needed unless it is a deleted item.
+	 */
+	if (wlk_prev_addr != gc_prev_addr) {
+		return 0;
+	}
+
+	/* copy needed */
+	LOG_DBG("Moving %d, len %d", gc_ate->id, gc_ate->len);
+
+	if (gc_ate->len > ZMS_DATA_IN_ATE_SIZE) {
+		/* Copy Data only when len > 8
+		 * Otherwise, Data is already inside ATE
+		 */
+		data_addr = (gc_prev_addr & ADDR_SECT_MASK);
+		data_addr += gc_ate->offset;
+		gc_ate->offset = (uint32_t)SECTOR_OFFSET(fs->data_wra);
+
+		rc = zms_flash_block_move(fs, data_addr, gc_ate->len);
 		if (rc) {
 			return rc;
 		}
-	} else if (rc) {
-		/* bad flash read */
+	}
+
+	gc_ate->cycle_cnt = cycle_cnt;
+	zms_ate_crc8_update(gc_ate);
+
+	return zms_flash_ate_wrt(fs, gc_ate);
+}
+
+/* End the garbage collection of the sector at sec_addr: mark it as done in the active
+ * sector, then erase the garbage collected sector.
+ */
+static int zms_gc_done(struct zms_fs *fs, uint64_t sec_addr)
+{
+	int rc;
+
+	/* Write a GC_done ATE to mark the end of this operation
+	 */
+
+	rc = zms_add_gc_done_ate(fs);
+	if (rc) {
+		return rc;
+	}
+
+	/* Erase the GC'ed sector when needed */
+	rc = zms_flash_erase_sector(fs, sec_addr);
+	if (rc) {
+		return rc;
+	}
+
+#ifdef CONFIG_ZMS_LOOKUP_CACHE
+	zms_lookup_cache_invalidate(fs, sec_addr >> ADDR_SECT_SHIFT);
+#endif
+	return zms_add_empty_ate(fs, sec_addr);
+}
+
+#ifndef CONFIG_ZMS_GC_INCREMENTAL
+
+/* garbage collection: the address ate_wra has been updated to the new sector
+ * that has just been started. The data to gc is in the sector after this new
+ * sector.
+ */
+static int zms_gc(struct zms_fs *fs)
+{
+	int rc;
+	int sec_closed;
+	struct zms_ate close_ate;
+	struct zms_ate gc_ate;
+	struct zms_ate empty_ate;
+	uint64_t sec_addr;
+	uint64_t gc_addr;
+	uint64_t gc_prev_addr;
+	uint64_t stop_addr;
+	uint8_t previous_cycle = 0;
+
+	rc = zms_gc_prepare(fs);
+	if (rc) {
 		return rc;
 	}
 	previous_cycle = fs->sector_cycle;
@@ -950,84 +1048,142 @@ static int zms_gc(struct zms_fs *fs)
 			continue;
 		}
 
-#ifdef CONFIG_ZMS_LOOKUP_CACHE
-		wlk_addr = fs->lookup_cache[zms_lookup_cache_pos(gc_ate.id)];
-
-		if (wlk_addr == ZMS_LOOKUP_CACHE_NO_ADDR) {
-			wlk_addr = fs->ate_wra;
+		rc = zms_gc_move_ate(fs, &gc_ate, gc_prev_addr, previous_cycle);
+		if (rc) {
+			return rc;
 		}
-#else
-		wlk_addr = fs->ate_wra;
-#endif
+	} while (gc_prev_addr != stop_addr);
 
-		/* Initialize the wlk_prev_addr as if no previous ID will be found */
-		wlk_prev_addr = gc_prev_addr;
-		/* Search for a previous valid ATE with the same ID. If it doesn't exist
-		 * then wlk_prev_addr will be equal to gc_prev_addr.
-		 */
-		rc = zms_find_ate_with_id(fs, gc_ate.id, wlk_addr, fs->ate_wra, &wlk_ate,
-					  &wlk_prev_addr);
-		if (rc < 0) {
+gc_done:
+
+	/* restore the previous sector_cycle */
+	fs->sector_cycle = previous_cycle;
+
+	return zms_gc_done(fs, sec_addr);
+}
+
+static inline size_t zms_gc_reserve(struct zms_fs *fs)
+{
+	return 0;
+}
+
+#else /* CONFIG_ZMS_GC_INCREMENTAL */
+
+/* garbage collection: the address ate_wra has been updated to the new sector
+ * that has just been started. The data to gc is in the sector after this new
+ * sector. The entries are copied later on by zms_gc_run_step(), while new ones
+ * are written to the new sector.
+ */
+static int zms_gc(struct zms_fs *fs)
+{
+	int rc;
+	int sec_closed;
+	struct zms_ate close_ate;
+	struct zms_ate empty_ate;
+	uint64_t sec_addr;
+	uint64_t gc_addr;
+
+	rc = zms_gc_prepare(fs);
+	if (rc) {
+		return rc;
+	}
+
+	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	zms_sector_advance(fs, &sec_addr);
+	gc_addr = sec_addr + fs->sector_size - fs->ate_size;
+
+	/* verify if the sector is closed */
+	sec_closed = zms_validate_closed_sector(fs, gc_addr, &empty_ate, &close_ate);
+	if (sec_closed < 0) {
+		return sec_closed;
+	}
+
+	/* stop_addr points to the first ATE before the header ATEs */
+	fs->gc_stop_addr = gc_addr - 2 * fs->ate_size;
+	fs->gc_addr = sec_addr + close_ate.offset;
+
+	/* if the sector is not closed or holds no ATE, there is nothing to copy */
+	if (!sec_closed || (fs->gc_addr > fs->gc_stop_addr)) {
+		return zms_gc_done(fs, sec_addr);
+	}
+
+	fs->gc_cycle = empty_ate.cycle_cnt;
+	fs->gc_data_end = close_ate.offset;
+	fs->gc_pending = true;
+
+	return 0;
+}
+
+/* Upper bound of the space that the pending garbage collection may still take in the
+ * active sector: each ATE left to collect may be copied with its data, and the gc done
+ * ATE ends the collection. New entries are only written when they leave this space free.
+ */
+static inline size_t zms_gc_reserve(struct zms_fs *fs)
+{
+	if (!fs->gc_pending) {
+		return 0;
+	}
+
+	return (fs->gc_stop_addr - fs->gc_addr) + 2 * fs->ate_size + fs->gc_data_end;
+}
+
+static int zms_gc_run_step(struct zms_fs *fs)
+{
+	int rc;
+	struct zms_ate gc_ate;
+	uint64_t gc_prev_addr;
+	uint32_t data_offset;
+
+	for (uint32_t i = 0; i < CONFIG_ZMS_GC_STEP_ENTRIES; i++) {
+		gc_prev_addr = fs->gc_addr;
+		rc = zms_flash_ate_rd(fs, gc_prev_addr, &gc_ate);
+		if (rc) {
 			return rc;
 		}
 
-		/* if walk_addr has reached the same address as gc_addr, a copy is
-		 * needed unless it is a deleted item.
-		 */
-		if (wlk_prev_addr == gc_prev_addr) {
-			/* copy needed */
-			LOG_DBG("Moving %d, len %d", gc_ate.id, gc_ate.len);
+		if (zms_ate_valid_different_sector(fs, &gc_ate, fs->gc_cycle) && gc_ate.len) {
+			data_offset = gc_ate.offset;
 
-			if (gc_ate.len > ZMS_DATA_IN_ATE_SIZE) {
-				/* Copy Data only when len > 8
-				 * Otherwise, Data is already inside ATE
-				 */
-				data_addr = (gc_prev_addr & ADDR_SECT_MASK);
-				data_addr += gc_ate.offset;
-				gc_ate.offset = (uint32_t)SECTOR_OFFSET(fs->data_wra);
+			rc = zms_gc_move_ate(fs, &gc_ate, gc_prev_addr, fs->sector_cycle);
+			if (rc) {
+				return rc;
+			}
 
-				rc = zms_flash_block_move(fs, data_addr, gc_ate.len);
-				if (rc) {
-					return rc;
-				}
+			/* The data of the older ATEs is stored below this one */
+			if ((gc_ate.len > ZMS_DATA_IN_ATE_SIZE) && (data_offset < fs->gc_data_end)) {
+				fs->gc_data_end = data_offset;
 			}
+		}
 
-			gc_ate.cycle_cnt = previous_cycle;
-			zms_ate_crc8_update(&gc_ate);
-			rc = zms_flash_ate_wrt(fs, &gc_ate);
+		if (gc_prev_addr == fs->gc_stop_addr) {
+			rc = zms_gc_done(fs, gc_prev_addr);
 			if (rc) {
 				return rc;
 			}
-		}
-	} while (gc_prev_addr != stop_addr);
 
-gc_done:
+			fs->gc_pending = false;
+			return 0;
+		}
 
-	/* restore the previous sector_cycle */
-	fs->sector_cycle = previous_cycle;
+		fs->gc_addr += fs->ate_size;
+	}
 
-	/* Write a GC_done ATE to mark the end of this operation
-	 */
+	return 0;
+}
 
-	rc = zms_add_gc_done_ate(fs);
-	if (rc) {
-		return rc;
-	}
+static int zms_gc_complete(struct zms_fs *fs)
+{
+	int rc = 0;
 
-	/* Erase the GC'ed sector when needed */
-	rc = zms_flash_erase_sector(fs, sec_addr);
-	if (rc) {
-		return rc;
+	while (!rc && fs->gc_pending) {
+		rc = zms_gc_run_step(fs);
 	}
 
-#ifdef CONFIG_ZMS_LOOKUP_CACHE
-	zms_lookup_cache_invalidate(fs, sec_addr >> ADDR_SECT_SHIFT);
-#endif
-	rc = zms_add_empty_ate(fs, sec_addr);
-
 	return rc;
 }
 
+#endif /* CONFIG_ZMS_GC_INCREMENTAL */
+
 int zms_clear(struct zms_fs *fs)
 {
 	int rc;
@@ -1247,6 +1403,7 @@ static int zms_init(struct zms_fs *fs)
 		 * Look for a marker (gc_done_ate) that indicates that gc was finished.
 		 */
 		bool gc_done_marker = false;
+		bool keep_write_sector = false;
 		struct zms_ate gc_done_ate;
 
 		fs->sector_cycle = empty_ate.cycle_cnt;
@@ -1276,19 +1433,33 @@ static int zms_init(struct zms_fs *fs)
 			goto end;
 		}
 		LOG_INF("No GC Done marker found: restarting gc");
-		rc = zms_flash_erase_sector(fs, fs->ate_wra);
-		if (rc) {
-			goto end;
-		}
-		rc = zms_add_empty_ate(fs, fs->ate_wra);
-		if (rc) {
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+		/* New entries may have been written to the write sector while the gc was
+		 * in progress. Keep them and resume the gc, which skips the entries that
+		 * were already copied, unless the sector was never used.
+		 */
+		rc = zms_get_sector_cycle(fs, fs->ate_wra, &fs->sector_cycle);
+		if (rc == 0) {
+			keep_write_sector = true;
+		} else if (rc != -ENOENT) {
 			goto end;
 		}
+#endif
+		if (!keep_write_sector) {
+			rc = zms_flash_erase_sector(fs, fs->ate_wra);
+			if (rc) {
+				goto end;
+			}
+			rc = zms_add_empty_ate(fs, fs->ate_wra);
+			if (rc) {
+				goto end;
+			}
 
-		/* Let's point to the first writable position */
-		fs->ate_wra &= ADDR_SECT_MASK;
-		fs->ate_wra += (fs->sector_size - 3 * fs->ate_size);
-		fs->data_wra = (fs->ate_wra & ADDR_SECT_MASK);
+			/* Let's point to the first writable position */
+			fs->ate_wra &= ADDR_SECT_MASK;
+			fs->ate_wra += (fs->sector_size - 3 * fs->ate_size);
+			fs->data_wra = (fs->ate_wra & ADDR_SECT_MASK);
+		}
 #ifdef CONFIG_ZMS_LOOKUP_CACHE
 		/**
 		 * At this point, the lookup cache wasn't built but the gc function need to use it.
@@ -1300,6 +1471,11 @@ static int zms_init(struct zms_fs *fs)
 		}
 #endif
 		rc = zms_gc(fs);
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+		if (!rc) {
+			rc = zms_gc_complete(fs);
+		}
+#endif
 		goto end;
 	}
 
@@ -1327,6 +1503,9 @@ int zms_mount(struct zms_fs *fs)
 	size_t write_block_size;
 
 	k_mutex_init(&fs->zms_lock);
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+	fs->gc_pending = false;
+#endif
 
 	fs->flash_parameters = flash_get_parameters(fs->flash_device);
 	if (fs->flash_parameters == NULL) {
@@ -1486,6 +1665,17 @@ no_cached_entry:
 
 	k_mutex_lock(&fs->zms_lock, K_FOREVER);
 
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+	/* Each write moves the pending gc forward by one step */
+	if (fs->gc_pending) {
+		rc = zms_gc_run_step(fs);
+		if (rc) {
+			LOG_ERR("Garbage collection failed, returned = %d", rc);
+			goto end;
+		}
+	}
+#endif
+
 	gc_count = 0;
 	while (1) {
 		if (gc_count == fs->sector_count) {
@@ -1501,9 +1691,10 @@ no_cached_entry:
 		 * after this write by ate_size and it will underflow.
 		 * So the first position of a sector (fs->ate_wra = 0x0) is forbidden for ATEs
 		 * and the second position could be written only be a delete ATE.
+		 * The space that a pending gc may still need is kept free as well.
 		 */
 		if ((SECTOR_OFFSET(fs->ate_wra)) &&
-		    (fs->ate_wra >= (fs->data_wra + required_space)) &&
+		    (fs->ate_wra >= (fs->data_wra + required_space + zms_gc_reserve(fs))) &&
 		    (SECTOR_OFFSET(fs->ate_wra - fs->ate_size) || !len)) {
 			rc = zms_flash_write_entry(fs, id, data, len);
 			if (rc) {
@@ -1511,6 +1702,17 @@ no_cached_entry:
 			}
 			break;
 		}
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+		/* The sector can only be closed once its gc is done */
+		if (fs->gc_pending) {
+			rc = zms_gc_run_step(fs);
+			if (rc) {
+				LOG_ERR("Garbage collection failed, returned = %d", rc);
+				goto end;
+			}
+			continue;
+		}
+#endif
 		rc = zms_sector_close(fs);
 		if (rc) {
 			LOG_ERR("Failed to close the sector, returned = %d", rc);
@@ -1770,12 +1972,19 @@ ssize_t zms_calc_free_space(struct zms_fs *fs)
 
 size_t zms_active_sector_free_space(struct zms_fs *fs)
 {
+	size_t free_space;
+	size_t reserve;
+
 	if (!fs->ready) {
 		LOG_ERR("ZMS not initialized");
 		return -EACCES;
 	}
 
-	return fs->ate_wra - fs->data_wra - fs->ate_size;
+	free_space = fs->ate_wra - fs->data_wra - fs->ate_size;
+	/* Do not count the space held back for a pending gc */
+	reserve = zms_gc_reserve(fs);
+
+	return (free_space > reserve) ? (free_space - reserve) : 0;
 }
 
 int zms_sector_use_next(struct zms_fs *fs)
@@ -1789,6 +1998,14 @@ int zms_sector_use_next(struct zms_fs *fs)
 
 	k_mutex_lock(&fs->zms_lock, K_FOREVER);
 
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+	/* The sector can only be closed once its gc is done */
+	ret = zms_gc_complete(fs);
+	if (ret != 0) {
+		goto end;
+	}
+#endif
+
 	ret = zms_sector_close(fs);
 	if (ret != 0) {
 		goto end;
@@ -1800,3 +2017,56 @@ end:
 	k_mutex_unlock(&fs->zms_lock);
 	return ret;
 }
+
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+
+int zms_gc_step(struct zms_fs *fs)
+{
+	int ret = 0;
+
+	if (!fs->ready) {
+		LOG_ERR("ZMS not initialized");
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->zms_lock, K_FOREVER);
+
+	if (fs->gc_pending) {
+		ret = zms_gc_run_step(fs);
+	}
+
+	if (ret == 0) {
+		ret = fs->gc_pending ? 1 : 0;
+	}
+
+	k_mutex_unlock(&fs->zms_lock);
+	return ret;
+}
+
+int zms_gc_pressure(struct zms_fs *fs)
+{
+	size_t free_space;
+	size_t reserve;
+
+	if (!fs->ready) {
+		LOG_ERR("ZMS not initialized");
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->zms_lock, K_FOREVER);
+	free_space = fs->ate_wra - fs->data_wra;
+	reserve = zms_gc_reserve(fs);
+	k_mutex_unlock(&fs->zms_lock);
+
+	if (reserve == 0) {
+		return 0;
+	}
+
+	if (reserve >= free_space) {
+		return 100;
+	}
+
+	return reserve * 100 / free_space;
+}
+
+#endif /* CONFIG_ZMS_GC_INCREMENTAL */
@@ -4,10 +4,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <zephyr/init.h>
 #include <zephyr/input/input.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/util.h>
 
 LOG_MODULE_REGISTER(input, CONFIG_INPUT_LOG_LEVEL);
 
@@ -18,15 +21,120 @@ K_MSGQ_DEFINE(input_msgq, sizeof(struct input_event),
 
 #endif
 
-static void input_process(struct input_event *evt)
+#ifdef CONFIG_INPUT_CALLBACK_FILTER
+
+struct input_filter_entry {
+	const struct device *dev;
+	/* Callbacks registered for the device, by section index */
+	uint32_t mask;
+};
+
+static struct input_filter_entry input_filter[CONFIG_INPUT_CALLBACK_FILTER_DEVICES];
+static uint8_t input_filter_devices;
+/* Callbacks registered for all devices */
+static uint32_t input_filter_any;
+static bool input_filter_ready;
+
+static int input_filter_init(void)
+{
+	struct input_callback *callback;
+	int count;
+	int i, j;
+
+	STRUCT_SECTION_COUNT(input_callback, &count);
+	if (count > 32) {
+		LOG_WRN("Too many callbacks for the filter: %d", count);
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		STRUCT_SECTION_GET(input_callback, i, &callback);
+
+		if (callback->dev == NULL) {
+			input_filter_any |= BIT(i);
+			continue;
+		}
+
+		for (j = 0; j < input_filter_devices; j++) {
+			if (input_filter[j].dev == callback->dev) {
+				break;
+			}
+		}
+
+		if (j == input_filter_devices) {
+			if (j == ARRAY_SIZE(input_filter)) {
+				LOG_WRN("Too many devices for the filter");
+				return 0;
+			}
+			input_filter[j].dev = callback->dev;
+			input_filter_devices++;
+		}
+
+		input_filter[j].mask |= BIT(i);
+	}
+
+	input_filter_ready = true;
+
+	return 0;
+}
+
+SYS_INIT(input_filter_init, PRE_KERNEL_1, 0);
+
+static uint32_t input_filter_get(const struct device *dev)
+{
+	if (dev == NULL) {
+		return input_filter_any;
+	}
+
+	for (int i = 0; i < input_filter_devices; i++) {
+		if (input_filter[i].dev == dev) {
+			return input_filter[i].mask | input_filter_any;
+		}
+	}
+
+	return input_filter_any;
+}
+
+#endif /* CONFIG_INPUT_CALLBACK_FILTER */
+
+static void input_process_events(struct input_event *evts, size_t count)
 {
+	const struct device *dev = evts[0].dev;
+
+#ifdef CONFIG_INPUT_CALLBACK_FILTER
+	if (input_filter_ready) {
+		uint32_t mask = input_filter_get(dev);
+
+		while (mask != 0) {
+			struct input_callback *callback;
+
+			STRUCT_SECTION_GET(input_callback, u32_count_trailing_zeros(mask),
+					   &callback);
+			mask &= mask - 1;
+
+			for (size_t i = 0; i < count; i++) {
+				callback->callback(&evts[i], callback->user_data);
+			}
+		}
+
+		return;
+	}
+#endif
+
 	STRUCT_SECTION_FOREACH(input_callback, callback) {
-		if (callback->dev == NULL || callback->dev == evt->dev) {
-			callback->callback(evt, callback->user_data);
+		if (callback->dev == NULL || callback->dev == dev) {
+			for (size_t i = 0; i < count; i++) {
+				callback->callback(&evts[i], callback->user_data);
+			}
 		}
 	}
 }
 
+static void input_process(struct input_event *evt)
+{
+	input_process_events(evt, 1);
+}
+
 bool input_queue_empty(void)
 {
 #ifdef CONFIG_INPUT_MODE_THREAD
@@ -59,6 +167,144 @@ int input_report(const struct device *dev,
 
 #ifdef CONFIG_INPUT_MODE_THREAD
 
+#ifdef CONFIG_INPUT_FRAME_BATCHING
+
+struct input_frame {
+	struct input_event evts[CONFIG_INPUT_FRAME_MAX_EVENTS];
+	uint8_t count;
+};
+
+/* Frame being received */
+static struct input_frame input_frame;
+
+#ifdef CONFIG_INPUT_FRAME_COALESCING
+/* Last complete frame, held back while more events are queued */
+static struct input_frame input_frame_pending;
+/* Number of events merged into the pending frame */
+static uint16_t input_frame_merged;
+#endif
+
+static void input_frame_deliver(struct input_frame *frame)
+{
+	if (frame->count == 0) {
+		return;
+	}
+
+	input_process_events(frame->evts, frame->count);
+	frame->count = 0;
+}
+
+static void input_frame_flush(void)
+{
+#ifdef CONFIG_INPUT_FRAME_COALESCING
+	input_frame_deliver(&input_frame_pending);
+#endif
+	input_frame_deliver(&input_frame);
+}
+
+#ifdef CONFIG_INPUT_FRAME_COALESCING
+static bool input_frame_merge(struct input_frame *dst, const struct input_frame *src)
+{
+	if (dst->count != src->count || dst->evts[0].dev != src->evts[0].dev) {
+		return false;
+	}
+
+	for (int i = 0; i < src->count; i++) {
+		const struct input_event *a = &dst->evts[i];
+		const struct input_event *b = &src->evts[i];
+
+		if (a->type != b->type || a->code != b->code) {
+			return false;
+		}
+
+		if (a->type != INPUT_EV_ABS && a->type != INPUT_EV_REL && a->value != b->value) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < src->count; i++) {
+		struct input_event *a = &dst->evts[i];
+
+		if (a->type == INPUT_EV_REL) {
+			a->value = CLAMP((int64_t)a->value + src->evts[i].value, INT32_MIN,
+					 INT32_MAX);
+		} else {
+			a->value = src->evts[i].value;
+		}
+	}
+
+	return true;
+}
+#endif /* CONFIG_INPUT_FRAME_COALESCING */
+
+static void input_frame_complete(void)
+{
+#ifdef CONFIG_INPUT_FRAME_COALESCING
+	if (input_frame_pending.count > 0 &&
+	    input_frame_merged < CONFIG_INPUT_QUEUE_MAX_MSGS &&
+	    input_frame_merge(&input_frame_pending, &input_frame)) {
+		input_frame_merged += input_frame.count;
+		input_frame.count = 0;
+		return;
+	}
+
+	input_frame_deliver(&input_frame_pending);
+	input_frame_pending = input_frame;
+	input_frame_merged = 0;
+	input_frame.count = 0;
+#else
+	input_frame_deliver(&input_frame);
+#endif
+}
+
+static void input_frame_add(struct input_event *evt)
+{
+	if (input_frame.count > 0 && input_frame.evts[0].dev != evt->dev) {
+		input_frame_flush();
+	}
+
+	input_frame.evts[input_frame.count++] = *evt;
+
+	if (evt->sync) {
+		input_frame_complete();
+	} else if (input_frame.count == ARRAY_SIZE(input_frame.evts)) {
+		input_frame_flush();
+	}
+}
+
+static bool input_frame_busy(void)
+{
+#ifdef CONFIG_INPUT_FRAME_COALESCING
+	if (input_frame_pending.count > 0) {
+		return true;
+	}
+#endif
+	return input_frame.count > 0;
+}
+
+static void input_thread(void)
+{
+	struct input_event evt;
+	int ret;
+
+	while (true) {
+		/* Never wait for more events with undelivered ones */
+		ret = k_msgq_get(&input_msgq, &evt,
+				 input_frame_busy() ? K_NO_WAIT : K_FOREVER);
+		if (ret == -ENOMSG) {
+			input_frame_flush();
+			continue;
+		} else if (ret) {
+			LOG_ERR("k_msgq_get error: %d", ret);
+			continue;
+		}
+
+		input_frame_add(&evt);
+	}
+}
+
+#else /* CONFIG_INPUT_FRAME_BATCHING */
+
 static void input_thread(void)
 {
 	struct input_event evt;
@@ -75,6 +321,8 @@ static void input_thread(void)
 	}
 }
 
+#endif /* CONFIG_INPUT_FRAME_BATCHING */
+
 #define INPUT_THREAD_PRIORITY \
 	COND_CODE_1(CONFIG_INPUT_THREAD_PRIORITY_OVERRIDE, \
 		    (CONFIG_INPUT_THREAD_PRIORITY), (K_LOWEST_APPLICATION_THREAD_PRIO))
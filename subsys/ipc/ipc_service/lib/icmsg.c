@@ -177,6 +177,8 @@ static void mbox_callback_process(struct icmsg_data_t *dev_data)
 	struct icmsg_data_t *dev_data = CONTAINER_OF(item, struct icmsg_data_t, mbox_work);
 #endif
 	uint8_t rx_buffer[CONFIG_PBUF_RX_READ_BUF_SIZE] __aligned(4);
+	const uint8_t *rx_data = rx_buffer;
+	bool in_place = false;
 
 	atomic_t state = atomic_get(&dev_data->state);
 
@@ -193,12 +195,34 @@ static void mbox_callback_process(struct icmsg_data_t *dev_data)
 		return;
 	}
 
-	len = pbuf_read(dev_data->rx_pb, rx_buffer, sizeof(rx_buffer));
+#ifdef CONFIG_IPC_SERVICE_ICMSG_NOCOPY_RX
+	if (state == ICMSG_STATE_READY) {
+		const char *data;
+		int ret = pbuf_get_rx_buffer(dev_data->rx_pb, &data);
+
+		/* Wrapped messages are copied to the local buffer. */
+		in_place = (ret > 0);
+		if (in_place) {
+			rx_data = (const uint8_t *)data;
+			len = ret;
+		}
+	}
+#endif
+
+	if (!in_place) {
+		rx_data = rx_buffer;
+		len = pbuf_read(dev_data->rx_pb, rx_buffer, sizeof(rx_buffer));
+	}
 
 	if (state == ICMSG_STATE_READY) {
 		if (dev_data->cb->received) {
-			dev_data->cb->received(rx_buffer, len, dev_data->ctx);
+			dev_data->cb->received(rx_data, len, dev_data->ctx);
+		}
+#ifdef CONFIG_IPC_SERVICE_ICMSG_NOCOPY_RX
+		if (in_place) {
+			(void)pbuf_release_rx_buffer(dev_data->rx_pb, len);
 		}
+#endif
 	} else {
 		__ASSERT_NO_MSG(state == ICMSG_STATE_BUSY);
 
@@ -336,6 +360,10 @@ int icmsg_send(const struct icmsg_config_t *conf,
 	int release_ret;
 #endif
 	int sent_bytes;
+#ifdef CONFIG_IPC_SERVICE_ICMSG_NOTIFY_COALESCING
+	uint32_t wr_idx;
+	bool notify = true;
+#endif
 
 	if (!is_endpoint_ready(dev_data)) {
 		return -EBUSY;
@@ -353,8 +381,22 @@ int icmsg_send(const struct icmsg_config_t *conf,
 	}
 #endif
 
+#ifdef CONFIG_IPC_SERVICE_ICMSG_NOTIFY_COALESCING
+	wr_idx = dev_data->tx_pb->data.wr_idx;
+#endif
+
 	write_ret = pbuf_write(dev_data->tx_pb, msg, len);
 
+#ifdef CONFIG_IPC_SERVICE_ICMSG_NOTIFY_COALESCING
+	/* The remote only has to be notified if it may have stopped reading before
+	 * the message was written. Otherwise it finds the message after reading
+	 * the previous ones.
+	 */
+	if (write_ret > 0) {
+		notify = pbuf_tx_consumed(dev_data->tx_pb, wr_idx);
+	}
+#endif
+
 #ifdef CONFIG_IPC_SERVICE_ICMSG_SHMEM_ACCESS_SYNC
 	release_ret = release_tx_buffer(dev_data);
 	__ASSERT_NO_MSG(!release_ret);
@@ -369,6 +411,12 @@ int icmsg_send(const struct icmsg_config_t *conf,
 
 	__ASSERT_NO_MSG(conf->mbox_tx.dev != NULL);
 
+#ifdef CONFIG_IPC_SERVICE_ICMSG_NOTIFY_COALESCING
+	if (!notify) {
+		return sent_bytes;
+	}
+#endif
+
 	ret = mbox_send_dt(&conf->mbox_tx, NULL);
 	if (ret) {
 		return ret;
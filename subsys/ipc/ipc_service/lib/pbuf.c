@@ -253,3 +253,95 @@ int pbuf_read(struct pbuf *pb, char *buf, uint16_t len)
 
 	return len;
 }
+
+int pbuf_get_rx_buffer(struct pbuf *pb, const char **buf)
+{
+	if (pb == NULL || buf == NULL) {
+		/* Incorrect call. */
+		return -EINVAL;
+	}
+
+	/* Invalidate wr_idx only, local rd_idx is used to increase buffer security. */
+	sys_cache_data_invd_range((void *)(pb->cfg->wr_idx_loc), sizeof(*(pb->cfg->wr_idx_loc)));
+	__sync_synchronize();
+
+	uint8_t *const data_loc = pb->cfg->data_loc;
+	const uint32_t blen = pb->cfg->len;
+	uint32_t wr_idx = *(pb->cfg->wr_idx_loc);
+	uint32_t rd_idx = pb->data.rd_idx;
+
+	/* rd_idx must always be aligned. */
+	__ASSERT_NO_MSG(IS_PTR_ALIGNED_BYTES(rd_idx, _PBUF_IDX_SIZE));
+	/* wr_idx shall always be aligned, but its value is received from the
+	 * writer. Can not assert.
+	 */
+	if (!IS_PTR_ALIGNED_BYTES(wr_idx, _PBUF_IDX_SIZE)) {
+		return -EINVAL;
+	}
+
+	if (rd_idx == wr_idx) {
+		/* Buffer is empty. */
+		return 0;
+	}
+
+	/* Get packet len.*/
+	sys_cache_data_invd_range(&data_loc[rd_idx], PBUF_PACKET_LEN_SZ);
+	uint16_t plen = sys_get_be16(&data_loc[rd_idx]);
+
+	uint32_t occupied_space = idx_occupied(blen, wr_idx, rd_idx);
+
+	if (occupied_space < plen + PBUF_PACKET_LEN_SZ) {
+		/* This should never happen. */
+		return -EAGAIN;
+	}
+
+	rd_idx = idx_wrap(blen, rd_idx + PBUF_PACKET_LEN_SZ);
+
+	if (plen > blen - rd_idx) {
+		/* Packet is wrapped, it can only be copied out. */
+		return -ENOTSUP;
+	}
+
+	sys_cache_data_invd_range(&data_loc[rd_idx], plen);
+	*buf = (const char *)&data_loc[rd_idx];
+
+	return (int)plen;
+}
+
+int pbuf_release_rx_buffer(struct pbuf *pb, uint16_t len)
+{
+	if (pb == NULL) {
+		/* Incorrect call. */
+		return -EINVAL;
+	}
+
+	const uint32_t blen = pb->cfg->len;
+	uint32_t rd_idx = idx_wrap(blen, pb->data.rd_idx + PBUF_PACKET_LEN_SZ);
+
+	/* The packet was not wrapped, when it was obtained. */
+	if (len > blen - rd_idx) {
+		return -EINVAL;
+	}
+
+	/* Update rd_idx. */
+	rd_idx = idx_wrap(blen, ROUND_UP(rd_idx + len, _PBUF_IDX_SIZE));
+
+	pb->data.rd_idx = rd_idx;
+	*(pb->cfg->rd_idx_loc) = rd_idx;
+	__sync_synchronize();
+	sys_cache_data_flush_range((void *)pb->cfg->rd_idx_loc, sizeof(*(pb->cfg->rd_idx_loc)));
+
+	return 0;
+}
+
+bool pbuf_tx_consumed(struct pbuf *pb, uint32_t wr_idx)
+{
+	/* Make sure the updated wr_idx is visible before rd_idx is checked, the reader
+	 * checks wr_idx after updating rd_idx.
+	 */
+	__sync_synchronize();
+	sys_cache_data_invd_range((void *)(pb->cfg->rd_idx_loc), sizeof(*(pb->cfg->rd_idx_loc)));
+	__sync_synchronize();
+
+	return *(pb->cfg->rd_idx_loc) == wr_idx;
+}
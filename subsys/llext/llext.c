@@ -23,6 +23,120 @@ static sys_slist_t _llext_list = SYS_SLIST_STATIC_INIT(&_llext_list);
 
 static struct k_mutex llext_lock = Z_MUTEX_INITIALIZER(llext_lock);
 
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+/* Unloaded extensions kept for revival, least recently unloaded first */
+static sys_slist_t _llext_cache = SYS_SLIST_STATIC_INIT(&_llext_cache);
+static unsigned int llext_cache_cnt;
+#endif
+
+static void llext_free_ext(struct llext *ext)
+{
+	llext_free_regions(ext);
+	llext_free(ext->sym_tab.syms);
+	llext_free(ext->exp_tab.syms);
+	llext_free(ext);
+}
+
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+/*
+ * Read the ELF header of the image provided by the loader into ldr->hdr and
+ * compute the CRC identifying the image in the cache.
+ */
+static int llext_cache_identify(struct llext_loader *ldr, uint32_t *crc)
+{
+	int ret;
+
+	ret = llext_prepare(ldr);
+	if (ret == 0) {
+		ret = llext_seek(ldr, 0);
+	}
+	if (ret == 0) {
+		ret = llext_read(ldr, &ldr->hdr, sizeof(ldr->hdr));
+	}
+	if (ret == 0) {
+		ret = llext_image_crc(ldr, crc);
+	}
+	llext_finalize(ldr);
+
+	return ret;
+}
+
+/*
+ * Look for a cached image of the extension provided by the loader. The name,
+ * the ELF header and the CRC of the whole image must match the ones of the
+ * cached image, so that a rebuilt extension is never mistaken for a stale one.
+ * Must be called with llext_lock held.
+ */
+static struct llext *llext_cache_revive(struct llext_loader *ldr, const char *name)
+{
+	struct llext *ext;
+	sys_snode_t *prev = NULL;
+	uint32_t crc;
+
+	if (sys_slist_is_empty(&_llext_cache)) {
+		return NULL;
+	}
+
+	if (llext_cache_identify(ldr, &crc) != 0) {
+		return NULL;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&_llext_cache, ext, _llext_list) {
+		if (strncmp(ext->name, name, sizeof(ext->name)) == 0 &&
+		    memcmp(&ext->cache_hdr, &ldr->hdr, sizeof(ldr->hdr)) == 0 &&
+		    ext->cache_crc == crc) {
+			sys_slist_remove(&_llext_cache, prev, &ext->_llext_list);
+			llext_cache_cnt--;
+
+			/* Keep the loader usable for llext_find_section() */
+			memcpy(ldr->sects, ext->cache_sects, sizeof(ldr->sects));
+			llext_restore_data(ext);
+
+			LOG_DBG("Revived cached extension %s", ext->name);
+			return ext;
+		}
+		prev = &ext->_llext_list;
+	}
+
+	return NULL;
+}
+
+/*
+ * Take the oldest image out of the cache, or NULL if the cache is empty.
+ * Must be called with llext_lock held.
+ */
+static struct llext *llext_cache_evict(void)
+{
+	sys_snode_t *node = sys_slist_get(&_llext_cache);
+
+	if (!node) {
+		return NULL;
+	}
+
+	llext_cache_cnt--;
+
+	return CONTAINER_OF(node, struct llext, _llext_list);
+}
+
+void llext_cache_flush(void)
+{
+	struct llext *ext;
+
+	k_mutex_lock(&llext_lock, K_FOREVER);
+
+	while ((ext = llext_cache_evict()) != NULL) {
+		LOG_DBG("Freeing cached extension %s", ext->name);
+		llext_free_ext(ext);
+	}
+
+	k_mutex_unlock(&llext_lock);
+}
+#else
+void llext_cache_flush(void)
+{
+}
+#endif
+
 ssize_t llext_find_section(struct llext_loader *ldr, const char *search_name)
 {
 	/* Note that this API is used after llext_load(), so the ldr->sect_hdrs
@@ -153,6 +267,16 @@ int llext_load(struct llext_loader *ldr, const char *name, struct llext **ext,
 		goto out;
 	}
 
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+	*ext = llext_cache_revive(ldr, name);
+	if (*ext) {
+		ret = (*ext)->use_count++;
+		sys_slist_append(&_llext_list, &(*ext)->_llext_list);
+		LOG_INF("Loaded extension %s from cache", (*ext)->name);
+		goto out;
+	}
+#endif
+
 	*ext = llext_alloc(sizeof(struct llext));
 	if (*ext == NULL) {
 		LOG_ERR("Not enough memory for extension metadata");
@@ -161,6 +285,15 @@ int llext_load(struct llext_loader *ldr, const char *name, struct llext **ext,
 	}
 
 	ret = do_llext_load(ldr, *ext, ldr_parm);
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+	/* Cached images only hold memory speculatively, drop them and retry */
+	while (ret == -ENOMEM && !sys_slist_is_empty(&_llext_cache)) {
+		struct llext *old = llext_cache_evict();
+
+		llext_free_ext(old);
+		ret = do_llext_load(ldr, *ext, ldr_parm);
+	}
+#endif
 	if (ret < 0) {
 		llext_free(*ext);
 		*ext = NULL;
@@ -248,15 +381,37 @@ int llext_unload(struct llext **ext)
 	/* FIXME: protect the global list */
 	sys_slist_find_and_remove(&_llext_list, &tmp->_llext_list);
 
+	*ext = NULL;
+
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+	/*
+	 * Extensions linked against other extensions are not cached, as they
+	 * would keep their dependencies pinned after those are unloaded.
+	 */
+	if (tmp->cacheable && !tmp->dependency[0]) {
+		struct llext *old = NULL;
+
+		if (llext_cache_cnt == CONFIG_LLEXT_IMAGE_CACHE_ENTRIES) {
+			old = llext_cache_evict();
+		}
+
+		sys_slist_append(&_llext_cache, &tmp->_llext_list);
+		llext_cache_cnt++;
+		k_mutex_unlock(&llext_lock);
+
+		if (old) {
+			llext_free_ext(old);
+		}
+
+		return 0;
+	}
+#endif
+
 	llext_dependency_remove_all(tmp);
 
-	*ext = NULL;
 	k_mutex_unlock(&llext_lock);
 
-	llext_free_regions(tmp);
-	llext_free(tmp->sym_tab.syms);
-	llext_free(tmp->exp_tab.syms);
-	llext_free(tmp);
+	llext_free_ext(tmp);
 
 	return 0;
 }
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <zephyr/sys/crc.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/llext/elf.h>
 #include <zephyr/llext/loader.h>
@@ -622,6 +623,61 @@ static int llext_copy_symbols(struct llext_loader *ldr, struct llext *ext,
 	return 0;
 }
 
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+/*
+ * Compute a CRC of the ELF image provided by the loader, from its start to the
+ * end of its last section or of its section header table. The image is read
+ * rather than peeked, so that the loader checks its bounds. The ELF header
+ * must already be in ldr->hdr and the loader must be prepared. The section
+ * headers are only read again when they were not loaded yet.
+ */
+int llext_image_crc(struct llext_loader *ldr, uint32_t *crc)
+{
+	size_t end = ldr->hdr.e_shoff + (size_t)ldr->hdr.e_shnum * ldr->hdr.e_shentsize;
+	uint8_t buf[64];
+	elf_shdr_t shdr;
+	size_t pos;
+	int ret;
+
+	for (unsigned int i = 0; i < ldr->hdr.e_shnum; i++) {
+		if (ldr->sect_hdrs != NULL && i < ldr->sect_cnt) {
+			shdr = ldr->sect_hdrs[i];
+		} else {
+			ret = llext_seek(ldr, ldr->hdr.e_shoff + i * ldr->hdr.e_shentsize);
+			if (ret == 0) {
+				ret = llext_read(ldr, &shdr, sizeof(shdr));
+			}
+			if (ret != 0) {
+				return ret;
+			}
+		}
+
+		if (shdr.sh_type != SHT_NOBITS) {
+			end = MAX(end, shdr.sh_offset + shdr.sh_size);
+		}
+	}
+
+	ret = llext_seek(ldr, 0);
+	if (ret != 0) {
+		return ret;
+	}
+
+	*crc = 0;
+	for (pos = 0; pos < end; pos += sizeof(buf)) {
+		size_t len = MIN(sizeof(buf), end - pos);
+
+		ret = llext_read(ldr, buf, len);
+		if (ret != 0) {
+			return ret;
+		}
+
+		*crc = crc32_ieee_update(*crc, buf, len);
+	}
+
+	return 0;
+}
+#endif
+
 /*
  * Load a valid ELF as an extension
  */
@@ -724,6 +780,29 @@ int do_llext_load(struct llext_loader *ldr, struct llext *ext,
 		goto out;
 	}
 
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+	/* Remember what was linked, so that the image can be revived without
+	 * relocating it again once unloaded. Only images whose regions were all
+	 * copied to the heap are cached: regions peeked from the loader buffer,
+	 * or used in place by a pre-located load, belong to the caller and may
+	 * be gone by the time the image is revived. An extension that cannot be
+	 * cached is still loaded, it just isn't cached.
+	 */
+	ext->cache_hdr = ldr->hdr;
+	memcpy(ext->cache_sects, ldr->sects, sizeof(ext->cache_sects));
+	ext->cacheable = !ldr_parm->pre_located;
+	for (int i = 0; i < LLEXT_MEM_COUNT && ext->cacheable; i++) {
+		if (ext->mem_size[i] != 0 && !ext->mem_on_heap[i]) {
+			ext->cacheable = false;
+		}
+	}
+	if (ext->cacheable) {
+		/* The loader is still prepared, identify the image now */
+		ext->cacheable = llext_image_crc(ldr, &ext->cache_crc) == 0 &&
+				 llext_snapshot_data(ext) == 0;
+	}
+#endif
+
 	llext_adjust_mmu_permissions(ext);
 
 out:
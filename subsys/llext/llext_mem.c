@@ -10,6 +10,7 @@
 #include <zephyr/llext/llext.h>
 #include <zephyr/kernel.h>
 #include <zephyr/cache.h>
+#include <zephyr/sys/mem_blocks.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(llext, CONFIG_LLEXT_LOG_LEVEL);
@@ -27,6 +28,59 @@ LOG_MODULE_DECLARE(llext, CONFIG_LLEXT_LOG_LEVEL);
 
 K_HEAP_DEFINE(llext_heap, CONFIG_LLEXT_HEAP_SIZE * 1024);
 
+#ifdef CONFIG_LLEXT_SECTION_POOL
+SYS_MEM_BLOCKS_DEFINE_STATIC(llext_section_pool, LLEXT_PAGE_SIZE,
+			     CONFIG_LLEXT_SECTION_POOL_SIZE * 1024 / LLEXT_PAGE_SIZE,
+			     LLEXT_PAGE_SIZE);
+#endif
+
+/*
+ * Section regions are always allocated in whole pages, so they can come from
+ * a block pool where every block is already page sized and aligned.
+ */
+static void *llext_section_alloc(size_t align, size_t bytes)
+{
+#ifdef CONFIG_LLEXT_SECTION_POOL
+	void *block;
+
+	__ASSERT_NO_MSG(align == LLEXT_PAGE_SIZE && bytes % LLEXT_PAGE_SIZE == 0);
+
+	if (sys_mem_blocks_alloc_contiguous(&llext_section_pool,
+					    bytes / LLEXT_PAGE_SIZE, &block) != 0) {
+		return NULL;
+	}
+
+	return block;
+#else
+	return llext_aligned_alloc(align, bytes);
+#endif
+}
+
+static void llext_section_free(void *ptr, size_t bytes)
+{
+#ifdef CONFIG_LLEXT_SECTION_POOL
+	if (ptr) {
+		sys_mem_blocks_free_contiguous(&llext_section_pool, ptr,
+					       DIV_ROUND_UP(bytes, LLEXT_PAGE_SIZE));
+	}
+#else
+	ARG_UNUSED(bytes);
+	llext_free(ptr);
+#endif
+}
+
+int llext_get_section_mem_stats(struct sys_memory_stats *stats)
+{
+#if defined(CONFIG_LLEXT_SECTION_POOL) && defined(CONFIG_SYS_MEM_BLOCKS_RUNTIME_STATS)
+	return sys_mem_blocks_runtime_stats_get(&llext_section_pool, stats);
+#elif !defined(CONFIG_LLEXT_SECTION_POOL) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+	return sys_heap_runtime_stats_get(&llext_heap.heap, stats);
+#else
+	ARG_UNUSED(stats);
+	return -ENOTSUP;
+#endif
+}
+
 /*
  * Initialize the memory partition associated with the specified memory region
  */
@@ -96,7 +150,7 @@ static int llext_copy_section(struct llext_loader *ldr, struct llext *ext,
 	uintptr_t sect_align = sect_alloc;
 #endif
 
-	ext->mem[mem_idx] = llext_aligned_alloc(sect_align, sect_alloc);
+	ext->mem[mem_idx] = llext_section_alloc(sect_align, sect_alloc);
 	if (!ext->mem[mem_idx]) {
 		return -ENOMEM;
 	}
@@ -125,7 +179,7 @@ static int llext_copy_section(struct llext_loader *ldr, struct llext *ext,
 	return 0;
 
 err:
-	llext_free(ext->mem[mem_idx]);
+	llext_section_free(ext->mem[mem_idx], sect_alloc);
 	ext->mem[mem_idx] = NULL;
 	return ret;
 }
@@ -206,12 +260,52 @@ void llext_free_regions(struct llext *ext)
 #endif
 		if (ext->mem_on_heap[i]) {
 			LOG_DBG("freeing memory region %d", i);
-			llext_free(ext->mem[i]);
+			llext_section_free(ext->mem[i],
+					   ROUND_UP(ext->mem_size[i], LLEXT_PAGE_SIZE));
 			ext->mem[i] = NULL;
 		}
 	}
+
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+	llext_section_free(ext->data_snapshot,
+			   ROUND_UP(ext->mem_size[LLEXT_MEM_DATA], LLEXT_PAGE_SIZE));
+	ext->data_snapshot = NULL;
+#endif
+}
+
+#ifdef CONFIG_LLEXT_IMAGE_CACHE
+int llext_snapshot_data(struct llext *ext)
+{
+	size_t size = ext->mem_size[LLEXT_MEM_DATA];
+
+	if (size == 0) {
+		return 0;
+	}
+
+	ext->data_snapshot = llext_section_alloc(LLEXT_PAGE_SIZE,
+						 ROUND_UP(size, LLEXT_PAGE_SIZE));
+	if (!ext->data_snapshot) {
+		return -ENOMEM;
+	}
+
+	memcpy(ext->data_snapshot, ext->mem[LLEXT_MEM_DATA], size);
+
+	return 0;
 }
 
+void llext_restore_data(struct llext *ext)
+{
+	if (ext->mem_size[LLEXT_MEM_DATA] != 0) {
+		memcpy(ext->mem[LLEXT_MEM_DATA], ext->data_snapshot,
+		       ext->mem_size[LLEXT_MEM_DATA]);
+	}
+
+	if (ext->mem_size[LLEXT_MEM_BSS] != 0) {
+		memset(ext->mem[LLEXT_MEM_BSS], 0, ext->mem_size[LLEXT_MEM_BSS]);
+	}
+}
+#endif
+
 int llext_add_domain(struct llext *ext, struct k_mem_domain *domain)
 {
 #ifdef CONFIG_USERSPACE
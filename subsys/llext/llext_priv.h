@@ -23,6 +23,8 @@ int llext_copy_strings(struct llext_loader *ldr, struct llext *ext);
 int llext_copy_regions(struct llext_loader *ldr, struct llext *ext);
 void llext_free_regions(struct llext *ext);
 void llext_adjust_mmu_permissions(struct llext *ext);
+int llext_snapshot_data(struct llext *ext);
+void llext_restore_data(struct llext *ext);
 
 static inline void *llext_alloc(size_t bytes)
 {
@@ -51,6 +53,7 @@ static inline void llext_free(void *ptr)
 
 int do_llext_load(struct llext_loader *ldr, struct llext *ext,
 		  const struct llext_load_param *ldr_parm);
+int llext_image_crc(struct llext_loader *ldr, uint32_t *crc);
 
 static inline const char *llext_string(struct llext_loader *ldr, struct llext *ext,
 				       enum llext_mem mem_idx, unsigned int idx)
@@ -201,6 +201,59 @@ void img_mgmt_take_lock(void);
  */
 void img_mgmt_release_lock(void);
 
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+/**
+ * @brief	Releases the chunks held for a windowed upload.
+ */
+void img_mgmt_window_reset(void);
+
+/**
+ * @brief	Checks whether an upload request carries a chunk that follows the next
+ *		expected offset of the upload in progress and can be held until the
+ *		chunks before it arrive.
+ *
+ * @param req		The upload request.
+ * @param window	The number of chunks the client may send ahead, 0 if the
+ *			upload is not windowed.
+ *
+ * @return true if the chunk can be held.
+ */
+bool img_mgmt_window_accepts(const struct img_mgmt_upload_req *req, uint32_t window);
+
+/**
+ * @brief	Holds a chunk received ahead of the next expected offset.
+ *
+ * @param off		The offset of the chunk.
+ * @param data		The image data of the chunk.
+ * @param len		The length of the chunk.
+ *
+ * @return 0 on success or if the chunk is held already;
+ *	   -ENOMEM if no chunk is free, in which case the client sends it again.
+ */
+int img_mgmt_window_hold(size_t off, const uint8_t *data, size_t len);
+
+/**
+ * @brief	Writes the held chunks that follow the next expected offset, and
+ *		advances it.
+ *
+ * @param last		Set to whether the last chunk written is the end of the image.
+ *
+ * @return 0 on success, MGMT_ERR_[...] code on failure.
+ */
+int img_mgmt_window_drain(bool *last);
+
+/**
+ * @brief	Encodes the window granted to the client and the offsets of the chunks
+ *		held, which are acknowledged besides the next expected offset.
+ *
+ * @param zse		The response encoder.
+ * @param window	The number of chunks the client may send ahead.
+ *
+ * @return true on success, false if the response is too large.
+ */
+bool img_mgmt_window_encode(zcbor_state_t *zse, uint32_t window);
+#endif
+
 #define ERASED_VAL_32(x) (((x) << 24) | ((x) << 16) | ((x) << 8) | (x))
 int img_mgmt_erased_val(int slot, uint8_t *erased_val);
 
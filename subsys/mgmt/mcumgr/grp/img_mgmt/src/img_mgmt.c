@@ -399,6 +399,9 @@ static void img_mgmt_reset_upload(void)
 	img_mgmt_take_lock();
 	memset(&g_img_mgmt_state, 0, sizeof(g_img_mgmt_state));
 	g_img_mgmt_state.area_id = -1;
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+	img_mgmt_window_reset();
+#endif
 	img_mgmt_release_lock();
 }
 
@@ -662,7 +665,7 @@ finish:
 #endif
 
 static int
-img_mgmt_upload_good_rsp(struct smp_streamer *ctxt)
+img_mgmt_upload_good_rsp(struct smp_streamer *ctxt, uint32_t window)
 {
 	zcbor_state_t *zse = ctxt->writer->zs;
 	bool ok = true;
@@ -675,6 +678,12 @@ img_mgmt_upload_good_rsp(struct smp_streamer *ctxt)
 	ok = ok && zcbor_tstr_put_lit(zse, "off")		&&
 		   zcbor_size_put(zse, g_img_mgmt_state.off);
 
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+	if (window > 0) {
+		ok = ok && img_mgmt_window_encode(zse, window);
+	}
+#endif
+
 	return ok ? MGMT_ERR_EOK : MGMT_ERR_EMSGSIZE;
 }
 
@@ -729,6 +738,8 @@ img_mgmt_upload(struct smp_streamer *ctxt)
 	struct img_mgmt_upload_action action;
 	bool last = false;
 	bool reset = false;
+	bool hold = false;
+	uint32_t window = 0;
 
 #ifdef CONFIG_IMG_ENABLE_IMAGE_CHECK
 	bool data_match = false;
@@ -751,7 +762,10 @@ defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 		ZCBOR_MAP_DECODE_KEY_DECODER("len", zcbor_size_decode, &req.size),
 		ZCBOR_MAP_DECODE_KEY_DECODER("off", zcbor_size_decode, &req.off),
 		ZCBOR_MAP_DECODE_KEY_DECODER("sha", zcbor_bstr_decode, &req.data_sha),
-		ZCBOR_MAP_DECODE_KEY_DECODER("upgrade", zcbor_bool_decode, &req.upgrade)
+		ZCBOR_MAP_DECODE_KEY_DECODER("upgrade", zcbor_bool_decode, &req.upgrade),
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+		ZCBOR_MAP_DECODE_KEY_DECODER("win", zcbor_uint32_decode, &window),
+#endif
 	};
 
 #if defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
@@ -779,6 +793,13 @@ defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 
 	img_mgmt_take_lock();
 
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+	/* The client asks for a windowed upload with the number of chunks it wants
+	 * to send ahead, grant what can be held.
+	 */
+	window = MIN(window, CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNKS);
+#endif
+
 	/* Determine what actions to take as a result of this request. */
 	rc = img_mgmt_upload_inspect(&req, &action);
 	if (rc != 0) {
@@ -794,12 +815,19 @@ defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 	}
 
 	if (!action.proceed) {
-		/* Request specifies incorrect offset.  Respond with a success code and
-		 * the correct offset.
-		 */
-		rc = img_mgmt_upload_good_rsp(ctxt);
-		img_mgmt_release_lock();
-		return rc;
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+		/* A chunk ahead of the expected offset is held in a windowed upload */
+		hold = img_mgmt_window_accepts(&req, window);
+#endif
+
+		if (!hold) {
+			/* Request specifies incorrect offset.  Respond with a success code
+			 * and the correct offset.
+			 */
+			rc = img_mgmt_upload_good_rsp(ctxt, window);
+			img_mgmt_release_lock();
+			return rc;
+		}
 	}
 
 #if defined(CONFIG_MCUMGR_GRP_IMG_UPLOAD_CHECK_HOOK)
@@ -824,6 +852,18 @@ defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 	}
 #endif
 
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+	if (hold) {
+		/* If no chunk is free, the chunk is not acknowledged and gets sent
+		 * again by the client.
+		 */
+		(void)img_mgmt_window_hold(req.off, req.img_data.value, req.img_data.len);
+		rc = img_mgmt_upload_good_rsp(ctxt, window);
+		img_mgmt_release_lock();
+		return rc;
+	}
+#endif
+
 	/* Remember flash area ID and image size for subsequent upload requests. */
 	g_img_mgmt_state.area_id = action.area_id;
 	g_img_mgmt_state.size = action.size;
@@ -839,6 +879,10 @@ defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 
 		g_img_mgmt_state.off = 0;
 
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+		img_mgmt_window_reset();
+#endif
+
 #if defined(CONFIG_MCUMGR_GRP_IMG_STATUS_HOOKS)
 		(void)mgmt_callback_notify(MGMT_EVT_OP_IMG_MGMT_DFU_STARTED, NULL, 0, &err_rc,
 					   &err_group);
@@ -915,7 +959,14 @@ defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 						    last);
 		if (rc == 0) {
 			g_img_mgmt_state.off += action.write_bytes;
-		} else {
+
+#ifdef CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW
+			/* Write the held chunks that now follow */
+			rc = img_mgmt_window_drain(&last);
+#endif
+		}
+
+		if (rc != 0) {
 			/* Write failed, currently not able to recover from this */
 #if defined(CONFIG_MCUMGR_SMP_COMMAND_STATUS_HOOKS)
 			cmd_status_arg.status = IMG_MGMT_ID_UPLOAD_STATUS_COMPLETE;
@@ -983,7 +1034,7 @@ end:
 
 		img_mgmt_reset_upload();
 	} else {
-		rc = img_mgmt_upload_good_rsp(ctxt);
+		rc = img_mgmt_upload_good_rsp(ctxt, window);
 
 #ifdef CONFIG_IMG_ENABLE_IMAGE_CHECK
 		if (last && rc == MGMT_ERR_EOK) {
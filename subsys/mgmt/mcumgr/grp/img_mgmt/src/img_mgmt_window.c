@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#include <zcbor_common.h>
+#include <zcbor_encode.h>
+
+#include <zephyr/mgmt/mcumgr/grp/img_mgmt/img_mgmt.h>
+
+#include <mgmt/mcumgr/grp/img_mgmt/img_mgmt_priv.h>
+
+/*
+ * Chunks received ahead of the next expected offset of a windowed upload are
+ * held here until the chunks before them arrive. A free chunk has a length
+ * of 0.
+ */
+struct img_mgmt_window_chunk {
+	size_t off;
+	size_t len;
+	uint8_t data[CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNK_SIZE];
+};
+
+static struct img_mgmt_window_chunk chunks[CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNKS];
+
+static struct img_mgmt_window_chunk *img_mgmt_window_find(size_t off)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(chunks); i++) {
+		if (chunks[i].len > 0 && chunks[i].off == off) {
+			return &chunks[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct img_mgmt_window_chunk *img_mgmt_window_find_free(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(chunks); i++) {
+		if (chunks[i].len == 0) {
+			return &chunks[i];
+		}
+	}
+
+	return NULL;
+}
+
+void img_mgmt_window_reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(chunks); i++) {
+		chunks[i].len = 0;
+	}
+}
+
+bool img_mgmt_window_accepts(const struct img_mgmt_upload_req *req, uint32_t window)
+{
+	return window > 0 && g_img_mgmt_state.area_id != -1 && req->off != SIZE_MAX &&
+	       req->off > g_img_mgmt_state.off && req->img_data.len > 0 &&
+	       req->img_data.len <= CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNK_SIZE &&
+	       req->off + req->img_data.len <= g_img_mgmt_state.size;
+}
+
+int img_mgmt_window_hold(size_t off, const uint8_t *data, size_t len)
+{
+	struct img_mgmt_window_chunk *chunk;
+
+	if (img_mgmt_window_find(off) != NULL) {
+		/* Sent again, the response got lost */
+		return 0;
+	}
+
+	chunk = img_mgmt_window_find_free();
+	if (chunk == NULL) {
+		return -ENOMEM;
+	}
+
+	memcpy(chunk->data, data, len);
+	chunk->off = off;
+	chunk->len = len;
+
+	return 0;
+}
+
+int img_mgmt_window_drain(bool *last)
+{
+	struct img_mgmt_window_chunk *chunk;
+	int rc;
+
+	while ((chunk = img_mgmt_window_find(g_img_mgmt_state.off)) != NULL) {
+		*last = g_img_mgmt_state.off + chunk->len == g_img_mgmt_state.size;
+
+		rc = img_mgmt_write_image_data(chunk->off, chunk->data, chunk->len, *last);
+		if (rc != 0) {
+			return rc;
+		}
+
+		g_img_mgmt_state.off += chunk->len;
+		chunk->len = 0;
+	}
+
+	/* Chunks starting before the upload offset are not on the chunk
+	 * boundaries of the client anymore, and cannot be written.
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(chunks); i++) {
+		if (chunks[i].off < g_img_mgmt_state.off) {
+			chunks[i].len = 0;
+		}
+	}
+
+	return 0;
+}
+
+bool img_mgmt_window_encode(zcbor_state_t *zse, uint32_t window)
+{
+	bool ok;
+
+	ok = zcbor_tstr_put_lit(zse, "win")	&&
+	     zcbor_uint32_put(zse, window)	&&
+	     zcbor_tstr_put_lit(zse, "sack")	&&
+	     zcbor_list_start_encode(zse, ARRAY_SIZE(chunks));
+
+	for (size_t i = 0; ok && i < ARRAY_SIZE(chunks); i++) {
+		if (chunks[i].len > 0) {
+			ok = zcbor_size_put(zse, chunks[i].off);
+		}
+	}
+
+	return ok && zcbor_list_end_encode(zse, ARRAY_SIZE(chunks));
+}
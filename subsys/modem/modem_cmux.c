@@ -889,6 +889,66 @@ static void modem_cmux_process_received_byte(struct modem_cmux *cmux, uint8_t by
 	}
 }
 
+/*
+ * Process the received bytes which need no parsing in bulk, that is the bytes preceding a
+ * start of frame flag and the data of a frame. Returns the number of bytes processed, which
+ * is 0 if the next byte must be parsed.
+ */
+static size_t modem_cmux_process_received_bulk(struct modem_cmux *cmux, const uint8_t *data,
+					       size_t len)
+{
+	const uint8_t *sof;
+	size_t count;
+
+	switch (cmux->receive_state) {
+	case MODEM_CMUX_RECEIVE_STATE_SOF:
+		sof = memchr(data, 0xF9, len);
+		return (sof == NULL) ? len : (size_t)(sof - data);
+
+	case MODEM_CMUX_RECEIVE_STATE_DATA:
+		if (cmux->frame.data_len <= cmux->receive_buf_len) {
+			return 0;
+		}
+
+		count = MIN(len, cmux->frame.data_len - cmux->receive_buf_len);
+
+		/* Copy what fits, the frame is dropped when its FCS is received otherwise */
+		if (cmux->receive_buf_len < cmux->receive_buf_size) {
+			memcpy(&cmux->receive_buf[cmux->receive_buf_len], data,
+			       MIN(count, cmux->receive_buf_size - cmux->receive_buf_len));
+		}
+
+		cmux->receive_buf_len += count;
+
+		/* Check if datalen reached */
+		if (cmux->frame.data_len == cmux->receive_buf_len) {
+			/* Await FCS */
+			cmux->receive_state = MODEM_CMUX_RECEIVE_STATE_FCS;
+		}
+
+		return count;
+
+	default:
+		return 0;
+	}
+}
+
+static void modem_cmux_process_received(struct modem_cmux *cmux, const uint8_t *data, size_t len)
+{
+	size_t count;
+
+	while (len > 0) {
+		count = modem_cmux_process_received_bulk(cmux, data, len);
+		if (count == 0) {
+			modem_cmux_process_received_byte(cmux, data[0]);
+			count = 1;
+		}
+
+		data += count;
+		len -= count;
+	}
+}
+
 static void modem_cmux_receive_handler(struct k_work *item)
 {
 	struct k_work_delayable *dwork = k_work_delayable_from_work(item);
@@ -905,9 +965,7 @@ static void modem_cmux_receive_handler(struct k_work *item)
 	}
 
 	/* Process received data */
-	for (int i = 0; i < ret; i++) {
-		modem_cmux_process_received_byte(cmux, cmux->work_buf[i]);
-	}
+	modem_cmux_process_received(cmux, cmux->work_buf, ret);
 
 	/* Reschedule received work */
 	k_work_schedule(&cmux->receive_work, K_NO_WAIT);
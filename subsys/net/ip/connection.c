@@ -59,10 +59,32 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+#if defined(CONFIG_NET_CONN_TABLE_SHARDS)
+#define CONN_SHARDS CONFIG_NET_CONN_TABLE_SHARDS
+#else
+#define CONN_SHARDS 1
+#endif
+
+/** Connections in use of a shard, and the lock that protects them */
+struct conn_list {
+	sys_slist_t conns;
+	struct k_mutex lock;
+};
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
 static sys_slist_t conn_unused;
-static sys_slist_t conn_used;
+
+/* The connections whose remote address and port are known are spread over
+ * the shards by a hash of their ports and remote address, so that a received
+ * packet only needs to walk one shard. All the other connections, such as the
+ * listening ones, are in the last list which is walked for every packet.
+ */
+#define CONN_LISTS (CONN_SHARDS > 1 ? CONN_SHARDS + 1 : 1)
+
+static struct conn_list conn_lists[CONN_LISTS];
+
+#define CONN_OTHERS (&conn_lists[CONN_LISTS - 1])
 
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
@@ -114,8 +136,117 @@ void conn_register_debug(struct net_conn *conn,
 #define conn_register_debug(...)
 #endif /* (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) */
 
+/* Protects the unused connections */
 static K_MUTEX_DEFINE(conn_lock);
 
+static uint32_t conn_hash(const uint8_t *remote_addr, size_t addr_len,
+			  uint16_t remote_port, uint16_t local_port)
+{
+	/* FNV-1a over the remote address, then the ports in network order */
+	uint32_t ports = ((uint32_t)remote_port << 16) | local_port;
+	uint32_t hash = 0x811c9dc5U;
+
+	for (size_t i = 0; i < addr_len; i++) {
+		hash = (hash ^ remote_addr[i]) * 0x01000193U;
+	}
+
+	hash = (hash ^ ports) * 0x01000193U;
+
+	return hash ^ (hash >> 16);
+}
+
+/* Get the list that holds the connection, which depends on its remote address
+ * and ports. Only TCP and UDP connections that can match a single remote
+ * endpoint are put in a shard.
+ */
+static struct conn_list *conn_list_get(struct net_conn *conn)
+{
+	const uint8_t spec = NET_CONN_REMOTE_ADDR_SPEC | NET_CONN_REMOTE_PORT_SPEC |
+			     NET_CONN_LOCAL_PORT_SPEC;
+	const uint8_t *addr;
+	size_t addr_len;
+	uint32_t hash;
+
+	if (CONN_SHARDS == 1 || (conn->flags & spec) != spec ||
+	    (conn->proto != IPPROTO_UDP && conn->proto != IPPROTO_TCP)) {
+		return CONN_OTHERS;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && conn->family == AF_INET &&
+	    conn->remote_addr.sa_family == AF_INET) {
+		addr = (const uint8_t *)&net_sin(&conn->remote_addr)->sin_addr;
+		addr_len = sizeof(struct in_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && conn->family == AF_INET6 &&
+		   conn->remote_addr.sa_family == AF_INET6 &&
+		   !net_ipv6_addr_is_v4_mapped(&net_sin6(&conn->remote_addr)->sin6_addr)) {
+		addr = (const uint8_t *)&net_sin6(&conn->remote_addr)->sin6_addr;
+		addr_len = sizeof(struct in6_addr);
+	} else {
+		/* The v4-mapped connections are matched by IPv4 packets */
+		return CONN_OTHERS;
+	}
+
+	hash = conn_hash(addr, addr_len, net_sin(&conn->remote_addr)->sin_port,
+			 net_sin(&conn->local_addr)->sin_port);
+
+	return &conn_lists[hash % CONN_SHARDS];
+}
+
+/* Get the lists that may hold the connections matching a received packet:
+ * the shard of its addresses and ports, and the other connections. Packets
+ * without ports may match any connection. The lists are returned in the order
+ * of the table.
+ */
+static size_t conn_input_lists(struct net_pkt *pkt, union net_ip_header *ip_hdr,
+			       uint8_t proto, uint16_t src_port, uint16_t dst_port,
+			       struct conn_list **lists)
+{
+	uint8_t pkt_family = net_pkt_family(pkt);
+	uint32_t hash;
+
+	if (CONN_SHARDS == 1) {
+		lists[0] = CONN_OTHERS;
+		return 1;
+	}
+
+	if ((proto != IPPROTO_UDP && proto != IPPROTO_TCP) ||
+	    (pkt_family != AF_INET && pkt_family != AF_INET6)) {
+		for (size_t i = 0; i < CONN_LISTS; i++) {
+			lists[i] = &conn_lists[i];
+		}
+
+		return CONN_LISTS;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && pkt_family == AF_INET) {
+		hash = conn_hash(ip_hdr->ipv4->src, sizeof(struct in_addr), src_port, dst_port);
+	} else {
+		hash = conn_hash(ip_hdr->ipv6->src, sizeof(struct in6_addr), src_port, dst_port);
+	}
+
+	lists[0] = &conn_lists[hash % CONN_SHARDS];
+	lists[1] = CONN_OTHERS;
+
+	return 2;
+}
+
+/* Several lists are always locked in the order of the table, so that a packet
+ * walking them and a connection moving between them cannot deadlock.
+ */
+static void conn_lists_lock(struct conn_list **lists, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		k_mutex_lock(&lists[i]->lock, K_FOREVER);
+	}
+}
+
+static void conn_lists_unlock(struct conn_list **lists, size_t count)
+{
+	for (size_t i = count; i > 0; i--) {
+		k_mutex_unlock(&lists[i - 1]->lock);
+	}
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -137,11 +268,15 @@ static struct net_conn *conn_get_unused(void)
 
 static void conn_set_used(struct net_conn *conn)
 {
+	struct conn_list *list;
+
 	conn->flags |= NET_CONN_IN_USE;
 
-	k_mutex_lock(&conn_lock, K_FOREVER);
-	sys_slist_prepend(&conn_used, &conn->node);
-	k_mutex_unlock(&conn_lock);
+	list = conn_list_get(conn);
+
+	k_mutex_lock(&list->lock, K_FOREVER);
+	sys_slist_prepend(&list->conns, &conn->node);
+	k_mutex_unlock(&list->lock);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -153,21 +288,21 @@ static void conn_set_unused(struct net_conn *conn)
 	k_mutex_unlock(&conn_lock);
 }
 
-/* Check if we already have identical connection handler installed. */
-static struct net_conn *conn_find_handler(struct net_if *iface,
-					  uint16_t proto, uint8_t family,
-					  const struct sockaddr *remote_addr,
-					  const struct sockaddr *local_addr,
-					  uint16_t remote_port,
-					  uint16_t local_port,
-					  bool reuseport_set)
+static struct net_conn *conn_list_find_handler(struct conn_list *list,
+					       struct net_if *iface,
+					       uint16_t proto, uint8_t family,
+					       const struct sockaddr *remote_addr,
+					       const struct sockaddr *local_addr,
+					       uint16_t remote_port,
+					       uint16_t local_port,
+					       bool reuseport_set)
 {
 	struct net_conn *conn;
 	struct net_conn *tmp;
 
-	k_mutex_lock(&conn_lock, K_FOREVER);
+	k_mutex_lock(&list->lock, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&list->conns, conn, tmp, node) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -260,11 +395,34 @@ static struct net_conn *conn_find_handler(struct net_if *iface,
 			}
 		}
 
-		k_mutex_unlock(&conn_lock);
+		k_mutex_unlock(&list->lock);
 		return conn;
 	}
 
-	k_mutex_unlock(&conn_lock);
+	k_mutex_unlock(&list->lock);
+	return NULL;
+}
+
+/* Check if we already have identical connection handler installed. */
+static struct net_conn *conn_find_handler(struct net_if *iface,
+					  uint16_t proto, uint8_t family,
+					  const struct sockaddr *remote_addr,
+					  const struct sockaddr *local_addr,
+					  uint16_t remote_port,
+					  uint16_t local_port,
+					  bool reuseport_set)
+{
+	struct net_conn *conn;
+
+	for (size_t i = 0; i < CONN_LISTS; i++) {
+		conn = conn_list_find_handler(&conn_lists[i], iface, proto, family,
+					      remote_addr, local_addr, remote_port,
+					      local_port, reuseport_set);
+		if (conn) {
+			return conn;
+		}
+	}
+
 	return NULL;
 }
 
@@ -439,6 +597,7 @@ error:
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
+	struct conn_list *list;
 
 	if (conn < &conns[0] || conn > &conns[CONFIG_NET_MAX_CONN]) {
 		return -EINVAL;
@@ -450,9 +609,11 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	NET_DBG("Connection handler %p removed", conn);
 
-	k_mutex_lock(&conn_lock, K_FOREVER);
-	sys_slist_find_and_remove(&conn_used, &conn->node);
-	k_mutex_unlock(&conn_lock);
+	list = conn_list_get(conn);
+
+	k_mutex_lock(&list->lock, K_FOREVER);
+	sys_slist_find_and_remove(&list->conns, &conn->node);
+	k_mutex_unlock(&list->lock);
 
 	conn_set_unused(conn);
 
@@ -466,6 +627,9 @@ int net_conn_update(struct net_conn_handle *handle,
 		    uint16_t remote_port)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
+	struct conn_list *lists[CONN_LISTS];
+	struct conn_list *old_list;
+	struct conn_list *new_list;
 	int ret;
 
 	if (conn < &conns[0] || conn > &conns[CONFIG_NET_MAX_CONN]) {
@@ -476,10 +640,31 @@ int net_conn_update(struct net_conn_handle *handle,
 		return -ENOENT;
 	}
 
+	/* A new remote may move the connection to another shard, which is only
+	 * known once the remote is changed. All the lists are locked meanwhile.
+	 * As net_conn_input() holds all the lists it walks at once, a packet
+	 * finds the connection either in its old list or in its new one.
+	 */
+	for (size_t i = 0; i < CONN_LISTS; i++) {
+		lists[i] = &conn_lists[i];
+	}
+
+	conn_lists_lock(lists, CONN_LISTS);
+
+	old_list = conn_list_get(conn);
+
 	net_conn_change_callback(conn, cb, user_data);
 
 	ret = net_conn_change_remote(conn, remote_addr, remote_port);
 
+	new_list = conn_list_get(conn);
+	if (new_list != old_list) {
+		sys_slist_find_and_remove(&old_list->conns, &conn->node);
+		sys_slist_prepend(&new_list->conns, &conn->node);
+	}
+
+	conn_lists_unlock(lists, CONN_LISTS);
+
 	return ret;
 }
 
@@ -689,6 +874,8 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	struct net_conn *conn;
+	struct conn_list *lists[CONN_LISTS];
+	size_t list_count;
 	net_conn_cb_t cb = NULL;
 	void *user_data = NULL;
 
@@ -708,182 +895,194 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	k_mutex_lock(&conn_lock, K_FOREVER);
+	list_count = conn_input_lists(pkt, ip_hdr, proto, src_port, dst_port, lists);
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
-		/* Is the candidate connection matching the packet's interface? */
-		if (conn->context != NULL &&
-		    net_context_is_bound_to_iface(conn->context) &&
-		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
-			continue; /* wrong interface */
-		}
+	/* The lists are held together, a connection moved by net_conn_update()
+	 * between two of them is then not missed.
+	 */
+	conn_lists_lock(lists, list_count);
+
+	for (size_t i = 0; i < list_count; i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&lists[i]->conns, conn, node) {
+			/* Is the candidate connection matching the packet's interface? */
+			if (conn->context != NULL &&
+			    net_context_is_bound_to_iface(conn->context) &&
+			    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
+				continue; /* wrong interface */
+			}
 
-		/* Is the candidate connection matching the packet's protocol family? */
-		if (conn->family != AF_UNSPEC &&
-		    conn->family != pkt_family) {
-			if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
-				/* If there are other listening connections than
-				 * AF_PACKET, the packet shall be also passed back to
-				 * net_conn_input() in upper layer processing in order to
-				 * re-check if there is any listening socket interested
-				 * in this packet.
-				 */
-				if (conn->family != AF_PACKET) {
-					raw_pkt_continue = true;
+			/* Is the candidate connection matching the packet's protocol family? */
+			if (conn->family != AF_UNSPEC &&
+			    conn->family != pkt_family) {
+				if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
+					/* If there are other listening connections than
+					 * AF_PACKET, the packet shall be also passed back to
+					 * net_conn_input() in upper layer processing in order to
+					 * re-check if there is any listening socket interested
+					 * in this packet.
+					 */
+					if (conn->family != AF_PACKET) {
+						raw_pkt_continue = true;
+					}
 				}
-			}
 
-			if (IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6)) {
-				if (!(conn->family == AF_INET6 && pkt_family == AF_INET &&
-				      !conn->v6only)) {
-					continue;
+				if (IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6)) {
+					if (!(conn->family == AF_INET6 && pkt_family == AF_INET &&
+					      !conn->v6only)) {
+						continue;
+					}
+				} else {
+					continue; /* wrong protocol family */
 				}
-			} else {
-				continue; /* wrong protocol family */
-			}
 
-			/* We might have a match for v4-to-v6 mapping, check more */
-		}
+				/* We might have a match for v4-to-v6 mapping, check more */
+			}
 
-		/* Is the candidate connection matching the packet's protocol within the family? */
-		if (conn->proto != proto) {
-			/* For packet socket data, the proto is set to ETH_P_ALL
-			 * or IPPROTO_RAW but the listener might have a specific
-			 * protocol set. This is ok and let the packet pass this
-			 * check in this case.
+			/* Is the candidate connection matching the packet's protocol
+			 * within the family?
 			 */
-			if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) && pkt_family == AF_PACKET) {
-				if (proto != ETH_P_ALL && proto != IPPROTO_RAW) {
+			if (conn->proto != proto) {
+				/* For packet socket data, the proto is set to ETH_P_ALL
+				 * or IPPROTO_RAW but the listener might have a specific
+				 * protocol set. This is ok and let the packet pass this
+				 * check in this case.
+				 */
+				if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
+				    pkt_family == AF_PACKET) {
+					if (proto != ETH_P_ALL && proto != IPPROTO_RAW) {
+						continue; /* wrong protocol */
+					}
+				} else {
 					continue; /* wrong protocol */
 				}
-			} else {
-				continue; /* wrong protocol */
 			}
-		}
-
-		/* Apply protocol-specific matching criteria... */
-		uint8_t conn_family = conn->family;
-
-		if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) && conn_family == AF_PACKET) {
-			/* This code shall be only executed when one enters
-			 * the net_conn_input() from net_packet_socket() which
-			 * targets AF_PACKET sockets.
-			 *
-			 * All AF_PACKET connections will receive the packet if
-			 * their socket type and - in case of IPPROTO - protocol
-			 * also matches.
-			 */
-			if (proto == ETH_P_ALL) {
-				/* We shall continue with ETH_P_ALL to IPPROTO_RAW: */
-				raw_pkt_continue = true;
-			}
-
-			/* With IPPROTO_RAW deliver only if protocol match: */
-			if ((proto == ETH_P_ALL && conn->proto != IPPROTO_RAW) ||
-			    conn->proto == proto) {
-				enum net_verdict ret = conn_raw_socket(pkt, conn, proto);
 
-				if (ret == NET_DROP) {
-					k_mutex_unlock(&conn_lock);
-					goto drop;
-				} else if (ret == NET_OK) {
-					raw_pkt_delivered = true;
+			/* Apply protocol-specific matching criteria... */
+			uint8_t conn_family = conn->family;
+
+			if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) && conn_family == AF_PACKET) {
+				/* This code shall be only executed when one enters
+				 * the net_conn_input() from net_packet_socket() which
+				 * targets AF_PACKET sockets.
+				 *
+				 * All AF_PACKET connections will receive the packet if
+				 * their socket type and - in case of IPPROTO - protocol
+				 * also matches.
+				 */
+				if (proto == ETH_P_ALL) {
+					/* We shall continue with ETH_P_ALL to IPPROTO_RAW: */
+					raw_pkt_continue = true;
 				}
 
-				continue; /* packet was consumed */
-			}
-		} else if ((IS_ENABLED(CONFIG_NET_UDP) || IS_ENABLED(CONFIG_NET_TCP)) &&
-			   (conn_family == AF_INET || conn_family == AF_INET6 ||
-			    conn_family == AF_UNSPEC)) {
-			/* Is the candidate connection matching the packet's TCP/UDP
-			 * address and port?
-			 */
-			if (net_sin(&conn->remote_addr)->sin_port &&
-			    net_sin(&conn->remote_addr)->sin_port != src_port) {
-				continue; /* wrong remote port */
-			}
+				/* With IPPROTO_RAW deliver only if protocol match: */
+				if ((proto == ETH_P_ALL && conn->proto != IPPROTO_RAW) ||
+				    conn->proto == proto) {
+					enum net_verdict ret = conn_raw_socket(pkt, conn, proto);
 
-			if (net_sin(&conn->local_addr)->sin_port &&
-			    net_sin(&conn->local_addr)->sin_port != dst_port) {
-				continue; /* wrong local port */
-			}
+					if (ret == NET_DROP) {
+						conn_lists_unlock(lists, list_count);
+						goto drop;
+					} else if (ret == NET_OK) {
+						raw_pkt_delivered = true;
+					}
 
-			if ((conn->flags & NET_CONN_REMOTE_ADDR_SET) &&
-			    !conn_addr_cmp(pkt, ip_hdr, &conn->remote_addr, true)) {
-				continue; /* wrong remote address */
-			}
+					continue; /* packet was consumed */
+				}
+			} else if ((IS_ENABLED(CONFIG_NET_UDP) || IS_ENABLED(CONFIG_NET_TCP)) &&
+				   (conn_family == AF_INET || conn_family == AF_INET6 ||
+				    conn_family == AF_UNSPEC)) {
+				/* Is the candidate connection matching the packet's TCP/UDP
+				 * address and port?
+				 */
+				if (net_sin(&conn->remote_addr)->sin_port &&
+				    net_sin(&conn->remote_addr)->sin_port != src_port) {
+					continue; /* wrong remote port */
+				}
 
-			if ((conn->flags & NET_CONN_LOCAL_ADDR_SET) &&
-			    !conn_addr_cmp(pkt, ip_hdr, &conn->local_addr, false)) {
+				if (net_sin(&conn->local_addr)->sin_port &&
+				    net_sin(&conn->local_addr)->sin_port != dst_port) {
+					continue; /* wrong local port */
+				}
 
-				/* Check if we could do a v4-mapping-to-v6 and the IPv6 socket
-				 * has no IPV6_V6ONLY option set and if the local IPV6 address
-				 * is unspecified, then we could accept a connection from IPv4
-				 * address by mapping it to IPv6 address.
-				 */
-				if (IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6)) {
-					if (!(conn->family == AF_INET6 && pkt_family == AF_INET &&
-					      !conn->v6only &&
-					      net_ipv6_is_addr_unspecified(
-						      &net_sin6(&conn->local_addr)->sin6_addr))) {
+				if ((conn->flags & NET_CONN_REMOTE_ADDR_SET) &&
+				    !conn_addr_cmp(pkt, ip_hdr, &conn->remote_addr, true)) {
+					continue; /* wrong remote address */
+				}
+
+				if ((conn->flags & NET_CONN_LOCAL_ADDR_SET) &&
+				    !conn_addr_cmp(pkt, ip_hdr, &conn->local_addr, false)) {
+
+					/* Check if we could do a v4-mapping-to-v6 and the IPv6
+					 * socket has no IPV6_V6ONLY option set and if the local
+					 * IPV6 address is unspecified, then we could accept a
+					 * connection from IPv4 address by mapping it to IPv6
+					 * address.
+					 */
+					if (IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6)) {
+						if (!(conn->family == AF_INET6 &&
+						      pkt_family == AF_INET && !conn->v6only &&
+						      net_ipv6_is_addr_unspecified(
+							&net_sin6(&conn->local_addr)->sin6_addr))) {
+							continue; /* wrong local address */
+						}
+					} else {
 						continue; /* wrong local address */
 					}
-				} else {
-					continue; /* wrong local address */
+
+					/* We might have a match for v4-to-v6 mapping,
+					 * continue with rank checking.
+					 */
 				}
 
-				/* We might have a match for v4-to-v6 mapping,
-				 * continue with rank checking.
-				 */
-			}
+				if (best_rank < NET_CONN_RANK(conn->flags)) {
+					struct net_pkt *mcast_pkt;
 
-			if (best_rank < NET_CONN_RANK(conn->flags)) {
-				struct net_pkt *mcast_pkt;
+					if (!is_mcast_pkt) {
+						best_rank = NET_CONN_RANK(conn->flags);
+						best_match = conn;
+						cb = conn->cb;
+						user_data = conn->user_data;
 
-				if (!is_mcast_pkt) {
-					best_rank = NET_CONN_RANK(conn->flags);
-					best_match = conn;
+						/* found a match - but maybe not yet the best */
+						continue;
+					}
 
-					continue; /* found a match - but maybe not yet the best */
-				}
+					/* If we have a multicast packet, and we found
+					 * a match, then deliver the packet immediately
+					 * to the handler. As there might be several
+					 * sockets interested about these, we need to
+					 * clone the received pkt.
+					 */
 
-				/* If we have a multicast packet, and we found
-				 * a match, then deliver the packet immediately
-				 * to the handler. As there might be several
-				 * sockets interested about these, we need to
-				 * clone the received pkt.
-				 */
+					NET_DBG("[%p] mcast match found cb %p ud %p", conn,
+						conn->cb, conn->user_data);
 
-				NET_DBG("[%p] mcast match found cb %p ud %p", conn, conn->cb,
-					conn->user_data);
+					mcast_pkt = net_pkt_clone(pkt, CLONE_TIMEOUT);
+					if (!mcast_pkt) {
+						conn_lists_unlock(lists, list_count);
+						goto drop;
+					}
 
-				mcast_pkt = net_pkt_clone(pkt, CLONE_TIMEOUT);
-				if (!mcast_pkt) {
-					k_mutex_unlock(&conn_lock);
-					goto drop;
-				}
+					if (conn->cb(conn, mcast_pkt, ip_hdr, proto_hdr,
+						     conn->user_data) == NET_DROP) {
+						net_stats_update_per_proto_drop(pkt_iface,
+										proto);
+						net_pkt_unref(mcast_pkt);
+					} else {
+						net_stats_update_per_proto_recv(pkt_iface, proto);
+					}
 
-				if (conn->cb(conn, mcast_pkt, ip_hdr, proto_hdr, conn->user_data) ==
-				    NET_DROP) {
-					net_stats_update_per_proto_drop(pkt_iface, proto);
-					net_pkt_unref(mcast_pkt);
-				} else {
-					net_stats_update_per_proto_recv(pkt_iface, proto);
+					mcast_pkt_delivered = true;
 				}
-
-				mcast_pkt_delivered = true;
+			} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) && conn_family == AF_CAN) {
+				best_match = conn;
+				cb = conn->cb;
+				user_data = conn->user_data;
 			}
-		} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) && conn_family == AF_CAN) {
-			best_match = conn;
-		}
-	} /* loop end */
-
-	if (best_match) {
-		cb = best_match->cb;
-		user_data = best_match->user_data;
+		} /* loop end */
 	}
 
-	k_mutex_unlock(&conn_lock);
+	conn_lists_unlock(lists, list_count);
 
 	if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) && pkt_family == AF_PACKET) {
 		if (raw_pkt_continue) {
@@ -949,13 +1148,15 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 {
 	struct net_conn *conn;
 
-	k_mutex_lock(&conn_lock, K_FOREVER);
+	for (size_t i = 0; i < CONN_LISTS; i++) {
+		k_mutex_lock(&conn_lists[i].lock, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
-		cb(conn, user_data);
-	}
+		SYS_SLIST_FOR_EACH_CONTAINER(&conn_lists[i].conns, conn, node) {
+			cb(conn, user_data);
+		}
 
-	k_mutex_unlock(&conn_lock);
+		k_mutex_unlock(&conn_lists[i].lock);
+	}
 }
 
 void net_conn_init(void)
@@ -963,7 +1164,11 @@ void net_conn_init(void)
 	int i;
 
 	sys_slist_init(&conn_unused);
-	sys_slist_init(&conn_used);
+
+	for (i = 0; i < CONN_LISTS; i++) {
+		sys_slist_init(&conn_lists[i].conns);
+		k_mutex_init(&conn_lists[i].lock);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
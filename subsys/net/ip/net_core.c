@@ -463,6 +463,114 @@ void net_process_rx_packet(struct net_pkt *pkt)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+#define RX_FLOW_HDR_LEN 64
+
+static uint32_t rx_flow_hash_bytes(uint32_t hash, const uint8_t *data, size_t len)
+{
+	/* FNV-1a */
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * 0x01000193U;
+	}
+
+	return hash;
+}
+
+/* The L2s whose frames start with an Ethernet or an IP header */
+static bool rx_flow_l2_parsed(struct net_if *iface)
+{
+	const struct net_l2 *l2 = net_if_l2(iface);
+
+	return (IS_ENABLED(CONFIG_NET_L2_ETHERNET) && l2 == &NET_L2_GET_NAME(ETHERNET)) ||
+	       (IS_ENABLED(CONFIG_NET_L2_DUMMY) && l2 == &NET_L2_GET_NAME(DUMMY)) ||
+	       (IS_ENABLED(CONFIG_NET_L2_VIRTUAL) && l2 == &NET_L2_GET_NAME(VIRTUAL)) ||
+	       (IS_ENABLED(CONFIG_NET_L2_OPENTHREAD) && l2 == &NET_L2_GET_NAME(OPENTHREAD));
+}
+
+/* Hash the addresses, the protocol and the ports of a received packet, so
+ * that the packets of a flow are always handled by the same RX flow queue.
+ * The packets that cannot be parsed here are only hashed over their Ethernet
+ * header, and all the frames of the other L2s get the same hash, as their
+ * headers may change from one frame of a flow to the next.
+ */
+static uint32_t rx_flow_hash(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_pkt_cursor backup;
+	uint8_t hdr[RX_FLOW_HDR_LEN];
+	size_t len = MIN(net_pkt_get_len(pkt), sizeof(hdr));
+	uint32_t hash = 0x811c9dc5U;
+	size_t offset = 0;
+	int ret;
+
+	if (!rx_flow_l2_parsed(iface)) {
+		return 0;
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+	ret = net_pkt_read(pkt, hdr, len);
+	net_pkt_cursor_restore(pkt, &backup);
+
+	if (ret < 0) {
+		return 0;
+	}
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		uint16_t type;
+
+		offset = sizeof(struct net_eth_hdr);
+		if (len < offset) {
+			return 0;
+		}
+
+		type = sys_get_be16(&hdr[offset - sizeof(uint16_t)]);
+		if (type == NET_ETH_PTYPE_VLAN && len >= offset + 4U) {
+			type = sys_get_be16(&hdr[offset + 2]);
+			offset += 4U;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return rx_flow_hash_bytes(hash, hdr, offset);
+		}
+	}
+#endif
+
+	if (len > offset && (hdr[offset] & 0xf0) == 0x40 &&
+	    len >= offset + sizeof(struct net_ipv4_hdr)) {
+		struct net_ipv4_hdr *hdr4 = (struct net_ipv4_hdr *)&hdr[offset];
+		size_t hdr_len = (hdr4->vhl & NET_IPV4_IHL_MASK) * 4U;
+
+		hash = rx_flow_hash_bytes(hash, &hdr4->proto, sizeof(hdr4->proto));
+		hash = rx_flow_hash_bytes(hash, hdr4->src, 2 * sizeof(struct in_addr));
+
+		/* The fragments are kept together, so the ports are not used */
+		if ((hdr4->proto == IPPROTO_TCP || hdr4->proto == IPPROTO_UDP) &&
+		    (sys_get_be16(hdr4->offset) &
+		     (NET_IPV4_MORE_FRAG_MASK | NET_IPV4_FRAGH_OFFSET_MASK)) == 0 &&
+		    len >= offset + hdr_len + 4U) {
+			hash = rx_flow_hash_bytes(hash, &hdr[offset + hdr_len], 4U);
+		}
+	} else if (len > offset && (hdr[offset] & 0xf0) == 0x60 &&
+		   len >= offset + sizeof(struct net_ipv6_hdr)) {
+		struct net_ipv6_hdr *hdr6 = (struct net_ipv6_hdr *)&hdr[offset];
+
+		hash = rx_flow_hash_bytes(hash, &hdr6->nexthdr, sizeof(hdr6->nexthdr));
+		hash = rx_flow_hash_bytes(hash, hdr6->src, 2 * sizeof(struct in6_addr));
+
+		/* The ports are only looked for right after the fixed header */
+		if ((hdr6->nexthdr == IPPROTO_TCP || hdr6->nexthdr == IPPROTO_UDP) &&
+		    len >= offset + sizeof(struct net_ipv6_hdr) + 4U) {
+			hash = rx_flow_hash_bytes(hash, &hdr[offset + sizeof(struct net_ipv6_hdr)],
+						  4U);
+		}
+	} else {
+		hash = rx_flow_hash_bytes(hash, hdr, offset);
+	}
+
+	return hash ^ (hash >> 16);
+}
+#endif /* CONFIG_NET_RX_FLOW_STEERING */
+
 static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
@@ -480,6 +588,10 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 
 	if (NET_TC_RX_COUNT == 0) {
 		net_process_rx_packet(pkt);
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+	} else if (tc == 0) {
+		net_tc_submit_to_rx_flow_queue(rx_flow_hash(iface, pkt), pkt);
+#endif
 	} else {
 		net_tc_submit_to_rx_queue(tc, pkt);
 	}
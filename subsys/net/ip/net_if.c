@@ -1040,6 +1040,28 @@ void net_if_mcast_monitor(struct net_if *iface,
 #endif /* CONFIG_NET_NATIVE_IPV4 || CONFIG_NET_NATIVE_IPV6 */
 
 #if defined(CONFIG_NET_IPV6)
+/* A configuration that is put back keeps its addresses, they are indexed
+ * again if it is given to an interface.
+ */
+static void ipv6_addr_index_update(struct net_if *iface, struct net_if_ipv6 *ipv6, bool add)
+{
+	if (!IS_ENABLED(CONFIG_NET_IF_ADDR_INDEX)) {
+		return;
+	}
+
+	ARRAY_FOR_EACH(ipv6->unicast, i) {
+		if (!ipv6->unicast[i].is_used) {
+			continue;
+		}
+
+		if (add) {
+			net_if_addr_index_add(iface, &ipv6->unicast[i]);
+		} else {
+			net_if_addr_index_remove(&ipv6->unicast[i]);
+		}
+	}
+}
+
 int net_if_config_ipv6_get(struct net_if *iface, struct net_if_ipv6 **ipv6)
 {
 	int ret = 0;
@@ -1070,6 +1092,8 @@ int net_if_config_ipv6_get(struct net_if *iface, struct net_if_ipv6 **ipv6)
 		iface->config.ip.ipv6 = &ipv6_addresses[i].ipv6;
 		ipv6_addresses[i].iface = iface;
 
+		ipv6_addr_index_update(iface, iface->config.ip.ipv6, true);
+
 		if (ipv6) {
 			*ipv6 = &ipv6_addresses[i].ipv6;
 		}
@@ -1111,6 +1135,8 @@ int net_if_config_ipv6_put(struct net_if *iface)
 			continue;
 		}
 
+		ipv6_addr_index_update(iface, iface->config.ip.ipv6, false);
+
 		iface->config.ip.ipv6 = NULL;
 		ipv6_addresses[i].iface = NULL;
 
@@ -1765,6 +1791,12 @@ struct net_if_addr *net_if_ipv6_addr_lookup(const struct in6_addr *addr,
 					    struct net_if **ret)
 {
 	struct net_if_addr *ifaddr = NULL;
+	int err;
+
+	err = net_if_addr_index_lookup(AF_INET6, addr, ret, &ifaddr);
+	if (err != -EAGAIN) {
+		return ifaddr;
+	}
 
 	STRUCT_SECTION_FOREACH(net_if, iface) {
 		struct net_if_ipv6 *ipv6;
@@ -1956,6 +1988,8 @@ struct net_if_addr *net_if_ipv6_addr_add(struct net_if *iface,
 		net_if_addr_init(&ipv6->unicast[i], addr, addr_type,
 				 vlifetime);
 
+		net_if_addr_index_add(iface, &ipv6->unicast[i]);
+
 		NET_DBG("[%zu] interface %d (%p) address %s type %s added", i,
 			net_if_get_by_iface(iface), iface,
 			net_sprint_ipv6_addr(addr),
@@ -3328,6 +3362,28 @@ struct in6_addr *net_if_ipv6_get_global_addr(enum net_addr_state state,
 #endif /* !CONFIG_NET_NATIVE_IPV4 */
 
 #if defined(CONFIG_NET_IPV4)
+/* A configuration that is put back keeps its addresses, they are indexed
+ * again if it is given to an interface.
+ */
+static void ipv4_addr_index_update(struct net_if *iface, struct net_if_ipv4 *ipv4, bool add)
+{
+	if (!IS_ENABLED(CONFIG_NET_IF_ADDR_INDEX)) {
+		return;
+	}
+
+	ARRAY_FOR_EACH(ipv4->unicast, i) {
+		if (!ipv4->unicast[i].ipv4.is_used) {
+			continue;
+		}
+
+		if (add) {
+			net_if_addr_index_add(iface, &ipv4->unicast[i].ipv4);
+		} else {
+			net_if_addr_index_remove(&ipv4->unicast[i].ipv4);
+		}
+	}
+}
+
 int net_if_config_ipv4_get(struct net_if *iface, struct net_if_ipv4 **ipv4)
 {
 	int ret = 0;
@@ -3357,6 +3413,8 @@ int net_if_config_ipv4_get(struct net_if *iface, struct net_if_ipv4 **ipv4)
 		iface->config.ip.ipv4 = &ipv4_addresses[i].ipv4;
 		ipv4_addresses[i].iface = iface;
 
+		ipv4_addr_index_update(iface, iface->config.ip.ipv4, true);
+
 		if (ipv4) {
 			*ipv4 = &ipv4_addresses[i].ipv4;
 		}
@@ -3397,6 +3455,8 @@ int net_if_config_ipv4_put(struct net_if *iface)
 			continue;
 		}
 
+		ipv4_addr_index_update(iface, iface->config.ip.ipv4, false);
+
 		iface->config.ip.ipv4 = NULL;
 		ipv4_addresses[i].iface = NULL;
 
@@ -3707,6 +3767,12 @@ struct net_if_addr *net_if_ipv4_addr_lookup(const struct in_addr *addr,
 					    struct net_if **ret)
 {
 	struct net_if_addr *ifaddr = NULL;
+	int err;
+
+	err = net_if_addr_index_lookup(AF_INET, addr, ret, &ifaddr);
+	if (err != -EAGAIN) {
+		return ifaddr;
+	}
 
 	STRUCT_SECTION_FOREACH(net_if, iface) {
 		struct net_if_ipv4 *ipv4;
@@ -4250,6 +4316,11 @@ struct net_if_addr *net_if_ipv4_addr_add(struct net_if *iface,
 	}
 
 	if (ifaddr) {
+		if (ifaddr->is_used) {
+			/* An overridable address is replaced */
+			net_if_addr_index_remove(ifaddr);
+		}
+
 		ifaddr->is_used = true;
 		ifaddr->address.family = AF_INET;
 		ifaddr->address.in_addr.s4_addr32[0] =
@@ -4257,6 +4328,8 @@ struct net_if_addr *net_if_ipv4_addr_add(struct net_if *iface,
 		ifaddr->addr_type = addr_type;
 		ifaddr->atomic_ref = ATOMIC_INIT(1);
 
+		net_if_addr_index_add(iface, ifaddr);
+
 		/* Caller has to take care of timers and their expiry */
 		if (vlifetime) {
 			ifaddr->is_infinite = false;
@@ -5111,6 +5184,8 @@ int net_if_addr_unref(struct net_if *iface,
 
 	ifaddr->is_used = false;
 
+	net_if_addr_index_remove(ifaddr);
+
 	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6 && addr != NULL) {
 		remove_ipv6_ifaddr(iface, ifaddr, maddr_count);
 	}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Hashed index of the unicast addresses of all the network interfaces.
+ *
+ * The index is an open addressing hash table with linear probing. Its
+ * entries point to the address slots of the interfaces, which are never
+ * freed, so a reader may always dereference them. The updates are
+ * serialized by a spinlock and make a sequence counter odd while they run.
+ * The readers do not lock anything: they check that the counter was even
+ * and did not change during the lookup, otherwise they tell the caller to
+ * fall back to walking the interfaces. They also do so while some addresses
+ * do not fit in the index.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_if, CONFIG_NET_IF_LOG_LEVEL);
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+
+#include "net_private.h"
+
+#define INDEX_SIZE CONFIG_NET_IF_ADDR_INDEX_SIZE
+
+struct addr_index_entry {
+	struct net_if *iface;
+	struct net_if_addr *ifaddr;
+	uint32_t hash;
+};
+
+static struct addr_index_entry addr_index[INDEX_SIZE];
+
+/* Odd while the index is being updated */
+static atomic_t addr_index_seq;
+
+/* Number of addresses that did not fit in the index */
+static atomic_t addr_index_overflow;
+
+static struct k_spinlock addr_index_lock;
+
+static uint32_t addr_hash(sa_family_t family, const void *addr)
+{
+	const uint8_t *bytes = addr;
+	size_t len = family == AF_INET6 ? sizeof(struct in6_addr) : sizeof(struct in_addr);
+	uint32_t hash = 0;
+
+	/* Fold the address in 32-bit words, then mix the result so that the
+	 * addresses differing only by their last bits use distant slots.
+	 */
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		hash ^= sys_get_le32(&bytes[i]);
+		hash *= 0x9e3779b1U;
+	}
+
+	return hash ^ (hash >> 16);
+}
+
+static bool addr_match(const struct net_if_addr *ifaddr, sa_family_t family, const void *addr)
+{
+	if (ifaddr->address.family != family) {
+		return false;
+	}
+
+	if (family == AF_INET6) {
+		return net_ipv6_addr_cmp_raw(ifaddr->address.in6_addr.s6_addr, addr);
+	}
+
+	return net_ipv4_addr_cmp_raw(ifaddr->address.in_addr.s4_addr, addr);
+}
+
+static uint32_t ifaddr_hash(const struct net_if_addr *ifaddr)
+{
+	/* Both address types start at the same place */
+	return addr_hash(ifaddr->address.family, &ifaddr->address.in_addr);
+}
+
+static void index_update_start(void)
+{
+	atomic_inc(&addr_index_seq);
+	barrier_dmem_fence_full();
+}
+
+static void index_update_end(void)
+{
+	barrier_dmem_fence_full();
+	atomic_inc(&addr_index_seq);
+}
+
+static void index_remove_slot(size_t slot)
+{
+	size_t hole = slot;
+	size_t i = slot;
+
+	/* Shift back the entries of the probe sequence, so that no tombstone
+	 * is needed. A full index has no empty slot to stop at.
+	 */
+	for (size_t n = 1; n < INDEX_SIZE; n++) {
+		size_t home;
+
+		i = (i + 1) % INDEX_SIZE;
+		if (addr_index[i].ifaddr == NULL) {
+			break;
+		}
+
+		home = addr_index[i].hash % INDEX_SIZE;
+
+		if (hole <= i ? (hole < home && home <= i) : (hole < home || home <= i)) {
+			continue;
+		}
+
+		addr_index[hole] = addr_index[i];
+		hole = i;
+	}
+
+	addr_index[hole].ifaddr = NULL;
+	addr_index[hole].iface = NULL;
+}
+
+void net_if_addr_index_add(struct net_if *iface, struct net_if_addr *ifaddr)
+{
+	uint32_t hash = ifaddr_hash(ifaddr);
+	k_spinlock_key_t key;
+	size_t slot;
+
+	key = k_spin_lock(&addr_index_lock);
+
+	for (size_t i = 0; i < INDEX_SIZE; i++) {
+		slot = (hash + i) % INDEX_SIZE;
+
+		if (addr_index[slot].ifaddr == ifaddr) {
+			goto out;
+		}
+
+		if (addr_index[slot].ifaddr == NULL) {
+			index_update_start();
+			addr_index[slot].iface = iface;
+			addr_index[slot].hash = hash;
+			addr_index[slot].ifaddr = ifaddr;
+			index_update_end();
+			goto out;
+		}
+	}
+
+	NET_DBG("Address index full, lookups walk the interfaces");
+	atomic_inc(&addr_index_overflow);
+
+out:
+	k_spin_unlock(&addr_index_lock, key);
+}
+
+void net_if_addr_index_remove(struct net_if_addr *ifaddr)
+{
+	uint32_t hash = ifaddr_hash(ifaddr);
+	k_spinlock_key_t key;
+	size_t slot;
+
+	key = k_spin_lock(&addr_index_lock);
+
+	for (size_t i = 0; i < INDEX_SIZE; i++) {
+		slot = (hash + i) % INDEX_SIZE;
+
+		if (addr_index[slot].ifaddr == NULL) {
+			break;
+		}
+
+		if (addr_index[slot].ifaddr == ifaddr) {
+			index_update_start();
+			index_remove_slot(slot);
+			index_update_end();
+			goto out;
+		}
+	}
+
+	/* Not indexed, so it was one of the addresses that did not fit */
+	if (atomic_get(&addr_index_overflow) > 0) {
+		atomic_dec(&addr_index_overflow);
+	}
+
+out:
+	k_spin_unlock(&addr_index_lock, key);
+}
+
+int net_if_addr_index_lookup(sa_family_t family, const void *addr,
+			     struct net_if **iface, struct net_if_addr **ifaddr)
+{
+	uint32_t hash = addr_hash(family, addr);
+	struct net_if_addr *found = NULL;
+	struct net_if *found_iface = NULL;
+	atomic_val_t seq;
+
+	/* Some addresses may only be found by walking the interfaces, and they
+	 * could be set on an interface that comes before the indexed one.
+	 */
+	if (atomic_get(&addr_index_overflow) > 0) {
+		return -EAGAIN;
+	}
+
+	seq = atomic_get(&addr_index_seq);
+	if (seq & 1) {
+		return -EAGAIN;
+	}
+
+	barrier_dmem_fence_full();
+
+	for (size_t i = 0; i < INDEX_SIZE; i++) {
+		size_t slot = (hash + i) % INDEX_SIZE;
+		struct net_if_addr *cur = addr_index[slot].ifaddr;
+
+		if (cur == NULL) {
+			break;
+		}
+
+		if (addr_index[slot].hash != hash || !cur->is_used ||
+		    !addr_match(cur, family, addr)) {
+			continue;
+		}
+
+		/* The same address may be set on several interfaces, return
+		 * the first one like a walk of the interfaces would.
+		 */
+		if (found == NULL || addr_index[slot].iface < found_iface) {
+			found = cur;
+			found_iface = addr_index[slot].iface;
+		}
+	}
+
+	barrier_dmem_fence_full();
+
+	if (atomic_get(&addr_index_seq) != seq) {
+		return -EAGAIN;
+	}
+
+	if (found == NULL) {
+		return -ENOENT;
+	}
+
+	*ifaddr = found;
+
+	if (iface != NULL) {
+		*iface = found_iface;
+	}
+
+	return 0;
+}
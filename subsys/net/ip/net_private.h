@@ -171,8 +171,43 @@ static inline void net_tc_rx_init(void) { }
 #endif
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+extern void net_tc_submit_to_rx_flow_queue(uint32_t hash, struct net_pkt *pkt);
+#endif
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
+#if defined(CONFIG_NET_IF_ADDR_INDEX)
+extern void net_if_addr_index_add(struct net_if *iface, struct net_if_addr *ifaddr);
+extern void net_if_addr_index_remove(struct net_if_addr *ifaddr);
+/* Returns -ENOENT if the address is not set on any interface, -EAGAIN if
+ * the caller needs to walk the interfaces to know.
+ */
+extern int net_if_addr_index_lookup(sa_family_t family, const void *addr,
+				    struct net_if **iface, struct net_if_addr **ifaddr);
+#else
+static inline void net_if_addr_index_add(struct net_if *iface, struct net_if_addr *ifaddr)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(ifaddr);
+}
+
+static inline void net_if_addr_index_remove(struct net_if_addr *ifaddr)
+{
+	ARG_UNUSED(ifaddr);
+}
+
+static inline int net_if_addr_index_lookup(sa_family_t family, const void *addr,
+					   struct net_if **iface, struct net_if_addr **ifaddr)
+{
+	ARG_UNUSED(family);
+	ARG_UNUSED(addr);
+	ARG_UNUSED(iface);
+	ARG_UNUSED(ifaddr);
+
+	return -EAGAIN;
+}
+#endif
+
 char *net_sprint_addr(sa_family_t af, const void *addr);
 
 #define net_sprint_ipv4_addr(_addr) net_sprint_addr(AF_INET, _addr)
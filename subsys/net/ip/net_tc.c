@@ -28,8 +28,16 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
 			    CONFIG_NET_TX_STACK_SIZE);
 
-/* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+/* Stacks for RX work queue. The lowest traffic class has no thread of its
+ * own when the RX flow queues handle it.
+ */
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+#define RX_STACK_FIRST_TC 1
+#else
+#define RX_STACK_FIRST_TC 0
+#endif
+
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT - RX_STACK_FIRST_TC,
 			    CONFIG_NET_RX_STACK_SIZE);
 
 #if NET_TC_TX_COUNT > 0
@@ -40,6 +48,16 @@ static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
 static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
 #endif
 
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+/* Stacks for the RX flow queues, which replace the queue of the lowest
+ * traffic class.
+ */
+K_KERNEL_STACK_ARRAY_DEFINE(rx_flow_stack, CONFIG_NET_RX_FLOW_QUEUE_COUNT,
+			    CONFIG_NET_RX_STACK_SIZE);
+
+static struct net_traffic_class rx_flows[CONFIG_NET_RX_FLOW_QUEUE_COUNT];
+#endif
+
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
 static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 {
@@ -72,6 +90,15 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #endif
 }
 
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+void net_tc_submit_to_rx_flow_queue(uint32_t hash, struct net_pkt *pkt)
+{
+	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+
+	submit_to_queue(&rx_flows[hash % CONFIG_NET_RX_FLOW_QUEUE_COUNT].fifo, pkt);
+}
+#endif
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -359,6 +386,11 @@ void net_tc_rx_init(void)
 		int priority;
 		k_tid_t tid;
 
+		if (i < RX_STACK_FIRST_TC) {
+			/* The flow queues handle this traffic class */
+			continue;
+		}
+
 		thread_priority = rx_tc2thread(i);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
@@ -368,7 +400,7 @@ void net_tc_rx_init(void)
 		NET_DBG("[%d] Starting RX handler %p stack size %zd "
 			"prio %d %s(%d)", i,
 			&rx_classes[i].handler,
-			K_KERNEL_STACK_SIZEOF(rx_stack[i]),
+			K_KERNEL_STACK_SIZEOF(rx_stack[i - RX_STACK_FIRST_TC]),
 			thread_priority,
 			IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 							"coop" : "preempt",
@@ -376,8 +408,9 @@ void net_tc_rx_init(void)
 
 		k_fifo_init(&rx_classes[i].fifo);
 
-		tid = k_thread_create(&rx_classes[i].handler, rx_stack[i],
-				      K_KERNEL_STACK_SIZEOF(rx_stack[i]),
+		tid = k_thread_create(&rx_classes[i].handler,
+				      rx_stack[i - RX_STACK_FIRST_TC],
+				      K_KERNEL_STACK_SIZEOF(rx_stack[i - RX_STACK_FIRST_TC]),
 				      tc_rx_handler,
 				      &rx_classes[i].fifo, NULL, NULL,
 				      priority, 0, K_FOREVER);
@@ -395,5 +428,56 @@ void net_tc_rx_init(void)
 
 		k_thread_start(tid);
 	}
+
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+	for (i = 0; i < CONFIG_NET_RX_FLOW_QUEUE_COUNT; i++) {
+		uint8_t thread_priority;
+		int priority;
+		k_tid_t tid;
+
+		thread_priority = rx_tc2thread(0);
+
+		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
+			K_PRIO_COOP(thread_priority) :
+			K_PRIO_PREEMPT(thread_priority);
+
+		NET_DBG("[%d] Starting RX flow handler %p stack size %zd "
+			"prio %d %s(%d)", i,
+			&rx_flows[i].handler,
+			K_KERNEL_STACK_SIZEOF(rx_flow_stack[i]),
+			thread_priority,
+			IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
+							"coop" : "preempt",
+			priority);
+
+		k_fifo_init(&rx_flows[i].fifo);
+
+		tid = k_thread_create(&rx_flows[i].handler, rx_flow_stack[i],
+				      K_KERNEL_STACK_SIZEOF(rx_flow_stack[i]),
+				      tc_rx_handler,
+				      &rx_flows[i].fifo, NULL, NULL,
+				      priority, 0, K_FOREVER);
+		if (!tid) {
+			NET_ERR("Cannot create RX flow handler thread %d", i);
+			continue;
+		}
+
+#if defined(CONFIG_SCHED_CPU_MASK)
+		/* Spread the flow queues over the CPUs, the connections of a
+		 * flow then stay in the cache of one CPU.
+		 */
+		(void)k_thread_cpu_pin(tid, i % arch_num_cpus());
+#endif
+
+		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
+			char name[MAX_NAME_LEN];
+
+			snprintk(name, sizeof(name), "rx_f[%d]", i);
+			k_thread_name_set(tid, name);
+		}
+
+		k_thread_start(tid);
+	}
+#endif
 #endif
 }
@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/math_extras.h>
 
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_core.h>
@@ -267,15 +268,239 @@ static inline void update_route_access(struct net_route_entry *route)
 	sys_slist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+/*
+ * Path compressed binary trie indexing the routes by prefix, so that the
+ * longest prefix match takes at most one step per prefix bit instead of one
+ * per routing table entry. Each node holds the routes of one prefix, one per
+ * interface, or none for the nodes only branching two subtries. As every
+ * empty node has two children, there are less empty nodes than routes.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+	sys_slist_t routes;
+	struct in6_addr prefix;
+	uint8_t len;
+};
+
+static struct route_trie_node route_trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *route_trie_free;
+static struct route_trie_node *route_trie_root;
+
+static inline uint8_t route_trie_bit(const struct in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7U - pos % 8U)) & 1U;
+}
+
+static uint8_t route_trie_common_len(const struct in6_addr *a,
+				     const struct in6_addr *b,
+				     uint8_t max_len)
+{
+	uint8_t len = 0U;
+
+	for (int i = 0; i < sizeof(a->s6_addr) && len < max_len; i++) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff != 0U) {
+			len += u32_count_leading_zeros(diff) - 24U;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max_len);
+}
+
+static struct route_trie_node *route_trie_node_alloc(const struct in6_addr *addr,
+						     uint8_t len)
+{
+	struct route_trie_node *node = route_trie_free;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	route_trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	net_ipv6_addr_prefix_mask(addr->s6_addr, node->prefix.s6_addr, len);
+	node->len = len;
+
+	return node;
+}
+
+static void route_trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = route_trie_free;
+	route_trie_free = node;
+}
+
+static void route_trie_init(void)
+{
+	route_trie_root = NULL;
+	route_trie_free = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(route_trie_nodes); i++) {
+		route_trie_node_free(&route_trie_nodes[i]);
+	}
+}
+
+static int route_trie_add(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node *node, *new_node, *glue;
+	uint8_t len = route->prefix_len;
+	uint8_t common = 0U;
+
+	while (*link != NULL) {
+		node = *link;
+		common = route_trie_common_len(&route->addr, &node->prefix,
+					       MIN(len, node->len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			sys_slist_append(&node->routes, &route->trie_node);
+			return 0;
+		}
+
+		link = &node->child[route_trie_bit(&route->addr, node->len)];
+	}
+
+	new_node = route_trie_node_alloc(&route->addr, len);
+	if (new_node == NULL) {
+		return -ENOMEM;
+	}
+
+	sys_slist_append(&new_node->routes, &route->trie_node);
+
+	node = *link;
+	if (node == NULL) {
+		*link = new_node;
+		return 0;
+	}
+
+	if (common == len) {
+		/* The new prefix covers the subtrie */
+		new_node->child[route_trie_bit(&node->prefix, len)] = node;
+		*link = new_node;
+		return 0;
+	}
+
+	/* The prefixes diverge at bit common, branch them */
+	glue = route_trie_node_alloc(&route->addr, common);
+	if (glue == NULL) {
+		route_trie_node_free(new_node);
+		return -ENOMEM;
+	}
+
+	glue->child[route_trie_bit(&route->addr, common)] = new_node;
+	glue->child[route_trie_bit(&node->prefix, common)] = node;
+	*link = glue;
+
+	return 0;
+}
+
+static void route_trie_del(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node **parent_link = NULL;
+	struct route_trie_node *node, *parent, *child;
+
+	while (*link != NULL && (*link)->len < route->prefix_len) {
+		parent_link = link;
+		link = &(*link)->child[route_trie_bit(&route->addr, (*link)->len)];
+	}
+
+	node = *link;
+	if (node == NULL || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->trie_node) ||
+	    !sys_slist_is_empty(&node->routes)) {
+		return;
+	}
+
+	if (node->child[0] != NULL && node->child[1] != NULL) {
+		/* Still branching */
+		return;
+	}
+
+	child = node->child[0] != NULL ? node->child[0] : node->child[1];
+	*link = child;
+	route_trie_node_free(node);
+
+	if (child != NULL || parent_link == NULL) {
+		return;
+	}
+
+	/* An empty parent left with a single child is not needed anymore */
+	parent = *parent_link;
+	if (sys_slist_is_empty(&parent->routes)) {
+		*parent_link = parent->child[0] != NULL ? parent->child[0] : parent->child[1];
+		route_trie_node_free(parent);
+	}
+}
+
+static struct net_route_entry *route_trie_find(struct net_if *iface,
+					       struct in6_addr *addr,
+					       uint8_t prefix_len)
+{
+	struct route_trie_node *node = route_trie_root;
+	struct net_route_entry *route;
+
+	while (node != NULL && node->len < prefix_len) {
+		node = node->child[route_trie_bit(addr, node->len)];
+	}
+
+	if (node == NULL || node->len != prefix_len ||
+	    !net_ipv6_is_prefix(addr->s6_addr, node->prefix.s6_addr, prefix_len)) {
+		return NULL;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+		if (route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+static struct net_route_entry *route_trie_lookup(struct net_if *iface,
+						 struct in6_addr *dst)
+{
+	struct route_trie_node *node = route_trie_root;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node != NULL &&
+	       net_ipv6_is_prefix(dst->s6_addr, node->prefix.s6_addr, node->len)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+			if (iface == NULL || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[route_trie_bit(dst, node->len)];
+	}
+
+	return found;
+}
+#else
+static struct net_route_entry *route_table_lookup(struct net_if *iface,
+						  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
 	int i;
 
-	net_ipv6_nbr_lock();
-
 	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
 		struct net_nbr *nbr = get_nbr(i);
 
@@ -298,6 +523,50 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+
+static struct net_route_entry *route_table_find(struct net_if *iface,
+						struct in6_addr *addr,
+						uint8_t prefix_len)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES; i++) {
+		struct net_nbr *nbr = get_nbr(i);
+		struct net_route_entry *route;
+
+		if (!nbr->ref || nbr->iface != iface) {
+			continue;
+		}
+
+		route = net_route_data(nbr);
+
+		if (route->prefix_len == prefix_len &&
+		    net_ipv6_is_prefix(addr->s6_addr,
+				       route->addr.s6_addr,
+				       prefix_len)) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_NET_ROUTE_LOOKUP_TRIE */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	net_ipv6_nbr_lock();
+
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+	found = route_trie_lookup(iface, dst);
+#else
+	found = route_table_lookup(iface, dst);
+#endif
+
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -361,7 +630,14 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 			net_sprint_ll_addr(nexthop_lladdr->addr, nexthop_lladdr->len));
 	}
 
-	route = net_route_lookup(iface, addr);
+	/* Only a route to the same prefix is replaced, a route to a
+	 * covering prefix is kept.
+	 */
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+	route = route_trie_find(iface, addr, prefix_len);
+#else
+	route = route_table_find(iface, addr, prefix_len);
+#endif
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -442,6 +718,16 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route->iface = iface;
 	route->preference = preference;
 
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+	if (route_trie_add(route) < 0) {
+		NET_ERR("No route trie node available!");
+		net_nbr_unref(tmp);
+		nbr_free(nbr);
+		route = NULL;
+		goto exit;
+	}
+#endif
+
 	net_route_update_lifetime(route, lifetime);
 
 	sys_slist_prepend(&routes, &route->node);
@@ -588,6 +874,10 @@ int net_route_del(struct net_route_entry *route)
 
 	sys_slist_find_and_remove(&routes, &route->node);
 
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+	route_trie_del(route);
+#endif
+
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		net_ipv6_nbr_unlock();
@@ -1129,6 +1419,9 @@ void net_route_init(void)
 	NET_DBG("Allocated %d nexthop entries (%zu bytes)",
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
 
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+	route_trie_init();
+#endif
 #if defined(CONFIG_NET_ROUTE_MCAST)
 	memset(route_mcast_entries, 0, sizeof(route_mcast_entries));
 #endif
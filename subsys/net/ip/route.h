@@ -68,6 +68,11 @@ struct net_route_entry {
 
 	/** Is the route valid forever */
 	uint8_t is_infinite : 1;
+
+#if defined(CONFIG_NET_ROUTE_LOOKUP_TRIE)
+	/** Routes with the same prefix in the lookup trie. */
+	sys_snode_t trie_node;
+#endif
 };
 
 /* Route preference values, as defined in RFC 4191 */
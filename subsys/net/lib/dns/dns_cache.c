@@ -5,29 +5,216 @@
  */
 
 #include <zephyr/net/dns_resolve.h>
+#include <zephyr/sys/crc.h>
 #include "dns_cache.h"
 
 LOG_MODULE_REGISTER(net_dns_cache, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 
-static void dns_cache_clean(struct dns_cache const *cache);
+/*
+ * The entries are chained by hash of their query and query type, and the
+ * entries in use are kept in a min-heap ordered by expiry, so that both
+ * lookups and the removal of expired entries do not scan the whole cache.
+ */
 
-int dns_cache_flush(struct dns_cache *cache)
+static void dns_cache_clean(struct dns_cache *cache);
+
+static uint32_t dns_cache_hash(char const *query, enum dns_query_type query_type)
+{
+	uint16_t type = query_type;
+	uint32_t hash;
+
+	hash = crc32_ieee((const uint8_t *)query, strlen(query));
+
+	return crc32_ieee_update(hash, (const uint8_t *)&type, sizeof(type));
+}
+
+/* Needs to be called when lock is already acquired */
+static void dns_cache_reset(struct dns_cache *cache)
 {
-	k_mutex_lock(cache->lock, K_FOREVER);
 	for (size_t i = 0; i < cache->size; i++) {
 		cache->entries[i].in_use = false;
+		cache->entries[i].next = (i + 1 < cache->size) ? i + 1 : DNS_CACHE_NONE;
+		cache->buckets[i] = DNS_CACHE_NONE;
+	}
+
+	cache->free = cache->size > 0 ? 0 : DNS_CACHE_NONE;
+	cache->count = 0;
+	cache->ready = true;
+}
+
+static void dns_cache_lock(struct dns_cache *cache)
+{
+	k_mutex_lock(cache->lock, K_FOREVER);
+
+	if (!cache->ready) {
+		dns_cache_reset(cache);
+	}
+}
+
+static bool heap_before(struct dns_cache *cache, uint16_t a, uint16_t b)
+{
+	return sys_timepoint_cmp(cache->entries[a].expiry, cache->entries[b].expiry) < 0;
+}
+
+static void heap_set(struct dns_cache *cache, size_t pos, uint16_t index)
+{
+	cache->heap[pos] = index;
+	cache->entries[index].heap_pos = pos;
+}
+
+static void heap_sift_up(struct dns_cache *cache, size_t pos)
+{
+	uint16_t index = cache->heap[pos];
+
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 2;
+
+		if (!heap_before(cache, index, cache->heap[parent])) {
+			break;
+		}
+
+		heap_set(cache, pos, cache->heap[parent]);
+		pos = parent;
 	}
+
+	heap_set(cache, pos, index);
+}
+
+static void heap_sift_down(struct dns_cache *cache, size_t pos)
+{
+	uint16_t index = cache->heap[pos];
+
+	while (true) {
+		size_t child = 2 * pos + 1;
+
+		if (child >= cache->count) {
+			break;
+		}
+
+		if (child + 1 < cache->count &&
+		    heap_before(cache, cache->heap[child + 1], cache->heap[child])) {
+			child++;
+		}
+
+		if (!heap_before(cache, cache->heap[child], index)) {
+			break;
+		}
+
+		heap_set(cache, pos, cache->heap[child]);
+		pos = child;
+	}
+
+	heap_set(cache, pos, index);
+}
+
+/* Needs to be called when lock is already acquired */
+static void dns_cache_entry_remove(struct dns_cache *cache, uint16_t index)
+{
+	struct dns_cache_entry *entry = &cache->entries[index];
+	uint16_t *link = &cache->buckets[entry->hash % cache->size];
+	size_t pos = entry->heap_pos;
+
+	while (*link != index) {
+		link = &cache->entries[*link].next;
+	}
+
+	*link = entry->next;
+
+	cache->count--;
+	if (pos < cache->count) {
+		heap_set(cache, pos, cache->heap[cache->count]);
+		heap_sift_down(cache, pos);
+		heap_sift_up(cache, pos);
+	}
+
+	entry->in_use = false;
+	entry->next = cache->free;
+	cache->free = index;
+}
+
+/* Needs to be called when lock is already acquired */
+static void dns_cache_entry_add(struct dns_cache *cache, char const *query,
+				enum dns_query_type query_type, uint32_t hash,
+				struct dns_addrinfo const *addrinfo, uint32_t ttl)
+{
+	struct dns_cache_entry *entry;
+	uint16_t *link;
+	uint16_t index;
+
+	if (cache->free == DNS_CACHE_NONE) {
+		NET_DBG("Overwrite \"%s\"", cache->entries[cache->heap[0]].query);
+		dns_cache_entry_remove(cache, cache->heap[0]);
+	}
+
+	index = cache->free;
+	entry = &cache->entries[index];
+	cache->free = entry->next;
+
+	strncpy(entry->query, query, CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1);
+	entry->query_type = query_type;
+	entry->hash = hash;
+	entry->negative = addrinfo == NULL;
+	if (addrinfo != NULL) {
+		entry->data = *addrinfo;
+	}
+	entry->expiry = sys_timepoint_calc(K_SECONDS(ttl));
+	entry->next = DNS_CACHE_NONE;
+	entry->in_use = true;
+
+	/* Chain at the end, so that the addresses are found in the order
+	 * they were added.
+	 */
+	link = &cache->buckets[hash % cache->size];
+	while (*link != DNS_CACHE_NONE) {
+		link = &cache->entries[*link].next;
+	}
+
+	*link = index;
+
+	heap_set(cache, cache->count, index);
+	cache->count++;
+	heap_sift_up(cache, cache->count - 1);
+}
+
+/* Needs to be called when lock is already acquired */
+static void dns_cache_entries_remove(struct dns_cache *cache, char const *query,
+				     enum dns_query_type query_type, uint32_t hash,
+				     bool negative_only)
+{
+	uint16_t index = cache->buckets[hash % cache->size];
+
+	while (index != DNS_CACHE_NONE) {
+		struct dns_cache_entry *entry = &cache->entries[index];
+		uint16_t next = entry->next;
+
+		if (entry->hash == hash && entry->query_type == query_type &&
+		    (entry->negative || !negative_only) && strcmp(entry->query, query) == 0) {
+			dns_cache_entry_remove(cache, index);
+		}
+
+		index = next;
+	}
+}
+
+int dns_cache_flush(struct dns_cache *cache)
+{
+	k_mutex_lock(cache->lock, K_FOREVER);
+	dns_cache_reset(cache);
 	k_mutex_unlock(cache->lock);
 
 	return 0;
 }
 
+static enum dns_query_type dns_cache_query_type(struct dns_addrinfo const *addrinfo)
+{
+	return addrinfo->ai_family == AF_INET6 ? DNS_QUERY_TYPE_AAAA : DNS_QUERY_TYPE_A;
+}
+
 int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinfo const *addrinfo,
 		  uint32_t ttl)
 {
-	k_timepoint_t closest_to_expiry = sys_timepoint_calc(K_FOREVER);
-	size_t index_to_replace = 0;
-	bool found_empty = false;
+	enum dns_query_type query_type;
+	uint32_t hash;
 
 	if (cache == NULL || query == NULL || addrinfo == NULL || ttl == 0) {
 		return -EINVAL;
@@ -40,32 +227,52 @@ int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinf
 		return -EINVAL;
 	}
 
-	k_mutex_lock(cache->lock, K_FOREVER);
+	query_type = dns_cache_query_type(addrinfo);
+	hash = dns_cache_hash(query, query_type);
+
+	dns_cache_lock(cache);
 
 	NET_DBG("Add \"%s\" with TTL %" PRIu32, query, ttl);
 
 	dns_cache_clean(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
-			index_to_replace = i;
-			found_empty = true;
-			break;
-		} else if (sys_timepoint_cmp(closest_to_expiry, cache->entries[i].expiry) > 0) {
-			index_to_replace = i;
-			closest_to_expiry = cache->entries[i].expiry;
-		}
+	/* The query has an address of the query type after all */
+	dns_cache_entries_remove(cache, query, query_type, hash, true);
+
+	dns_cache_entry_add(cache, query, query_type, hash, addrinfo, ttl);
+
+	k_mutex_unlock(cache->lock);
+
+	return 0;
+}
+
+int dns_cache_add_negative(struct dns_cache *cache, char const *query,
+			   enum dns_query_type query_type, uint32_t ttl)
+{
+	uint32_t hash;
+
+	if (cache == NULL || query == NULL || ttl == 0) {
+		return -EINVAL;
 	}
 
-	if (!found_empty) {
-		NET_DBG("Overwrite \"%s\"", cache->entries[index_to_replace].query);
+	if (strlen(query) >= CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) {
+		NET_WARN("Query string to big to be processed %u >= "
+			 "CONFIG_DNS_RESOLVER_MAX_QUERY_LEN",
+			 strlen(query));
+		return -EINVAL;
 	}
 
-	strncpy(cache->entries[index_to_replace].query, query,
-		CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1);
-	cache->entries[index_to_replace].data = *addrinfo;
-	cache->entries[index_to_replace].expiry = sys_timepoint_calc(K_SECONDS(ttl));
-	cache->entries[index_to_replace].in_use = true;
+	hash = dns_cache_hash(query, query_type);
+
+	dns_cache_lock(cache);
+
+	NET_DBG("Add negative \"%s\" type %d with TTL %" PRIu32, query, query_type, ttl);
+
+	dns_cache_clean(cache);
+
+	dns_cache_entries_remove(cache, query, query_type, hash, false);
+
+	dns_cache_entry_add(cache, query, query_type, hash, NULL, ttl);
 
 	k_mutex_unlock(cache->lock);
 
@@ -82,25 +289,27 @@ int dns_cache_remove(struct dns_cache *cache, char const *query)
 		return -EINVAL;
 	}
 
-	k_mutex_lock(cache->lock, K_FOREVER);
+	dns_cache_lock(cache);
 
 	dns_cache_clean(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (cache->entries[i].in_use && strcmp(cache->entries[i].query, query) == 0) {
-			cache->entries[i].in_use = false;
-		}
-	}
+	dns_cache_entries_remove(cache, query, DNS_QUERY_TYPE_A,
+				 dns_cache_hash(query, DNS_QUERY_TYPE_A), false);
+	dns_cache_entries_remove(cache, query, DNS_QUERY_TYPE_AAAA,
+				 dns_cache_hash(query, DNS_QUERY_TYPE_AAAA), false);
 
 	k_mutex_unlock(cache->lock);
 
 	return 0;
 }
 
-int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_addrinfo *addrinfo,
-		   size_t addrinfo_array_len)
+int dns_cache_find(struct dns_cache *cache, const char *query, enum dns_query_type query_type,
+		   struct dns_addrinfo *addrinfo, size_t addrinfo_array_len)
 {
+	bool negative = false;
 	size_t found = 0;
+	uint32_t hash;
+	uint16_t index;
 
 	NET_DBG("Find \"%s\"", query);
 	if (cache == NULL || query == NULL || addrinfo == NULL || addrinfo_array_len <= 0) {
@@ -113,22 +322,31 @@ int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_
 		return -EINVAL;
 	}
 
-	k_mutex_lock(cache->lock, K_FOREVER);
+	hash = dns_cache_hash(query, query_type);
+
+	dns_cache_lock(cache);
 
 	dns_cache_clean(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
+	for (index = cache->buckets[hash % cache->size]; index != DNS_CACHE_NONE;
+	     index = cache->entries[index].next) {
+		struct dns_cache_entry *entry = &cache->entries[index];
+
+		if (entry->hash != hash || entry->query_type != query_type) {
+			continue;
+		}
+		if (strcmp(entry->query, query) != 0) {
 			continue;
 		}
-		if (strcmp(cache->entries[i].query, query) != 0) {
+		if (entry->negative) {
+			negative = true;
 			continue;
 		}
 		if (found >= addrinfo_array_len) {
 			NET_WARN("Found \"%s\" but not enough space in provided buffer.", query);
 			found++;
 		} else {
-			addrinfo[found] = cache->entries[i].data;
+			addrinfo[found] = entry->data;
 			found++;
 			NET_DBG("Found \"%s\"", query);
 		}
@@ -141,22 +359,21 @@ int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_
 	}
 
 	if (found == 0) {
+		if (negative) {
+			NET_DBG("\"%s\" has no address of type %d", query, query_type);
+			return -ENODATA;
+		}
+
 		NET_DBG("Could not find \"%s\"", query);
 	}
 	return found;
 }
 
 /* Needs to be called when lock is already acquired */
-static void dns_cache_clean(struct dns_cache const *cache)
+static void dns_cache_clean(struct dns_cache *cache)
 {
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
-			continue;
-		}
-
-		if (sys_timepoint_expired(cache->entries[i].expiry)) {
-			NET_DBG("Remove \"%s\"", cache->entries[i].query);
-			cache->entries[i].in_use = false;
-		}
+	while (cache->count > 0 && sys_timepoint_expired(cache->entries[cache->heap[0]].expiry)) {
+		NET_DBG("Remove \"%s\"", cache->entries[cache->heap[0]].query);
+		dns_cache_entry_remove(cache, cache->heap[0]);
 	}
 }
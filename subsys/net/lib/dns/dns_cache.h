@@ -18,16 +18,35 @@
 #include <zephyr/kernel.h>
 #include <zephyr/sys_clock.h>
 
+/** No cache entry */
+#define DNS_CACHE_NONE UINT16_MAX
+
 struct dns_cache_entry {
 	char query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN];
 	struct dns_addrinfo data;
 	k_timepoint_t expiry;
+	/* Hash of the query and query type */
+	uint32_t hash;
+	/* Next entry of the hash chain, or of the free list */
+	uint16_t next;
+	/* Position of the entry in the expiry heap */
+	uint16_t heap_pos;
+	enum dns_query_type query_type;
+	/* The query has no address of the query type */
+	bool negative;
 	bool in_use;
 };
 
 struct dns_cache {
 	size_t size;
 	struct dns_cache_entry *entries;
+	/* First entry of each hash chain */
+	uint16_t *buckets;
+	/* Entries in use, as a min-heap on their expiry */
+	uint16_t *heap;
+	size_t count;
+	uint16_t free;
+	bool ready;
 	struct k_mutex *lock;
 };
 
@@ -41,10 +60,14 @@ struct dns_cache {
  * @param name Name of the cache.
  */
 #define DNS_CACHE_DEFINE(name, cache_size)                                                         \
+	BUILD_ASSERT((cache_size) > 0 && (cache_size) < DNS_CACHE_NONE, "Invalid DNS cache size"); \
 	static K_MUTEX_DEFINE(name##_mutex);                                                       \
 	static struct dns_cache_entry name##_entries[cache_size];                                  \
+	static uint16_t name##_buckets[cache_size];                                                \
+	static uint16_t name##_heap[cache_size];                                                   \
 	static struct dns_cache name = {                                                           \
-		.entries = name##_entries, .size = cache_size, .lock = &name##_mutex};
+		.entries = name##_entries, .size = cache_size, .buckets = name##_buckets,          \
+		.heap = name##_heap, .lock = &name##_mutex};
 
 /**
  * @brief Flushes the dns cache removing all its entries.
@@ -59,6 +82,9 @@ int dns_cache_flush(struct dns_cache *cache);
  * @brief Adds a new entry to the dns cache removing the one closest to expiry
  * if no free space is available.
  *
+ * The entry is found by queries of the type of the address family of
+ * @p addrinfo.
+ *
  * @param cache Cache where the entry should be added.
  * @param query Query which should be persisted in the cache.
  * @param addrinfo Addrinfo resulting from the query which will be returned
@@ -71,6 +97,22 @@ int dns_cache_flush(struct dns_cache *cache);
 int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinfo const *addrinfo,
 		  uint32_t ttl);
 
+/**
+ * @brief Adds a negative entry to the dns cache, recording that the query
+ * has no address of the given type (RFC 2308).
+ *
+ * @param cache Cache where the entry should be added.
+ * @param query Query which should be persisted in the cache.
+ * @param query_type Type of the query.
+ * @param ttl Time to live for the entry in seconds. This usually is the
+ * minimum of the TTL and of the MINIMUM field of the SOA record of the
+ * authority section of the response.
+ * @retval 0 on success
+ * @retval On error, a negative value is returned.
+ */
+int dns_cache_add_negative(struct dns_cache *cache, char const *query,
+			   enum dns_query_type query_type, uint32_t ttl);
+
 /**
  * @brief Removes all entries with the given query
  *
@@ -86,6 +128,7 @@ int dns_cache_remove(struct dns_cache *cache, char const *query);
  *
  * @param cache Cache where the entry should be searched.
  * @param query Query which should be searched for.
+ * @param query_type Type of the query.
  * @param addrinfo dns_addrinfo array which will be written if the query was found.
  * @param addrinfo_array_len Array size of the dns_addrinfo array
  * @retval on success the amount of dns_addrinfo written into the addrinfo array will be returned.
@@ -93,8 +136,10 @@ int dns_cache_remove(struct dns_cache *cache, char const *query);
  * @retval On error a negative value is returned.
  * -ENOSR means there was not enough space in the addrinfo array to accommodate all cache hits the
  * array will however be filled with valid data.
+ * -ENODATA means a negative entry was found, the query has no address of the query type.
  */
-int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_addrinfo *addrinfo,
+int dns_cache_find(struct dns_cache *cache, const char *query,
+		   enum dns_query_type query_type, struct dns_addrinfo *addrinfo,
 		   size_t addrinfo_array_len);
 
 #endif /* ZEPHYR_INCLUDE_NET_DNS_CACHE_H_ */
@@ -221,15 +221,68 @@ int dns_unpack_response_header(struct dns_msg_t *msg, int src_id)
 	ancount = dns_unpack_header_ancount(dns_header);
 
 	/* For mDNS (when src_id == 0) the query count is 0 so accept
-	 * the packet in that case.
+	 * the packet in that case. A response without answers must have
+	 * an authority section, see RFC 2308 2.2 No Data.
 	 */
-	if ((qdcount < 1 && src_id > 0) || ancount < 1) {
+	if ((qdcount < 1 && src_id > 0) ||
+	    (ancount < 1 && dns_header_nscount(dns_header) < 1)) {
 		return -EINVAL;
 	}
 
 	return 0;
 }
 
+int dns_unpack_negative_ttl(struct dns_msg_t *dns_msg, uint32_t *ttl)
+{
+	int nscount = dns_header_nscount(dns_msg->msg);
+	int offset = dns_msg->answer_offset;
+
+	for (int i = 0; i < nscount; i++) {
+		uint8_t *rr = dns_msg->msg + offset;
+		uint32_t minimum;
+		uint16_t rdlength;
+		int dname_len;
+
+		if (offset >= dns_msg->msg_size) {
+			return -EINVAL;
+		}
+
+		dname_len = skip_fqdn(rr, dns_msg->msg_size - offset);
+		if (dname_len < 0) {
+			return dname_len;
+		}
+
+		offset += dname_len + DNS_COMMON_UINT_SIZE + /* type length */
+			  DNS_COMMON_UINT_SIZE + /* class length */
+			  DNS_TTL_LEN + DNS_RDLENGTH_LEN;
+		if (offset > dns_msg->msg_size) {
+			return -EINVAL;
+		}
+
+		rdlength = dns_answer_rdlength(dname_len, rr);
+		if (offset + rdlength > dns_msg->msg_size) {
+			return -EINVAL;
+		}
+
+		if (dns_answer_type(dname_len, rr) == DNS_RR_TYPE_SOA) {
+			if (rdlength < DNS_SOA_MIN_RDLENGTH) {
+				return -EINVAL;
+			}
+
+			/* MINIMUM is the last field of the SOA RDATA */
+			minimum = ntohl(UNALIGNED_GET((uint32_t *)(dns_msg->msg + offset +
+								   rdlength - DNS_TTL_LEN)));
+			*ttl = MIN((uint32_t)dns_answer_ttl(dname_len, rr), minimum);
+
+			return 0;
+		}
+
+		offset += rdlength;
+	}
+
+	return -ENOENT;
+}
+
 static int dns_msg_pack_query_header(uint8_t *buf, uint16_t size, uint16_t id)
 {
 	uint16_t offset;
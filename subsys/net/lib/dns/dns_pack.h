@@ -39,6 +39,9 @@
 #define DNS_TTL_LEN		4
 #define DNS_RDLENGTH_LEN	2
 
+/* SOA RDATA: MNAME and RNAME, then SERIAL, REFRESH, RETRY, EXPIRE, MINIMUM */
+#define DNS_SOA_MIN_RDLENGTH	(2 * DNS_LABEL_MIN_SIZE + 5 * DNS_TTL_LEN)
+
 #define NS_CMPRSFLGS    0xc0   /* DNS name compression */
 
 /* RFC 1035 '4.1.1. Header section format' defines the following flags:
@@ -89,6 +92,7 @@ enum dns_rr_type {
 	DNS_RR_TYPE_INVALID = 0,
 	DNS_RR_TYPE_A	= 1,		/* IPv4  */
 	DNS_RR_TYPE_CNAME = 5,		/* CNAME */
+	DNS_RR_TYPE_SOA = 6,		/* SOA   */
 	DNS_RR_TYPE_PTR = 12,		/* PTR   */
 	DNS_RR_TYPE_TXT = 16,		/* TXT   */
 	DNS_RR_TYPE_AAAA = 28,		/* IPv6  */
@@ -360,12 +364,30 @@ int dns_unpack_answer(struct dns_msg_t *dns_msg, int dname_ptr, uint32_t *ttl,
  * @retval -EINVAL if the src_id does not match the header's id, or if the
  *         header's QR value is not DNS_RESPONSE or if the header's OPCODE
  *         value is not DNS_QUERY, or if the header's Z value is not 0 or if
- *         the question counter is not 1 or the answer counter is less than 1.
+ *         the question counter is not 1 or if both the answer and the
+ *         authority counters are less than 1.
  * @retval RFC 1035 RCODEs (> 0) 1 Format error, 2 Server failure, 3 Name Error,
  *         4 Not Implemented and 5 Refused.
  */
 int dns_unpack_response_header(struct dns_msg_t *msg, int src_id);
 
+/**
+ * @brief Unpacks the TTL of a negative response.
+ *
+ * @details RFC 2308 states that negative responses are cached for the
+ *          minimum of the TTL of the SOA record of the authority section
+ *          and of its MINIMUM field.
+ *
+ * @param dns_msg Structure containing the message. Its answer_offset field
+ *        must point to the authority section.
+ * @param ttl Negative response TTL.
+ * @retval 0 on success
+ * @retval -ENOENT if the authority section has no SOA record, the response
+ *         must not be cached then.
+ * @retval -EINVAL if the authority section is malformed.
+ */
+int dns_unpack_negative_ttl(struct dns_msg_t *dns_msg, uint32_t *ttl);
+
 /**
  * @brief Packs the query message
  *
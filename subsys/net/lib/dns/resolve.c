@@ -99,6 +99,9 @@ static inline void invoke_query_callback(int status,
 					 struct dns_addrinfo *info,
 					 struct dns_pending_query *pending_query);
 static void release_query(struct dns_pending_query *pending_query);
+static void invoke_query_callbacks(struct dns_resolve_context *ctx, int status,
+				   struct dns_addrinfo *info, int slot);
+static void complete_query(struct dns_resolve_context *ctx, int status, int slot);
 
 static bool server_is_mdns(sa_family_t family, struct sockaddr *addr)
 {
@@ -270,10 +273,8 @@ quit:
 		goto free_buf;
 	}
 
-	invoke_query_callback(ret, NULL, &ctx->queries[i]);
-
 	/* Marks the end of the results */
-	release_query(&ctx->queries[i]);
+	complete_query(ctx, ret, i);
 
 free_buf:
 	if (dns_cname) {
@@ -620,6 +621,89 @@ static void release_query(struct dns_pending_query *pending_query)
 	}
 }
 
+/* Check whether a query slot is given the answer of a query in flight in
+ * another slot, instead of being sent to the servers.
+ */
+static inline bool query_is_shared(struct dns_pending_query *pending_query)
+{
+#if defined(CONFIG_DNS_RESOLVER_COALESCE_QUERIES)
+	return pending_query->leader >= 0;
+#else
+	ARG_UNUSED(pending_query);
+
+	return false;
+#endif
+}
+
+#if defined(CONFIG_DNS_RESOLVER_COALESCE_QUERIES)
+/* Must be invoked with context lock held */
+static inline bool query_shares(struct dns_resolve_context *ctx, int i, int slot)
+{
+	return i != slot && ctx->queries[i].cb != NULL &&
+	       ctx->queries[i].query != NULL && ctx->queries[i].leader == slot;
+}
+
+/* Find the query in flight, if any, of the given name and type.
+ *
+ * Must be invoked with context lock held.
+ */
+static int find_query_in_flight(struct dns_resolve_context *ctx, int slot,
+				const char *query, enum dns_query_type type)
+{
+	for (int i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		struct dns_pending_query *pending_query = &ctx->queries[i];
+
+		if (i != slot && check_query_active(pending_query, false) &&
+		    pending_query->query != NULL && !query_is_shared(pending_query) &&
+		    pending_query->query_type == type &&
+		    strcmp(pending_query->query, query) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+#endif /* CONFIG_DNS_RESOLVER_COALESCE_QUERIES */
+
+/* Invoke the callback associated with a query slot, and those of the query
+ * slots sharing its answer.
+ *
+ * Must be invoked with context lock held.
+ */
+static void invoke_query_callbacks(struct dns_resolve_context *ctx, int status,
+				   struct dns_addrinfo *info, int slot)
+{
+	invoke_query_callback(status, info, &ctx->queries[slot]);
+
+#if defined(CONFIG_DNS_RESOLVER_COALESCE_QUERIES)
+	for (int i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (query_shares(ctx, i, slot)) {
+			invoke_query_callback(status, info, &ctx->queries[i]);
+		}
+	}
+#endif
+}
+
+/* Invoke the final callback of a query slot, and those of the query slots
+ * sharing its answer, and release them.
+ *
+ * Must be invoked with context lock held.
+ */
+static void complete_query(struct dns_resolve_context *ctx, int status, int slot)
+{
+#if defined(CONFIG_DNS_RESOLVER_COALESCE_QUERIES)
+	for (int i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (query_shares(ctx, i, slot)) {
+			invoke_query_callback(status, NULL, &ctx->queries[i]);
+			release_query(&ctx->queries[i]);
+		}
+	}
+#endif
+
+	invoke_query_callback(status, NULL, &ctx->queries[slot]);
+	release_query(&ctx->queries[slot]);
+}
+
 /* Must be invoked with context lock held */
 static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 				 uint16_t dns_id,
@@ -629,6 +713,7 @@ static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 
 	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
 		if (check_query_active(&ctx->queries[i], false) &&
+		    !query_is_shared(&ctx->queries[i]) &&
 		    ctx->queries[i].id == dns_id &&
 		    (query_hash == 0 ||
 		     ctx->queries[i].query_hash == query_hash)) {
@@ -812,8 +897,8 @@ query_known:
 			src = dns_msg->msg + dns_msg->response_position;
 			memcpy(addr, src, address_size);
 
-			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
-					      &ctx->queries[*query_idx]);
+			invoke_query_callbacks(ctx, DNS_EAI_INPROGRESS, &info,
+					       *query_idx);
 #ifdef CONFIG_DNS_RESOLVER_CACHE
 			dns_cache_add(&dns_cache,
 				ctx->queries[*query_idx].query, &info, ttl);
@@ -884,6 +969,20 @@ query_known:
 	}
 
 	if (items == 0) {
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+		/* Remember that the name has no address of this type, for the
+		 * time given by the SOA record of the authority section.
+		 */
+		if (CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL_MAX > 0 &&
+		    (dns_header_rcode(dns_msg->msg) == DNS_HEADER_NOERROR ||
+		     dns_header_rcode(dns_msg->msg) == DNS_HEADER_NAMEERROR) &&
+		    dns_unpack_negative_ttl(dns_msg, &ttl) == 0 && ttl > 0) {
+			dns_cache_add_negative(&dns_cache, ctx->queries[*query_idx].query,
+					       ctx->queries[*query_idx].query_type,
+					       MIN(ttl, CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL_MAX));
+		}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 		ret = DNS_EAI_NODATA;
 	} else {
 		ret = DNS_EAI_ALLDONE;
@@ -922,10 +1021,8 @@ static int dns_read(struct dns_resolve_context *ctx,
 		goto quit;
 	}
 
-	invoke_query_callback(ret, NULL, &ctx->queries[query_idx]);
-
 	/* Marks the end of the results */
-	release_query(&ctx->queries[query_idx]);
+	complete_query(ctx, ret, query_idx);
 
 	return 0;
 
@@ -1064,9 +1161,7 @@ static int dns_write(struct dns_resolve_context *ctx,
 /* Must be invoked with context lock held */
 static void dns_resolve_cancel_slot(struct dns_resolve_context *ctx, int slot)
 {
-	invoke_query_callback(DNS_EAI_CANCELED, NULL, &ctx->queries[slot]);
-
-	release_query(&ctx->queries[slot]);
+	complete_query(ctx, DNS_EAI_CANCELED, slot);
 }
 
 /* Must be invoked with context lock held */
@@ -1206,6 +1301,18 @@ static void query_timeout(struct k_work *work)
 	NET_DBG("Query timeout DNS req %u type %d hash %u", pending_query->id,
 		pending_query->query_type, pending_query->query_hash);
 
+	if (query_is_shared(pending_query)) {
+		struct dns_resolve_context *ctx = pending_query->ctx;
+
+		/* Only this caller stops waiting for the query in flight */
+		if (pending_query->query != NULL && ctx->state == DNS_RESOLVE_CONTEXT_ACTIVE) {
+			dns_resolve_cancel_slot(ctx, pending_query - ctx->queries);
+		}
+
+		k_mutex_unlock(&ctx->lock);
+		return;
+	}
+
 	/* The resolve cancel will invoke release_query(), but release will
 	 * not be completed because the work item is still pending.  Instead
 	 * the release will be completed when check_query_active() confirms
@@ -1300,7 +1407,7 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 
 try_resolve:
 #ifdef CONFIG_DNS_RESOLVER_CACHE
-	ret = dns_cache_find(&dns_cache, query, cached_info, ARRAY_SIZE(cached_info));
+	ret = dns_cache_find(&dns_cache, query, type, cached_info, ARRAY_SIZE(cached_info));
 	if (ret > 0) {
 		/* The query was cached, no
 		 * need to continue further.
@@ -1312,6 +1419,13 @@ try_resolve:
 
 		return 0;
 	}
+
+	if (ret == -ENODATA) {
+		/* The name is cached as having no address of this type */
+		cb(DNS_EAI_NODATA, NULL, user_data);
+
+		return 0;
+	}
 #endif /* CONFIG_DNS_RESOLVER_CACHE */
 
 	k_mutex_lock(&ctx->lock, K_FOREVER);
@@ -1337,6 +1451,33 @@ try_resolve:
 
 	k_work_init_delayable(&ctx->queries[i].timer, query_timeout);
 
+#if defined(CONFIG_DNS_RESOLVER_COALESCE_QUERIES)
+	ctx->queries[i].leader = find_query_in_flight(ctx, i, query, type);
+	if (ctx->queries[i].leader >= 0) {
+		struct dns_pending_query *leader = &ctx->queries[ctx->queries[i].leader];
+
+		/* Wait for the answer of the query in flight instead of
+		 * sending another one.
+		 */
+		ctx->queries[i].id = leader->id;
+		ctx->queries[i].query_hash = leader->query_hash;
+
+		if (dns_id) {
+			*dns_id = leader->id;
+		}
+
+		NET_DBG("[%u] sharing query %d for id %u", i, ctx->queries[i].leader,
+			leader->id);
+
+		ret = k_work_reschedule(&ctx->queries[i].timer, tout);
+		if (ret >= 0) {
+			ret = 0;
+		}
+
+		goto quit;
+	}
+#endif /* CONFIG_DNS_RESOLVER_COALESCE_QUERIES */
+
 	dns_data = net_buf_alloc(&dns_msg_pool, ctx->buf_timeout);
 	if (!dns_data) {
 		ret = -ENOMEM;
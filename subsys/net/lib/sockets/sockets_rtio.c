@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * RTIO socket iodevs. Submissions are parked on the iodev and completed
+ * directly from the net_context callbacks, so no thread has to block on a
+ * socket. Received packets and accepted connections are kept in the
+ * net_context queues the BSD socket layer uses, which means data arriving
+ * before a receive submission, or a connection established before an accept
+ * submission, is not lost.
+ *
+ * A single spinlock protects the queues and the link between an iodev and
+ * its net_context, the latter being held in the user_data of the context.
+ * Submissions are always completed with the lock released, as completing a
+ * multishot or chained submission submits again.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/socket_rtio.h>
+
+#include "sockets_internal.h"
+
+static struct k_spinlock socket_rtio_lock;
+
+static void socket_rtio_received_cb(struct net_context *ctx, struct net_pkt *pkt,
+				    union net_ip_header *ip_hdr,
+				    union net_proto_header *proto_hdr, int status,
+				    void *user_data);
+
+/* Complete a submission for good, stopping a multishot receive */
+static void socket_rtio_finish(struct rtio_iodev_sqe *iodev_sqe, int result)
+{
+	iodev_sqe->sqe.flags &= ~RTIO_SQE_MULTISHOT;
+
+	if (result < 0) {
+		rtio_iodev_sqe_err(iodev_sqe, result);
+	} else {
+		rtio_iodev_sqe_ok(iodev_sqe, result);
+	}
+}
+
+static int socket_rtio_attach(struct socket_rtio_data *data, struct net_context *ctx)
+{
+	k_spinlock_key_t key = k_spin_lock(&socket_rtio_lock);
+
+	if (data->ctx != NULL) {
+		k_spin_unlock(&socket_rtio_lock, key);
+		return -EBUSY;
+	}
+
+	data->ctx = ctx;
+	mpsc_init(&data->rx_q);
+	mpsc_init(&data->accept_q);
+	data->connect_sqe = NULL;
+	data->rx_busy = false;
+	data->rx_wait = false;
+	k_sem_init(&data->rx_idle, 0, 1);
+	/* The connection may have been reset while waiting to be accepted */
+	data->error = sock_is_error(ctx) ? -ECONNRESET : 0;
+	ctx->user_data = data;
+
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	return 0;
+}
+
+static bool socket_rtio_rx_ready(struct socket_rtio_data *data)
+{
+	return !k_fifo_is_empty(&data->ctx->recv_q) || sock_is_eof(data->ctx) ||
+	       data->error != 0;
+}
+
+/*
+ * Only called with rx_busy set, which makes the caller the only consumer of
+ * recv_q. Sets @a done when no more data will be received.
+ */
+static int socket_rtio_rx_fill(struct socket_rtio_data *data, struct rtio_iodev_sqe *iodev_sqe,
+			       bool *done)
+{
+	struct net_context *ctx = data->ctx;
+	bool stream = net_context_get_type(ctx) == SOCK_STREAM;
+	struct net_pkt *pkt = k_fifo_peek_head(&ctx->recv_q);
+	uint32_t buf_len, copied = 0;
+	k_spinlock_key_t key;
+	uint8_t *buf;
+	size_t len;
+	int rc;
+
+	if (pkt == NULL) {
+		/* End of stream, or the connection failed */
+		*done = true;
+		return data->error;
+	}
+
+	rc = rtio_sqe_rx_buf(iodev_sqe, 1, MAX(net_pkt_remaining_data(pkt), 1), &buf, &buf_len);
+	if (rc < 0) {
+		*done = true;
+		return rc;
+	}
+
+	do {
+		len = MIN(buf_len - copied, net_pkt_remaining_data(pkt));
+		if (net_pkt_read(pkt, buf + copied, len) < 0) {
+			*done = true;
+			return -EIO;
+		}
+		copied += len;
+
+		if (stream && net_pkt_remaining_data(pkt) > 0) {
+			/* Buffer full, the rest goes to the next submission */
+			break;
+		}
+
+		/* Datagrams that do not fit the buffer are truncated */
+		key = k_spin_lock(&socket_rtio_lock);
+		(void)k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+		if (net_pkt_eof(pkt)) {
+			sock_set_eof(ctx);
+		}
+		k_spin_unlock(&socket_rtio_lock, key);
+
+		net_pkt_unref(pkt);
+
+		pkt = stream ? k_fifo_peek_head(&ctx->recv_q) : NULL;
+	} while (pkt != NULL && copied < buf_len);
+
+	if (stream) {
+		net_context_update_recv_wnd(ctx, copied);
+	}
+
+	*done = false;
+
+	return copied;
+}
+
+static void socket_rtio_rx_process(struct socket_rtio_data *data)
+{
+	struct rtio_iodev_sqe *iodev_sqe;
+	struct mpsc_node *node;
+	k_spinlock_key_t key;
+	bool done;
+	int rc;
+
+	key = k_spin_lock(&socket_rtio_lock);
+
+	if (data->rx_busy) {
+		/* The thread already completing submissions picks this up */
+		k_spin_unlock(&socket_rtio_lock, key);
+		return;
+	}
+
+	data->rx_busy = true;
+
+	while (data->ctx != NULL && socket_rtio_rx_ready(data)) {
+		node = mpsc_pop(&data->rx_q);
+		if (node == NULL) {
+			break;
+		}
+
+		k_spin_unlock(&socket_rtio_lock, key);
+
+		iodev_sqe = CONTAINER_OF(node, struct rtio_iodev_sqe, q);
+		rc = socket_rtio_rx_fill(data, iodev_sqe, &done);
+		if (done) {
+			socket_rtio_finish(iodev_sqe, rc);
+		} else {
+			/* A multishot submission is queued again from here */
+			rtio_iodev_sqe_ok(iodev_sqe, rc);
+		}
+
+		key = k_spin_lock(&socket_rtio_lock);
+	}
+
+	data->rx_busy = false;
+
+	if (data->rx_wait) {
+		data->rx_wait = false;
+		k_sem_give(&data->rx_idle);
+	}
+
+	k_spin_unlock(&socket_rtio_lock, key);
+}
+
+static void socket_rtio_received_cb(struct net_context *ctx, struct net_pkt *pkt,
+				    union net_ip_header *ip_hdr,
+				    union net_proto_header *proto_hdr, int status,
+				    void *user_data)
+{
+	struct socket_rtio_data *data;
+	struct net_pkt *last_pkt;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+	ARG_UNUSED(user_data);
+
+	key = k_spin_lock(&socket_rtio_lock);
+
+	/* NULL for an accepted connection not attached to an iodev yet */
+	data = ctx->user_data;
+
+	if (status < 0) {
+		if (data != NULL) {
+			data->error = status;
+		} else {
+			sock_set_error(ctx);
+		}
+	}
+
+	if (pkt == NULL) {
+		/* EOF, once the data already received has been consumed */
+		last_pkt = k_fifo_peek_tail(&ctx->recv_q);
+		if (last_pkt == NULL) {
+			sock_set_eof(ctx);
+		} else {
+			net_pkt_set_eof(last_pkt, true);
+		}
+	} else {
+		net_pkt_set_eof(pkt, false);
+		k_fifo_put(&ctx->recv_q, pkt);
+	}
+
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	if (data != NULL) {
+		socket_rtio_rx_process(data);
+	}
+}
+
+static void socket_rtio_accept_process(struct socket_rtio_data *data)
+{
+	struct rtio_iodev_sqe *iodev_sqe;
+	struct socket_rtio_data *conn;
+	struct net_context *new_ctx;
+	struct mpsc_node *node;
+	k_spinlock_key_t key;
+	int rc;
+
+	for (;;) {
+		key = k_spin_lock(&socket_rtio_lock);
+
+		if (data->ctx == NULL || k_fifo_is_empty(&data->ctx->accept_q)) {
+			k_spin_unlock(&socket_rtio_lock, key);
+			return;
+		}
+
+		node = mpsc_pop(&data->accept_q);
+		if (node == NULL) {
+			k_spin_unlock(&socket_rtio_lock, key);
+			return;
+		}
+
+		new_ctx = k_fifo_get(&data->ctx->accept_q, K_NO_WAIT);
+
+		k_spin_unlock(&socket_rtio_lock, key);
+
+		iodev_sqe = CONTAINER_OF(node, struct rtio_iodev_sqe, q);
+		conn = iodev_sqe->sqe.accept.iodev->data;
+
+		rc = socket_rtio_attach(conn, new_ctx);
+		if (rc < 0) {
+			NET_DBG("discarding ctx %p", new_ctx);
+			net_context_put(new_ctx);
+			rtio_iodev_sqe_err(iodev_sqe, rc);
+			continue;
+		}
+
+		rtio_iodev_sqe_ok(iodev_sqe, 0);
+	}
+}
+
+static void socket_rtio_accepted_cb(struct net_context *new_ctx, struct sockaddr *addr,
+				    socklen_t addrlen, int status, void *user_data)
+{
+	struct net_context *parent = user_data;
+	struct socket_rtio_data *data;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(addr);
+	ARG_UNUSED(addrlen);
+
+	NET_DBG("parent=%p, ctx=%p, st=%d", parent, new_ctx, status);
+
+	if (status != 0) {
+		return;
+	}
+
+	new_ctx->user_data = NULL;
+	new_ctx->socket_data = NULL;
+	k_fifo_init(&new_ctx->recv_q);
+
+	/* This just installs a callback, so cannot fail. */
+	(void)net_context_recv(new_ctx, socket_rtio_received_cb, K_NO_WAIT, NULL);
+
+	/* Owned by both the application and the stack, as for BSD sockets */
+	net_context_ref(new_ctx);
+
+	key = k_spin_lock(&socket_rtio_lock);
+	data = parent->user_data;
+	k_fifo_put(&parent->accept_q, new_ctx);
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	if (data != NULL) {
+		socket_rtio_accept_process(data);
+	}
+}
+
+static void socket_rtio_connect_done(struct socket_rtio_data *data, int status)
+{
+	struct rtio_iodev_sqe *iodev_sqe;
+	k_spinlock_key_t key = k_spin_lock(&socket_rtio_lock);
+
+	iodev_sqe = data->connect_sqe;
+	data->connect_sqe = NULL;
+
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	/* Completed once, either from the callback or by the submitter */
+	if (iodev_sqe != NULL) {
+		socket_rtio_finish(iodev_sqe, status);
+	}
+}
+
+static void socket_rtio_connected_cb(struct net_context *ctx, int status, void *user_data)
+{
+	ARG_UNUSED(ctx);
+
+	socket_rtio_connect_done(user_data, status);
+}
+
+/* Queue a receive or accept submission, unless the iodev was closed meanwhile */
+static bool socket_rtio_park(struct socket_rtio_data *data, struct mpsc *q,
+			     struct rtio_iodev_sqe *iodev_sqe)
+{
+	k_spinlock_key_t key = k_spin_lock(&socket_rtio_lock);
+	bool open = data->ctx != NULL;
+
+	if (open) {
+		mpsc_push(q, &iodev_sqe->q);
+	}
+
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	return open;
+}
+
+static void socket_rtio_submit_tx(struct socket_rtio_data *data,
+				  struct rtio_iodev_sqe *iodev_sqe)
+{
+	const struct rtio_sqe *sqe = &iodev_sqe->sqe;
+	int rc;
+
+	if (sqe->op == RTIO_OP_TINY_TX) {
+		rc = net_context_send(data->ctx, sqe->tiny_tx.buf, sqe->tiny_tx.buf_len, NULL,
+				      K_NO_WAIT, data);
+	} else {
+		rc = net_context_send(data->ctx, sqe->tx.buf, sqe->tx.buf_len, NULL, K_NO_WAIT,
+				      data);
+	}
+
+	if (rc < 0) {
+		rtio_iodev_sqe_err(iodev_sqe, rc);
+	} else {
+		rtio_iodev_sqe_ok(iodev_sqe, rc);
+	}
+}
+
+static void socket_rtio_submit_connect(struct socket_rtio_data *data,
+				       struct rtio_iodev_sqe *iodev_sqe)
+{
+	const struct rtio_sqe *sqe = &iodev_sqe->sqe;
+	struct net_context *ctx = data->ctx;
+	bool stream = net_context_get_type(ctx) == SOCK_STREAM;
+	k_spinlock_key_t key;
+	int rc;
+
+	key = k_spin_lock(&socket_rtio_lock);
+	if (data->connect_sqe != NULL) {
+		k_spin_unlock(&socket_rtio_lock, key);
+		rtio_iodev_sqe_err(iodev_sqe, -EALREADY);
+		return;
+	}
+	data->connect_sqe = iodev_sqe;
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	/* Data may follow the handshake right away */
+	if (stream) {
+		(void)net_context_recv(ctx, socket_rtio_received_cb, K_NO_WAIT, NULL);
+	}
+
+	rc = net_context_connect(ctx, sqe->connect.addr, sqe->connect.addrlen,
+				 socket_rtio_connected_cb, K_NO_WAIT, data);
+	if (rc == -EINPROGRESS) {
+		/* Completed from socket_rtio_connected_cb() */
+		return;
+	}
+
+	if (rc == 0 && !stream) {
+		rc = net_context_recv(ctx, socket_rtio_received_cb, K_NO_WAIT, NULL);
+	}
+
+	socket_rtio_connect_done(data, rc);
+}
+
+static void socket_rtio_submit(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct socket_rtio_data *data = iodev_sqe->sqe.iodev->data;
+	const struct rtio_iodev *conn_iodev;
+
+	if (data->ctx == NULL) {
+		socket_rtio_finish(iodev_sqe, -EBADF);
+		return;
+	}
+
+	switch (iodev_sqe->sqe.op) {
+	case RTIO_OP_RX:
+		if (!socket_rtio_park(data, &data->rx_q, iodev_sqe)) {
+			socket_rtio_finish(iodev_sqe, -EBADF);
+			return;
+		}
+		socket_rtio_rx_process(data);
+		break;
+	case RTIO_OP_TX:
+	case RTIO_OP_TINY_TX:
+		socket_rtio_submit_tx(data, iodev_sqe);
+		break;
+	case RTIO_OP_NET_ACCEPT:
+		conn_iodev = iodev_sqe->sqe.accept.iodev;
+		if (conn_iodev == NULL || conn_iodev->api != &socket_rtio_iodev_api ||
+		    net_context_get_state(data->ctx) != NET_CONTEXT_LISTENING) {
+			rtio_iodev_sqe_err(iodev_sqe, -EINVAL);
+			return;
+		}
+		if (!socket_rtio_park(data, &data->accept_q, iodev_sqe)) {
+			rtio_iodev_sqe_err(iodev_sqe, -EBADF);
+			return;
+		}
+		socket_rtio_accept_process(data);
+		break;
+	case RTIO_OP_NET_CONNECT:
+		socket_rtio_submit_connect(data, iodev_sqe);
+		break;
+	default:
+		socket_rtio_finish(iodev_sqe, -ENOTSUP);
+		break;
+	}
+}
+
+const struct rtio_iodev_api socket_rtio_iodev_api = {
+	.submit = socket_rtio_submit,
+};
+
+int socket_rtio_open(const struct rtio_iodev *iodev, int family, int type, int proto)
+{
+	struct socket_rtio_data *data = iodev->data;
+	struct net_context *ctx;
+	int rc;
+
+	if (data->ctx != NULL) {
+		return -EBUSY;
+	}
+
+	if (proto == 0 && (family == AF_INET || family == AF_INET6)) {
+		if (type == SOCK_DGRAM) {
+			proto = IPPROTO_UDP;
+		} else if (type == SOCK_STREAM) {
+			proto = IPPROTO_TCP;
+		}
+	}
+
+	rc = net_context_get(family, type, proto, &ctx);
+	if (rc < 0) {
+		return rc;
+	}
+
+	ctx->user_data = NULL;
+	ctx->socket_data = NULL;
+	k_fifo_init(&ctx->recv_q);
+
+	rc = socket_rtio_attach(data, ctx);
+	if (rc < 0) {
+		net_context_put(ctx);
+		return rc;
+	}
+
+	/* Owned by both the application and the stack, as for BSD sockets */
+	if (proto == IPPROTO_TCP) {
+		net_context_ref(ctx);
+	}
+
+	return 0;
+}
+
+int socket_rtio_bind(const struct rtio_iodev *iodev, const struct sockaddr *addr,
+		     socklen_t addrlen)
+{
+	struct socket_rtio_data *data = iodev->data;
+	int rc;
+
+	if (data->ctx == NULL) {
+		return -EBADF;
+	}
+
+	rc = net_context_bind(data->ctx, addr, addrlen);
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* Datagrams can be received as soon as the socket is bound */
+	if (net_context_get_type(data->ctx) == SOCK_DGRAM) {
+		rc = net_context_recv(data->ctx, socket_rtio_received_cb, K_NO_WAIT, NULL);
+	}
+
+	return rc;
+}
+
+int socket_rtio_listen(const struct rtio_iodev *iodev, int backlog)
+{
+	struct socket_rtio_data *data = iodev->data;
+	int rc;
+
+	if (data->ctx == NULL) {
+		return -EBADF;
+	}
+
+	rc = net_context_listen(data->ctx, backlog);
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* Stored as user_data of the context, the callback gets the context */
+	return net_context_accept(data->ctx, socket_rtio_accepted_cb, K_NO_WAIT, data);
+}
+
+int socket_rtio_close(const struct rtio_iodev *iodev)
+{
+	struct socket_rtio_data *data = iodev->data;
+	struct rtio_iodev_sqe *connect_sqe;
+	struct net_context *ctx;
+	struct mpsc_node *node;
+	k_spinlock_key_t key;
+	bool is_listen;
+	void *p;
+
+	key = k_spin_lock(&socket_rtio_lock);
+
+	/* Let a thread completing receive submissions finish with the context */
+	while (data->rx_busy) {
+		data->rx_wait = true;
+		k_spin_unlock(&socket_rtio_lock, key);
+		(void)k_sem_take(&data->rx_idle, K_FOREVER);
+		key = k_spin_lock(&socket_rtio_lock);
+	}
+
+	ctx = data->ctx;
+	if (ctx == NULL) {
+		k_spin_unlock(&socket_rtio_lock, key);
+		return -EBADF;
+	}
+
+	data->ctx = NULL;
+	ctx->user_data = NULL;
+	connect_sqe = data->connect_sqe;
+	data->connect_sqe = NULL;
+
+	k_spin_unlock(&socket_rtio_lock, key);
+
+	is_listen = net_context_get_state(ctx) == NET_CONTEXT_LISTENING;
+	if (is_listen) {
+		(void)net_context_accept(ctx, NULL, K_NO_WAIT, NULL);
+	} else {
+		(void)net_context_recv(ctx, NULL, K_NO_WAIT, NULL);
+	}
+
+	/* recv_q and accept_q are shared via a union */
+	while ((p = k_fifo_get(&ctx->recv_q, K_NO_WAIT)) != NULL) {
+		if (is_listen) {
+			net_context_put(p);
+		} else {
+			net_pkt_unref(p);
+		}
+	}
+
+	/* Nothing is queued once the context is detached, so no lock needed */
+	while ((node = mpsc_pop(&data->rx_q)) != NULL) {
+		socket_rtio_finish(CONTAINER_OF(node, struct rtio_iodev_sqe, q), -ECANCELED);
+	}
+	while ((node = mpsc_pop(&data->accept_q)) != NULL) {
+		socket_rtio_finish(CONTAINER_OF(node, struct rtio_iodev_sqe, q), -ECANCELED);
+	}
+	if (connect_sqe != NULL) {
+		socket_rtio_finish(connect_sqe, -ECANCELED);
+	}
+
+	return net_context_put(ctx);
+}
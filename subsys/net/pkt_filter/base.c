@@ -74,16 +74,20 @@ static struct npf_rule_list *get_ip_rules(uint8_t pf)
  */
 
 /*
- * All tests must be true to return true.
+ * All tests but the skipped one must be true to return true.
  * If no tests then it is true.
  */
-static bool apply_tests(struct npf_rule *rule, struct net_pkt *pkt)
+static bool apply_tests_skip(struct npf_rule *rule, struct net_pkt *pkt, int skip)
 {
 	struct npf_test *test;
 	unsigned int i;
 	bool result;
 
 	for (i = 0; i < rule->nb_tests; i++) {
+		if ((int)i == skip) {
+			continue;
+		}
+
 		test = rule->tests[i];
 		result = test->fn(test, pkt);
 		NET_DBG("test %p result %d", test, result);
@@ -95,6 +99,11 @@ static bool apply_tests(struct npf_rule *rule, struct net_pkt *pkt)
 	return true;
 }
 
+static inline bool apply_tests(struct npf_rule *rule, struct net_pkt *pkt)
+{
+	return apply_tests_skip(rule, pkt, -1);
+}
+
 /*
  * We return the specified result for the first rule whose tests are all true.
  */
@@ -119,8 +128,283 @@ static enum net_verdict evaluate(sys_slist_t *rule_head, struct net_pkt *pkt)
 	return NET_DROP;
 }
 
+#ifdef CONFIG_NET_PKT_FILTER_COMPILED
+
+/*
+ * Compiled rule lists
+ *
+ * Each rule with an Ethernet type or interface match test is chained with
+ * the other rules having the same test value, the other rules are chained
+ * together as wildcards. The chains of a packet are looked up by value and
+ * merged in rule order, so that the first matching rule still wins, while
+ * the rules of other values are not visited and the looked up test is not
+ * evaluated again.
+ *
+ * Evaluations use the active compiled set without taking the rule list
+ * lock. Updates compile the list into the other set and swap them, then wait
+ * for the evaluations still using the previous set, so that removed rules
+ * are not referenced anymore once the update returns.
+ */
+
+#define NPF_RULE_NONE UINT16_MAX
+
+enum npf_key_kind {
+	NPF_KEY_ETH_TYPE = 1,
+	NPF_KEY_IFACE,
+};
+
+static K_MUTEX_DEFINE(npf_update_lock);
+
+static uint32_t bucket_hash(uint8_t kind, uintptr_t key)
+{
+	uint32_t hash = (uint32_t)key ^ (uint32_t)((uint64_t)key >> 32) ^ kind;
+
+	hash *= 0x9e3779b1U;
+
+	return (hash >> 16) % NPF_COMPILED_BUCKETS;
+}
+
+static struct npf_rule_bucket *bucket_find(struct npf_rule_set *set, uint8_t kind,
+					   uintptr_t key, bool add)
+{
+	uint32_t idx = bucket_hash(kind, key);
+
+	for (int i = 0; i < NPF_COMPILED_BUCKETS; i++) {
+		struct npf_rule_bucket *bucket = &set->buckets[idx];
+
+		if (bucket->head == NPF_RULE_NONE) {
+			if (!add) {
+				return NULL;
+			}
+
+			bucket->kind = kind;
+			bucket->key = key;
+			return bucket;
+		}
+
+		if (bucket->kind == kind && bucket->key == key) {
+			return bucket;
+		}
+
+		idx = (idx + 1) % NPF_COMPILED_BUCKETS;
+	}
+
+	return NULL;
+}
+
+static int rule_key(struct npf_rule *rule, uint8_t *kind, uintptr_t *key)
+{
+	for (uint32_t i = 0; i < MIN(rule->nb_tests, INT8_MAX); i++) {
+		struct npf_test *test = rule->tests[i];
+
+#ifdef CONFIG_NET_L2_ETHERNET
+		if (test->fn == npf_eth_type_match) {
+			*kind = NPF_KEY_ETH_TYPE;
+			*key = CONTAINER_OF(test, struct npf_test_eth_type, test)->type;
+			return i;
+		}
+#endif
+
+		if (test->fn == npf_iface_match) {
+			*kind = NPF_KEY_IFACE;
+			*key = (uintptr_t)CONTAINER_OF(test, struct npf_test_iface, test)->iface;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static bool compile(struct npf_rule_set *set, sys_slist_t *rule_head)
+{
+	struct npf_rule *rule;
+	uint16_t idx = 0;
+
+	if (sys_slist_len(rule_head) > NPF_COMPILED_MAX_RULES) {
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(rule_head, rule, node) {
+		set->rules[idx++] = rule;
+	}
+
+	set->nb_rules = idx;
+	set->wildcard_head = NPF_RULE_NONE;
+	set->kinds = 0;
+
+	for (int i = 0; i < NPF_COMPILED_BUCKETS; i++) {
+		set->buckets[i].head = NPF_RULE_NONE;
+	}
+
+	/* Chains are built backwards, so that they are in rule order */
+	while (idx-- > 0) {
+		uint16_t *head = &set->wildcard_head;
+		uintptr_t key;
+		uint8_t kind;
+
+		set->key_test[idx] = rule_key(set->rules[idx], &kind, &key);
+		if (set->key_test[idx] >= 0) {
+			/* There are at most as many values as rules */
+			head = &bucket_find(set, kind, key, true)->head;
+			set->kinds |= BIT(kind);
+		}
+
+		set->next[idx] = *head;
+		*head = idx;
+	}
+
+	return true;
+}
+
+static uint16_t chain_head(struct npf_rule_set *set, uint8_t kind, uintptr_t key)
+{
+	struct npf_rule_bucket *bucket;
+
+	if ((set->kinds & BIT(kind)) == 0) {
+		return NPF_RULE_NONE;
+	}
+
+	bucket = bucket_find(set, kind, key, false);
+
+	return bucket != NULL ? bucket->head : NPF_RULE_NONE;
+}
+
+static enum net_verdict evaluate_compiled(struct npf_rule_set *set, struct net_pkt *pkt)
+{
+	uint16_t wildcard = set->wildcard_head;
+	uint16_t eth_type = NPF_RULE_NONE;
+	uint16_t iface;
+	uint16_t idx;
+
+	if (set->nb_rules == 0) {
+		NET_DBG("no rules");
+		return NET_OK;
+	}
+
+#ifdef CONFIG_NET_L2_ETHERNET
+	/* Packets without the header match no Ethernet type rule, as in npf_eth_type_match() */
+	if ((set->kinds & BIT(NPF_KEY_ETH_TYPE)) != 0 && npf_eth_hdr_present(pkt)) {
+		eth_type = chain_head(set, NPF_KEY_ETH_TYPE, NET_ETH_HDR(pkt)->type);
+	}
+#endif
+	iface = chain_head(set, NPF_KEY_IFACE, (uintptr_t)net_pkt_iface(pkt));
+
+	while (true) {
+		idx = MIN(wildcard, MIN(eth_type, iface));
+		if (idx == NPF_RULE_NONE) {
+			break;
+		}
+
+		if (apply_tests_skip(set->rules[idx], pkt, set->key_test[idx])) {
+			return set->rules[idx]->result;
+		}
+
+		if (idx == wildcard) {
+			wildcard = set->next[idx];
+		} else if (idx == eth_type) {
+			eth_type = set->next[idx];
+		} else {
+			iface = set->next[idx];
+		}
+	}
+
+	NET_DBG("no matching rules from set %p", set);
+	return NET_DROP;
+}
+
+static struct npf_rule_set *rule_set_get(struct npf_rule_list *rules)
+{
+	struct npf_rule_set *set;
+
+	while (true) {
+		set = atomic_ptr_get(&rules->active);
+		if (set == NULL) {
+			return NULL;
+		}
+
+		atomic_inc(&set->readers);
+
+		/* The set may have been swapped out before being marked in use */
+		if (atomic_ptr_get(&rules->active) == set) {
+			return set;
+		}
+
+		atomic_dec(&set->readers);
+	}
+}
+
+static void rule_set_put(struct npf_rule_set *set)
+{
+	atomic_dec(&set->readers);
+}
+
+static void rule_set_wait(struct npf_rule_set *set)
+{
+	while (atomic_get(&set->readers) != 0) {
+		k_sleep(K_TICKS(1));
+	}
+}
+
+static void update_begin(void)
+{
+	__ASSERT(!k_is_in_isr(), "rule lists can only be updated from thread context");
+
+	k_mutex_lock(&npf_update_lock, K_FOREVER);
+}
+
+static void update_end(struct npf_rule_list *rules)
+{
+	struct npf_rule_set *old = atomic_ptr_get(&rules->active);
+	struct npf_rule_set *set = old == &rules->sets[0] ? &rules->sets[1] : &rules->sets[0];
+	k_spinlock_key_t key;
+	bool compiled;
+
+	/* Late evaluations may still be using the set from the swap before */
+	rule_set_wait(set);
+
+	key = k_spin_lock(&rules->lock);
+	compiled = compile(set, &rules->rule_head);
+	k_spin_unlock(&rules->lock, key);
+
+	if (!compiled) {
+		NET_DBG("too many rules in %p, not compiled", rules);
+	}
+
+	atomic_ptr_set(&rules->active, compiled ? set : NULL);
+
+	if (old != NULL) {
+		rule_set_wait(old);
+	}
+
+	k_mutex_unlock(&npf_update_lock);
+}
+
+#else
+
+static inline void update_begin(void)
+{
+}
+
+static inline void update_end(struct npf_rule_list *rules)
+{
+	ARG_UNUSED(rules);
+}
+
+#endif /* CONFIG_NET_PKT_FILTER_COMPILED */
+
 static enum net_verdict lock_evaluate(struct npf_rule_list *rules, struct net_pkt *pkt)
 {
+#ifdef CONFIG_NET_PKT_FILTER_COMPILED
+	struct npf_rule_set *set = rule_set_get(rules);
+
+	if (set != NULL) {
+		enum net_verdict result = evaluate_compiled(set, pkt);
+
+		rule_set_put(set);
+		return result;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 	enum net_verdict result = evaluate(&rules->rule_head, pkt);
 
@@ -173,12 +457,16 @@ bool net_pkt_filter_ip_recv_ok(struct net_pkt *pkt)
 
 void npf_insert_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 {
+	update_begin();
+
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 
 	NET_DBG("inserting rule %p into %p", rule, rules);
 	sys_slist_prepend(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
+
+	update_end(rules);
 }
 
 void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
@@ -186,26 +474,37 @@ void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 	__ASSERT(sys_slist_peek_tail(&rules->rule_head) != &npf_default_ok.node, "");
 	__ASSERT(sys_slist_peek_tail(&rules->rule_head) != &npf_default_drop.node, "");
 
+	update_begin();
+
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 
 	NET_DBG("appending rule %p into %p", rule, rules);
 	sys_slist_append(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
+
+	update_end(rules);
 }
 
 bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 {
+	update_begin();
+
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 	bool result = sys_slist_find_and_remove(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
+
+	update_end(rules);
+
 	NET_DBG("removing rule %p from %p: %d", rule, rules, result);
 	return result;
 }
 
 bool npf_remove_all_rules(struct npf_rule_list *rules)
 {
+	update_begin();
+
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 	bool result = !sys_slist_is_empty(&rules->rule_head);
 
@@ -215,6 +514,9 @@ bool npf_remove_all_rules(struct npf_rule_list *rules)
 	}
 
 	k_spin_unlock(&rules->lock, key);
+
+	update_end(rules);
+
 	return result;
 }
 
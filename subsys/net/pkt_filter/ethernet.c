@@ -65,11 +65,31 @@ bool npf_eth_dst_addr_unmatch(struct npf_test *test, struct net_pkt *pkt)
 	return !npf_eth_dst_addr_match(test, pkt);
 }
 
+bool npf_eth_hdr_present(struct net_pkt *pkt)
+{
+	const struct net_l2 *l2 = net_if_l2(net_pkt_iface(pkt));
+
+	/*
+	 * The header stays at the head of the packet until the Ethernet L2 has
+	 * processed it, and other L2s have none. Packets not bound to any
+	 * interface are taken to carry one.
+	 */
+	return pkt->frags != NULL && pkt->frags->len >= sizeof(struct net_eth_hdr) &&
+	       !net_pkt_is_l2_processed(pkt) &&
+	       (net_pkt_iface(pkt) == NULL || l2 == &NET_L2_GET_NAME(ETHERNET));
+}
+
 bool npf_eth_type_match(struct npf_test *test, struct net_pkt *pkt)
 {
 	struct npf_test_eth_type *test_eth_type =
 			CONTAINER_OF(test, struct npf_test_eth_type, test);
-	struct net_eth_hdr *eth_hdr = NET_ETH_HDR(pkt);
+	struct net_eth_hdr *eth_hdr;
+
+	if (!npf_eth_hdr_present(pkt)) {
+		return false;
+	}
+
+	eth_hdr = NET_ETH_HDR(pkt);
 
 	/* note: type_match->type is assumed to be in network order already */
 	return eth_hdr->type == test_eth_type->type;
@@ -10,6 +10,8 @@
 #include <zephyr/arch/cpu.h>
 #include <zephyr/shell/shell.h>
 #include <zephyr/shell/shell_uart.h>
+#include <zephyr/profiling/perf.h>
+#include <zephyr/debug/symtab.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -142,6 +144,106 @@ static int cmd_perf_print(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+#ifdef CONFIG_PROFILING_PERF_CONTINUOUS
+static int cmd_perf_continuous_start(const struct shell *sh, size_t argc, char **argv)
+{
+	int ret = perf_continuous_start(strtoul(argv[1], NULL, 10));
+
+	if (ret == -EINPROGRESS) {
+		shell_warn(sh, "Perf is running");
+	} else if (ret != 0) {
+		shell_error(sh, "Invalid frequency");
+	} else {
+		shell_print(sh, "Enabled continuous perf");
+	}
+
+	return ret;
+}
+
+static int cmd_perf_continuous_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	perf_continuous_stop();
+	shell_print(sh, "Perf done!");
+
+	return 0;
+}
+
+static int cmd_perf_continuous_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	int ret = perf_continuous_reset();
+
+	if (ret != 0) {
+		shell_warn(sh, "Perf is running");
+	} else {
+		shell_print(sh, "Perf table cleared");
+	}
+
+	return ret;
+}
+
+static int cmd_perf_continuous_info(const struct shell *sh, size_t argc, char **argv)
+{
+	struct perf_continuous_stats stats;
+
+	perf_continuous_stats_get(&stats);
+	shell_print(sh, "Perf stacks: %u/%d, samples: %u, dropped: %u", stats.stacks,
+		    CONFIG_PROFILING_PERF_CONTINUOUS_STACKS, stats.samples, stats.dropped);
+
+	return 0;
+}
+
+static void perf_print_frame(const struct shell *sh, uintptr_t addr, bool return_addr)
+{
+#ifdef CONFIG_SYMTAB
+	uint32_t offset;
+
+	/* A return address may already belong to the next function */
+	shell_fprintf(sh, SHELL_NORMAL, ";%s",
+		      symtab_find_symbol_name(return_addr ? addr - 1 : addr, &offset));
+#else
+	ARG_UNUSED(return_addr);
+	shell_fprintf(sh, SHELL_NORMAL, ";0x%lx", addr);
+#endif
+}
+
+/* One line per stack: thread;cpu;outermost;...;innermost count */
+static void perf_print_folded(const struct perf_stack *stack, void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	if (stack->thread != NULL) {
+		shell_fprintf(sh, SHELL_NORMAL, "%s", stack->thread);
+	} else {
+		shell_fprintf(sh, SHELL_NORMAL, "%p", (void *)stack->tid);
+	}
+	shell_fprintf(sh, SHELL_NORMAL, ";cpu%u", stack->cpu);
+
+	for (int i = stack->depth - 1; i >= 0; i--) {
+		perf_print_frame(sh, stack->frames[i], i != 0);
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, " %u\n", stack->count);
+}
+
+static int cmd_perf_continuous_folded(const struct shell *sh, size_t argc, char **argv)
+{
+	perf_continuous_foreach(perf_print_folded, (void *)sh);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(m_sub_perf_continuous,
+	SHELL_CMD_ARG(start, NULL, "Start sampling on <frequency> Hz\nUsage: start <frequency>",
+		      cmd_perf_continuous_start, 2, 0),
+	SHELL_CMD_ARG(stop, NULL, "Stop sampling", cmd_perf_continuous_stop, 0, 0),
+	SHELL_CMD_ARG(folded, NULL, "Print the call stacks in folded format",
+		      cmd_perf_continuous_folded, 0, 0),
+	SHELL_CMD_ARG(reset, NULL, "Clear the call stack table", cmd_perf_continuous_reset, 0, 0),
+	SHELL_CMD_ARG(info, NULL, "Print the continuous perf info", cmd_perf_continuous_info, 0, 0),
+	SHELL_SUBCMD_SET_END
+);
+#endif /* CONFIG_PROFILING_PERF_CONTINUOUS */
+
 #define CMD_HELP_RECORD                                                                            \
 	"Start recording for <duration> ms on <frequency> Hz\n"                                    \
 	"Usage: record <duration> <frequency>"
@@ -151,6 +253,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(m_sub_perf,
 	SHELL_CMD_ARG(printbuf, NULL, "Print the perf buffer", cmd_perf_print, 0, 0),
 	SHELL_CMD_ARG(clear, NULL, "Clear the perf buffer", cmd_perf_clear, 0, 0),
 	SHELL_CMD_ARG(info, NULL, "Print the perf info", cmd_perf_info, 0, 0),
+	SHELL_COND_CMD(CONFIG_PROFILING_PERF_CONTINUOUS, continuous, &m_sub_perf_continuous,
+		       "Continuous sampling", NULL),
 	SHELL_SUBCMD_SET_END
 );
 SHELL_CMD_ARG_REGISTER(perf, &m_sub_perf, "Lightweight profiler", NULL, 0, 0);
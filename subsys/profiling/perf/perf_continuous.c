@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Continuous sampling: instead of appending raw stack traces to a buffer
+ * until it fills, every sample is folded into a hash table of call stacks,
+ * keyed by the sampled thread, its CPU and the return addresses, which only
+ * keeps a counter per distinct stack.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/profiling/perf.h>
+
+size_t arch_perf_current_stack_trace(uintptr_t *buf, size_t size);
+
+#define PERF_STACKS CONFIG_PROFILING_PERF_CONTINUOUS_STACKS
+#define PERF_DEPTH  CONFIG_PROFILING_PERF_CONTINUOUS_DEPTH
+
+struct perf_stack_entry {
+	/* Number of samples, 0 for an unused entry */
+	uint32_t count;
+	k_tid_t thread;
+	uint8_t cpu;
+	uint8_t depth;
+#ifdef CONFIG_THREAD_NAME
+	char name[CONFIG_THREAD_MAX_NAME_LEN];
+#endif
+	uintptr_t frames[PERF_DEPTH];
+};
+
+static struct perf_stack_entry perf_stacks[PERF_STACKS];
+static uintptr_t perf_scratch[PERF_DEPTH];
+static struct perf_continuous_stats perf_stats;
+static bool perf_running;
+static struct k_spinlock perf_lock;
+
+static uint32_t perf_stack_hash(k_tid_t thread, uint8_t cpu, const uintptr_t *frames,
+				size_t depth)
+{
+	/* FNV-1a over the words making up the key */
+	uint32_t hash = 2166136261U;
+
+	hash = (hash ^ (uint32_t)(uintptr_t)thread) * 16777619U;
+	hash = (hash ^ cpu) * 16777619U;
+	for (size_t i = 0; i < depth; i++) {
+		hash = (hash ^ (uint32_t)frames[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static bool perf_stack_match(const struct perf_stack_entry *e, k_tid_t thread, uint8_t cpu,
+			     const uintptr_t *frames, size_t depth)
+{
+	return e->thread == thread && e->cpu == cpu && e->depth == depth &&
+	       memcmp(e->frames, frames, depth * sizeof(frames[0])) == 0;
+}
+
+static void perf_continuous_sample(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	k_tid_t thread = _current;
+	uint8_t cpu = _current_cpu->id;
+	struct perf_stack_entry *e;
+	size_t depth;
+	uint32_t slot;
+	k_spinlock_key_t key = k_spin_lock(&perf_lock);
+
+	depth = arch_perf_current_stack_trace(perf_scratch, PERF_DEPTH);
+	if (depth == 0) {
+		/* Stack deeper than PERF_DEPTH frames */
+		perf_stats.dropped++;
+		goto out;
+	}
+
+	slot = perf_stack_hash(thread, cpu, perf_scratch, depth) % PERF_STACKS;
+	for (size_t probe = 0; probe < PERF_STACKS; probe++) {
+		e = &perf_stacks[slot];
+
+		if (e->count == 0U) {
+			e->thread = thread;
+			e->cpu = cpu;
+			e->depth = depth;
+			memcpy(e->frames, perf_scratch, depth * sizeof(perf_scratch[0]));
+#ifdef CONFIG_THREAD_NAME
+			/* Copied, as the thread may be gone by the time samples are exported */
+			strncpy(e->name, k_thread_name_get(thread), sizeof(e->name) - 1);
+			e->name[sizeof(e->name) - 1] = '\0';
+#endif
+			perf_stats.stacks++;
+		}
+
+		if (e->count == 0U || perf_stack_match(e, thread, cpu, perf_scratch, depth)) {
+			e->count++;
+			perf_stats.samples++;
+			goto out;
+		}
+
+		slot = (slot + 1) % PERF_STACKS;
+	}
+
+	perf_stats.dropped++;
+
+out:
+	k_spin_unlock(&perf_lock, key);
+}
+
+static K_TIMER_DEFINE(perf_continuous_timer, perf_continuous_sample, NULL);
+
+int perf_continuous_start(uint32_t frequency)
+{
+	k_timeout_t period;
+
+	if (frequency == 0U) {
+		return -EINVAL;
+	}
+
+	if (perf_running) {
+		return -EINPROGRESS;
+	}
+
+	period = K_NSEC(NSEC_PER_SEC / frequency);
+	perf_running = true;
+	k_timer_start(&perf_continuous_timer, period, period);
+
+	return 0;
+}
+
+void perf_continuous_stop(void)
+{
+	k_timer_stop(&perf_continuous_timer);
+	perf_running = false;
+}
+
+int perf_continuous_reset(void)
+{
+	k_spinlock_key_t key;
+
+	if (perf_running) {
+		return -EINPROGRESS;
+	}
+
+	key = k_spin_lock(&perf_lock);
+	memset(perf_stacks, 0, sizeof(perf_stacks));
+	memset(&perf_stats, 0, sizeof(perf_stats));
+	k_spin_unlock(&perf_lock, key);
+
+	return 0;
+}
+
+void perf_continuous_stats_get(struct perf_continuous_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&perf_lock);
+
+	*stats = perf_stats;
+	k_spin_unlock(&perf_lock, key);
+}
+
+void perf_continuous_foreach(perf_stack_cb_t cb, void *user_data)
+{
+	struct perf_stack_entry snapshot;
+	struct perf_stack stack;
+	k_spinlock_key_t key;
+
+	/* Entries are only ever added while sampling, so indexes stay stable */
+	for (size_t i = 0; i < PERF_STACKS; i++) {
+		key = k_spin_lock(&perf_lock);
+		snapshot = perf_stacks[i];
+		k_spin_unlock(&perf_lock, key);
+
+		if (snapshot.count == 0U) {
+			continue;
+		}
+
+		stack = (struct perf_stack) {
+			.tid = snapshot.thread,
+#ifdef CONFIG_THREAD_NAME
+			.thread = snapshot.name[0] != '\0' ? snapshot.name : NULL,
+#endif
+			.cpu = snapshot.cpu,
+			.depth = snapshot.depth,
+			.count = snapshot.count,
+			.frames = snapshot.frames,
+		};
+		cb(&stack, user_data);
+	}
+}
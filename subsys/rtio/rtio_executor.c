@@ -10,6 +10,259 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(rtio_executor, CONFIG_RTIO_LOG_LEVEL);
 
+#if defined(CONFIG_SYS_CLOCK_EXISTS) && (CONFIG_RTIO_TIMEOUT_COUNT > 0)
+
+/*
+ * Timer of a started timeout submission. Timers are taken from a pool shared by all the RTIO
+ * contexts, so that the submissions, which every context allocates in numbers, only carry a
+ * pointer to one.
+ */
+struct rtio_timeout {
+	struct k_timer timer;
+	sys_snode_t node;
+	/* The timeout submission */
+	struct rtio_iodev_sqe *iodev_sqe;
+	/* Submission bounded by a linked timeout */
+	struct rtio_iodev_sqe *linked;
+	/* Holders of the timer: the timer itself until it expires or is stopped, and the
+	 * executor until it stops a linked timeout
+	 */
+	uint8_t refs;
+	/* Whether the timeout may still expire */
+	bool armed;
+};
+
+BUILD_ASSERT(sizeof(((struct rtio_sqe *)0)->timeout) <= sizeof(((struct rtio_sqe *)0)->txrx),
+	     "Timeout submissions must not grow the submission union");
+
+static struct rtio_timeout rtio_timeouts[CONFIG_RTIO_TIMEOUT_COUNT];
+static sys_slist_t rtio_timeout_free = SYS_SLIST_STATIC_INIT(&rtio_timeout_free);
+/* Timers of the pool never used yet, which still need to be initialized */
+static size_t rtio_timeout_unused;
+
+/* Protects the pool and serializes the expiry of linked timeouts with the completion of what
+ * they bound
+ */
+static struct k_spinlock rtio_timeout_lock;
+
+static void rtio_timeout_expired(struct k_timer *timer);
+static void rtio_timeout_stopped(struct k_timer *timer);
+
+static inline void rtio_timeout_init(struct rtio_iodev_sqe *iodev_sqe)
+{
+	/* Only set while a timer is held for the submission */
+	iodev_sqe->sqe.timeout.timer = NULL;
+}
+
+/* Must be called with rtio_timeout_lock held */
+static struct rtio_timeout *rtio_timeout_alloc(void)
+{
+	struct rtio_timeout *t;
+	sys_snode_t *node = sys_slist_get(&rtio_timeout_free);
+
+	if (node != NULL) {
+		return CONTAINER_OF(node, struct rtio_timeout, node);
+	}
+
+	if (rtio_timeout_unused == ARRAY_SIZE(rtio_timeouts)) {
+		return NULL;
+	}
+
+	/* Timers are initialized once, they are linked to the kernel object lists */
+	t = &rtio_timeouts[rtio_timeout_unused++];
+	k_timer_init(&t->timer, rtio_timeout_expired, rtio_timeout_stopped);
+
+	return t;
+}
+
+/* Must be called with rtio_timeout_lock held */
+static void rtio_timeout_put(struct rtio_timeout *t)
+{
+	if (--t->refs == 0U) {
+		sys_slist_prepend(&rtio_timeout_free, &t->node);
+	}
+}
+
+static void rtio_timeout_expired(struct k_timer *timer)
+{
+	struct rtio_timeout *t = CONTAINER_OF(timer, struct rtio_timeout, timer);
+	k_spinlock_key_t key = k_spin_lock(&rtio_timeout_lock);
+	struct rtio_iodev_sqe *iodev_sqe = t->iodev_sqe;
+	struct rtio_iodev_sqe *curr = t->linked;
+	bool linked = curr != NULL;
+	bool expired = t->armed;
+
+	/* A linked timeout stopped meanwhile lets the submission it bounds complete */
+	t->armed = false;
+
+	if (expired && linked) {
+		/*
+		 * The bounded submission is still owned by its iodev. Cancel it along with the rest
+		 * of the chain, this timeout included, so that none of them produces a completion
+		 * once the iodev is done with it, and report the expiry right away.
+		 */
+		do {
+			curr->sqe.flags |= RTIO_SQE_CANCELED;
+			curr = rtio_iodev_sqe_next(curr);
+		} while (curr != NULL);
+
+		if ((iodev_sqe->sqe.flags & RTIO_SQE_NO_RESPONSE) == 0) {
+			rtio_cqe_submit(iodev_sqe->r, -ETIME, iodev_sqe->sqe.userdata, 0);
+		}
+	}
+
+	if (!linked) {
+		iodev_sqe->sqe.timeout.timer = NULL;
+	}
+	/* The timer may be reused as soon as it is released */
+	rtio_timeout_put(t);
+	k_spin_unlock(&rtio_timeout_lock, key);
+
+	if (expired && !linked) {
+		rtio_iodev_sqe_ok(iodev_sqe, 0);
+	}
+}
+
+static void rtio_timeout_stopped(struct k_timer *timer)
+{
+	/* Called by k_timer_stop() with rtio_timeout_lock held, the timer will not expire */
+	rtio_timeout_put(CONTAINER_OF(timer, struct rtio_timeout, timer));
+}
+
+/**
+ * @brief Start the timer of a timeout submission
+ *
+ * @param iodev_sqe Timeout submission
+ * @param linked Submission bounded by the timeout, NULL if it is not a linked timeout
+ *
+ * @retval 0 The timer is started
+ * @retval -ENOMEM All the timers are in use
+ */
+static int rtio_timeout_start(struct rtio_iodev_sqe *iodev_sqe, struct rtio_iodev_sqe *linked)
+{
+	k_spinlock_key_t key = k_spin_lock(&rtio_timeout_lock);
+	struct rtio_timeout *t = rtio_timeout_alloc();
+
+	if (t == NULL) {
+		k_spin_unlock(&rtio_timeout_lock, key);
+		LOG_WRN("No timer left for the timeout, see CONFIG_RTIO_TIMEOUT_COUNT");
+		return -ENOMEM;
+	}
+
+	t->iodev_sqe = iodev_sqe;
+	t->linked = linked;
+	t->refs = linked != NULL ? 2U : 1U;
+	t->armed = true;
+	iodev_sqe->sqe.timeout.timer = t;
+
+	k_timer_start(&t->timer, iodev_sqe->sqe.timeout.timeout, K_NO_WAIT);
+	k_spin_unlock(&rtio_timeout_lock, key);
+
+	return 0;
+}
+
+/**
+ * @brief Get the linked timeout bounding a submission, if any
+ */
+static inline struct rtio_iodev_sqe *rtio_link_timeout_get(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_iodev_sqe *next;
+
+	if ((iodev_sqe->sqe.flags & RTIO_SQE_CHAINED) == 0) {
+		return NULL;
+	}
+
+	next = iodev_sqe->next;
+	if (next == NULL || next->sqe.op != RTIO_OP_TIMEOUT ||
+	    (next->sqe.flags & RTIO_SQE_LINK_TIMEOUT) == 0) {
+		return NULL;
+	}
+
+	return next;
+}
+
+/**
+ * @brief Start the linked timeout bounding a submission given to an iodev
+ */
+static inline int rtio_link_timeout_start(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_iodev_sqe *timeout_sqe = rtio_link_timeout_get(iodev_sqe);
+
+	if (timeout_sqe == NULL) {
+		return 0;
+	}
+
+	return rtio_timeout_start(timeout_sqe, iodev_sqe);
+}
+
+/**
+ * @brief Stop the linked timeout bounding a completed submission
+ *
+ * Once stopped, the submission is either canceled because the timeout expired, or the timeout
+ * can no longer expire.
+ */
+static inline void rtio_link_timeout_stop(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_iodev_sqe *timeout_sqe = rtio_link_timeout_get(iodev_sqe);
+	struct rtio_timeout *t;
+	k_spinlock_key_t key;
+
+	if (timeout_sqe == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&rtio_timeout_lock);
+	t = timeout_sqe->sqe.timeout.timer;
+	if (t != NULL) {
+		timeout_sqe->sqe.timeout.timer = NULL;
+		/* An expiry already running on another CPU finds the timer disarmed */
+		t->armed = false;
+		k_timer_stop(&t->timer);
+		rtio_timeout_put(t);
+	}
+	k_spin_unlock(&rtio_timeout_lock, key);
+}
+
+static inline void rtio_timeout_op(struct rtio_iodev_sqe *iodev_sqe)
+{
+	struct rtio_sqe *sqe = &iodev_sqe->sqe;
+
+	if (sqe->flags & RTIO_SQE_LINK_TIMEOUT) {
+		/* Only reached once the bounded submission completed in time */
+		rtio_iodev_sqe_err(iodev_sqe, -ECANCELED);
+	} else if (K_TIMEOUT_EQ(sqe->timeout.timeout, K_FOREVER)) {
+		rtio_iodev_sqe_err(iodev_sqe, -EINVAL);
+	} else if (rtio_timeout_start(iodev_sqe, NULL) != 0) {
+		rtio_iodev_sqe_err(iodev_sqe, -ENOMEM);
+	}
+}
+
+#else
+
+static inline void rtio_timeout_init(struct rtio_iodev_sqe *iodev_sqe)
+{
+	ARG_UNUSED(iodev_sqe);
+}
+
+static inline int rtio_link_timeout_start(struct rtio_iodev_sqe *iodev_sqe)
+{
+	ARG_UNUSED(iodev_sqe);
+
+	return 0;
+}
+
+static inline void rtio_link_timeout_stop(struct rtio_iodev_sqe *iodev_sqe)
+{
+	ARG_UNUSED(iodev_sqe);
+}
+
+static inline void rtio_timeout_op(struct rtio_iodev_sqe *iodev_sqe)
+{
+	rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+}
+
+#endif /* CONFIG_SYS_CLOCK_EXISTS && CONFIG_RTIO_TIMEOUT_COUNT > 0 */
+
 /**
  * @brief Executor handled submissions
  */
@@ -22,6 +275,9 @@ static void rtio_executor_op(struct rtio_iodev_sqe *iodev_sqe)
 		sqe->callback.callback(iodev_sqe->r, sqe, sqe->callback.arg0);
 		rtio_iodev_sqe_ok(iodev_sqe, 0);
 		break;
+	case RTIO_OP_TIMEOUT:
+		rtio_timeout_op(iodev_sqe);
+		break;
 	default:
 		rtio_iodev_sqe_err(iodev_sqe, -EINVAL);
 	}
@@ -48,6 +304,11 @@ static inline void rtio_iodev_submit(struct rtio_iodev_sqe *iodev_sqe)
 		return;
 	}
 
+	if (rtio_link_timeout_start(iodev_sqe) != 0) {
+		rtio_iodev_sqe_err(iodev_sqe, -ENOMEM);
+		return;
+	}
+
 	iodev_sqe->sqe.iodev->api->submit(iodev_sqe);
 }
 
@@ -71,6 +332,9 @@ void rtio_executor_submit(struct rtio *r)
 			iodev_sqe->sqe.flags |= cancel_no_response;
 		}
 		iodev_sqe->r = r;
+		if (iodev_sqe->sqe.op == RTIO_OP_TIMEOUT) {
+			rtio_timeout_init(iodev_sqe);
+		}
 
 		struct rtio_iodev_sqe *curr = iodev_sqe, *next;
 
@@ -95,6 +359,9 @@ void rtio_executor_submit(struct rtio *r)
 			curr->next = next;
 			curr = next;
 			curr->r = r;
+			if (curr->sqe.op == RTIO_OP_TIMEOUT) {
+				rtio_timeout_init(curr);
+			}
 
 			__ASSERT(
 				curr != NULL,
@@ -141,13 +408,18 @@ static inline void rtio_executor_handle_multishot(struct rtio *r, struct rtio_io
 
 static inline void rtio_executor_done(struct rtio_iodev_sqe *iodev_sqe, int result, bool is_ok)
 {
-	const bool is_multishot = FIELD_GET(RTIO_SQE_MULTISHOT, iodev_sqe->sqe.flags) == 1;
-	const bool is_canceled = FIELD_GET(RTIO_SQE_CANCELED, iodev_sqe->sqe.flags) == 1;
+	bool is_multishot, is_canceled;
 	struct rtio *r = iodev_sqe->r;
 	struct rtio_iodev_sqe *curr = iodev_sqe, *next;
 	void *userdata;
 	uint32_t sqe_flags, cqe_flags;
 
+	/* A linked timeout may cancel the submission until it is stopped */
+	rtio_link_timeout_stop(iodev_sqe);
+
+	is_multishot = FIELD_GET(RTIO_SQE_MULTISHOT, iodev_sqe->sqe.flags) == 1;
+	is_canceled = FIELD_GET(RTIO_SQE_CANCELED, iodev_sqe->sqe.flags) == 1;
+
 	do {
 		userdata = curr->sqe.userdata;
 		sqe_flags = curr->sqe.flags;
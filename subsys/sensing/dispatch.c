@@ -34,6 +34,100 @@ static void update_client_consume_time(struct sensing_sensor *sensor,
 	conn->next_consume_time += interval;
 }
 
+static uint32_t batch_reading_count(struct sensing_connection *conn)
+{
+	return ((struct sensing_sensor_value_header *)conn->batch)->reading_count;
+}
+
+static void flush_client_batch(struct sensing_connection *conn)
+{
+	struct sensing_sensor_value_header *header = conn->batch;
+
+	if (header->reading_count == 0) {
+		return;
+	}
+
+	LOG_DBG("sensor:%s flush %d readings to client:%p", conn->source->dev->name,
+		header->reading_count, conn);
+
+	if (conn->callback_list->on_data_event) {
+		conn->callback_list->on_data_event(conn, conn->batch,
+				conn->callback_list->context);
+	}
+
+	header->reading_count = 0;
+}
+
+/* append the readings of a sample to the batch of a client, reporting the batch once full */
+static void batch_client_data(struct sensing_connection *conn, const void *data)
+{
+	const struct sensing_sensor_value_header *src = data;
+	struct sensing_sensor_value_header *dst = conn->batch;
+	size_t readings_offset, reading_size;
+	uint64_t timestamp = src->base_timestamp;
+	uint32_t delta;
+	const uint8_t *reading;
+
+	(void)get_sample_layout(conn->source->info->type, &readings_offset, &reading_size);
+
+	for (int i = 0; i < src->reading_count; i++) {
+		reading = (const uint8_t *)data + readings_offset + i * reading_size;
+
+		/* each reading starts with its timestamp delta to the previous one */
+		memcpy(&delta, reading, sizeof(delta));
+		timestamp += delta;
+
+		if (dst->reading_count > 0 && timestamp - conn->batch_timestamp > UINT32_MAX) {
+			flush_client_batch(conn);
+		}
+
+		if (dst->reading_count == 0) {
+			/* the fields preceding the readings are taken from the first sample */
+			memcpy(dst, src, readings_offset);
+			dst->base_timestamp = timestamp;
+			dst->reading_count = 0;
+			delta = 0;
+			conn->batch_deadline = get_us() + conn->latency;
+		} else {
+			delta = (uint32_t)(timestamp - conn->batch_timestamp);
+		}
+
+		memcpy((uint8_t *)dst + readings_offset + dst->reading_count * reading_size,
+		       reading, reading_size);
+		memcpy((uint8_t *)dst + readings_offset + dst->reading_count * reading_size,
+		       &delta, sizeof(delta));
+		dst->reading_count++;
+		conn->batch_timestamp = timestamp;
+
+		if (dst->reading_count == CONFIG_SENSING_BATCH_MAX_READINGS) {
+			flush_client_batch(conn);
+		}
+	}
+}
+
+/* report the batches whose latency expired, return when the next one expires */
+static uint64_t flush_expired_batches(uint64_t cur_time)
+{
+	struct sensing_connection *conn;
+	uint64_t next_deadline = UINT64_MAX;
+
+	for_each_sensor(sensor) {
+		for_each_client_conn(sensor, conn) {
+			if (conn->batch == NULL || batch_reading_count(conn) == 0) {
+				continue;
+			}
+
+			if (conn->batch_deadline <= cur_time || !is_client_batching(conn)) {
+				flush_client_batch(conn);
+			} else {
+				next_deadline = MIN(next_deadline, conn->batch_deadline);
+			}
+		}
+	}
+
+	return next_deadline;
+}
+
 /* send data to clients based on interval and sensitivity */
 static int send_data_to_clients(struct sensing_sensor *sensor,
 				void *data)
@@ -64,6 +158,12 @@ static int send_data_to_clients(struct sensing_sensor *sensor,
 					conn->source->dev->name);
 			continue;
 		}
+
+		if (is_client_batching(conn)) {
+			batch_client_data(conn, data);
+			continue;
+		}
+
 		conn->callback_list->on_data_event(conn, data,
 				conn->callback_list->context);
 	}
@@ -92,8 +192,16 @@ static void dispatch_task(void *a, void *b, void *c)
 
 	while (true) {
 		struct rtio_cqe cqe;
+		uint64_t cur_time = get_us();
+		uint64_t next_deadline = flush_expired_batches(cur_time);
+		k_timeout_t timeout = K_FOREVER;
+
+		/* sleep until either a sample arrives or a batch must be reported */
+		if (next_deadline != UINT64_MAX) {
+			timeout = K_USEC(next_deadline - cur_time);
+		}
 
-		rc = rtio_cqe_copy_out(&sensing_rtio_ctx, &cqe, 1, K_FOREVER);
+		rc = rtio_cqe_copy_out(&sensing_rtio_ctx, &cqe, 1, timeout);
 		if (rc < 1) {
 			continue;
 		}
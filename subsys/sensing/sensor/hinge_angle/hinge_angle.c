@@ -5,6 +5,7 @@
  */
 
 #include <stdlib.h>
+#include <zephyr/kernel.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/util.h>
@@ -143,6 +144,9 @@ static void hinge_reporter_on_data_event(sensing_sensor_handle_t handle,
 			return;
 		}
 
+		sample->header.base_timestamp = k_ticks_to_us_floor64(k_uptime_ticks());
+		sample->header.reading_count = 1;
+		sample->readings[0].timestamp_delta = 0;
 		sample->readings[0].v = calc_hinge_angle(data);
 
 		struct rtio_iodev_sqe *sqe = data->sqe;
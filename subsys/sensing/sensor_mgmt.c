@@ -181,11 +181,66 @@ static int config_sensitivity(struct sensing_sensor *sensor, int index)
 	return set_arbitrate_sensitivity(sensor, index, sensitivity);
 }
 
+static uint64_t arbitrate_latency(struct sensing_sensor *sensor)
+{
+	struct sensing_connection *conn;
+	uint64_t min_latency = UINT64_MAX;
+
+	/* search from all clients, arbitrate the latency */
+	for_each_client_conn(sensor, conn) {
+		if (!is_client_request_data(conn)) {
+			continue;
+		}
+		if (conn->latency < min_latency) {
+			min_latency = conn->latency;
+		}
+	}
+
+	/* min_latency == UINT64_MAX means sensor is not opened by any clients,
+	 * then latency should be 0
+	 */
+	return (min_latency == UINT64_MAX ? 0 : min_latency);
+}
+
+static int config_latency(struct sensing_sensor *sensor)
+{
+	struct sensing_submit_config *config = sensor->iodev->data;
+	uint64_t latency = arbitrate_latency(sensor);
+	struct sensor_value duration = {0};
+	int ret;
+
+	LOG_INF("config latency, sensor:%s, latency:%llu", sensor->dev->name, latency);
+
+	if (latency == sensor->latency) {
+		return 0;
+	}
+
+	/* let sensors with a hardware FIFO hold samples for as long as every client allows,
+	 * so that each streamed completion carries a whole FIFO frame
+	 */
+	duration.val1 = (int32_t)MIN(k_us_to_ticks_floor64(latency), INT32_MAX);
+	ret = sensor_attr_set(sensor->dev, config->chan,
+			SENSOR_ATTR_BATCH_DURATION, &duration);
+	if (ret == -ENOTSUP || ret == -ENOSYS) {
+		LOG_DBG("%s has no hardware batching", sensor->dev->name);
+		ret = 0;
+	}
+
+	sensor->latency = latency;
+
+	return ret;
+}
+
 static int config_sensor(struct sensing_sensor *sensor)
 {
 	int ret;
 	int i = 0;
 
+	ret = config_latency(sensor);
+	if (ret) {
+		LOG_WRN("sensor:%s config latency error:%d", sensor->dev->name, ret);
+	}
+
 	ret = config_interval(sensor);
 	if (ret) {
 		LOG_WRN("sensor:%s config interval error", sensor->dev->name);
@@ -382,6 +437,7 @@ int close_sensor(struct sensing_connection **conn)
 
 	save_config_and_notify(tmp_conn->source);
 
+	free(tmp_conn->batch);
 	free(*conn);
 	*conn = NULL;
 
@@ -500,6 +556,46 @@ int get_sensitivity(struct sensing_connection *conn, int8_t index, uint32_t *sen
 	return 0;
 }
 
+int set_latency(struct sensing_connection *conn, uint64_t latency)
+{
+	size_t readings_offset, reading_size;
+
+	__ASSERT(conn && conn->source, "set latency, connection or reporter not be NULL");
+
+	LOG_INF("set latency, sensor:%s, latency:%llu(us)", conn->source->dev->name, latency);
+
+	if (latency > 0 && conn->batch == NULL) {
+		if (!get_sample_layout(conn->source->info->type, &readings_offset,
+				       &reading_size)) {
+			LOG_ERR("sensor:%s samples cannot be batched", conn->source->dev->name);
+			return -ENOTSUP;
+		}
+
+		/* allocated once, the dispatch thread may be filling it from then on */
+		conn->batch = calloc(1, ROUND_UP(readings_offset + reading_size *
+					CONFIG_SENSING_BATCH_MAX_READINGS, sizeof(uint64_t)));
+		if (conn->batch == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	conn->latency = latency;
+
+	save_config_and_notify(conn->source);
+
+	return 0;
+}
+
+int get_latency(struct sensing_connection *conn, uint64_t *latency)
+{
+	__ASSERT(conn, "get latency, connection not be NULL");
+	*latency = conn->latency;
+
+	LOG_INF("get latency, sensor:%s, latency:%llu(us)", conn->source->dev->name, *latency);
+
+	return 0;
+}
+
 int sensing_get_sensors(int *sensor_nums, const struct sensing_sensor_info **info)
 {
 	if (info == NULL) {
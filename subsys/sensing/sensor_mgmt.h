@@ -8,10 +8,12 @@
 #define SENSOR_MGMT_H_
 
 #include <zephyr/sensing/sensing_datatypes.h>
+#include <zephyr/sensing/sensing_sensor_types.h>
 #include <zephyr/sensing/sensing_sensor.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys/slist.h>
 #include <zephyr/sys/ring_buffer.h>
+#include <stddef.h>
 #include <string.h>
 
 #ifdef __cplusplus
@@ -57,6 +59,8 @@ int set_interval(struct sensing_connection *conn, uint32_t interval);
 int get_interval(struct sensing_connection *con, uint32_t *sensitivity);
 int set_sensitivity(struct sensing_connection *conn, int8_t index, uint32_t interval);
 int get_sensitivity(struct sensing_connection *con, int8_t index, uint32_t *sensitivity);
+int set_latency(struct sensing_connection *conn, uint64_t latency);
+int get_latency(struct sensing_connection *conn, uint64_t *latency);
 
 static inline struct sensing_sensor *get_sensor_by_dev(const struct device *dev)
 {
@@ -105,6 +109,35 @@ static inline bool is_sensor_state_ready(struct sensing_sensor *sensor)
 	return (sensor->state == SENSING_SENSOR_STATE_READY);
 }
 
+/* get where the readings of a sample start and their size, for sensor types that can be batched */
+static inline bool get_sample_layout(int32_t type, size_t *readings_offset, size_t *reading_size)
+{
+	switch (type) {
+	case SENSING_SENSOR_TYPE_MOTION_ACCELEROMETER_3D:
+	case SENSING_SENSOR_TYPE_MOTION_UNCALIB_ACCELEROMETER_3D:
+	case SENSING_SENSOR_TYPE_MOTION_GYROMETER_3D:
+		*readings_offset = offsetof(struct sensing_sensor_value_3d_q31, readings);
+		*reading_size = sizeof(((struct sensing_sensor_value_3d_q31 *)0)->readings[0]);
+		return true;
+	case SENSING_SENSOR_TYPE_MOTION_HINGE_ANGLE:
+		*readings_offset = offsetof(struct sensing_sensor_value_q31, readings);
+		*reading_size = sizeof(((struct sensing_sensor_value_q31 *)0)->readings[0]);
+		return true;
+	case SENSING_SENSOR_TYPE_LIGHT_AMBIENTLIGHT:
+		*readings_offset = offsetof(struct sensing_sensor_value_uint32, readings);
+		*reading_size = sizeof(((struct sensing_sensor_value_uint32 *)0)->readings[0]);
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* check if readings for the client are batched */
+static inline bool is_client_batching(struct sensing_connection *conn)
+{
+	return conn->latency != 0 && conn->batch != NULL;
+}
+
 /* this function is used to decide whether filtering sensitivity checking
  * for example: filter sensitivity checking if sensitivity value is 0.
  */
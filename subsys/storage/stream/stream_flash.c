@@ -13,6 +13,8 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME, CONFIG_STREAM_FLASH_LOG_LEVEL);
 #include <zephyr/types.h>
 #include <string.h>
 #include <zephyr/drivers/flash.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/crc.h>
 
 #include <zephyr/storage/stream_flash.h>
 
@@ -122,23 +124,55 @@ int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
 
 #endif /* CONFIG_STREAM_FLASH_ERASE */
 
-static int flash_sync(struct stream_flash_ctx *ctx)
+#ifdef CONFIG_STREAM_FLASH_VERIFY
+
+#define VERIFY_CHUNK_SIZE 64
+
+/* Compare the CRC of the data read back in chunks with the CRC of the
+ * written buffer, so that the buffer is neither copied nor overwritten.
+ */
+static int flash_verify(struct stream_flash_ctx *ctx, const uint8_t *buf,
+			size_t len, size_t addr)
+{
+	uint8_t chunk[VERIFY_CHUNK_SIZE];
+	uint32_t crc = 0;
+	size_t chunk_len;
+	int rc;
+
+	for (size_t i = 0; i < len; i += chunk_len) {
+		chunk_len = MIN(len - i, sizeof(chunk));
+
+		rc = flash_read(ctx->fdev, addr + i, chunk, chunk_len);
+		if (rc != 0) {
+			LOG_ERR("flash read failed: %d", rc);
+			return rc;
+		}
+
+		crc = crc32_ieee_update(crc, chunk, chunk_len);
+	}
+
+	if (crc != crc32_ieee(buf, len)) {
+		LOG_ERR("verification failed offset=0x%08zx", addr);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_STREAM_FLASH_VERIFY */
+
+static int flash_program(struct stream_flash_ctx *ctx, uint8_t *buf,
+			 size_t buf_bytes, size_t write_addr)
 {
 	int rc = 0;
-	size_t write_addr = ctx->offset + ctx->bytes_written;
 	size_t buf_bytes_aligned;
 	size_t fill_length;
 	uint8_t filler;
 
-
-	if (ctx->buf_bytes == 0) {
-		return 0;
-	}
-
 	if (IS_ENABLED(CONFIG_STREAM_FLASH_ERASE)) {
 
 		rc = stream_flash_erase_page(ctx,
-					     write_addr + ctx->buf_bytes - 1);
+					     write_addr + buf_bytes - 1);
 		if (rc < 0) {
 			LOG_ERR("stream_flash_erase_page err %d offset=0x%08zx",
 				rc, write_addr);
@@ -147,17 +181,17 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 	}
 
 	fill_length = ctx->write_block_size;
-	if (ctx->buf_bytes % fill_length) {
-		fill_length -= ctx->buf_bytes % fill_length;
+	if (buf_bytes % fill_length) {
+		fill_length -= buf_bytes % fill_length;
 		filler = ctx->erase_value;
 
-		memset(ctx->buf + ctx->buf_bytes, filler, fill_length);
+		memset(buf + buf_bytes, filler, fill_length);
 	} else {
 		fill_length = 0;
 	}
 
-	buf_bytes_aligned = ctx->buf_bytes + fill_length;
-	rc = flash_write(ctx->fdev, write_addr, ctx->buf, buf_bytes_aligned);
+	buf_bytes_aligned = buf_bytes + fill_length;
+	rc = flash_write(ctx->fdev, write_addr, buf, buf_bytes_aligned);
 
 	if (rc != 0) {
 		LOG_ERR("flash_write error %d offset=0x%08zx", rc,
@@ -165,34 +199,235 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 		return rc;
 	}
 
+#ifdef CONFIG_STREAM_FLASH_VERIFY
+	rc = flash_verify(ctx, buf, buf_bytes, write_addr);
+	if (rc != 0) {
+		return rc;
+	}
+#endif
+
 	if (ctx->callback) {
 		/* Invert to ensure that caller is able to discover a faulty
 		 * flash_read() even if no error code is returned.
 		 */
-		for (int i = 0; i < ctx->buf_bytes; i++) {
-			ctx->buf[i] = ~ctx->buf[i];
+		for (int i = 0; i < buf_bytes; i++) {
+			buf[i] = ~buf[i];
 		}
 
-		rc = flash_read(ctx->fdev, write_addr, ctx->buf,
-				ctx->buf_bytes);
+		rc = flash_read(ctx->fdev, write_addr, buf, buf_bytes);
 		if (rc != 0) {
 			LOG_ERR("flash read failed: %d", rc);
 			return rc;
 		}
 
-		rc = ctx->callback(ctx->buf, ctx->buf_bytes, write_addr);
+		rc = ctx->callback(buf, buf_bytes, write_addr);
 		if (rc != 0) {
 			LOG_ERR("callback failed: %d", rc);
 			return rc;
 		}
 	}
 
+	return rc;
+}
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+
+static K_THREAD_STACK_DEFINE(stream_flash_work_q_stack,
+			     CONFIG_STREAM_FLASH_ASYNC_STACK_SIZE);
+static struct k_work_q stream_flash_work_q;
+
+static void async_program(struct k_work *work)
+{
+	struct stream_flash_ctx *ctx =
+		CONTAINER_OF(work, struct stream_flash_ctx, async.work);
+
+	ctx->async.rc = flash_program(ctx, ctx->async.buf, ctx->async.bytes,
+				      ctx->async.addr);
+}
+
+static void async_erase(struct k_work *work)
+{
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	struct stream_flash_ctx *ctx =
+		CONTAINER_OF(work, struct stream_flash_ctx, async.erase_work);
+	struct flash_pages_info page;
+	int rc;
+
+	/* Only the page the next buffer starts at is known to be written to.
+	 * When the buffer starts within a page, that page has already been
+	 * erased for the previous buffer.
+	 */
+	rc = flash_get_page_info_by_offs(ctx->fdev, ctx->async.erase_addr,
+					 &page);
+	if (rc == 0 && page.start_offset == ctx->async.erase_addr) {
+		rc = stream_flash_erase_page(ctx, ctx->async.erase_addr);
+	}
+
+	if (ctx->async.rc == 0) {
+		ctx->async.rc = rc;
+	}
+#endif
+}
+
+/* Wait for the work queue to be done with the context, and account for the
+ * buffer programmed.
+ */
+static int async_wait(struct stream_flash_ctx *ctx)
+{
+	struct k_work_sync sync;
+	int rc;
+
+	(void)k_work_flush(&ctx->async.work, &sync);
+	(void)k_work_flush(&ctx->async.erase_work, &sync);
+
+	rc = ctx->async.rc;
+	ctx->async.rc = 0;
+
+	if (rc == 0) {
+		ctx->bytes_written += ctx->async.bytes;
+	}
+
+	ctx->async.bytes = 0;
+
+	return rc;
+}
+
+/* Stop the work queue using the context before it is set up again, so that
+ * the buffers of a previous stream are not programmed into the new one.
+ */
+static void async_cancel(struct stream_flash_ctx *ctx)
+{
+	struct k_work_sync sync;
+
+	if (ctx->async.buf == NULL) {
+		return;
+	}
+
+	(void)k_work_cancel_sync(&ctx->async.work, &sync);
+	(void)k_work_cancel_sync(&ctx->async.erase_work, &sync);
+}
+
+/* Erase ahead the page the next buffer starts in, while it is being filled */
+static void async_erase_ahead(struct stream_flash_ctx *ctx)
+{
+	if (!IS_ENABLED(CONFIG_STREAM_FLASH_ERASE)) {
+		return;
+	}
+
+	ctx->async.erase_addr = ctx->offset + ctx->bytes_written +
+				ctx->async.bytes;
+
+	(void)k_work_submit_to_queue(&stream_flash_work_q,
+				     &ctx->async.erase_work);
+}
+
+static int async_sync(struct stream_flash_ctx *ctx)
+{
+	uint8_t *buf;
+	int rc;
+
+	rc = async_wait(ctx);
+	if (rc != 0) {
+		return rc;
+	}
+
+	if (ctx->buf_bytes == 0) {
+		return 0;
+	}
+
+	/* Swap the buffers, the spare one gets filled next */
+	buf = ctx->async.buf;
+	ctx->async.buf = ctx->buf;
+	ctx->async.bytes = ctx->buf_bytes;
+	ctx->async.addr = ctx->offset + ctx->bytes_written;
+	ctx->buf = buf;
+	ctx->buf_bytes = 0U;
+
+	(void)k_work_submit_to_queue(&stream_flash_work_q, &ctx->async.work);
+
+	return 0;
+}
+
+int stream_flash_set_async(struct stream_flash_ctx *ctx, uint8_t *buf, size_t buf_len)
+{
+	if (!ctx || !buf) {
+		return -EFAULT;
+	}
+
+	if (buf_len != ctx->buf_len) {
+		LOG_ERR("Buffer size differs from the write buffer size");
+		return -EINVAL;
+	}
+
+	async_cancel(ctx);
+
+	k_work_init(&ctx->async.work, async_program);
+	k_work_init(&ctx->async.erase_work, async_erase);
+	ctx->async.buf = buf;
+	ctx->async.bytes = 0;
+	ctx->async.rc = 0;
+
+	return 0;
+}
+
+static int stream_flash_work_q_init(void)
+{
+	k_work_queue_start(&stream_flash_work_q, stream_flash_work_q_stack,
+			   K_THREAD_STACK_SIZEOF(stream_flash_work_q_stack),
+			   CONFIG_STREAM_FLASH_ASYNC_THREAD_PRIO, NULL);
+	k_thread_name_set(&stream_flash_work_q.thread, "stream_flash_wq");
+
+	return 0;
+}
+
+SYS_INIT(stream_flash_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
+static size_t bytes_in_flight(const struct stream_flash_ctx *ctx)
+{
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	return ctx->async.bytes;
+#else
+	return 0;
+#endif
+}
+
+static int flash_sync(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (ctx->async.buf != NULL) {
+		return async_sync(ctx);
+	}
+#endif
+
+	if (ctx->buf_bytes == 0) {
+		return 0;
+	}
+
+	rc = flash_program(ctx, ctx->buf, ctx->buf_bytes,
+			   ctx->offset + ctx->bytes_written);
+	if (rc != 0) {
+		return rc;
+	}
+
 	ctx->bytes_written += ctx->buf_bytes;
 	ctx->buf_bytes = 0U;
 
 	return rc;
 }
 
+static void buf_start(struct stream_flash_ctx *ctx)
+{
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (ctx->async.buf != NULL) {
+		async_erase_ahead(ctx);
+	}
+#endif
+}
+
 int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
 				size_t len, bool flush)
 {
@@ -204,12 +439,17 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		return -EFAULT;
 	}
 
-	if (ctx->bytes_written + ctx->buf_bytes + len > ctx->available) {
+	if (ctx->bytes_written + bytes_in_flight(ctx) + ctx->buf_bytes + len >
+	    ctx->available) {
 		return -ENOMEM;
 	}
 
 	while ((len - processed) >=
 	       (buf_empty_bytes = ctx->buf_len - ctx->buf_bytes)) {
+		if (ctx->buf_bytes == 0) {
+			buf_start(ctx);
+		}
+
 		memcpy(ctx->buf + ctx->buf_bytes, data + processed,
 		       buf_empty_bytes);
 
@@ -225,6 +465,10 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 
 	/* place rest of the data into ctx->buf */
 	if (processed < len) {
+		if (ctx->buf_bytes == 0) {
+			buf_start(ctx);
+		}
+
 		memcpy(ctx->buf + ctx->buf_bytes,
 		       data + processed, len - processed);
 		ctx->buf_bytes += len - processed;
@@ -234,12 +478,19 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		rc = flash_sync(ctx);
 	}
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	/* Flushing concludes the stream, wait for the buffers in flight */
+	if (flush && rc == 0 && ctx->async.buf != NULL) {
+		rc = async_wait(ctx);
+	}
+#endif
+
 	return rc;
 }
 
 size_t stream_flash_bytes_written(const struct stream_flash_ctx *ctx)
 {
-	return ctx->bytes_written;
+	return ctx->bytes_written + bytes_in_flight(ctx);
 }
 
 struct _inspect_flash {
@@ -272,6 +523,10 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 		return -EFAULT;
 	}
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	async_cancel(ctx);
+#endif
+
 #ifdef CONFIG_STREAM_FLASH_PROGRESS
 	int rc = settings_subsys_init();
 
@@ -323,6 +578,10 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 	ctx->last_erased_page_start_offset = -1;
 #endif
 	ctx->erase_value = params->erase_value;
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	ctx->async.buf = NULL;
+	ctx->async.bytes = 0;
+#endif
 
 	return 0;
 }
@@ -130,6 +130,11 @@ static void test_thread_entry(void *p1, void *p2, void *p3)
 	}
 
 	pipe_test();
+
+	/* Claimed pipe regions are in kernel memory */
+	if (!skip_mem_and_mbox) {
+		pipe_zc_test();
+	}
 }
 
 /**
@@ -36,6 +36,7 @@
 #define NR_OF_MAP_RUNS 1000
 #define NR_OF_MBOX_RUNS 128
 #define NR_OF_PIPE_RUNS 256
+#define NR_OF_PIPE_ZC_BYTES 65536
 #define SEMA_WAIT_TIME (5000)
 
 #ifdef CONFIG_USERSPACE
@@ -80,6 +81,7 @@ extern void message_queue_test(void);
 extern void mutex_test(void);
 extern void memorymap_test(void);
 extern void pipe_test(void);
+extern void pipe_zc_test(void);
 
 /* kernel objects needed for benchmarking */
 extern struct k_mutex DEMO_MUTEX;
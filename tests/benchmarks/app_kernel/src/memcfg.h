@@ -11,5 +11,6 @@
 
 #define MESSAGE_SIZE        4096
 #define MESSAGE_SIZE_PIPE   2048	/* must be smaller than MESSAGE_SIZE */
+#define MESSAGE_SIZE_PIPE_ZC 16384	/* largest zero-copy pipe packet */
 
 #endif
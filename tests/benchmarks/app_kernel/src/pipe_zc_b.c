@@ -0,0 +1,116 @@
+/* pipe_zc_b.c */
+
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "master.h"
+
+#define PRINT_ZC_HEADER()                                                     \
+	do {                                                                  \
+		PRINT_STRING("|   size(B) |       time/packet (nsec)      "   \
+			     "|              MB/sec             |\n");        \
+		PRINT_STRING(dashline);                                       \
+		PRINT_STRING("|           |      copy     |  claim/commit "   \
+			     "|      copy      |  claim/commit  |\n");        \
+		PRINT_STRING(dashline);                                       \
+	} while (0)
+
+#define PRINT_ZC()                                                            \
+	PRINT_F("|%11u|%15u|%15u|%16u|%16u|\n",                               \
+		size, time[0], time[1],                                       \
+		(uint32_t)(((uint64_t)size * 1000U) / SAFE_DIVISOR(time[0])), \
+		(uint32_t)(((uint64_t)size * 1000U) / SAFE_DIVISOR(time[1])))
+
+BENCH_BMEM char data_zc[MESSAGE_SIZE_PIPE_ZC];
+
+static const uint32_t zc_sizes[] = {64, 1024, MESSAGE_SIZE_PIPE_ZC};
+
+/**
+ * @brief Produce @a count packets of @a size bytes into the pipe
+ *
+ * The producer generates each packet, either in its own buffer which is
+ * then copied into the pipe, or in place in the pipe buffer.
+ *
+ * @return 0 on success, 1 on error
+ */
+static int pipeput_zc(struct k_pipe *pipe, bool zero_copy, uint32_t size,
+		      int count, uint32_t *time)
+{
+	timing_t start;
+	timing_t end;
+	size_t written;
+	void *data;
+	size_t claimed;
+
+	/* first sync with the receiver */
+	k_sem_give(&SEM0);
+	start = timing_timestamp_get();
+	for (int i = 0; i < count; i++) {
+		if (!zero_copy) {
+			(void)memset(data_zc, i, size);
+			if (k_pipe_put(pipe, data_zc, size, &written, size,
+				       K_FOREVER) != 0) {
+				return 1;
+			}
+			continue;
+		}
+
+		for (size_t left = size; left != 0; left -= claimed) {
+			claimed = left;
+			if (k_pipe_put_claim(pipe, &data, &claimed,
+					     K_FOREVER) != 0) {
+				return 1;
+			}
+			(void)memset(data, i, claimed);
+			(void)k_pipe_put_commit(pipe, claimed);
+		}
+	}
+	end = timing_timestamp_get();
+
+	*time = SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timing_cycles_get(&start, &end),
+					      count);
+
+	return 0;
+}
+
+/**
+ * @brief Compare copying and zero-copy pipe transfers
+ */
+void pipe_zc_test(void)
+{
+	uint32_t time[2];
+	struct getinfo getinfo;
+
+	k_sem_reset(&SEM0);
+	k_sem_give(&STARTRCV);
+
+	PRINT_STRING(dashline);
+	PRINT_STRING("|            Z E R O - C O P Y   P I P E"
+		     "   M E A S U R E M E N T S            |\n");
+	PRINT_STRING(dashline);
+	PRINT_STRING("| Stream data through a 4096 byte pipe buffer to a"
+		     " higher priority task       |\n");
+	PRINT_STRING(dashline);
+	PRINT_ZC_HEADER();
+
+	ARRAY_FOR_EACH(zc_sizes, i) {
+		uint32_t size = zc_sizes[i];
+		int count = NR_OF_PIPE_ZC_BYTES / size;
+
+		for (int zero_copy = 0; zero_copy < 2; zero_copy++) {
+			int ret = pipeput_zc(&PIPE_BIGBUFF, zero_copy, size,
+					     count, &time[zero_copy]);
+
+			/* waiting for ack */
+			k_msgq_get(&CH_COMM, &getinfo, K_FOREVER);
+			if (ret != 0 || getinfo.count < 0) {
+				PRINT_STRING("| pipe transfer failed\n");
+			}
+		}
+		PRINT_ZC();
+	}
+	PRINT_STRING(dashline);
+}
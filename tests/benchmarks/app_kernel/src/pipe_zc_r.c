@@ -0,0 +1,78 @@
+/* pipe_zc_r.c */
+
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "receiver.h"
+#include "master.h"
+
+BENCH_BMEM char data_zc_recv[MESSAGE_SIZE_PIPE_ZC];
+
+/**
+ * @brief Consume @a count packets of @a size bytes from the pipe
+ *
+ * The consumer checks each packet, either after copying it out of the pipe,
+ * or in place in the pipe buffer.
+ *
+ * @return 0 on success, 1 on error
+ */
+static int pipeget_zc(struct k_pipe *pipe, bool zero_copy, uint32_t size,
+		      int count)
+{
+	size_t read;
+	void *data;
+	size_t claimed;
+
+	/* sync with the sender */
+	k_sem_take(&SEM0, K_FOREVER);
+	for (int i = 0; i < count; i++) {
+		if (!zero_copy) {
+			if (k_pipe_get(pipe, data_zc_recv, size, &read, size,
+				       K_FOREVER) != 0 ||
+			    data_zc_recv[size - 1] != (char)i) {
+				return 1;
+			}
+			continue;
+		}
+
+		for (size_t left = size; left != 0; left -= claimed) {
+			claimed = left;
+			if (k_pipe_get_claim(pipe, &data, &claimed,
+					     K_FOREVER) != 0 ||
+			    ((char *)data)[claimed - 1] != (char)i) {
+				return 1;
+			}
+			(void)k_pipe_get_commit(pipe, claimed);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Receive task of the zero-copy pipe test
+ */
+void pipezcrecvtask(void)
+{
+	static const uint32_t sizes[] = {64, 1024, MESSAGE_SIZE_PIPE_ZC};
+	struct getinfo getinfo;
+
+	ARRAY_FOR_EACH(sizes, i) {
+		int count = NR_OF_PIPE_ZC_BYTES / sizes[i];
+
+		for (int zero_copy = 0; zero_copy < 2; zero_copy++) {
+			getinfo.time = 0;
+			getinfo.size = sizes[i];
+			getinfo.count = count;
+			if (pipeget_zc(&PIPE_BIGBUFF, zero_copy, sizes[i],
+				       count) != 0) {
+				getinfo.count = -1;
+			}
+			/* acknowledge to master */
+			k_msgq_put(&CH_COMM, &getinfo, K_FOREVER);
+		}
+	}
+}
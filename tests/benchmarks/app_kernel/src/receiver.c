@@ -23,6 +23,7 @@ void dequtask(void);
 void waittask(void);
 void mailrecvtask(void);
 void piperecvtask(void);
+void pipezcrecvtask(void);
 
 /**
  * @brief Main function of the task that receives data in the test
@@ -49,4 +50,9 @@ void recvtask(void *p1, void *p2, void *p3)
 
 	k_sem_take(&STARTRCV, K_FOREVER);
 	piperecvtask();
+
+	if (!skip_mbox) {
+		k_sem_take(&STARTRCV, K_FOREVER);
+		pipezcrecvtask();
+	}
 }
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_REPORT_H_
+#define ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_REPORT_H_
+
+/*
+ * Records printed by the benchmarks, one per line. Twister cannot share
+ * harness settings between applications, so the testcase.yaml of each
+ * benchmark collects them with this console harness:
+ *
+ *   harness: console
+ *   harness_config:
+ *     type: one_line
+ *     record:
+ *       regex: "(?P<metric>.*) - (?P<description>.*):\\s*(?P<value>[0-9]+) (?P<unit>.*)"
+ *     regex:
+ *       - "PROJECT EXECUTION SUCCESSFUL"
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <zephyr/sys/printk.h>
+
+/**
+ * @brief Print a benchmark record
+ *
+ * @param tag Metric name, unique in the benchmark
+ * @param description What the value measures
+ * @param value Measured value
+ * @param unit Unit of @p value
+ */
+static inline void bench_report(const char *tag, const char *description, uint64_t value,
+				const char *unit)
+{
+	printk("%-40s - %-34s:%10" PRIu64 " %s\n", tag, description, value, unit);
+}
+
+#endif /* ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_REPORT_H_ */
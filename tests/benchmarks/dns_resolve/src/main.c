@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken by the DNS resolver
+ * to resolve names, from a stand-in DNS server on the loopback interface
+ * and from its cache, and count the queries the server receives.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/dns_resolve.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_LOOKUPS CONFIG_BENCHMARK_NUM_LOOKUPS
+#define NUM_BURSTS  CONFIG_BENCHMARK_NUM_BURSTS
+#define BURST_SIZE  CONFIG_DNS_NUM_CONCUR_QUERIES
+#define NUM_HOSTS   200
+#define NUM_MISSING 25
+#define NUM_NAMES   (NUM_HOSTS + NUM_MISSING)
+#define NAME_LEN    32
+#define TIMEOUT_MS  2000
+
+#define SERVER_PORT   15353
+#define SERVER_PRIO   K_PRIO_PREEMPT(8)
+#define DNS_HDR_LEN   12
+#define DNS_TYPE_A    1
+#define DNS_TYPE_SOA  6
+#define DNS_CLASS_IN  1
+#define DNS_NXDOMAIN  3
+#define RR_HDR_LEN    12 /* Compressed owner, type, class, TTL, RDATA length */
+#define SOA_RDATA_LEN 32 /* Compressed "ns" and "host" names and 5 values */
+#define HOST_TTL      300
+#define SOA_TTL       3600
+#define SOA_MINIMUM   60
+
+static K_SEM_DEFINE(server_ready, 0, 1);
+static K_SEM_DEFINE(done, 0, BURST_SIZE);
+static atomic_t server_queries;
+
+struct lookup {
+	int status;
+	int addresses;
+};
+
+static uint8_t *put_rr(uint8_t *p, uint16_t owner, uint16_t type, uint32_t ttl,
+		       uint16_t rdlength)
+{
+	sys_put_be16(0xc000 | owner, p);
+	sys_put_be16(type, p + 2);
+	sys_put_be16(DNS_CLASS_IN, p + 4);
+	sys_put_be32(ttl, p + 6);
+	sys_put_be16(rdlength, p + 10);
+
+	return p + RR_HDR_LEN;
+}
+
+static uint8_t *put_name(uint8_t *p, const char *label, uint16_t zone)
+{
+	size_t len = strlen(label);
+
+	*p++ = len;
+	memcpy(p, label, len);
+	sys_put_be16(0xc000 | zone, p + len);
+
+	return p + len + 2;
+}
+
+/* Turn the query in buf into its response. The hosts have an IPv4 address,
+ * the other names are answered with the SOA record of their zone, and the
+ * missing hosts do not exist.
+ */
+static int build_response(uint8_t *buf, int len)
+{
+	uint8_t *p = buf + DNS_HDR_LEN;
+	bool missing;
+	uint16_t zone;
+	uint16_t type;
+
+	if (len <= DNS_HDR_LEN || buf[DNS_HDR_LEN] == 0) {
+		return -EINVAL;
+	}
+
+	missing = buf[DNS_HDR_LEN] > 7 && memcmp(&buf[DNS_HDR_LEN + 1], "missing", 7) == 0;
+	zone = DNS_HDR_LEN + 1 + buf[DNS_HDR_LEN];
+
+	while (p < buf + len && *p != 0) {
+		p += *p + 1;
+	}
+
+	if (p + 5 > buf + len) {
+		return -EINVAL;
+	}
+
+	type = sys_get_be16(p + 1);
+	p += 5;
+
+	/* Response with the recursion desired flag of the query */
+	buf[2] = 0x80 | (buf[2] & 0x01);
+	buf[3] = 0x80;
+	sys_put_be16(0, &buf[8]);
+	sys_put_be16(0, &buf[10]);
+
+	if (!missing && type == DNS_TYPE_A) {
+		sys_put_be16(1, &buf[6]);
+		p = put_rr(p, DNS_HDR_LEN, DNS_TYPE_A, HOST_TTL, 4);
+		*p++ = 192;
+		*p++ = 0;
+		*p++ = 2;
+		*p++ = 1;
+
+		return p - buf;
+	}
+
+	if (missing) {
+		buf[3] |= DNS_NXDOMAIN;
+	}
+
+	sys_put_be16(0, &buf[6]);
+	sys_put_be16(1, &buf[8]);
+	p = put_rr(p, zone, DNS_TYPE_SOA, SOA_TTL, SOA_RDATA_LEN);
+	p = put_name(p, "ns", zone);
+	p = put_name(p, "host", zone);
+	sys_put_be32(1, p);            /* Serial */
+	sys_put_be32(7200, p + 4);     /* Refresh */
+	sys_put_be32(900, p + 8);      /* Retry */
+	sys_put_be32(1209600, p + 12); /* Expire */
+	sys_put_be32(SOA_MINIMUM, p + 16);
+
+	return p + 20 - buf;
+}
+
+static void dns_server(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	static uint8_t buf[512];
+	int sock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0 || zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		TC_PRINT("Cannot start the DNS server: %d\n", errno);
+		return;
+	}
+
+	k_sem_give(&server_ready);
+
+	while (true) {
+		struct sockaddr_in client;
+		socklen_t client_len = sizeof(client);
+		int len;
+
+		/* Leave room for the record added to the query */
+		len = zsock_recvfrom(sock, buf, sizeof(buf) - RR_HDR_LEN - SOA_RDATA_LEN, 0,
+				     (struct sockaddr *)&client, &client_len);
+		if (len < 0) {
+			continue;
+		}
+
+		atomic_inc(&server_queries);
+
+		len = build_response(buf, len);
+		if (len < 0) {
+			continue;
+		}
+
+		(void)zsock_sendto(sock, buf, len, 0, (struct sockaddr *)&client, client_len);
+	}
+}
+
+/* Lower priority than main, so that the queries of a burst are all sent
+ * before the first one is answered.
+ */
+K_THREAD_DEFINE(dns_server_thread, 2048, dns_server, NULL, NULL, NULL, SERVER_PRIO, 0, 0);
+
+static void resolve_cb(enum dns_resolve_status status, struct dns_addrinfo *info,
+		       void *user_data)
+{
+	struct lookup *lookup = user_data;
+
+	if (status == DNS_EAI_INPROGRESS) {
+		lookup->addresses++;
+		return;
+	}
+
+	lookup->status = status;
+	k_sem_give(&done);
+}
+
+static int resolve(const char *name, struct lookup *lookup)
+{
+	lookup->status = DNS_EAI_INPROGRESS;
+	lookup->addresses = 0;
+
+	return dns_get_addr_info(name, DNS_QUERY_TYPE_A, NULL, resolve_cb, lookup, TIMEOUT_MS);
+}
+
+static void lookup_name(int i, char *name)
+{
+	if (i < NUM_HOSTS) {
+		snprintk(name, NAME_LEN, "host%d.bench", i);
+	} else {
+		snprintk(name, NAME_LEN, "missing%d.bench", i - NUM_HOSTS);
+	}
+}
+
+static bool lookup_ok(int i, const struct lookup *lookup)
+{
+	if (i < NUM_HOSTS) {
+		return lookup->status == DNS_EAI_ALLDONE && lookup->addresses == 1;
+	}
+
+	return lookup->status == DNS_EAI_NODATA;
+}
+
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+/* Resolve each name once, then names at random, which the cache answers */
+static int run_lookups(uint32_t *errors)
+{
+	char name[NAME_LEN];
+	struct lookup lookup;
+	uint64_t cycles = 0;
+	atomic_val_t queries;
+
+	queries = atomic_get(&server_queries);
+
+	for (int i = 0; i < NUM_NAMES; i++) {
+		timing_t start, end;
+
+		lookup_name(i, name);
+
+		start = timing_counter_get();
+		if (resolve(name, &lookup) < 0) {
+			return -EIO;
+		}
+		k_sem_take(&done, K_FOREVER);
+		end = timing_counter_get();
+
+		cycles += timing_cycles_get(&start, &end);
+		*errors += !lookup_ok(i, &lookup);
+	}
+
+	bench_report("dns.resolve.uncached", "Average resolve time",
+		     timing_cycles_to_ns_avg(cycles, NUM_NAMES), "ns");
+	bench_report("dns.resolve.uncached.queries", "Server queries",
+		     atomic_get(&server_queries) - queries, "queries");
+
+	queries = atomic_get(&server_queries);
+	cycles = 0;
+
+	for (int i = 0; i < NUM_LOOKUPS; i++) {
+		int index = next_random() % NUM_NAMES;
+		timing_t start, end;
+
+		lookup_name(index, name);
+
+		start = timing_counter_get();
+		if (resolve(name, &lookup) < 0) {
+			return -EIO;
+		}
+		k_sem_take(&done, K_FOREVER);
+		end = timing_counter_get();
+
+		cycles += timing_cycles_get(&start, &end);
+		*errors += !lookup_ok(index, &lookup);
+	}
+
+	bench_report("dns.resolve.cached", "Average resolve time",
+		     timing_cycles_to_ns_avg(cycles, NUM_LOOKUPS), "ns");
+	bench_report("dns.resolve.cached.queries", "Server queries",
+		     atomic_get(&server_queries) - queries, "queries");
+
+	return 0;
+}
+
+/* Resolve new names, each by BURST_SIZE callers at the same time */
+static int run_bursts(uint32_t *errors)
+{
+	struct lookup lookups[BURST_SIZE];
+	char name[NAME_LEN];
+	uint64_t cycles = 0;
+	atomic_val_t queries;
+
+	queries = atomic_get(&server_queries);
+
+	for (int i = 0; i < NUM_BURSTS; i++) {
+		timing_t start, end;
+
+		snprintk(name, sizeof(name), "burst%d.bench", i);
+
+		start = timing_counter_get();
+		for (int j = 0; j < BURST_SIZE; j++) {
+			if (resolve(name, &lookups[j]) < 0) {
+				return -EIO;
+			}
+		}
+		for (int j = 0; j < BURST_SIZE; j++) {
+			k_sem_take(&done, K_FOREVER);
+		}
+		end = timing_counter_get();
+
+		cycles += timing_cycles_get(&start, &end);
+		for (int j = 0; j < BURST_SIZE; j++) {
+			*errors += !lookup_ok(0, &lookups[j]);
+		}
+	}
+
+	bench_report("dns.resolve.burst", "Average burst resolve time",
+		     timing_cycles_to_ns_avg(cycles, NUM_BURSTS), "ns");
+	bench_report("dns.resolve.burst.queries", "Server queries per burst",
+		     (atomic_get(&server_queries) - queries) / NUM_BURSTS, "queries");
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int ret;
+
+	if (k_sem_take(&server_ready, K_SECONDS(1)) < 0) {
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	ret = run_lookups(&errors);
+	if (ret == 0) {
+		ret = run_bursts(&errors);
+	}
+
+	timing_stop();
+
+	if (ret < 0) {
+		TC_PRINT("Cannot start a lookup\n");
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	bench_report("dns.resolve.errors", "Lookups with an unexpected answer", errors, "lookups");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
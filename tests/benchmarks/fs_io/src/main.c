@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * File system throughput benchmark: sequential and random reads and writes
+ * through the VFS on a RAM disk, or on a loopback disk backed by a file on a
+ * FAT formatted RAM disk, and raw sector reads through the disk access API.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/storage/disk_access.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/random/random.h>
+
+#ifdef CONFIG_FAT_FILESYSTEM_ELM
+#include <ff.h>
+#endif
+#ifdef CONFIG_DISK_DRIVER_LOOPBACK
+#include <zephyr/drivers/loopback_disk.h>
+#endif
+
+#ifdef CONFIG_DISK_DRIVER_LOOPBACK
+#define DISK_NAME "loopback0"
+/* FatFs only knows the volumes listed in FF_VOLUME_STRS */
+#define BACKING_DISK_NAME "NAND"
+#define BACKING_PATH "/"BACKING_DISK_NAME":"
+#define LOOPBACK_SIZE KB(512)
+#else
+#define DISK_NAME "RAM"
+#endif
+
+#ifdef CONFIG_BENCHMARK_FS_IO_FAT
+#define FS_TYPE FS_FATFS
+#define FS_NAME "fat"
+#define MNT_POINT "/"DISK_NAME":"
+#define MKFS_DEV DISK_NAME":"
+#else
+#define FS_TYPE FS_EXT2
+#define FS_NAME "ext2"
+#define MNT_POINT "/bench"
+#define MKFS_DEV DISK_NAME
+#endif
+#define FILE_PATH MNT_POINT "/data.bin"
+
+#define FILE_SIZE KB(128)
+#define SEQ_CHUNK_SIZE 4096
+#define RANDOM_IO_SIZE 512
+#define RANDOM_ITERATIONS 256
+
+static uint8_t io_buf[SEQ_CHUNK_SIZE] __aligned(32);
+static uint32_t random_offsets[RANDOM_ITERATIONS];
+
+#ifdef CONFIG_BENCHMARK_FS_IO_FAT
+static FATFS bench_fat_fs;
+#endif
+
+static struct fs_mount_t bench_mnt = {
+	.type = FS_TYPE,
+	.mnt_point = MNT_POINT,
+#ifdef CONFIG_BENCHMARK_FS_IO_FAT
+	.fs_data = &bench_fat_fs,
+#else
+	.storage_dev = DISK_NAME,
+#endif
+};
+
+#ifdef CONFIG_DISK_DRIVER_LOOPBACK
+static struct loopback_disk_access lo_access;
+static FATFS fat_fs;
+static struct fs_mount_t backing_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = BACKING_PATH,
+	.fs_data = &fat_fs,
+};
+
+static void setup_loopback_backing(void)
+{
+	struct fs_file_t f;
+	int rc;
+
+	rc = fs_mkfs(FS_FATFS, (uintptr_t)BACKING_DISK_NAME":", NULL, 0);
+	zassert_ok(rc, "Failed to format backing file system");
+
+	rc = fs_mount(&backing_mnt);
+	zassert_ok(rc, "Failed to mount backing file system");
+
+	memset(io_buf, 0, sizeof(io_buf));
+	fs_file_t_init(&f);
+	rc = fs_open(&f, BACKING_PATH "/loopback.img", FS_O_WRITE | FS_O_CREATE);
+	zassert_ok(rc, "Failed to create backing file");
+	for (int i = 0; i < LOOPBACK_SIZE / sizeof(io_buf); i++) {
+		rc = fs_write(&f, io_buf, sizeof(io_buf));
+		zassert_equal(rc, sizeof(io_buf), "Failed to enlarge backing file");
+	}
+	zassert_ok(fs_close(&f), "Failed to close backing file");
+
+	rc = loopback_disk_access_register(&lo_access, BACKING_PATH "/loopback.img", DISK_NAME);
+	zassert_ok(rc, "Loopback disk access initialization failed");
+}
+#endif
+
+static uint64_t elapsed_ns(timing_t start, timing_t end)
+{
+	return timing_cycles_to_ns(timing_cycles_get(&start, &end));
+}
+
+static void report_throughput(const char *what, size_t bytes, size_t ops, uint64_t ns)
+{
+	ns = MAX(ns, 1);
+
+	TC_PRINT("%s %s on %s: %" PRIu64 " KiB/s, %" PRIu64 " IOPS\n", FS_NAME, what, DISK_NAME,
+		 (uint64_t)bytes * NSEC_PER_SEC / 1024 / ns,
+		 (uint64_t)ops * NSEC_PER_SEC / ns);
+}
+
+static void open_test_file(struct fs_file_t *f, fs_mode_t flags)
+{
+	fs_file_t_init(f);
+	zassert_ok(fs_open(f, FILE_PATH, flags), "Failed to open test file");
+}
+
+/* Write the whole file, including the final sync, and return the time taken. */
+static uint64_t write_file(void)
+{
+	struct fs_file_t f;
+	timing_t start, end;
+	ssize_t rc;
+
+	sys_rand_get(io_buf, sizeof(io_buf));
+	open_test_file(&f, FS_O_WRITE | FS_O_CREATE);
+
+	start = timing_counter_get();
+	for (size_t off = 0; off < FILE_SIZE; off += sizeof(io_buf)) {
+		rc = fs_write(&f, io_buf, sizeof(io_buf));
+		zassert_equal(rc, sizeof(io_buf), "Write failed (%d)", (int)rc);
+	}
+	zassert_ok(fs_sync(&f), "Sync failed");
+	end = timing_counter_get();
+
+	zassert_ok(fs_close(&f), "Close failed");
+
+	return elapsed_ns(start, end);
+}
+
+static void *fs_io_setup(void)
+{
+	int rc;
+
+#ifdef CONFIG_DISK_DRIVER_LOOPBACK
+	setup_loopback_backing();
+#endif
+
+	rc = fs_mkfs(FS_TYPE, (uintptr_t)MKFS_DEV, NULL, 0);
+	zassert_ok(rc, "Failed to format %s", DISK_NAME);
+
+	rc = fs_mount(&bench_mnt);
+	zassert_ok(rc, "Failed to mount %s", DISK_NAME);
+
+	timing_init();
+	timing_start();
+
+	/* Every test works on an existing, fully allocated file. */
+	(void)write_file();
+
+	for (int i = 0; i < RANDOM_ITERATIONS; i++) {
+		random_offsets[i] = ROUND_DOWN(sys_rand32_get() % FILE_SIZE, RANDOM_IO_SIZE);
+	}
+
+	return NULL;
+}
+
+static void fs_io_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	timing_stop();
+	fs_unmount(&bench_mnt);
+}
+
+ZTEST(fs_io, test_sequential_write)
+{
+	uint64_t ns = write_file();
+
+	report_throughput("sequential write", FILE_SIZE, FILE_SIZE / SEQ_CHUNK_SIZE, ns);
+}
+
+ZTEST(fs_io, test_sequential_read)
+{
+	struct fs_file_t f;
+	timing_t start, end;
+	ssize_t rc;
+
+	open_test_file(&f, FS_O_READ);
+
+	start = timing_counter_get();
+	for (size_t off = 0; off < FILE_SIZE; off += sizeof(io_buf)) {
+		rc = fs_read(&f, io_buf, sizeof(io_buf));
+		zassert_equal(rc, sizeof(io_buf), "Read failed (%d)", (int)rc);
+	}
+	end = timing_counter_get();
+
+	zassert_ok(fs_close(&f), "Close failed");
+
+	report_throughput("sequential read", FILE_SIZE, FILE_SIZE / SEQ_CHUNK_SIZE,
+			  elapsed_ns(start, end));
+}
+
+ZTEST(fs_io, test_random_write)
+{
+	struct fs_file_t f;
+	timing_t start, end;
+	ssize_t rc;
+
+	sys_rand_get(io_buf, RANDOM_IO_SIZE);
+	open_test_file(&f, FS_O_WRITE);
+
+	start = timing_counter_get();
+	for (int i = 0; i < RANDOM_ITERATIONS; i++) {
+		zassert_ok(fs_seek(&f, random_offsets[i], FS_SEEK_SET), "Seek failed");
+		rc = fs_write(&f, io_buf, RANDOM_IO_SIZE);
+		zassert_equal(rc, RANDOM_IO_SIZE, "Write failed (%d)", (int)rc);
+	}
+	zassert_ok(fs_sync(&f), "Sync failed");
+	end = timing_counter_get();
+
+	zassert_ok(fs_close(&f), "Close failed");
+
+	report_throughput("random write", RANDOM_ITERATIONS * RANDOM_IO_SIZE,
+			  RANDOM_ITERATIONS, elapsed_ns(start, end));
+}
+
+ZTEST(fs_io, test_random_read)
+{
+	struct fs_file_t f;
+	timing_t start, end;
+	ssize_t rc;
+
+	open_test_file(&f, FS_O_READ);
+
+	start = timing_counter_get();
+	for (int i = 0; i < RANDOM_ITERATIONS; i++) {
+		zassert_ok(fs_seek(&f, random_offsets[i], FS_SEEK_SET), "Seek failed");
+		rc = fs_read(&f, io_buf, RANDOM_IO_SIZE);
+		zassert_equal(rc, RANDOM_IO_SIZE, "Read failed (%d)", (int)rc);
+	}
+	end = timing_counter_get();
+
+	zassert_ok(fs_close(&f), "Close failed");
+
+	report_throughput("random read", RANDOM_ITERATIONS * RANDOM_IO_SIZE,
+			  RANDOM_ITERATIONS, elapsed_ns(start, end));
+}
+
+#ifdef CONFIG_DISK_ACCESS_QUEUE
+static K_SEM_DEFINE(raw_done, 0, 1);
+static struct disk_access_req raw_reqs[SEQ_CHUNK_SIZE / RANDOM_IO_SIZE];
+static int raw_result;
+
+/* Requests complete in order, the last one of a batch completes the batch */
+static void raw_read_done(struct disk_access_req *req, int result)
+{
+	if (result != 0) {
+		raw_result = result;
+	}
+	if (req == &raw_reqs[ARRAY_SIZE(raw_reqs) - 1]) {
+		k_sem_give(&raw_done);
+	}
+}
+#endif
+
+/*
+ * Read the first sectors of the disk one at a time, the way file systems do,
+ * synchronously and, when available, through the disk request queue.
+ */
+ZTEST(fs_io, test_raw_sector_read)
+{
+	const size_t sectors = FILE_SIZE / RANDOM_IO_SIZE;
+	uint32_t sector_size;
+	timing_t start, end;
+
+	zassert_ok(disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_SIZE, &sector_size));
+	zassert_equal(sector_size, RANDOM_IO_SIZE, "Unexpected sector size");
+
+	start = timing_counter_get();
+	for (uint32_t s = 0; s < sectors; s++) {
+		zassert_ok(disk_access_read(DISK_NAME, &io_buf[(s * sector_size) % sizeof(io_buf)],
+					    s, 1), "Read failed");
+	}
+	end = timing_counter_get();
+
+	TC_PRINT("raw sector read on %s: %" PRIu64 " KiB/s\n", DISK_NAME,
+		 (uint64_t)FILE_SIZE * NSEC_PER_SEC / 1024 / MAX(elapsed_ns(start, end), 1));
+
+#ifdef CONFIG_DISK_ACCESS_QUEUE
+	start = timing_counter_get();
+	for (uint32_t s = 0; s < sectors; s += ARRAY_SIZE(raw_reqs)) {
+		for (int i = 0; i < ARRAY_SIZE(raw_reqs); i++) {
+			raw_reqs[i] = (struct disk_access_req) {
+				.pdrv = DISK_NAME,
+				.buf = &io_buf[i * sector_size],
+				.start_sector = s + i,
+				.num_sector = 1,
+				.cb = raw_read_done,
+			};
+			zassert_ok(disk_access_submit(&raw_reqs[i]), "Submit failed");
+		}
+		zassert_ok(k_sem_take(&raw_done, K_SECONDS(5)), "Queued reads timed out");
+	}
+	end = timing_counter_get();
+	zassert_ok(raw_result, "Queued read failed");
+
+	TC_PRINT("queued sector read on %s: %" PRIu64 " KiB/s\n", DISK_NAME,
+		 (uint64_t)FILE_SIZE * NSEC_PER_SEC / 1024 / MAX(elapsed_ns(start, end), 1));
+#endif
+}
+
+ZTEST_SUITE(fs_io, NULL, fs_io_setup, NULL, NULL, fs_io_teardown);
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that replay a synthetic touch stream through the
+ * input subsystem and measure the latency from the report of a frame to its
+ * delivery to the application, when the application takes longer to process
+ * a frame than the touch panel takes to report one.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_FRAMES      CONFIG_BENCHMARK_NUM_FRAMES
+#define FRAME_PERIOD_US CONFIG_BENCHMARK_FRAME_PERIOD_US
+#define CALLBACK_WORK_US CONFIG_BENCHMARK_CALLBACK_WORK_US
+
+static const struct device touch_dev;
+
+static timing_t reported_at[NUM_FRAMES];
+static int32_t last_x;
+static uint32_t delivered;
+static uint64_t latency_sum_ns;
+static uint64_t latency_max_ns;
+
+static K_SEM_DEFINE(released_sem, 0, 1);
+
+static void touch_cb(struct input_event *evt, void *user_data)
+{
+	timing_t now;
+	uint64_t ns;
+
+	if (evt->type == INPUT_EV_ABS && evt->code == INPUT_ABS_X) {
+		last_x = evt->value;
+	}
+
+	if (!evt->sync) {
+		return;
+	}
+
+	if (evt->type == INPUT_EV_KEY && evt->code == INPUT_BTN_TOUCH && evt->value == 0) {
+		k_sem_give(&released_sem);
+		return;
+	}
+
+	now = timing_counter_get();
+	ns = timing_cycles_to_ns(timing_cycles_get(&reported_at[last_x], &now));
+	latency_sum_ns += ns;
+	latency_max_ns = MAX(latency_max_ns, ns);
+	delivered++;
+
+	/* Application processing of the frame */
+	k_busy_wait(CALLBACK_WORK_US);
+}
+INPUT_CALLBACK_DEFINE(&touch_dev, touch_cb, NULL);
+
+static uint32_t any_count;
+
+static void any_cb(struct input_event *evt, void *user_data)
+{
+	any_count++;
+}
+INPUT_CALLBACK_DEFINE(NULL, any_cb, NULL);
+
+/* Callbacks of other devices, never invoked for the touch panel */
+#define OTHER_DEVICE_DEFINE(n, _)                                                                  \
+	static const struct device other_dev_##n;                                                  \
+	static void other_cb_##n(struct input_event *evt, void *user_data)                         \
+	{                                                                                          \
+	}                                                                                          \
+	INPUT_CALLBACK_DEFINE(&other_dev_##n, other_cb_##n, NULL)
+
+LISTIFY(8, OTHER_DEVICE_DEFINE, (;));
+
+static void report_frame(int32_t x, int32_t y, bool pressed)
+{
+	(void)input_report_abs(&touch_dev, INPUT_ABS_X, x, false, K_FOREVER);
+	(void)input_report_abs(&touch_dev, INPUT_ABS_Y, y, false, K_FOREVER);
+	(void)input_report_key(&touch_dev, INPUT_BTN_TOUCH, pressed, true, K_FOREVER);
+}
+
+int main(void)
+{
+	int rc;
+
+	timing_init();
+	timing_start();
+
+	for (int i = 0; i < NUM_FRAMES; i++) {
+		reported_at[i] = timing_counter_get();
+		report_frame(i, NUM_FRAMES - i, true);
+		k_usleep(FRAME_PERIOD_US);
+	}
+	report_frame(NUM_FRAMES - 1, 1, false);
+
+	rc = k_sem_take(&released_sem, K_SECONDS(60));
+
+	timing_stop();
+
+	if (rc != 0 || delivered == 0) {
+		TC_PRINT("Touch release not delivered\n");
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	bench_report("input.touch.latency.avg", "Average frame latency",
+		     latency_sum_ns / delivered / 1000, "us");
+	bench_report("input.touch.latency.max", "Maximum frame latency", latency_max_ns / 1000,
+		     "us");
+	bench_report("input.touch.frames", "Frames delivered to the callback", delivered, "frames");
+	bench_report("input.touch.events", "Events delivered to any callback", any_count, "events");
+
+	TC_END_REPORT(TC_PASS);
+
+	return 0;
+}
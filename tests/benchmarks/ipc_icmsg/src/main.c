@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the per message latency and the
+ * throughput of the icmsg library, and the number of mailbox notifications
+ * it signals. Both ends of the link run in this image, over two shared memory
+ * regions and a loopback mailbox.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/mbox.h>
+#include <zephyr/ipc/icmsg.h>
+#include <zephyr/ipc/pbuf.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_ITERATIONS CONFIG_BENCHMARK_NUM_ITERATIONS
+#define MSG_SIZE       CONFIG_BENCHMARK_MSG_SIZE
+#define BURST_SIZE     CONFIG_BENCHMARK_BURST_SIZE
+#define SHMEM_SIZE     CONFIG_BENCHMARK_SHMEM_SIZE
+
+BUILD_ASSERT(BURST_SIZE * ROUND_UP(MSG_SIZE + PBUF_PACKET_LEN_SZ, sizeof(uint32_t)) <
+	     SHMEM_SIZE - PBUF_HEADER_OVERHEAD(0), "Shared memory can not fit a burst");
+
+/* Loopback mailbox, a message sent on a channel is received on the same channel */
+#define MBOX_CHANNELS 2
+
+struct mbox_loopback_data {
+	mbox_callback_t cb[MBOX_CHANNELS];
+	void *user_data[MBOX_CHANNELS];
+	bool enabled[MBOX_CHANNELS];
+	uint32_t sent;
+};
+
+static struct mbox_loopback_data mbox_data;
+
+static int mbox_loopback_send(const struct device *dev, mbox_channel_id_t channel_id,
+			      const struct mbox_msg *msg)
+{
+	struct mbox_loopback_data *data = dev->data;
+
+	if (channel_id >= MBOX_CHANNELS || msg != NULL) {
+		return -EINVAL;
+	}
+
+	data->sent++;
+
+	if (data->enabled[channel_id] && data->cb[channel_id] != NULL) {
+		data->cb[channel_id](dev, channel_id, data->user_data[channel_id], NULL);
+	}
+
+	return 0;
+}
+
+static int mbox_loopback_register_callback(const struct device *dev,
+					   mbox_channel_id_t channel_id, mbox_callback_t cb,
+					   void *user_data)
+{
+	struct mbox_loopback_data *data = dev->data;
+
+	if (channel_id >= MBOX_CHANNELS) {
+		return -EINVAL;
+	}
+
+	data->cb[channel_id] = cb;
+	data->user_data[channel_id] = user_data;
+
+	return 0;
+}
+
+static int mbox_loopback_mtu_get(const struct device *dev)
+{
+	return 0;
+}
+
+static int mbox_loopback_set_enabled(const struct device *dev, mbox_channel_id_t channel_id,
+				     bool enabled)
+{
+	struct mbox_loopback_data *data = dev->data;
+
+	if (channel_id >= MBOX_CHANNELS) {
+		return -EINVAL;
+	}
+
+	data->enabled[channel_id] = enabled;
+
+	return 0;
+}
+
+static uint32_t mbox_loopback_max_channels_get(const struct device *dev)
+{
+	return MBOX_CHANNELS;
+}
+
+static const struct mbox_driver_api mbox_loopback_api = {
+	.send = mbox_loopback_send,
+	.register_callback = mbox_loopback_register_callback,
+	.mtu_get = mbox_loopback_mtu_get,
+	.max_channels_get = mbox_loopback_max_channels_get,
+	.set_enabled = mbox_loopback_set_enabled,
+};
+
+DEVICE_DEFINE(mbox_loopback, "mbox_loopback", NULL, NULL, &mbox_data, NULL, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &mbox_loopback_api);
+
+/* Shared memory of each direction */
+static uint8_t shmem_h2r[SHMEM_SIZE] __aligned(32);
+static uint8_t shmem_r2h[SHMEM_SIZE] __aligned(32);
+
+static PBUF_MAYBE_CONST struct pbuf_cfg h2r_tx_cfg = PBUF_CFG_INIT(shmem_h2r, SHMEM_SIZE, 0);
+static PBUF_MAYBE_CONST struct pbuf_cfg h2r_rx_cfg = PBUF_CFG_INIT(shmem_h2r, SHMEM_SIZE, 0);
+static PBUF_MAYBE_CONST struct pbuf_cfg r2h_tx_cfg = PBUF_CFG_INIT(shmem_r2h, SHMEM_SIZE, 0);
+static PBUF_MAYBE_CONST struct pbuf_cfg r2h_rx_cfg = PBUF_CFG_INIT(shmem_r2h, SHMEM_SIZE, 0);
+
+static struct pbuf h2r_tx_pb = {.cfg = &h2r_tx_cfg};
+static struct pbuf h2r_rx_pb = {.cfg = &h2r_rx_cfg};
+static struct pbuf r2h_tx_pb = {.cfg = &r2h_tx_cfg};
+static struct pbuf r2h_rx_pb = {.cfg = &r2h_rx_cfg};
+
+static struct icmsg_config_t host_conf = {
+	.mbox_tx = {.channel_id = 0},
+	.mbox_rx = {.channel_id = 1},
+};
+
+static struct icmsg_config_t remote_conf = {
+	.mbox_tx = {.channel_id = 1},
+	.mbox_rx = {.channel_id = 0},
+};
+
+static struct icmsg_data_t host_data = {
+	.tx_pb = &h2r_tx_pb,
+	.rx_pb = &r2h_rx_pb,
+};
+
+static struct icmsg_data_t remote_data = {
+	.tx_pb = &r2h_tx_pb,
+	.rx_pb = &h2r_rx_pb,
+};
+
+static K_SEM_DEFINE(bound_sem, 0, 2);
+static K_SEM_DEFINE(received_sem, 0, 1);
+
+static uint8_t msg[MSG_SIZE];
+static uint32_t received;
+static uint32_t expected;
+static uint32_t checksum;
+static timing_t sent_at;
+static uint64_t latency_ns;
+
+static void bound(void *priv)
+{
+	k_sem_give(&bound_sem);
+}
+
+static void remote_received(const void *data, size_t len, void *priv)
+{
+	const uint8_t *bytes = data;
+
+	if (len != MSG_SIZE) {
+		return;
+	}
+
+	/* Consume the message, like an application would */
+	for (size_t i = 0; i < len; i++) {
+		checksum += bytes[i];
+	}
+
+	received++;
+	if (received == expected) {
+		timing_t now = timing_counter_get();
+
+		latency_ns += timing_cycles_to_ns(timing_cycles_get(&sent_at, &now));
+		k_sem_give(&received_sem);
+	}
+}
+
+static const struct ipc_service_cb host_cb = {
+	.bound = bound,
+};
+
+static const struct ipc_service_cb remote_cb = {
+	.bound = bound,
+	.received = remote_received,
+};
+
+static uint64_t elapsed_ns(timing_t start, timing_t finish)
+{
+	return MAX(timing_cycles_to_ns(timing_cycles_get(&start, &finish)), 1);
+}
+
+static int send_and_wait(uint32_t count)
+{
+	int ret;
+
+	expected = received + count;
+	sent_at = timing_counter_get();
+
+	for (uint32_t i = 0; i < count; i++) {
+		msg[0] = (uint8_t)i;
+		ret = icmsg_send(&host_conf, &host_data, msg, sizeof(msg));
+		if (ret != sizeof(msg)) {
+			TC_PRINT("Failed to send message: %d\n", ret);
+			return -1;
+		}
+	}
+
+	if (k_sem_take(&received_sem, K_SECONDS(1)) != 0) {
+		TC_PRINT("Received %u messages, expected %u\n", received, expected);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int bench_latency(void)
+{
+	uint32_t notifications = mbox_data.sent;
+
+	latency_ns = 0;
+
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		if (send_and_wait(1) != 0) {
+			return -1;
+		}
+	}
+
+	bench_report("ipc.icmsg.latency", "Per message latency, one by one",
+		     latency_ns / NUM_ITERATIONS, "ns");
+	bench_report("ipc.icmsg.latency.notifications", "Notifications per 100 messages",
+		     (uint64_t)(mbox_data.sent - notifications) * 100 / NUM_ITERATIONS,
+		     "notifications");
+
+	return 0;
+}
+
+static int bench_burst(void)
+{
+	uint32_t notifications = mbox_data.sent;
+	timing_t start, finish;
+	uint64_t ns;
+	int bursts = DIV_ROUND_UP(NUM_ITERATIONS, BURST_SIZE);
+
+	start = timing_counter_get();
+	for (int i = 0; i < bursts; i++) {
+		if (send_and_wait(BURST_SIZE) != 0) {
+			return -1;
+		}
+	}
+	finish = timing_counter_get();
+
+	ns = elapsed_ns(start, finish);
+	bench_report("ipc.icmsg.burst", "Throughput in bursts",
+		     (uint64_t)bursts * BURST_SIZE * NSEC_PER_SEC / ns, "msgs/s");
+	bench_report("ipc.icmsg.burst.bytes", "Throughput in bursts",
+		     (uint64_t)bursts * BURST_SIZE * MSG_SIZE * NSEC_PER_SEC / ns, "bytes/s");
+	bench_report("ipc.icmsg.burst.notifications", "Notifications per 100 messages",
+		     (uint64_t)(mbox_data.sent - notifications) * 100 / (bursts * BURST_SIZE),
+		     "notifications");
+
+	return 0;
+}
+
+int main(void)
+{
+	const struct device *mbox = DEVICE_GET(mbox_loopback);
+	int rc;
+
+	host_conf.mbox_tx.dev = mbox;
+	host_conf.mbox_rx.dev = mbox;
+	remote_conf.mbox_tx.dev = mbox;
+	remote_conf.mbox_rx.dev = mbox;
+
+	memset(msg, 0xa5, sizeof(msg));
+
+	rc = icmsg_open(&remote_conf, &remote_data, &remote_cb, NULL);
+	if (rc == 0) {
+		rc = icmsg_open(&host_conf, &host_data, &host_cb, NULL);
+	}
+	for (int i = 0; rc == 0 && i < 2; i++) {
+		rc = k_sem_take(&bound_sem, K_SECONDS(1));
+	}
+	if (rc != 0) {
+		TC_PRINT("Failed to bond the endpoints: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	/* Keep the receiving work queue from preempting the sender, as if the
+	 * receiver ran on another core.
+	 */
+	k_thread_priority_set(k_current_get(), K_HIGHEST_THREAD_PRIO);
+
+	timing_init();
+	timing_start();
+
+	rc = bench_latency();
+	if (rc == 0) {
+		rc = bench_burst();
+	}
+
+	timing_stop();
+
+	TC_END_REPORT(rc == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken to upload an image
+ * to the MCUmgr UDP transport through a link with a fixed latency, waiting
+ * for the response to each chunk and with a windowed upload.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/mgmt/mcumgr/mgmt/mgmt_defines.h>
+#include <zephyr/mgmt/mcumgr/grp/img_mgmt/img_mgmt.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include <zcbor_common.h>
+#include <zcbor_decode.h>
+#include <zcbor_encode.h>
+
+#include "bench_report.h"
+
+#define IMAGE_SIZE  CONFIG_BENCHMARK_IMAGE_SIZE
+#define CHUNK_SIZE  CONFIG_BENCHMARK_CHUNK_SIZE
+#define NUM_CHUNKS  (IMAGE_SIZE / CHUNK_SIZE)
+#define LATENCY_MS  CONFIG_BENCHMARK_LATENCY_MS
+#define WINDOW      CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNKS
+#define TIMEOUT_MS  (4 * LATENCY_MS + 500)
+#define SLOT_ID     FIXED_PARTITION_ID(slot1_partition)
+
+#define PROXY_PORT   11337
+#define PROXY_PRIO   K_PRIO_PREEMPT(5)
+#define PROXY_SLOTS  (2 * WINDOW + 4)
+#define SMP_HDR_LEN  8
+#define SMP_VERSION  1 /* SMP version 2 */
+#define FRAME_SIZE   (SMP_HDR_LEN + CHUNK_SIZE + 64)
+#define ZCBOR_STATES 4
+
+BUILD_ASSERT(IMAGE_SIZE % CHUNK_SIZE == 0, "The image must be made of whole chunks");
+BUILD_ASSERT(CHUNK_SIZE <= CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNK_SIZE,
+	     "Chunks are larger than the chunks held by the server");
+BUILD_ASSERT(FRAME_SIZE <= CONFIG_MCUMGR_TRANSPORT_UDP_MTU, "Chunks do not fit in a frame");
+
+static K_SEM_DEFINE(proxy_ready, 0, 1);
+
+static uint8_t image[IMAGE_SIZE];
+static bool held[NUM_CHUNKS];
+static uint8_t frame[FRAME_SIZE];
+static uint8_t read_buf[256];
+static uint8_t seq;
+
+struct upload_rsp {
+	uint32_t off;
+	uint32_t win;
+	uint32_t sack[WINDOW];
+	size_t sack_len;
+};
+
+/* Datagrams in flight on the link, in the order they are forwarded */
+struct datagram {
+	int64_t due;
+	bool to_server;
+	size_t len;
+	uint8_t data[FRAME_SIZE];
+};
+
+static struct datagram line[PROXY_SLOTS];
+
+/* Forward the datagrams of the client to the SMP server and the responses
+ * back to the client, each LATENCY_MS after it is received.
+ */
+static void proxy(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PROXY_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct sockaddr_in server = {
+		.sin_family = AF_INET,
+		.sin_port = htons(CONFIG_MCUMGR_TRANSPORT_UDP_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct sockaddr_in client = { 0 };
+	size_t head = 0;
+	size_t count = 0;
+	int sock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0 || zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		TC_PRINT("Cannot start the proxy: %d\n", errno);
+		return;
+	}
+
+	k_sem_give(&proxy_ready);
+
+	while (true) {
+		struct zsock_pollfd fds = {
+			.fd = sock,
+			.events = ZSOCK_POLLIN,
+		};
+		int timeout = -1;
+
+		if (count > 0) {
+			timeout = MAX(line[head].due - k_uptime_get(), 0);
+		}
+
+		if (zsock_poll(&fds, 1, timeout) > 0 && (fds.revents & ZSOCK_POLLIN)) {
+			struct datagram *d = &line[(head + count) % PROXY_SLOTS];
+			struct sockaddr_in from;
+			socklen_t from_len = sizeof(from);
+			int len;
+
+			len = zsock_recvfrom(sock, d->data, sizeof(d->data), 0,
+					     (struct sockaddr *)&from, &from_len);
+
+			/* A full link drops the datagram */
+			if (len > 0 && count < PROXY_SLOTS) {
+				d->to_server = from.sin_port != server.sin_port;
+				if (d->to_server) {
+					client = from;
+				}
+
+				d->len = len;
+				d->due = k_uptime_get() + LATENCY_MS;
+				count++;
+			}
+		}
+
+		while (count > 0 && line[head].due <= k_uptime_get()) {
+			struct datagram *d = &line[head];
+
+			(void)zsock_sendto(sock, d->data, d->len, 0,
+					   (struct sockaddr *)(d->to_server ? &server : &client),
+					   sizeof(struct sockaddr_in));
+
+			head = (head + 1) % PROXY_SLOTS;
+			count--;
+		}
+	}
+}
+
+K_THREAD_DEFINE(proxy_thread, 2048, proxy, NULL, NULL, NULL, PROXY_PRIO, 0, 0);
+
+static uint32_t seed;
+
+static uint8_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 16;
+}
+
+static void fill_image(void)
+{
+	struct image_header *hdr = (struct image_header *)image;
+
+	seed = 12345;
+
+	for (size_t i = 0; i < sizeof(image); i++) {
+		image[i] = next_random();
+	}
+
+	/* The server checks the magic of the image header in the first chunk */
+	hdr->ih_magic = IMAGE_MAGIC;
+}
+
+static int send_chunk(int sock, const struct sockaddr *to, uint32_t off, uint32_t win)
+{
+	zcbor_state_t zse[ZCBOR_STATES];
+	size_t len;
+	bool ok;
+
+	zcbor_new_encode_state(zse, ARRAY_SIZE(zse), &frame[SMP_HDR_LEN],
+			       sizeof(frame) - SMP_HDR_LEN, 0);
+
+	ok = zcbor_map_start_encode(zse, 4)			&&
+	     zcbor_tstr_put_lit(zse, "off")			&&
+	     zcbor_uint32_put(zse, off)				&&
+	     zcbor_tstr_put_lit(zse, "data")			&&
+	     zcbor_bstr_encode_ptr(zse, &image[off], CHUNK_SIZE);
+
+	if (off == 0) {
+		ok = ok && zcbor_tstr_put_lit(zse, "len")	&&
+		     zcbor_uint32_put(zse, IMAGE_SIZE);
+	}
+
+	if (win > 0) {
+		ok = ok && zcbor_tstr_put_lit(zse, "win")	&&
+		     zcbor_uint32_put(zse, win);
+	}
+
+	ok = ok && zcbor_map_end_encode(zse, 4);
+	if (!ok) {
+		return -ENOMEM;
+	}
+
+	len = zse->payload - &frame[SMP_HDR_LEN];
+
+	frame[0] = MGMT_OP_WRITE | (SMP_VERSION << 3);
+	frame[1] = 0;
+	sys_put_be16(len, &frame[2]);
+	sys_put_be16(MGMT_GROUP_ID_IMAGE, &frame[4]);
+	frame[6] = seq++;
+	frame[7] = IMG_MGMT_ID_UPLOAD;
+
+	if (zsock_sendto(sock, frame, SMP_HDR_LEN + len, 0, to,
+			 sizeof(struct sockaddr_in)) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+static int decode_rsp(const uint8_t *data, size_t len, struct upload_rsp *rsp)
+{
+	zcbor_state_t zsd[ZCBOR_STATES];
+	struct zcbor_string key;
+	bool ok;
+
+	if (len < SMP_HDR_LEN || (data[0] & 0x07) != MGMT_OP_WRITE_RSP ||
+	    sys_get_be16(&data[4]) != MGMT_GROUP_ID_IMAGE || data[7] != IMG_MGMT_ID_UPLOAD) {
+		return -EBADMSG;
+	}
+
+	zcbor_new_decode_state(zsd, ARRAY_SIZE(zsd), &data[SMP_HDR_LEN], len - SMP_HDR_LEN, 1,
+			       NULL, 0);
+
+	rsp->off = 0;
+	rsp->win = 0;
+	rsp->sack_len = 0;
+
+	ok = zcbor_map_start_decode(zsd);
+
+	while (ok && zcbor_tstr_decode(zsd, &key)) {
+		if (key.len == 3 && memcmp(key.value, "off", 3) == 0) {
+			ok = zcbor_uint32_decode(zsd, &rsp->off);
+		} else if (key.len == 3 && memcmp(key.value, "win", 3) == 0) {
+			ok = zcbor_uint32_decode(zsd, &rsp->win);
+		} else if (key.len == 4 && memcmp(key.value, "sack", 4) == 0) {
+			ok = zcbor_list_start_decode(zsd);
+			while (ok && rsp->sack_len < ARRAY_SIZE(rsp->sack) &&
+			       zcbor_uint32_decode(zsd, &rsp->sack[rsp->sack_len])) {
+				rsp->sack_len++;
+			}
+			ok = ok && zcbor_list_end_decode(zsd);
+		} else if ((key.len == 2 && memcmp(key.value, "rc", 2) == 0) ||
+			   (key.len == 3 && memcmp(key.value, "err", 3) == 0)) {
+			/* The server refused the chunk */
+			return -EIO;
+		} else {
+			ok = zcbor_any_skip(zsd, NULL);
+		}
+	}
+
+	return ok && zcbor_map_end_decode(zsd) ? 0 : -EBADMSG;
+}
+
+static int receive_rsp(int sock, struct upload_rsp *rsp)
+{
+	static uint8_t buf[128];
+	struct zsock_pollfd fds = {
+		.fd = sock,
+		.events = ZSOCK_POLLIN,
+	};
+	int len;
+
+	if (zsock_poll(&fds, 1, TIMEOUT_MS) <= 0) {
+		return -EAGAIN;
+	}
+
+	len = zsock_recv(sock, buf, sizeof(buf), 0);
+	if (len < 0) {
+		return -errno;
+	}
+
+	return decode_rsp(buf, len, rsp);
+}
+
+/* Upload the image, with up to win chunks sent ahead of the acknowledged
+ * offset once the server grants a window, otherwise one chunk at a time.
+ */
+static int upload(int sock, uint32_t win, uint32_t *requests)
+{
+	struct sockaddr_in to = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PROXY_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct upload_rsp rsp;
+	uint32_t granted = 0;
+	uint32_t acked = 0;
+	uint32_t next = 0;
+	int rc;
+
+	memset(held, 0, sizeof(held));
+
+	while (acked < IMAGE_SIZE) {
+		uint32_t limit = acked + MAX(granted, 1) * CHUNK_SIZE;
+
+		for (next = MAX(next, acked); next < IMAGE_SIZE && next < limit;
+		     next += CHUNK_SIZE) {
+			if (held[next / CHUNK_SIZE]) {
+				continue;
+			}
+
+			rc = send_chunk(sock, (struct sockaddr *)&to, next, win);
+			if (rc < 0) {
+				return rc;
+			}
+
+			(*requests)++;
+		}
+
+		rc = receive_rsp(sock, &rsp);
+		if (rc == -EAGAIN) {
+			/* Send the chunks not acknowledged again */
+			next = acked;
+			continue;
+		}
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		acked = MAX(acked, rsp.off);
+		granted = MIN(rsp.win, win);
+
+		for (size_t i = 0; i < rsp.sack_len; i++) {
+			if (rsp.sack[i] < IMAGE_SIZE) {
+				held[rsp.sack[i] / CHUNK_SIZE] = true;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* Read the uploaded image back and compare it with the image */
+static bool image_ok(void)
+{
+	const struct flash_area *fa;
+	bool ok = true;
+
+	if (flash_area_open(SLOT_ID, &fa) != 0) {
+		return false;
+	}
+
+	for (size_t off = 0; ok && off < IMAGE_SIZE; off += sizeof(read_buf)) {
+		size_t len = MIN(sizeof(read_buf), IMAGE_SIZE - off);
+
+		ok = flash_area_read(fa, off, read_buf, len) == 0 &&
+		     memcmp(read_buf, &image[off], len) == 0;
+	}
+
+	flash_area_close(fa);
+
+	return ok;
+}
+
+static int run_upload(int sock, const char *name, uint32_t win, uint32_t *errors)
+{
+	struct upload_rsp rsp;
+	uint32_t requests = 0;
+	uint64_t cycles;
+	timing_t start, end;
+	char tag[40];
+	int rc;
+
+	start = timing_counter_get();
+	rc = upload(sock, win, &requests);
+	end = timing_counter_get();
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	cycles = timing_cycles_get(&start, &end);
+
+	/* Drop the responses to chunks sent again */
+	while (receive_rsp(sock, &rsp) != -EAGAIN) {
+	}
+
+	snprintk(tag, sizeof(tag), "mcumgr.upload.%s", name);
+	bench_report(tag, "Upload time", timing_cycles_to_ns(cycles) / NSEC_PER_USEC, "us");
+	snprintk(tag, sizeof(tag), "mcumgr.upload.%s.rate", name);
+	bench_report(tag, "Upload rate",
+		     cycles != 0 ?
+		     (uint64_t)IMAGE_SIZE * NSEC_PER_SEC / timing_cycles_to_ns(cycles) / 1000 : 0,
+		     "kB/s");
+	snprintk(tag, sizeof(tag), "mcumgr.upload.%s.requests", name);
+	bench_report(tag, "Requests sent", requests, "requests");
+
+	*errors += !image_ok();
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int sock;
+	int rc;
+
+	if (k_sem_take(&proxy_ready, K_SECONDS(1)) < 0) {
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0) {
+		TC_PRINT("Cannot open the client socket: %d\n", errno);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	/* Let the SMP server start on the loopback interface */
+	k_sleep(K_MSEC(100));
+
+	fill_image();
+
+	timing_init();
+	timing_start();
+
+	rc = run_upload(sock, "stop_and_wait", 0, &errors);
+	if (rc == 0) {
+		rc = run_upload(sock, "windowed", WINDOW, &errors);
+	}
+
+	timing_stop();
+
+	if (rc < 0) {
+		TC_PRINT("Cannot upload the image: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	bench_report("mcumgr.upload.errors", "Uploads with a corrupted image", errors, "uploads");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
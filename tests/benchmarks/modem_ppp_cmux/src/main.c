@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken to transmit and
+ * receive PPP frames through the modem PPP module stacked on a CMUX channel,
+ * the CMUX instance being connected to a second one through bridged mock
+ * backends.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/modem/cmux.h>
+#include <zephyr/modem/ppp.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_l2.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include <modem_backend_mock.h>
+
+#include "bench_report.h"
+
+#define NUM_FRAMES   CONFIG_BENCHMARK_NUM_FRAMES
+#define FRAME_SIZE   CONFIG_BENCHMARK_FRAME_SIZE
+#define DLCI_ADDRESS 2
+#define CMUX_BUF_SIZE 256
+#define PPP_BUF_SIZE 512
+#define MOCK_BUF_SIZE 4096
+#define WAIT_TIMEOUT K_SECONDS(1)
+
+/* Protocol, payload and FCS, all escaped at worst, and the delimiters */
+#define WRAPPED_SIZE_MAX (4 + 2 * (2 + FRAME_SIZE + 2) + 1)
+
+static K_SEM_DEFINE(connected, 0, 2);
+static K_SEM_DEFINE(dlci_opened, 0, 2);
+static K_SEM_DEFINE(modem_receive_ready, 0, 1);
+static K_SEM_DEFINE(modem_transmit_idle, 0, 1);
+static K_SEM_DEFINE(pkt_received, 0, 1);
+
+static size_t received_len;
+
+/* Network interface receiving the unwrapped frames */
+static uint8_t link_addr[] = {0x00, 0x00, 0x5E, 0x00, 0x53, 0x01};
+
+static enum net_verdict bench_l2_recv(struct net_if *iface, struct net_pkt *pkt)
+{
+	received_len = net_pkt_get_len(pkt);
+	net_pkt_unref(pkt);
+	k_sem_give(&pkt_received);
+
+	return NET_OK;
+}
+
+static struct net_l2 bench_l2 = {
+	.recv = bench_l2_recv,
+};
+
+static struct net_if_dev bench_if_dev = {
+	.l2 = &bench_l2,
+	.link_addr.addr = link_addr,
+	.link_addr.len = sizeof(link_addr),
+	.link_addr.type = NET_LINK_DUMMY,
+	.mtu = 1500,
+	.oper_state = NET_IF_OPER_UP,
+};
+
+static struct net_if bench_iface = {
+	.if_dev = &bench_if_dev,
+};
+
+/* Modem PPP, initialized manually as the network interface is emulated */
+static uint8_t ppp_receive_buf[PPP_BUF_SIZE];
+static uint8_t ppp_transmit_buf[PPP_BUF_SIZE];
+
+static struct modem_ppp ppp = {
+	.iface = &bench_iface,
+	.receive_buf = ppp_receive_buf,
+	.transmit_buf = ppp_transmit_buf,
+	.buf_size = PPP_BUF_SIZE,
+};
+
+extern const struct ppp_api modem_ppp_ppp_api;
+static const struct device ppp_net_dev = {.data = &ppp};
+
+/* CMUX of the host, carrying PPP, and CMUX of the modem */
+struct cmux_end {
+	struct modem_cmux cmux;
+	uint8_t receive_buf[CMUX_BUF_SIZE];
+	uint8_t transmit_buf[CMUX_BUF_SIZE];
+	struct modem_cmux_dlci dlci;
+	uint8_t dlci_receive_buf[CMUX_BUF_SIZE];
+	struct modem_pipe *dlci_pipe;
+	struct modem_backend_mock mock;
+	uint8_t mock_rx_buf[MOCK_BUF_SIZE];
+	uint8_t mock_tx_buf[MOCK_BUF_SIZE];
+};
+
+static struct cmux_end host;
+static struct cmux_end modem;
+
+static uint8_t frame[2 + FRAME_SIZE + 2];
+static uint8_t wrapped[WRAPPED_SIZE_MAX];
+static size_t wrapped_size;
+static uint8_t buffer[CMUX_BUF_SIZE];
+
+static void cmux_callback(struct modem_cmux *cmux, enum modem_cmux_event event, void *user_data)
+{
+	if (event == MODEM_CMUX_EVENT_CONNECTED) {
+		k_sem_give(&connected);
+	}
+}
+
+static void host_dlci_callback(struct modem_pipe *pipe, enum modem_pipe_event event,
+			       void *user_data)
+{
+	if (event == MODEM_PIPE_EVENT_OPENED) {
+		k_sem_give(&dlci_opened);
+	}
+}
+
+static void modem_dlci_callback(struct modem_pipe *pipe, enum modem_pipe_event event,
+				void *user_data)
+{
+	switch (event) {
+	case MODEM_PIPE_EVENT_OPENED:
+		k_sem_give(&dlci_opened);
+		break;
+
+	case MODEM_PIPE_EVENT_RECEIVE_READY:
+		k_sem_give(&modem_receive_ready);
+		break;
+
+	case MODEM_PIPE_EVENT_TRANSMIT_IDLE:
+		k_sem_give(&modem_transmit_idle);
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void cmux_end_init(struct cmux_end *end, modem_pipe_api_callback dlci_callback)
+{
+	const struct modem_cmux_config cmux_config = {
+		.callback = cmux_callback,
+		.receive_buf = end->receive_buf,
+		.receive_buf_size = sizeof(end->receive_buf),
+		.transmit_buf = end->transmit_buf,
+		.transmit_buf_size = sizeof(end->transmit_buf),
+	};
+	const struct modem_cmux_dlci_config dlci_config = {
+		.dlci_address = DLCI_ADDRESS,
+		.receive_buf = end->dlci_receive_buf,
+		.receive_buf_size = sizeof(end->dlci_receive_buf),
+	};
+	const struct modem_backend_mock_config mock_config = {
+		.rx_buf = end->mock_rx_buf,
+		.rx_buf_size = sizeof(end->mock_rx_buf),
+		.tx_buf = end->mock_tx_buf,
+		.tx_buf_size = sizeof(end->mock_tx_buf),
+		.limit = MOCK_BUF_SIZE,
+	};
+	struct modem_pipe *bus_pipe;
+
+	modem_cmux_init(&end->cmux, &cmux_config);
+	end->dlci_pipe = modem_cmux_dlci_init(&end->cmux, &end->dlci, &dlci_config);
+	bus_pipe = modem_backend_mock_init(&end->mock, &mock_config);
+	(void)modem_pipe_open(bus_pipe, WAIT_TIMEOUT);
+	(void)modem_cmux_attach(&end->cmux, bus_pipe);
+	modem_pipe_attach(end->dlci_pipe, dlci_callback, NULL);
+}
+
+static int setup(void)
+{
+	cmux_end_init(&host, host_dlci_callback);
+	cmux_end_init(&modem, modem_dlci_callback);
+	modem_backend_mock_bridge(&host.mock, &modem.mock);
+
+	if ((modem_cmux_connect_async(&host.cmux) < 0) ||
+	    (k_sem_take(&connected, WAIT_TIMEOUT) < 0) ||
+	    (k_sem_take(&connected, WAIT_TIMEOUT) < 0)) {
+		return -ENOTCONN;
+	}
+
+	if ((modem_pipe_open_async(host.dlci_pipe) < 0) ||
+	    (k_sem_take(&dlci_opened, WAIT_TIMEOUT) < 0) ||
+	    (k_sem_take(&dlci_opened, WAIT_TIMEOUT) < 0)) {
+		return -ENOTCONN;
+	}
+
+	modem_ppp_init_internal(&ppp_net_dev);
+	net_if_flag_set(&bench_iface, NET_IF_UP);
+
+	return modem_ppp_attach(&ppp, host.dlci_pipe);
+}
+
+static uint32_t seed = 12345;
+
+static uint8_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 16;
+}
+
+/* Build an IPv4 PPP frame with a random payload, and the frame the modem sends for it */
+static void build_frame(void)
+{
+	static const uint8_t header[] = {0xFF, 0x03};
+	uint16_t fcs;
+
+	frame[0] = 0x00;
+	frame[1] = 0x21;
+
+	for (size_t i = 2; i < (sizeof(frame) - 2); i++) {
+		frame[i] = next_random();
+	}
+
+	fcs = crc16_ccitt(0xFFFF, header, sizeof(header));
+	fcs = crc16_ccitt(fcs, frame, sizeof(frame) - 2) ^ 0xFFFF;
+	frame[sizeof(frame) - 2] = fcs & 0xFF;
+	frame[sizeof(frame) - 1] = fcs >> 8;
+
+	wrapped[0] = 0x7E;
+	wrapped[1] = 0xFF;
+	wrapped[2] = 0x7D;
+	wrapped[3] = 0x23;
+	wrapped_size = 4;
+
+	for (size_t i = 0; i < sizeof(frame); i++) {
+		if ((frame[i] == 0x7E) || (frame[i] == 0x7D) || (frame[i] < 0x20)) {
+			wrapped[wrapped_size++] = 0x7D;
+			wrapped[wrapped_size++] = frame[i] ^ 0x20;
+		} else {
+			wrapped[wrapped_size++] = frame[i];
+		}
+	}
+
+	wrapped[wrapped_size++] = 0x7E;
+}
+
+/* Read from the channel of the modem until the end of the frame */
+static int modem_receive_frame(void)
+{
+	int delimiters = 0;
+	int ret;
+
+	while (delimiters < 2) {
+		ret = modem_pipe_receive(modem.dlci_pipe, buffer, sizeof(buffer));
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (ret == 0) {
+			if (k_sem_take(&modem_receive_ready, WAIT_TIMEOUT) < 0) {
+				return -ETIMEDOUT;
+			}
+
+			continue;
+		}
+
+		for (int i = 0; i < ret; i++) {
+			delimiters += buffer[i] == 0x7E;
+		}
+	}
+
+	return 0;
+}
+
+/* Write the wrapped frame to the channel of the modem */
+static int modem_transmit_frame(void)
+{
+	size_t sent = 0;
+	int ret;
+
+	while (sent < wrapped_size) {
+		ret = modem_pipe_transmit(modem.dlci_pipe, &wrapped[sent], wrapped_size - sent);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (ret == 0) {
+			if (k_sem_take(&modem_transmit_idle, WAIT_TIMEOUT) < 0) {
+				return -ETIMEDOUT;
+			}
+
+			continue;
+		}
+
+		sent += ret;
+	}
+
+	return 0;
+}
+
+static void report_rate(const char *name, const char *description, uint64_t cycles)
+{
+	uint64_t avg_ns = timing_cycles_to_ns_avg(cycles, NUM_FRAMES);
+	char tag[40];
+
+	snprintk(tag, sizeof(tag), "modem.ppp_cmux.%s.frame", name);
+	bench_report(tag, description, avg_ns, "ns");
+	snprintk(tag, sizeof(tag), "modem.ppp_cmux.%s.rate", name);
+	bench_report(tag, "Payload rate",
+		     avg_ns != 0 ? (uint64_t)FRAME_SIZE * NSEC_PER_SEC / avg_ns / 1000 : 0, "kB/s");
+}
+
+static int run_transmit(void)
+{
+	struct net_pkt *pkt;
+	uint64_t cycles = 0;
+	int ret = 0;
+
+	pkt = net_pkt_alloc_with_buffer(&bench_iface, FRAME_SIZE, AF_UNSPEC, 0, K_NO_WAIT);
+	if (pkt == NULL) {
+		return -ENOMEM;
+	}
+
+	net_pkt_set_family(pkt, AF_INET);
+	if (net_pkt_write(pkt, &frame[2], FRAME_SIZE) < 0) {
+		net_pkt_unref(pkt);
+		return -ENOBUFS;
+	}
+
+	for (int i = 0; i < NUM_FRAMES; i++) {
+		timing_t start, end;
+
+		start = timing_counter_get();
+		ret = modem_ppp_ppp_api.send(&ppp_net_dev, pkt);
+		if (ret == 0) {
+			ret = modem_receive_frame();
+		}
+		end = timing_counter_get();
+
+		if (ret < 0) {
+			break;
+		}
+
+		cycles += timing_cycles_get(&start, &end);
+	}
+
+	net_pkt_unref(pkt);
+
+	if (ret == 0) {
+		report_rate("tx", "Average frame transmit time", cycles);
+	}
+
+	return ret;
+}
+
+static int run_receive(uint32_t *errors)
+{
+	uint64_t cycles = 0;
+	int ret;
+
+	for (int i = 0; i < NUM_FRAMES; i++) {
+		timing_t start, end;
+
+		start = timing_counter_get();
+		ret = modem_transmit_frame();
+		if (ret == 0 && k_sem_take(&pkt_received, WAIT_TIMEOUT) < 0) {
+			ret = -ETIMEDOUT;
+		}
+		end = timing_counter_get();
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		cycles += timing_cycles_get(&start, &end);
+
+		/* The FCS is removed from the packet */
+		*errors += received_len != (2 + FRAME_SIZE);
+	}
+
+	report_rate("rx", "Average frame receive time", cycles);
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int ret;
+
+	ret = setup();
+	if (ret < 0) {
+		TC_PRINT("Cannot connect the CMUX instances: %d\n", ret);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	build_frame();
+
+	timing_init();
+	timing_start();
+
+	ret = run_transmit();
+	if (ret == 0) {
+		ret = run_receive(&errors);
+	}
+
+	timing_stop();
+
+	if (ret < 0) {
+		TC_PRINT("Cannot transfer the frames: %d\n", ret);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	bench_report("modem.ppp_cmux.rx.errors", "Frames received with a bad length", errors,
+		     "frames");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken to find the network
+ * interface owning an IPv6 or IPv4 address, with 32 interfaces having 8
+ * addresses of each family.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_LOOKUPS     CONFIG_BENCHMARK_NUM_LOOKUPS
+#define NUM_IFACES      32
+#define ADDRS_PER_IFACE 8
+
+BUILD_ASSERT(CONFIG_NET_IF_MAX_IPV6_COUNT >= NUM_IFACES);
+BUILD_ASSERT(CONFIG_NET_IF_MAX_IPV4_COUNT >= NUM_IFACES);
+BUILD_ASSERT(CONFIG_NET_IF_UNICAST_IPV6_ADDR_COUNT >= ADDRS_PER_IFACE);
+BUILD_ASSERT(CONFIG_NET_IF_UNICAST_IPV4_ADDR_COUNT >= ADDRS_PER_IFACE);
+
+#if defined(CONFIG_NET_IF_ADDR_INDEX)
+#define MODE ".index"
+#else
+#define MODE ""
+#endif
+
+static uint8_t mac_addrs[NUM_IFACES][sizeof(struct net_eth_addr)];
+
+static void bench_iface_init(struct net_if *iface)
+{
+	uint8_t *mac = mac_addrs[(net_if_get_by_iface(iface) - 1) % NUM_IFACES];
+
+	mac[0] = 0x00;
+	mac[1] = 0x00;
+	mac[2] = 0x5E;
+	mac[3] = 0x00;
+	mac[4] = 0x53;
+	mac[5] = net_if_get_by_iface(iface);
+
+	net_if_set_link_addr(iface, mac, sizeof(mac_addrs[0]), NET_LINK_ETHERNET);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+#define BENCH_IFACE_DEFINE(i, _)						\
+	NET_DEVICE_INIT(bench_if_##i, "bench_if_" #i, NULL, NULL, NULL, NULL,	\
+			CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,	\
+			DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280)
+
+LISTIFY(NUM_IFACES, BENCH_IFACE_DEFINE, (;));
+
+static struct net_if *ifaces[NUM_IFACES];
+
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+/* 2001:db8:<iface>:<n>::1, the interface 0xffff owns no address */
+static void ipv6_addr(int iface, int n, struct in6_addr *addr)
+{
+	memset(addr, 0, sizeof(*addr));
+
+	addr->s6_addr[0] = 0x20;
+	addr->s6_addr[1] = 0x01;
+	addr->s6_addr[2] = 0x0d;
+	addr->s6_addr[3] = 0xb8;
+	addr->s6_addr[4] = iface >> 8;
+	addr->s6_addr[5] = iface & 0xff;
+	addr->s6_addr[7] = n;
+	addr->s6_addr[15] = 0x1;
+}
+
+/* 10.<iface>.<n>.1, the interface 0xff owns no address */
+static void ipv4_addr(int iface, int n, struct in_addr *addr)
+{
+	addr->s4_addr[0] = 10;
+	addr->s4_addr[1] = iface;
+	addr->s4_addr[2] = n;
+	addr->s4_addr[3] = 1;
+}
+
+static int add_addresses(void)
+{
+	struct in6_addr addr6;
+	struct in_addr addr4;
+	int i = 0;
+
+	STRUCT_SECTION_FOREACH(net_if, iface) {
+		if (net_if_l2(iface) != &NET_L2_GET_NAME(DUMMY) || i == NUM_IFACES) {
+			continue;
+		}
+
+		ifaces[i] = iface;
+
+		for (int n = 0; n < ADDRS_PER_IFACE; n++) {
+			ipv6_addr(i, n, &addr6);
+			ipv4_addr(i, n, &addr4);
+
+			if (net_if_ipv6_addr_add(iface, &addr6, NET_ADDR_MANUAL, 0) == NULL ||
+			    net_if_ipv4_addr_add(iface, &addr4, NET_ADDR_MANUAL, 0) == NULL) {
+				return -ENOMEM;
+			}
+		}
+
+		i++;
+	}
+
+	return i == NUM_IFACES ? 0 : -ENODEV;
+}
+
+/* Returns the number of lookups that did not find the expected interface */
+static uint32_t run_lookups(sa_family_t family)
+{
+	uint64_t total = 0;
+	uint32_t errors = 0;
+	timing_t start, end;
+
+	for (int i = 0; i < NUM_LOOKUPS; i++) {
+		/* One lookup in four is for an address that is not set */
+		bool miss = next_random() % 4 == 0;
+		int iface = miss ? 0xff : next_random() % NUM_IFACES;
+		int n = next_random() % ADDRS_PER_IFACE;
+		struct net_if *found = NULL;
+		struct net_if_addr *ifaddr;
+		struct in6_addr addr6;
+		struct in_addr addr4;
+
+		if (family == AF_INET6) {
+			ipv6_addr(miss ? 0xffff : iface, n, &addr6);
+
+			start = timing_counter_get();
+			ifaddr = net_if_ipv6_addr_lookup(&addr6, &found);
+			end = timing_counter_get();
+		} else {
+			ipv4_addr(iface, n, &addr4);
+
+			start = timing_counter_get();
+			ifaddr = net_if_ipv4_addr_lookup(&addr4, &found);
+			end = timing_counter_get();
+		}
+
+		total += timing_cycles_to_ns(timing_cycles_get(&start, &end));
+
+		if (miss ? ifaddr != NULL : (ifaddr == NULL || found != ifaces[iface])) {
+			errors++;
+		}
+	}
+
+	if (family == AF_INET6) {
+		bench_report("net.iface.addr_lookup" MODE ".ipv6", "Average address lookup time",
+			     total / NUM_LOOKUPS, "ns");
+	} else {
+		bench_report("net.iface.addr_lookup" MODE ".ipv4", "Average address lookup time",
+			     total / NUM_LOOKUPS, "ns");
+	}
+
+	return errors;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int rc;
+
+	rc = add_addresses();
+	if (rc < 0) {
+		TC_PRINT("Cannot add the addresses: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	errors += run_lookups(AF_INET6);
+	errors += run_lookups(AF_INET);
+
+	timing_stop();
+
+	bench_report("net.iface.addr_lookup" MODE ".errors", "Lookups of a wrong interface", errors,
+		     "lookups");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken by receive packet
+ * filtering as the rule list grows from 1 to 200 rules.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_pkt_filter.h>
+#include <zephyr/sys/util_macro.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_PACKETS CONFIG_BENCHMARK_NUM_PACKETS
+#define NUM_PKTS    8
+#define PKT_SIZE    128
+#define MAX_RULES   200
+#define FIRST_TYPE  0x9000
+
+static const int rule_counts[] = { 1, 20, MAX_RULES };
+
+ETH_NET_DEVICE_INIT(bench_iface_a, "bench_a", NULL, NULL, NULL, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, NULL, NET_ETH_MTU);
+ETH_NET_DEVICE_INIT(bench_iface_b, "bench_b", NULL, NULL, NULL, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, NULL, NET_ETH_MTU);
+#define bench_iface_a NET_IF_GET_NAME(bench_iface_a, 0)[0]
+#define bench_iface_b NET_IF_GET_NAME(bench_iface_b, 0)[0]
+
+/* Rule i drops the Ethernet type FIRST_TYPE + i, on interface A if i is even */
+#define BENCH_TESTS(i, _)                                                                      \
+	static NPF_ETH_TYPE_MATCH(match_type_##i, FIRST_TYPE + i);                             \
+	static NPF_IFACE_MATCH(match_iface_##i, (i) % 2 == 0 ? &bench_iface_a : &bench_iface_b)
+#define BENCH_RULE(i, _) static NPF_RULE(drop_##i, NET_DROP, match_type_##i, match_iface_##i)
+#define BENCH_RULE_ADDR(i, _) &drop_##i
+
+LISTIFY(MAX_RULES, BENCH_TESTS, (;));
+LISTIFY(MAX_RULES, BENCH_RULE, (;));
+
+static struct npf_rule *const rules[] = {
+	LISTIFY(MAX_RULES, BENCH_RULE_ADDR, (,))
+};
+
+static struct net_pkt *pkts[NUM_PKTS];
+
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+static int build_pkts(void)
+{
+	struct net_eth_hdr eth_hdr = { 0 };
+
+	for (int i = 0; i < NUM_PKTS; i++) {
+		pkts[i] = net_pkt_rx_alloc_with_buffer(&bench_iface_a, PKT_SIZE, AF_UNSPEC, 0,
+						       K_NO_WAIT);
+		if (pkts[i] == NULL) {
+			return -ENOMEM;
+		}
+
+		if (net_pkt_write(pkts[i], &eth_hdr, sizeof(eth_hdr)) < 0) {
+			return -ENOBUFS;
+		}
+	}
+
+	return 0;
+}
+
+/* One packet in four has a type no rule filters */
+static struct net_pkt *next_pkt(int num_rules)
+{
+	struct net_pkt *pkt = pkts[next_random() % NUM_PKTS];
+	uint16_t type = NET_ETH_PTYPE_IP;
+
+	if (next_random() % 4 != 0) {
+		type = FIRST_TYPE + next_random() % num_rules;
+	}
+
+	NET_ETH_HDR(pkt)->type = htons(type);
+	net_pkt_set_iface(pkt, next_random() % 2 == 0 ? &bench_iface_a : &bench_iface_b);
+
+	return pkt;
+}
+
+int main(void)
+{
+	int num_rules = 0;
+	int ret;
+
+	ret = build_pkts();
+	if (ret < 0) {
+		TC_PRINT("Cannot build the packets: %d\n", ret);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	for (int r = 0; r < ARRAY_SIZE(rule_counts); r++) {
+		uint32_t accepted = 0;
+		uint64_t cycles = 0;
+		uint64_t avg_ns;
+		char tag[40];
+
+		npf_remove_recv_rule(&npf_default_ok);
+
+		for (; num_rules < rule_counts[r]; num_rules++) {
+			npf_append_recv_rule(rules[num_rules]);
+		}
+
+		npf_append_recv_rule(&npf_default_ok);
+
+		for (int i = 0; i < NUM_PACKETS; i++) {
+			struct net_pkt *pkt = next_pkt(num_rules);
+			timing_t start, end;
+			bool ok;
+
+			start = timing_counter_get();
+			ok = net_pkt_filter_recv_ok(pkt);
+			end = timing_counter_get();
+
+			cycles += timing_cycles_get(&start, &end);
+			accepted += ok;
+		}
+
+		avg_ns = timing_cycles_to_ns_avg(cycles, NUM_PACKETS);
+
+		snprintk(tag, sizeof(tag), "net.pkt_filter.recv.%d", num_rules);
+		bench_report(tag, "Average filter time", avg_ns, "ns");
+		snprintk(tag, sizeof(tag), "net.pkt_filter.rate.%d", num_rules);
+		bench_report(tag, "Packets filtered per second",
+			     avg_ns != 0 ? NSEC_PER_SEC / avg_ns : 0, "pkts");
+		snprintk(tag, sizeof(tag), "net.pkt_filter.accepted.%d", num_rules);
+		bench_report(tag, "Packets accepted", accepted, "pkts");
+	}
+
+	timing_stop();
+
+	npf_remove_all_recv_rules();
+
+	for (int i = 0; i < NUM_PKTS; i++) {
+		net_pkt_unref(pkts[i]);
+	}
+
+	TC_END_REPORT(TC_PASS);
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken by IPv6 route
+ * lookups as the routing table grows from 10 to 1000 routes.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "ipv6.h"
+#include "nbr.h"
+#include "route.h"
+#include "bench_report.h"
+
+#define NUM_LOOKUPS CONFIG_BENCHMARK_NUM_LOOKUPS
+
+static const int table_sizes[] = { 10, 100, 1000 };
+static const uint8_t prefix_lens[] = { 48, 56, 64, 128 };
+
+static struct in6_addr nexthop = { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+
+static uint8_t mac_addr[sizeof(struct net_eth_addr)] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+static uint8_t nexthop_mac[sizeof(struct net_eth_addr)] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x02 };
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr), NET_LINK_ETHERNET);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_route_bench, "net_route_bench", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+/* 2001:db8:<i>::/len, the host bits of the longest prefixes are set too */
+static void route_prefix(int i, struct in6_addr *addr, uint8_t *len)
+{
+	memset(addr, 0, sizeof(*addr));
+
+	addr->s6_addr[0] = 0x20;
+	addr->s6_addr[1] = 0x01;
+	addr->s6_addr[2] = 0x0d;
+	addr->s6_addr[3] = 0xb8;
+	addr->s6_addr[4] = i >> 8;
+	addr->s6_addr[5] = i & 0xff;
+
+	*len = prefix_lens[i % ARRAY_SIZE(prefix_lens)];
+	if (*len == 128) {
+		addr->s6_addr[15] = 0x1;
+	}
+}
+
+static void lookup_address(int num_routes, struct in6_addr *dst)
+{
+	uint8_t len;
+
+	/* One lookup in four has no route */
+	if (next_random() % 4 == 0) {
+		memset(dst, 0, sizeof(*dst));
+		dst->s6_addr[0] = 0x3f;
+		dst->s6_addr[1] = 0xff;
+		dst->s6_addr[15] = next_random() & 0xff;
+		return;
+	}
+
+	route_prefix(next_random() % num_routes, dst, &len);
+	if (len < 128) {
+		dst->s6_addr[len / 8] |= next_random() & (0xff >> (len % 8));
+		dst->s6_addr[15] = next_random() & 0xff;
+	}
+}
+
+int main(void)
+{
+	struct net_linkaddr lladdr = {
+		.addr = nexthop_mac,
+		.len = sizeof(nexthop_mac),
+		.type = NET_LINK_ETHERNET,
+	};
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	int num_routes = 0;
+
+	if (net_ipv6_nbr_add(iface, &nexthop, &lladdr, true,
+			     NET_IPV6_NBR_STATE_STATIC) == NULL) {
+		TC_PRINT("Cannot add the next hop neighbor\n");
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	for (int t = 0; t < ARRAY_SIZE(table_sizes); t++) {
+		uint32_t found = 0;
+		uint64_t cycles = 0;
+		char tag[40];
+
+		for (; num_routes < table_sizes[t]; num_routes++) {
+			struct in6_addr prefix;
+			uint8_t len;
+
+			route_prefix(num_routes, &prefix, &len);
+			if (net_route_add(iface, &prefix, len, &nexthop,
+					  NET_IPV6_ND_INFINITE_LIFETIME,
+					  NET_ROUTE_PREFERENCE_MEDIUM) == NULL) {
+				TC_PRINT("Cannot add route %d\n", num_routes);
+				TC_END_REPORT(TC_FAIL);
+				return 0;
+			}
+		}
+
+		for (int i = 0; i < NUM_LOOKUPS; i++) {
+			struct in6_addr dst;
+			timing_t start, end;
+			struct net_route_entry *route;
+
+			lookup_address(num_routes, &dst);
+
+			start = timing_counter_get();
+			route = net_route_lookup(iface, &dst);
+			end = timing_counter_get();
+
+			cycles += timing_cycles_get(&start, &end);
+			found += route != NULL;
+		}
+
+		snprintk(tag, sizeof(tag), "net.route.lookup.%d", num_routes);
+		bench_report(tag, "Average route lookup time",
+			     timing_cycles_to_ns_avg(cycles, NUM_LOOKUPS), "ns");
+		snprintk(tag, sizeof(tag), "net.route.found.%d", num_routes);
+		bench_report(tag, "Lookups finding a route", found, "lookups");
+	}
+
+	timing_stop();
+
+	TC_END_REPORT(TC_PASS);
+
+	return 0;
+}
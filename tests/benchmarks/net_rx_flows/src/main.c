@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains a benchmark measuring the rate at which the IP stack
+ * delivers UDP datagrams received on the loopback interface, when the
+ * traffic is spread over several flows, to compare the default receive path
+ * with the RX flow steering and the sharded connection table.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_FLOWS   CONFIG_BENCHMARK_NUM_FLOWS
+#define NUM_PACKETS CONFIG_BENCHMARK_NUM_PACKETS
+#define MSG_SIZE    64
+#define TX_PORT     6000
+#define RX_PORT     7000
+
+/* Time without any datagram after which the remaining ones are lost */
+#define IDLE_TIMEOUT_MS 200
+
+#define RECEIVER_PRIORITY   K_PRIO_COOP(8)
+#define RECEIVER_STACK_SIZE 2048
+
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+#define MODE "steering"
+#else
+#define MODE "default"
+#endif
+
+K_THREAD_STACK_DEFINE(receiver_stack, RECEIVER_STACK_SIZE);
+static struct k_thread receiver_thread;
+static K_SEM_DEFINE(receiver_done, 0, 1);
+
+static int tx_socks[NUM_FLOWS];
+static int rx_socks[NUM_FLOWS];
+
+static uint8_t msg[MSG_SIZE];
+
+static uint32_t received;
+static timing_t last_rx;
+
+static int flow_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+
+	return zsock_inet_pton(AF_INET, "127.0.0.1", &addr->sin_addr) == 1 ? 0 : -EINVAL;
+}
+
+/* Open a pair of sockets per flow, each connected to the other one, so that
+ * the receiving connections all have a remote address and port.
+ */
+static int open_flows(void)
+{
+	struct sockaddr_in tx_addr;
+	struct sockaddr_in rx_addr;
+
+	for (int i = 0; i < NUM_FLOWS; i++) {
+		if (flow_addr(&tx_addr, TX_PORT + i) < 0 || flow_addr(&rx_addr, RX_PORT + i) < 0) {
+			return -EINVAL;
+		}
+
+		tx_socks[i] = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		rx_socks[i] = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (tx_socks[i] < 0 || rx_socks[i] < 0) {
+			return -errno;
+		}
+
+		if (zsock_bind(tx_socks[i], (struct sockaddr *)&tx_addr, sizeof(tx_addr)) < 0 ||
+		    zsock_bind(rx_socks[i], (struct sockaddr *)&rx_addr, sizeof(rx_addr)) < 0 ||
+		    zsock_connect(tx_socks[i], (struct sockaddr *)&rx_addr, sizeof(rx_addr)) < 0 ||
+		    zsock_connect(rx_socks[i], (struct sockaddr *)&tx_addr, sizeof(tx_addr)) < 0) {
+			return -errno;
+		}
+	}
+
+	return 0;
+}
+
+static void receiver(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	static struct zsock_pollfd fds[NUM_FLOWS];
+	static uint8_t buf[MSG_SIZE];
+
+	for (int i = 0; i < NUM_FLOWS; i++) {
+		fds[i].fd = rx_socks[i];
+		fds[i].events = ZSOCK_POLLIN;
+	}
+
+	while (received < NUM_PACKETS) {
+		int ret = zsock_poll(fds, NUM_FLOWS, IDLE_TIMEOUT_MS);
+
+		if (ret <= 0) {
+			/* Idle for too long, the other datagrams were dropped */
+			break;
+		}
+
+		for (int i = 0; i < NUM_FLOWS; i++) {
+			if (!(fds[i].revents & ZSOCK_POLLIN)) {
+				continue;
+			}
+
+			while (zsock_recv(fds[i].fd, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT) > 0) {
+				received++;
+			}
+		}
+
+		last_rx = timing_counter_get();
+	}
+
+	k_sem_give(&receiver_done);
+}
+
+static int send_packets(void)
+{
+	for (int i = 0; i < NUM_PACKETS; i++) {
+		int sock = tx_socks[i % NUM_FLOWS];
+
+		while (zsock_send(sock, msg, sizeof(msg), 0) < 0) {
+			if (errno != ENOMEM && errno != ENOBUFS && errno != EAGAIN) {
+				return -errno;
+			}
+
+			/* Let the stack drain the queues */
+			k_yield();
+		}
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	timing_t start;
+	uint64_t ns;
+	int rc;
+
+	rc = open_flows();
+	if (rc < 0) {
+		TC_PRINT("Cannot open the flows: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	k_thread_create(&receiver_thread, receiver_stack, K_THREAD_STACK_SIZEOF(receiver_stack),
+			receiver, NULL, NULL, NULL, RECEIVER_PRIORITY, 0, K_NO_WAIT);
+
+	start = timing_counter_get();
+
+	rc = send_packets();
+
+	k_sem_take(&receiver_done, K_FOREVER);
+
+	ns = timing_cycles_to_ns(timing_cycles_get(&start, &last_rx));
+
+	timing_stop();
+
+	if (rc < 0) {
+		TC_PRINT("Cannot send: %d\n", rc);
+		errors++;
+	}
+
+	/* Losing most of the traffic means the flows are not delivered */
+	errors += (received < NUM_PACKETS / 2);
+
+	bench_report("net.rx_flows." MODE, "Datagrams received",
+		     ns > 0 ? (uint64_t)received * NSEC_PER_SEC / ns : 0, "packets/s");
+	bench_report("net.rx_flows." MODE ".drops", "Datagrams lost", NUM_PACKETS - received,
+		     "packets");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
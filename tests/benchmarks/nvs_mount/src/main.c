@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken to mount an NVS file
+ * system filled to several levels, and count the flash reads done by the
+ * mount to rebuild the lookup cache.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/nvs.h>
+#include <zephyr/stats/stats.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define SECTOR_COUNT CONFIG_BENCHMARK_SECTOR_COUNT
+#define NUM_IDS      CONFIG_BENCHMARK_NUM_IDS
+#define HOT_IDS      CONFIG_BENCHMARK_HOT_IDS
+#define NUM_MOUNTS   CONFIG_BENCHMARK_NUM_MOUNTS
+#define SECTOR_SIZE  4096
+#define SLOT_OFFSET  FIXED_PARTITION_OFFSET(slot1_partition)
+#define SLOT_SIZE    FIXED_PARTITION_SIZE(slot1_partition)
+#define SECT_SHIFT   16
+
+BUILD_ASSERT(SECTOR_COUNT * SECTOR_SIZE <= SLOT_SIZE, "File system does not fit in the slot");
+BUILD_ASSERT(HOT_IDS <= NUM_IDS, "More hot IDs than IDs");
+
+static const uint8_t fill_levels[] = {25, 50, 100};
+
+struct record {
+	uint32_t id;
+	uint32_t version;
+	uint8_t payload[24];
+};
+
+static struct nvs_fs fs = {
+	.flash_device = FIXED_PARTITION_DEVICE(slot1_partition),
+	.offset = SLOT_OFFSET,
+	.sector_size = SECTOR_SIZE,
+	.sector_count = SECTOR_COUNT,
+};
+
+static uint32_t versions[NUM_IDS];
+
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+struct stat_value {
+	const char *name;
+	uint32_t value;
+};
+
+static int find_stat(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off)
+{
+	struct stat_value *stat = arg;
+
+	if (strcmp(name, stat->name) == 0) {
+		stat->value = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t flash_stat(const char *name)
+{
+	struct stat_value stat = {.name = name};
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	if (hdr != NULL) {
+		(void)stats_walk(hdr, find_stat, &stat);
+	}
+
+	return stat.value;
+}
+
+static int write_record(uint16_t id)
+{
+	struct record record = {
+		.id = id,
+		.version = ++versions[id - 1],
+	};
+	ssize_t rc;
+
+	memset(record.payload, id, sizeof(record.payload));
+
+	rc = nvs_write(&fs, id, &record, sizeof(record));
+
+	return rc < 0 ? rc : 0;
+}
+
+/* Write every ID once, then update hot IDs until the wanted number of
+ * sectors is used.
+ */
+static int fill(uint8_t level)
+{
+	uint32_t last_sector = SECTOR_COUNT * level / 100 - 1;
+	int rc;
+
+	rc = nvs_clear(&fs);
+	if (rc == 0) {
+		rc = nvs_mount(&fs);
+	}
+
+	memset(versions, 0, sizeof(versions));
+
+	for (int i = 1; rc == 0 && i <= NUM_IDS; i++) {
+		rc = write_record(i);
+	}
+
+	while (rc == 0 && (fs.ate_wra >> SECT_SHIFT) < last_sector) {
+		rc = write_record(1 + next_random() % HOT_IDS);
+	}
+
+	return rc;
+}
+
+/* Check that every ID reads back its last version */
+static bool content_ok(void)
+{
+	struct record record;
+
+	for (int i = 1; i <= NUM_IDS; i++) {
+		if (nvs_read(&fs, i, &record, sizeof(record)) != sizeof(record) ||
+		    record.id != i || record.version != versions[i - 1]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int run_mounts(uint8_t level, uint32_t *errors)
+{
+	uint64_t cycles = 0;
+	uint32_t reads, bytes;
+	timing_t start, end;
+	char tag[40];
+	int rc;
+
+	rc = fill(level);
+	if (rc < 0) {
+		return rc;
+	}
+
+	reads = flash_stat("flash_read_calls");
+	bytes = flash_stat("bytes_read");
+
+	for (int i = 0; i < NUM_MOUNTS; i++) {
+		start = timing_counter_get();
+		rc = nvs_mount(&fs);
+		end = timing_counter_get();
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		cycles += timing_cycles_get(&start, &end);
+	}
+
+	reads = flash_stat("flash_read_calls") - reads;
+	bytes = flash_stat("bytes_read") - bytes;
+
+	snprintk(tag, sizeof(tag), "nvs.mount.fill_%u", level);
+	bench_report(tag, "Average mount time", timing_cycles_to_ns_avg(cycles, NUM_MOUNTS), "ns");
+	snprintk(tag, sizeof(tag), "nvs.mount.fill_%u.reads", level);
+	bench_report(tag, "Flash reads per mount", reads / NUM_MOUNTS, "reads");
+	snprintk(tag, sizeof(tag), "nvs.mount.fill_%u.bytes", level);
+	bench_report(tag, "Bytes read per mount", bytes / NUM_MOUNTS, "bytes");
+
+	*errors += !content_ok();
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int rc;
+
+	if (!device_is_ready(fs.flash_device)) {
+		TC_PRINT("Flash device is not ready\n");
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	/* nvs_clear() needs a mounted file system */
+	rc = nvs_mount(&fs);
+	if (rc < 0) {
+		TC_PRINT("Cannot mount the file system: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	for (size_t i = 0; rc == 0 && i < ARRAY_SIZE(fill_levels); i++) {
+		rc = run_mounts(fill_levels[i], &errors);
+	}
+
+	timing_stop();
+
+	if (rc < 0) {
+		TC_PRINT("Cannot fill or mount the file system: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	bench_report("nvs.mount.errors", "Fill levels with a corrupted content", errors, "levels");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the throughput of sending and
+ * receiving POSIX messages, with and without mixed priorities, and the
+ * latency of SIGEV_THREAD notifications.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/posix/mqueue.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_ITERATIONS CONFIG_BENCHMARK_NUM_ITERATIONS
+#define QUEUE_NAME     "bench"
+#define MSG_SIZE       16
+#define MAX_MSGS       8
+#define NUM_PRIOS      4
+
+static char msg[MSG_SIZE] = "benchmark";
+static char rx_msg[MSG_SIZE];
+
+static K_SEM_DEFINE(notified, 0, 1);
+static timing_t notify_end;
+
+static mqd_t queue_open(void)
+{
+	struct mq_attr attrs = {
+		.mq_msgsize = MSG_SIZE,
+		.mq_maxmsg = MAX_MSGS,
+	};
+	mqd_t mqd = mq_open(QUEUE_NAME, O_RDWR | O_CREAT, 0666, &attrs);
+
+	if (mqd == (mqd_t)-1) {
+		TC_PRINT("Unable to open message queue (%d)\n", errno);
+	}
+
+	return mqd;
+}
+
+static void queue_close(mqd_t mqd)
+{
+	(void)mq_close(mqd);
+	(void)mq_unlink(QUEUE_NAME);
+}
+
+static uint64_t elapsed_ns(timing_t start, timing_t finish)
+{
+	return MAX(timing_cycles_to_ns(timing_cycles_get(&start, &finish)), 1);
+}
+
+static void report_ops(const char *tag, const char *description, uint64_t ops, uint64_t ns)
+{
+	bench_report(tag, description, ops * NSEC_PER_SEC / ns, "ops/s");
+}
+
+static int bench_send_receive(void)
+{
+	timing_t start, finish;
+	mqd_t mqd = queue_open();
+
+	if (mqd == (mqd_t)-1) {
+		return -1;
+	}
+
+	start = timing_counter_get();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		(void)mq_send(mqd, msg, MSG_SIZE, 0);
+		(void)mq_receive(mqd, rx_msg, MSG_SIZE, NULL);
+	}
+	finish = timing_counter_get();
+
+	queue_close(mqd);
+	report_ops("mq.send.receive", "Send and receive, same thread", NUM_ITERATIONS,
+		   elapsed_ns(start, finish));
+
+	return 0;
+}
+
+static int bench_priorities(void)
+{
+	timing_t start, finish;
+	unsigned int prio;
+	mqd_t mqd = queue_open();
+
+	if (mqd == (mqd_t)-1) {
+		return -1;
+	}
+
+	start = timing_counter_get();
+	for (int i = 0; i < NUM_ITERATIONS / MAX_MSGS; i++) {
+		for (int j = 0; j < MAX_MSGS; j++) {
+			(void)mq_send(mqd, msg, MSG_SIZE, (i + j) % NUM_PRIOS);
+		}
+		for (int j = 0; j < MAX_MSGS; j++) {
+			(void)mq_receive(mqd, rx_msg, MSG_SIZE, &prio);
+		}
+	}
+	finish = timing_counter_get();
+
+	queue_close(mqd);
+	report_ops("mq.send.receive.prio", "Fill and drain, mixed priorities",
+		   ROUND_DOWN(NUM_ITERATIONS, MAX_MSGS), elapsed_ns(start, finish));
+
+	return 0;
+}
+
+static void notify_fn(union sigval val)
+{
+	ARG_UNUSED(val);
+
+	notify_end = timing_counter_get();
+	k_sem_give(&notified);
+}
+
+static int bench_notify_latency(void)
+{
+	struct sigevent not = {
+		.sigev_notify = SIGEV_THREAD,
+		.sigev_notify_function = notify_fn,
+	};
+	uint64_t total_ns = 0;
+	timing_t start;
+	mqd_t mqd = queue_open();
+
+	if (mqd == (mqd_t)-1) {
+		return -1;
+	}
+
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		if (mq_notify(mqd, &not) != 0) {
+			TC_PRINT("Unable to register notification (%d)\n", errno);
+			queue_close(mqd);
+			return -1;
+		}
+
+		start = timing_counter_get();
+		(void)mq_send(mqd, msg, MSG_SIZE, 0);
+		(void)k_sem_take(&notified, K_FOREVER);
+		total_ns += elapsed_ns(start, notify_end);
+
+		(void)mq_receive(mqd, rx_msg, MSG_SIZE, NULL);
+	}
+
+	queue_close(mqd);
+	bench_report("mq.notify.thread.latency", "SIGEV_THREAD notification latency",
+		     total_ns / NUM_ITERATIONS, "ns");
+
+	return 0;
+}
+
+int main(void)
+{
+	int rc;
+
+	timing_init();
+	timing_start();
+
+	rc = bench_send_receive();
+	if (rc == 0) {
+		rc = bench_priorities();
+	}
+	if (rc == 0) {
+		rc = bench_notify_latency();
+	}
+
+	timing_stop();
+
+	TC_END_REPORT(rc == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
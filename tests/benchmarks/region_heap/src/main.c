@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that replay an allocation workload over fake
+ * memory regions with different attributes, and compare a multi-heap with a
+ * linear choice function to the region heap.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/multi_heap.h>
+#include <zephyr/sys/region_heap.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_OPS     CONFIG_BENCHMARK_NUM_OPS
+#define LIVE_BLOCKS CONFIG_BENCHMARK_LIVE_BLOCKS
+
+#define ATTR_FAST BIT(0)
+#define ATTR_DMA  BIT(1)
+
+enum {
+	REGION_TCM,
+	REGION_SRAM,
+	REGION_PSRAM,
+	NUM_REGIONS,
+};
+
+static uint8_t tcm_mem[4 * 1024] __aligned(8);
+static uint8_t sram_mem[32 * 1024] __aligned(8);
+static uint8_t psram_mem[64 * 1024] __aligned(8);
+
+static const struct sys_region_heap_config regions[] = {
+	[REGION_TCM] = {
+		.addr = (uintptr_t)tcm_mem,
+		.size = sizeof(tcm_mem),
+		.attr = ATTR_FAST,
+		.max_alloc = 128,
+		.slab_block_size = 64,
+		.slab_num_blocks = 32,
+		.fallback = REGION_SRAM,
+	},
+	[REGION_SRAM] = {
+		.addr = (uintptr_t)sram_mem,
+		.size = sizeof(sram_mem),
+		.attr = ATTR_FAST | ATTR_DMA,
+		.fallback = REGION_PSRAM,
+	},
+	[REGION_PSRAM] = {
+		.addr = (uintptr_t)psram_mem,
+		.size = sizeof(psram_mem),
+		.attr = ATTR_DMA,
+		.fallback = SYS_REGION_HEAP_NONE,
+	},
+};
+
+struct result {
+	uint64_t alloc_ns;
+	uint32_t fast;
+	uint32_t fast_in_tcm;
+	uint32_t failures;
+};
+
+/* Multi-heap taking the first heap providing the attributes */
+static struct {
+	struct sys_multi_heap mheap;
+	struct sys_heap heaps[NUM_REGIONS];
+	struct k_spinlock lock;
+} linear;
+
+static void *linear_choice(struct sys_multi_heap *mheap, void *cfg, size_t align, size_t size)
+{
+	uint32_t attr = (uint32_t)(uintptr_t)cfg;
+	k_spinlock_key_t key;
+	void *block = NULL;
+
+	key = k_spin_lock(&linear.lock);
+
+	for (int i = 0; i < NUM_REGIONS; i++) {
+		if ((regions[i].attr & attr) != attr) {
+			continue;
+		}
+
+		block = sys_heap_aligned_alloc(&linear.heaps[i], align, size);
+		if (block != NULL) {
+			break;
+		}
+	}
+
+	k_spin_unlock(&linear.lock, key);
+
+	return block;
+}
+
+static void linear_init(void)
+{
+	sys_multi_heap_init(&linear.mheap, linear_choice);
+
+	for (int i = 0; i < NUM_REGIONS; i++) {
+		sys_heap_init(&linear.heaps[i], (void *)regions[i].addr, regions[i].size);
+		sys_multi_heap_add_heap(&linear.mheap, &linear.heaps[i], NULL);
+	}
+}
+
+static void *linear_alloc(uint32_t attr, size_t bytes)
+{
+	return sys_multi_heap_alloc(&linear.mheap, (void *)(uintptr_t)attr, bytes);
+}
+
+static void linear_free(void *block)
+{
+	k_spinlock_key_t key = k_spin_lock(&linear.lock);
+
+	sys_multi_heap_free(&linear.mheap, block);
+
+	k_spin_unlock(&linear.lock, key);
+}
+
+static struct sys_region_heap rheap;
+
+static void *region_alloc(uint32_t attr, size_t bytes)
+{
+	return sys_region_heap_alloc(&rheap, attr, bytes);
+}
+
+static void region_free(void *block)
+{
+	sys_region_heap_free(&rheap, block);
+}
+
+static void *live[LIVE_BLOCKS];
+
+static void run(void *(*alloc)(uint32_t attr, size_t bytes), void (*free_fn)(void *block),
+		struct result *res)
+{
+	uint32_t seed = 12345;
+	uint64_t cycles = 0;
+
+	memset(res, 0, sizeof(*res));
+
+	for (int i = 0; i < NUM_OPS; i++) {
+		int slot = i % LIVE_BLOCKS;
+		timing_t start, end;
+		uint32_t attr, pick;
+		size_t bytes;
+		void *block;
+
+		seed = seed * 1103515245U + 12345U;
+		pick = (seed >> 16) % 100;
+
+		if (pick < 70) {
+			/* Small buffers on the fast path */
+			attr = ATTR_FAST;
+			bytes = 16 + (seed >> 8) % 48;
+		} else if (pick < 90) {
+			/* Medium DMA buffers */
+			attr = ATTR_DMA;
+			bytes = 256 + (seed >> 8) % 768;
+		} else {
+			/* Large buffers without requirements */
+			attr = 0;
+			bytes = 1024 + (seed >> 8) % 1024;
+		}
+
+		free_fn(live[slot]);
+
+		start = timing_counter_get();
+		block = alloc(attr, bytes);
+		end = timing_counter_get();
+
+		cycles += timing_cycles_get(&start, &end);
+		live[slot] = block;
+
+		if (block == NULL) {
+			res->failures++;
+			continue;
+		}
+
+		if (attr == ATTR_FAST) {
+			res->fast++;
+			if ((uintptr_t)block >= regions[REGION_TCM].addr &&
+			    (uintptr_t)block < regions[REGION_TCM].addr + regions[REGION_TCM].size) {
+				res->fast_in_tcm++;
+			}
+		}
+	}
+
+	for (int i = 0; i < LIVE_BLOCKS; i++) {
+		free_fn(live[i]);
+		live[i] = NULL;
+	}
+
+	res->alloc_ns = timing_cycles_to_ns_avg(cycles, NUM_OPS);
+}
+
+static void report_result(const char *name, const struct result *res)
+{
+	char tag[40];
+
+	snprintk(tag, sizeof(tag), "region_heap.%s.alloc", name);
+	bench_report(tag, "Average allocation time", res->alloc_ns, "ns");
+	snprintk(tag, sizeof(tag), "region_heap.%s.fast_in_tcm", name);
+	bench_report(tag, "Fast allocations placed in TCM",
+		     res->fast != 0 ? 100ULL * res->fast_in_tcm / res->fast : 0, "%");
+	snprintk(tag, sizeof(tag), "region_heap.%s.failures", name);
+	bench_report(tag, "Failed allocations", res->failures, "allocs");
+}
+
+int main(void)
+{
+	struct result res;
+	int rc;
+
+	timing_init();
+	timing_start();
+
+	linear_init();
+	run(linear_alloc, linear_free, &res);
+	report_result("linear", &res);
+
+	rc = sys_region_heap_init(&rheap, regions, ARRAY_SIZE(regions));
+	if (rc != 0) {
+		TC_PRINT("Region heap initialization failed: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	run(region_alloc, region_free, &res);
+	report_result("region", &res);
+
+	timing_stop();
+
+	TC_END_REPORT(TC_PASS);
+
+	return 0;
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the throughput of decoding a buffer
+ * holding a hardware FIFO of accelerometer samples into one array per axis,
+ * one sample at a time and in bulk.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_ITERATIONS   CONFIG_BENCHMARK_NUM_ITERATIONS
+#define NUM_SAMPLES      CONFIG_BENCHMARK_FIFO_SAMPLES
+#define SAMPLE_PERIOD_NS 625000
+#define FIFO_SHIFT       4
+
+/* Raw FIFO contents, as read from an accelerometer with 16 bit samples */
+struct fifo_buffer {
+	uint64_t timestamp_ns;
+	uint16_t count;
+	int8_t shift;
+	int16_t samples[NUM_SAMPLES][3];
+};
+
+static struct fifo_buffer fifo;
+
+static q31_t q31_out[3][NUM_SAMPLES];
+static q31_t bulk_q31_out[3][NUM_SAMPLES];
+static float float_out[3][NUM_SAMPLES];
+static float bulk_float_out[3][NUM_SAMPLES];
+
+static int fifo_get_frame_count(const uint8_t *buffer, struct sensor_chan_spec chan_spec,
+				uint16_t *frame_count)
+{
+	const struct fifo_buffer *buf = (const struct fifo_buffer *)buffer;
+
+	if (chan_spec.chan_type != SENSOR_CHAN_ACCEL_XYZ || chan_spec.chan_idx != 0) {
+		return -ENOTSUP;
+	}
+
+	*frame_count = buf->count;
+
+	return 0;
+}
+
+static int fifo_decode(const uint8_t *buffer, struct sensor_chan_spec chan_spec, uint32_t *fit,
+		       uint16_t max_count, void *data_out)
+{
+	const struct fifo_buffer *buf = (const struct fifo_buffer *)buffer;
+	struct sensor_three_axis_data *out = data_out;
+	uint16_t count = 0;
+
+	if (chan_spec.chan_type != SENSOR_CHAN_ACCEL_XYZ || chan_spec.chan_idx != 0) {
+		return -ENOTSUP;
+	}
+
+	if (*fit >= buf->count) {
+		return 0;
+	}
+
+	out->header.base_timestamp_ns = buf->timestamp_ns + (uint64_t)*fit * SAMPLE_PERIOD_NS;
+	out->shift = buf->shift;
+
+	while (count < max_count && *fit < buf->count) {
+		out->readings[count].timestamp_delta = count == 0 ? 0 : SAMPLE_PERIOD_NS;
+		for (int axis = 0; axis < 3; axis++) {
+			out->readings[count].values[axis] = (q31_t)buf->samples[*fit][axis] << 16;
+		}
+		count++;
+		(*fit)++;
+	}
+
+	out->header.reading_count = count;
+
+	return count;
+}
+
+static const struct sensor_decoder_api fifo_decoder = {
+	.get_frame_count = fifo_get_frame_count,
+	.get_size_info = sensor_natively_supported_channel_size_info,
+	.decode = fifo_decode,
+};
+
+static const struct sensor_chan_spec accel_xyz = {SENSOR_CHAN_ACCEL_XYZ, 0};
+
+static uint64_t elapsed_ns(timing_t start, timing_t finish)
+{
+	return MAX(timing_cycles_to_ns(timing_cycles_get(&start, &finish)), 1);
+}
+
+static void report_samples(const char *tag, const char *description, uint64_t ns)
+{
+	bench_report(tag, description, (uint64_t)NUM_ITERATIONS * NUM_SAMPLES * NSEC_PER_SEC / ns,
+		     "samples/s");
+}
+
+static void fill_fifo(void)
+{
+	fifo.timestamp_ns = 0;
+	fifo.count = NUM_SAMPLES;
+	fifo.shift = FIFO_SHIFT;
+	for (int i = 0; i < NUM_SAMPLES; i++) {
+		for (int axis = 0; axis < 3; axis++) {
+			fifo.samples[i][axis] = (int16_t)(i * 1237 + axis * 9931);
+		}
+	}
+}
+
+static int decode_samples_q31(void)
+{
+	struct sensor_three_axis_data data;
+	struct sensor_decode_context ctx =
+		SENSOR_DECODE_CONTEXT_INIT(&fifo_decoder, (const uint8_t *)&fifo,
+					   SENSOR_CHAN_ACCEL_XYZ, 0);
+	int i;
+
+	for (i = 0; sensor_decode(&ctx, &data, 1) > 0; i++) {
+		q31_out[0][i] = data.readings[0].x;
+		q31_out[1][i] = data.readings[0].y;
+		q31_out[2][i] = data.readings[0].z;
+	}
+
+	return i;
+}
+
+static int decode_samples_float(void)
+{
+	struct sensor_three_axis_data data;
+	struct sensor_decode_context ctx =
+		SENSOR_DECODE_CONTEXT_INIT(&fifo_decoder, (const uint8_t *)&fifo,
+					   SENSOR_CHAN_ACCEL_XYZ, 0);
+	float scale;
+	int i;
+
+	for (i = 0; sensor_decode(&ctx, &data, 1) > 0; i++) {
+		scale = (data.shift >= 0 ? (float)BIT64(data.shift)
+					 : 1.0f / (float)BIT64(-data.shift)) / (float)BIT64(31);
+		float_out[0][i] = (float)data.readings[0].x * scale;
+		float_out[1][i] = (float)data.readings[0].y * scale;
+		float_out[2][i] = (float)data.readings[0].z * scale;
+	}
+
+	return i;
+}
+
+static int bench_decode(const char *tag, const char *description, int (*decode_fn)(void))
+{
+	timing_t start, finish;
+	int count = 0;
+
+	start = timing_counter_get();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		count = decode_fn();
+	}
+	finish = timing_counter_get();
+
+	if (count != NUM_SAMPLES) {
+		TC_PRINT("%s: decoded %d samples, expected %d\n", tag, count, NUM_SAMPLES);
+		return -1;
+	}
+
+	report_samples(tag, description, elapsed_ns(start, finish));
+
+	return 0;
+}
+
+static int bulk_decode_q31(void)
+{
+	return sensor_decode_three_axis_q31(&fifo_decoder, (const uint8_t *)&fifo, accel_xyz,
+					    FIFO_SHIFT, bulk_q31_out[0], bulk_q31_out[1],
+					    bulk_q31_out[2], NUM_SAMPLES);
+}
+
+static int bulk_decode_float(void)
+{
+	return sensor_decode_three_axis_float(&fifo_decoder, (const uint8_t *)&fifo, accel_xyz,
+					      bulk_float_out[0], bulk_float_out[1],
+					      bulk_float_out[2], NUM_SAMPLES);
+}
+
+static int check_results(void)
+{
+	for (int axis = 0; axis < 3; axis++) {
+		for (int i = 0; i < NUM_SAMPLES; i++) {
+			float diff = float_out[axis][i] - bulk_float_out[axis][i];
+
+			if (q31_out[axis][i] != bulk_q31_out[axis][i]) {
+				TC_PRINT("q31 mismatch on axis %d sample %d\n", axis, i);
+				return -1;
+			}
+			if (diff > 1e-5f || diff < -1e-5f) {
+				TC_PRINT("float mismatch on axis %d sample %d\n", axis, i);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	int rc;
+
+	fill_fifo();
+
+	timing_init();
+	timing_start();
+
+	rc = bench_decode("sensor.decode.sample.q31", "Per sample decode to q31 arrays",
+			  decode_samples_q31);
+	if (rc == 0) {
+		rc = bench_decode("sensor.decode.bulk.q31", "Bulk decode to q31 arrays",
+				  bulk_decode_q31);
+	}
+	if (rc == 0) {
+		rc = bench_decode("sensor.decode.sample.float", "Per sample decode to float arrays",
+				  decode_samples_float);
+	}
+	if (rc == 0) {
+		rc = bench_decode("sensor.decode.bulk.float", "Bulk decode to float arrays",
+				  bulk_decode_float);
+	}
+	if (rc == 0) {
+		rc = check_results();
+	}
+
+	timing_stop();
+
+	TC_END_REPORT(rc == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains a benchmark comparing two TCP echo servers on the
+ * loopback interface: one driving all connections through a single RTIO
+ * context with socket iodevs, and one built on zsock_poll(). The client
+ * keeps one message in flight on every connection and measures the number
+ * of messages echoed per second.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_rtio.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_ITERATIONS  CONFIG_BENCHMARK_NUM_ITERATIONS
+#define NUM_CONNECTIONS CONFIG_BENCHMARK_NUM_CONNECTIONS
+#define MSG_SIZE        64
+#define RTIO_PORT       4242
+#define POLL_PORT       4243
+
+/* Cooperative, like the network threads, so neither preempts the other */
+#define SERVER_PRIORITY K_PRIO_COOP(8)
+#define SERVER_STACK_SIZE 2048
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static K_SEM_DEFINE(server_ready, 0, 1);
+static int server_rc;
+
+static uint8_t msg[MSG_SIZE];
+static uint8_t rx_msg[MSG_SIZE];
+
+enum echo_op_type {
+	ECHO_ACCEPT,
+	ECHO_RX,
+	ECHO_TX,
+};
+
+/* Passed as user data of the submissions, to tell completions apart */
+struct echo_op {
+	enum echo_op_type type;
+};
+
+struct echo_conn {
+	const struct rtio_iodev *iodev;
+	struct echo_op accept_op;
+	struct echo_op rx_op;
+};
+
+/* Memory pool buffer being echoed back */
+struct echo_tx {
+	struct echo_op op;
+	uint8_t *buf;
+	uint32_t buf_len;
+};
+
+#define ECHO_IODEV_DEFINE(i, _) SOCKET_RTIO_IODEV_DEFINE(echo_iodev_##i)
+#define ECHO_IODEV_REF(i, _)    &echo_iodev_##i
+
+SOCKET_RTIO_IODEV_DEFINE(listen_iodev);
+LISTIFY(NUM_CONNECTIONS, ECHO_IODEV_DEFINE, (;));
+
+static const struct rtio_iodev *const echo_iodevs[] = {
+	LISTIFY(NUM_CONNECTIONS, ECHO_IODEV_REF, (,))
+};
+
+static struct echo_conn echo_conns[NUM_CONNECTIONS];
+
+RTIO_DEFINE_WITH_MEMPOOL(echo_rtio, 3 * NUM_CONNECTIONS, 3 * NUM_CONNECTIONS,
+			 4 * NUM_CONNECTIONS, 128, 4);
+K_MEM_SLAB_DEFINE_STATIC(echo_tx_slab, sizeof(struct echo_tx), 4 * NUM_CONNECTIONS, 4);
+
+static uint64_t elapsed_ns(timing_t start, timing_t finish)
+{
+	return MAX(timing_cycles_to_ns(timing_cycles_get(&start, &finish)), 1);
+}
+
+static void report_ops(const char *tag, const char *description, uint64_t ops, uint64_t ns)
+{
+	bench_report(tag, description, ops * NSEC_PER_SEC / ns, "ops/s");
+}
+
+static void server_started(int rc)
+{
+	server_rc = rc;
+	k_sem_give(&server_ready);
+}
+
+static int rtio_server_open(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(RTIO_PORT),
+	};
+	struct rtio_sqe *sqe;
+	int rc;
+
+	rc = socket_rtio_open(&listen_iodev, AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (rc == 0) {
+		rc = socket_rtio_bind(&listen_iodev, (struct sockaddr *)&addr, sizeof(addr));
+	}
+	if (rc == 0) {
+		rc = socket_rtio_listen(&listen_iodev, NUM_CONNECTIONS);
+	}
+	if (rc < 0) {
+		return rc;
+	}
+
+	for (int i = 0; i < NUM_CONNECTIONS; i++) {
+		echo_conns[i] = (struct echo_conn) {
+			.iodev = echo_iodevs[i],
+			.accept_op.type = ECHO_ACCEPT,
+			.rx_op.type = ECHO_RX,
+		};
+
+		sqe = rtio_sqe_acquire(&echo_rtio);
+		socket_rtio_prep_accept(sqe, &listen_iodev, echo_conns[i].iodev,
+					&echo_conns[i].accept_op);
+	}
+
+	return rtio_submit(&echo_rtio, 0);
+}
+
+static void rtio_server_echo(struct echo_conn *conn, struct rtio_cqe *cqe)
+{
+	struct rtio_sqe *sqe;
+	struct echo_tx *tx;
+
+	if (k_mem_slab_alloc(&echo_tx_slab, (void **)&tx, K_NO_WAIT) != 0) {
+		printk("Out of echo buffers\n");
+		return;
+	}
+
+	tx->op.type = ECHO_TX;
+	(void)rtio_cqe_get_mempool_buffer(&echo_rtio, cqe, &tx->buf, &tx->buf_len);
+
+	sqe = rtio_sqe_acquire(&echo_rtio);
+	rtio_sqe_prep_write(sqe, conn->iodev, RTIO_PRIO_NORM, tx->buf, cqe->result, &tx->op);
+}
+
+static void rtio_server(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	struct echo_conn *conn;
+	struct rtio_cqe *cqe;
+	struct echo_op *op;
+	struct echo_tx *tx;
+	struct rtio_sqe *sqe;
+	int closed = 0;
+
+	server_started(rtio_server_open());
+	if (server_rc < 0) {
+		return;
+	}
+
+	while (closed < NUM_CONNECTIONS) {
+		cqe = rtio_cqe_consume_block(&echo_rtio);
+		op = cqe->userdata;
+
+		switch (op->type) {
+		case ECHO_ACCEPT:
+			/* One receive per connection, rearmed by RTIO after each completion */
+			conn = CONTAINER_OF(op, struct echo_conn, accept_op);
+			sqe = rtio_sqe_acquire(&echo_rtio);
+			rtio_sqe_prep_read_multishot(sqe, conn->iodev, RTIO_PRIO_NORM, &conn->rx_op);
+			break;
+		case ECHO_RX:
+			conn = CONTAINER_OF(op, struct echo_conn, rx_op);
+			if (cqe->result > 0) {
+				rtio_server_echo(conn, cqe);
+			} else {
+				/* Client closed, the multishot receive is over */
+				(void)socket_rtio_close(conn->iodev);
+				closed++;
+			}
+			break;
+		case ECHO_TX:
+			tx = CONTAINER_OF(op, struct echo_tx, op);
+			rtio_release_buffer(&echo_rtio, tx->buf, tx->buf_len);
+			k_mem_slab_free(&echo_tx_slab, tx);
+			break;
+		}
+
+		rtio_cqe_release(&echo_rtio, cqe);
+		(void)rtio_submit(&echo_rtio, 0);
+	}
+
+	(void)socket_rtio_close(&listen_iodev);
+}
+
+static int poll_server_open(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(POLL_PORT),
+	};
+	int sock;
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    zsock_listen(sock, NUM_CONNECTIONS) < 0) {
+		(void)zsock_close(sock);
+		return -errno;
+	}
+
+	return sock;
+}
+
+static void poll_server(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	struct zsock_pollfd fds[NUM_CONNECTIONS + 1];
+	static uint8_t buf[MSG_SIZE];
+	int closed = 0;
+	ssize_t len;
+	int sock;
+
+	sock = poll_server_open();
+	server_started(MIN(sock, 0));
+	if (sock < 0) {
+		return;
+	}
+
+	fds[0] = (struct zsock_pollfd) { .fd = sock, .events = ZSOCK_POLLIN };
+	for (int i = 1; i <= NUM_CONNECTIONS; i++) {
+		fds[i] = (struct zsock_pollfd) { .fd = -1, .events = ZSOCK_POLLIN };
+	}
+
+	while (closed < NUM_CONNECTIONS) {
+		if (zsock_poll(fds, ARRAY_SIZE(fds), -1) < 0) {
+			break;
+		}
+
+		if (fds[0].revents & ZSOCK_POLLIN) {
+			for (int i = 1; i <= NUM_CONNECTIONS; i++) {
+				if (fds[i].fd < 0) {
+					fds[i].fd = zsock_accept(sock, NULL, NULL);
+					break;
+				}
+			}
+		}
+
+		for (int i = 1; i <= NUM_CONNECTIONS; i++) {
+			if (fds[i].fd < 0 || !(fds[i].revents & (ZSOCK_POLLIN | ZSOCK_POLLHUP))) {
+				continue;
+			}
+
+			len = zsock_recv(fds[i].fd, buf, sizeof(buf), 0);
+			if (len > 0) {
+				(void)zsock_send(fds[i].fd, buf, len, 0);
+				continue;
+			}
+
+			(void)zsock_close(fds[i].fd);
+			fds[i].fd = -1;
+			closed++;
+		}
+	}
+
+	(void)zsock_close(sock);
+}
+
+static int recv_all(int sock, uint8_t *buf, size_t len)
+{
+	ssize_t rc;
+
+	while (len > 0) {
+		rc = zsock_recv(sock, buf, len, 0);
+		if (rc <= 0) {
+			return -1;
+		}
+		buf += rc;
+		len -= rc;
+	}
+
+	return 0;
+}
+
+static int bench_echo(k_thread_entry_t server, uint16_t port, const char *tag,
+		      const char *description)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(port),
+	};
+	int socks[NUM_CONNECTIONS];
+	timing_t start, finish;
+	int one = 1;
+	int rc = 0;
+
+	(void)zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	k_thread_create(&server_thread, server_stack, K_THREAD_STACK_SIZEOF(server_stack),
+			server, NULL, NULL, NULL, SERVER_PRIORITY, 0, K_NO_WAIT);
+	(void)k_sem_take(&server_ready, K_FOREVER);
+	if (server_rc < 0) {
+		TC_PRINT("Unable to start %s server (%d)\n", tag, server_rc);
+		(void)k_thread_join(&server_thread, K_FOREVER);
+		return -1;
+	}
+
+	for (int i = 0; i < NUM_CONNECTIONS; i++) {
+		socks[i] = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (socks[i] < 0 ||
+		    zsock_connect(socks[i], (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+			TC_PRINT("Unable to connect to %s server (%d)\n", tag, errno);
+			return -1;
+		}
+		(void)zsock_setsockopt(socks[i], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	}
+
+	start = timing_counter_get();
+	for (int n = 0; n < NUM_ITERATIONS && rc == 0; n++) {
+		for (int i = 0; i < NUM_CONNECTIONS; i++) {
+			(void)zsock_send(socks[i], msg, MSG_SIZE, 0);
+		}
+		for (int i = 0; i < NUM_CONNECTIONS && rc == 0; i++) {
+			rc = recv_all(socks[i], rx_msg, MSG_SIZE);
+		}
+	}
+	finish = timing_counter_get();
+
+	for (int i = 0; i < NUM_CONNECTIONS; i++) {
+		(void)zsock_close(socks[i]);
+	}
+	(void)k_thread_join(&server_thread, K_FOREVER);
+
+	if (rc < 0) {
+		TC_PRINT("Echo from %s server failed\n", tag);
+		return -1;
+	}
+
+	report_ops(tag, description, (uint64_t)NUM_ITERATIONS * NUM_CONNECTIONS,
+		   elapsed_ns(start, finish));
+
+	return 0;
+}
+
+int main(void)
+{
+	int rc;
+
+	for (int i = 0; i < MSG_SIZE; i++) {
+		msg[i] = (uint8_t)i;
+	}
+
+	timing_init();
+	timing_start();
+
+	rc = bench_echo(rtio_server, RTIO_PORT, "net.echo.rtio",
+			"Echo, RTIO socket iodevs");
+	if (rc == 0) {
+		rc = bench_echo(poll_server, POLL_PORT, "net.echo.poll",
+				"Echo, zsock_poll() server");
+	}
+
+	timing_stop();
+
+	TC_END_REPORT(rc == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the time taken to stream an image
+ * received in chunks to the flash simulator, with a single write buffer and
+ * with asynchronous writes.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/storage/stream_flash.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define IMAGE_SIZE     CONFIG_BENCHMARK_IMAGE_SIZE
+#define CHUNK_SIZE     CONFIG_BENCHMARK_CHUNK_SIZE
+#define NUM_CHUNKS     (IMAGE_SIZE / CHUNK_SIZE)
+#define BUF_LEN        512
+#define SLOT_OFFSET    FIXED_PARTITION_OFFSET(slot1_partition)
+#define SLOT_SIZE      FIXED_PARTITION_SIZE(slot1_partition)
+#define READ_BUF_SIZE  256
+
+BUILD_ASSERT(IMAGE_SIZE <= SLOT_SIZE, "Image does not fit in the slot");
+
+static const struct device *const fdev = FIXED_PARTITION_DEVICE(slot1_partition);
+
+static struct stream_flash_ctx ctx;
+static uint8_t buf[BUF_LEN];
+static uint8_t buf_async[BUF_LEN];
+static uint8_t chunk[CHUNK_SIZE];
+static uint8_t read_buf[READ_BUF_SIZE];
+
+static uint32_t seed;
+
+static uint8_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 16;
+}
+
+static void fill_chunk(void)
+{
+	for (size_t i = 0; i < sizeof(chunk); i++) {
+		chunk[i] = next_random();
+	}
+}
+
+/* Read the image back and compare it with the chunks, generated again */
+static bool image_ok(void)
+{
+	size_t offset = 0;
+
+	seed = 12345;
+
+	for (int i = 0; i < NUM_CHUNKS; i++) {
+		fill_chunk();
+
+		for (size_t j = 0; j < sizeof(chunk); j += sizeof(read_buf)) {
+			size_t len = MIN(sizeof(read_buf), sizeof(chunk) - j);
+
+			if (flash_read(fdev, SLOT_OFFSET + offset, read_buf, len) != 0 ||
+			    memcmp(read_buf, &chunk[j], len) != 0) {
+				return false;
+			}
+
+			offset += len;
+		}
+	}
+
+	return true;
+}
+
+static int run_upload(const char *name, bool async, uint32_t *errors)
+{
+	uint64_t write_cycles = 0;
+	uint64_t total_cycles;
+	timing_t begin, start, end;
+	char tag[40];
+	int rc;
+
+	rc = stream_flash_init(&ctx, fdev, buf, BUF_LEN, SLOT_OFFSET, SLOT_SIZE, NULL);
+	if (rc == 0 && async) {
+		rc = stream_flash_set_async(&ctx, buf_async, BUF_LEN);
+	}
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	seed = 12345;
+	begin = timing_counter_get();
+
+	for (int i = 0; i < NUM_CHUNKS; i++) {
+		/* Wait for the chunk to be received */
+		k_usleep(CONFIG_BENCHMARK_CHUNK_INTERVAL_US);
+		fill_chunk();
+
+		start = timing_counter_get();
+		rc = stream_flash_buffered_write(&ctx, chunk, sizeof(chunk), i == NUM_CHUNKS - 1);
+		end = timing_counter_get();
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		write_cycles += timing_cycles_get(&start, &end);
+	}
+
+	total_cycles = timing_cycles_get(&begin, &end);
+
+	snprintk(tag, sizeof(tag), "stream_flash.%s.write", name);
+	bench_report(tag, "Average write time", timing_cycles_to_ns_avg(write_cycles, NUM_CHUNKS),
+		     "ns");
+	snprintk(tag, sizeof(tag), "stream_flash.%s.upload", name);
+	bench_report(tag, "Upload time", timing_cycles_to_ns(total_cycles) / NSEC_PER_USEC, "us");
+	snprintk(tag, sizeof(tag), "stream_flash.%s.rate", name);
+	bench_report(tag, "Upload rate",
+		     total_cycles != 0 ?
+		     (uint64_t)IMAGE_SIZE * NSEC_PER_SEC / timing_cycles_to_ns(total_cycles) /
+		     1000 : 0, "kB/s");
+
+	*errors += !image_ok();
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int rc;
+
+	if (!device_is_ready(fdev)) {
+		TC_PRINT("Flash device is not ready\n");
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	rc = run_upload("sync", false, &errors);
+	if (rc == 0) {
+		rc = run_upload("async", true, &errors);
+	}
+
+	timing_stop();
+
+	if (rc < 0) {
+		TC_PRINT("Cannot stream the image: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	bench_report("stream_flash.errors", "Uploads with a corrupted image", errors, "uploads");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the aggregate throughput of mutex,
+ * semaphore and condition variable operations performed concurrently by one
+ * thread per CPU. In the "private" tests every thread works on its own
+ * object, which should scale with the number of CPUs as long as unrelated
+ * objects do not share any lock. In the "shared" tests all threads work on
+ * the same object, measuring the cost of real contention.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define NUM_THREADS    CONFIG_BENCHMARK_NUM_THREADS
+#define NUM_ITERATIONS CONFIG_BENCHMARK_NUM_ITERATIONS
+#define STACK_SIZE     (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+typedef void (*bench_fn_t)(unsigned int id);
+
+static K_THREAD_STACK_ARRAY_DEFINE(bench_stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread bench_threads[NUM_THREADS];
+
+static K_SEM_DEFINE(start_sem, 0, NUM_THREADS);
+static K_SEM_DEFINE(done_sem, 0, NUM_THREADS);
+
+static struct k_mutex mutexes[NUM_THREADS];
+static struct k_sem sems[NUM_THREADS];
+static struct k_condvar condvars[NUM_THREADS];
+
+static void mutex_private(unsigned int id)
+{
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		k_mutex_lock(&mutexes[id], K_FOREVER);
+		k_mutex_unlock(&mutexes[id]);
+	}
+}
+
+static void mutex_shared(unsigned int id)
+{
+	ARG_UNUSED(id);
+
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		k_mutex_lock(&mutexes[0], K_FOREVER);
+		k_mutex_unlock(&mutexes[0]);
+	}
+}
+
+static void sem_private(unsigned int id)
+{
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		k_sem_take(&sems[id], K_FOREVER);
+		k_sem_give(&sems[id]);
+	}
+}
+
+static void sem_shared(unsigned int id)
+{
+	ARG_UNUSED(id);
+
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		k_sem_take(&sems[0], K_FOREVER);
+		k_sem_give(&sems[0]);
+	}
+}
+
+static void condvar_private(unsigned int id)
+{
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		k_mutex_lock(&mutexes[id], K_FOREVER);
+		k_condvar_signal(&condvars[id]);
+		k_mutex_unlock(&mutexes[id]);
+	}
+}
+
+static void bench_thread(void *p1, void *p2, void *p3)
+{
+	bench_fn_t fn = p1;
+	unsigned int id = POINTER_TO_UINT(p2);
+
+	ARG_UNUSED(p3);
+
+	k_sem_take(&start_sem, K_FOREVER);
+	fn(id);
+	k_sem_give(&done_sem);
+}
+
+static void objects_init(void)
+{
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_mutex_init(&mutexes[i]);
+		k_sem_init(&sems[i], 1, 1);
+		k_condvar_init(&condvars[i]);
+	}
+}
+
+static void run_test(const char *tag, const char *description, bench_fn_t fn)
+{
+	timing_t start, finish;
+	uint64_t ns;
+	uint64_t ops = (uint64_t)NUM_THREADS * NUM_ITERATIONS;
+
+	objects_init();
+
+	/* Lower priority than main: all of them start once main blocks */
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&bench_threads[i], bench_stacks[i], STACK_SIZE, bench_thread,
+				fn, UINT_TO_POINTER(i), NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	}
+
+	start = timing_counter_get();
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_sem_give(&start_sem);
+	}
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+	finish = timing_counter_get();
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_join(&bench_threads[i], K_FOREVER);
+	}
+
+	ns = MAX(timing_cycles_to_ns(timing_cycles_get(&start, &finish)), 1);
+
+	bench_report(tag, description, ops * NSEC_PER_SEC / ns, "ops/s");
+}
+
+int main(void)
+{
+	timing_init();
+
+	printk("Synchronization object throughput: %d threads, %d CPUs\n",
+	       NUM_THREADS, arch_num_cpus());
+
+	timing_start();
+
+	run_test("sync.mutex.lock.unlock.private", "Per-thread mutex lock/unlock",
+		 mutex_private);
+	run_test("sync.mutex.lock.unlock.shared", "Shared mutex lock/unlock",
+		 mutex_shared);
+	run_test("sync.sem.take.give.private", "Per-thread semaphore take/give",
+		 sem_private);
+	run_test("sync.sem.take.give.shared", "Shared semaphore take/give",
+		 sem_shared);
+	run_test("sync.condvar.signal.private", "Per-thread condvar signal",
+		 condvar_private);
+
+	timing_stop();
+
+	TC_END_REPORT(0);
+
+	return 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * This file contains tests that measure the distribution of the time taken
+ * by ZMS writes, including the ones that trigger a garbage collection, to
+ * compare the worst case latency with and without incremental garbage
+ * collection.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/zms.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/tc_util.h>
+
+#include "bench_report.h"
+
+#define SECTOR_COUNT CONFIG_BENCHMARK_SECTOR_COUNT
+#define NUM_IDS      CONFIG_BENCHMARK_NUM_IDS
+#define NUM_WRITES   CONFIG_BENCHMARK_NUM_WRITES
+#define SECTOR_SIZE  4096
+#define SLOT_OFFSET  FIXED_PARTITION_OFFSET(slot1_partition)
+#define SLOT_SIZE    FIXED_PARTITION_SIZE(slot1_partition)
+
+BUILD_ASSERT(SECTOR_COUNT * SECTOR_SIZE <= SLOT_SIZE, "File system does not fit in the slot");
+
+#if defined(CONFIG_BENCHMARK_GC_WORK)
+#define MODE "incremental_work"
+#elif defined(CONFIG_ZMS_GC_INCREMENTAL)
+#define MODE "incremental"
+#else
+#define MODE "default"
+#endif
+
+struct record {
+	uint32_t id;
+	uint32_t version;
+	uint8_t payload[24];
+};
+
+static struct zms_fs fs = {
+	.flash_device = FIXED_PARTITION_DEVICE(slot1_partition),
+	.offset = SLOT_OFFSET,
+	.sector_size = SECTOR_SIZE,
+	.sector_count = SECTOR_COUNT,
+};
+
+static uint32_t versions[NUM_IDS];
+static uint32_t latencies[NUM_WRITES];
+
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+#ifdef CONFIG_BENCHMARK_GC_WORK
+static void gc_work_handler(struct k_work *work)
+{
+	/* One step per run, so that the work queue is not held for long */
+	if (zms_gc_step(&fs) > 0) {
+		(void)k_work_submit(work);
+	}
+}
+
+static K_WORK_DEFINE(gc_work, gc_work_handler);
+#endif
+
+static int write_record(uint32_t id)
+{
+	struct record record = {
+		.id = id,
+		.version = ++versions[id],
+	};
+	ssize_t rc;
+
+	memset(record.payload, id, sizeof(record.payload));
+
+	rc = zms_write(&fs, id, &record, sizeof(record));
+
+	return rc < 0 ? rc : 0;
+}
+
+/* Check that every ID reads back its last version */
+static bool content_ok(void)
+{
+	struct record record;
+
+	for (uint32_t i = 0; i < NUM_IDS; i++) {
+		if (zms_read(&fs, i, &record, sizeof(record)) != sizeof(record) ||
+		    record.id != i || record.version != versions[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+	uint32_t la = *(const uint32_t *)a;
+	uint32_t lb = *(const uint32_t *)b;
+
+	return (la > lb) - (la < lb);
+}
+
+static int run_writes(void)
+{
+	uint64_t total = 0;
+	timing_t start, end;
+	int rc;
+
+	/* Write every ID once, so that the garbage collection has entries to move */
+	for (uint32_t i = 0; i < NUM_IDS; i++) {
+		rc = write_record(i);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	for (int i = 0; i < NUM_WRITES; i++) {
+		uint32_t id = next_random() % NUM_IDS;
+
+		start = timing_counter_get();
+		rc = write_record(id);
+		end = timing_counter_get();
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		latencies[i] = (uint32_t)timing_cycles_to_ns(timing_cycles_get(&start, &end));
+		total += latencies[i];
+
+#ifdef CONFIG_BENCHMARK_GC_WORK
+		if (zms_gc_pressure(&fs) > 0) {
+			(void)k_work_submit(&gc_work);
+		}
+#endif
+		/* Wait for the next value to store */
+		k_usleep(CONFIG_BENCHMARK_WRITE_INTERVAL_US);
+	}
+
+	qsort(latencies, NUM_WRITES, sizeof(latencies[0]), compare_latency);
+
+	bench_report("zms.gc." MODE ".write", "Average write time", total / NUM_WRITES, "ns");
+	bench_report("zms.gc." MODE ".write.p50", "Median write time", latencies[NUM_WRITES / 2],
+		     "ns");
+	bench_report("zms.gc." MODE ".write.p99", "99th percentile write time",
+		     latencies[NUM_WRITES * 99 / 100], "ns");
+	bench_report("zms.gc." MODE ".write.max", "Worst case write time",
+		     latencies[NUM_WRITES - 1], "ns");
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	int rc;
+
+	if (!device_is_ready(fs.flash_device)) {
+		TC_PRINT("Flash device is not ready\n");
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	/* zms_clear() needs a mounted file system */
+	rc = zms_mount(&fs);
+	if (rc == 0) {
+		rc = zms_clear(&fs);
+	}
+	if (rc == 0) {
+		rc = zms_mount(&fs);
+	}
+
+	if (rc < 0) {
+		TC_PRINT("Cannot mount the file system: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	timing_init();
+	timing_start();
+
+	rc = run_writes();
+
+	timing_stop();
+
+	if (rc < 0) {
+		TC_PRINT("Cannot write to the file system: %d\n", rc);
+		TC_END_REPORT(TC_FAIL);
+		return 0;
+	}
+
+	errors += !content_ok();
+
+	/* The content must survive a remount, which completes a pending gc */
+	rc = zms_mount(&fs);
+	errors += (rc < 0 || !content_ok());
+
+	bench_report("zms.gc." MODE ".errors", "Checks of a corrupted content", errors, "checks");
+
+	TC_END_REPORT(errors == 0 ? TC_PASS : TC_FAIL);
+
+	return 0;
+}
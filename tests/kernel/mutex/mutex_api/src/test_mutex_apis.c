@@ -469,6 +469,55 @@ ZTEST(mutex_api_1cpu, test_mutex_timeout_race_during_priority_inversion)
 	k_mutex_unlock(&tmutex);
 }
 
+#define STRESS_ITERATIONS 2000
+
+static unsigned int stress_counter;
+
+static void tThread_mutex_stress(void *p1, void *p2, void *p3)
+{
+	struct k_mutex *mutex = p1;
+	unsigned int val;
+
+	for (int i = 0; i < STRESS_ITERATIONS; i++) {
+		k_mutex_lock(mutex, K_FOREVER);
+		val = stress_counter;
+		if ((i % 64) == 0) {
+			/* Make other threads wait, exercising the slow paths */
+			k_yield();
+		}
+		stress_counter = val + 1;
+		k_mutex_unlock(mutex);
+	}
+}
+
+/**
+ * @brief Test mutual exclusion with several threads hammering a mutex
+ * @details Threads on all available CPUs increment a shared counter under
+ * the mutex, sometimes yielding with it held so that the contended and the
+ * uncontended lock and unlock paths interleave. No increment may be lost.
+ * @ingroup kernel_mutex_tests
+ */
+ZTEST(mutex_api, test_mutex_stress)
+{
+	k_mutex_init(&tmutex);
+	stress_counter = 0;
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, tThread_mutex_stress,
+			&tmutex, NULL, NULL, THREAD_LOW_PRIORITY, 0, K_NO_WAIT);
+	k_thread_create(&tdata2, tstack2, STACK_SIZE, tThread_mutex_stress,
+			&tmutex, NULL, NULL, THREAD_LOW_PRIORITY, 0, K_NO_WAIT);
+	k_thread_create(&tdata3, tstack3, STACK_SIZE, tThread_mutex_stress,
+			&tmutex, NULL, NULL, THREAD_LOW_PRIORITY, 0, K_NO_WAIT);
+
+	k_thread_join(&tdata, K_FOREVER);
+	k_thread_join(&tdata2, K_FOREVER);
+	k_thread_join(&tdata3, K_FOREVER);
+
+	zassert_equal(stress_counter, 3 * STRESS_ITERATIONS, "lost %u increments",
+		      3 * STRESS_ITERATIONS - stress_counter);
+	zassert_is_null(tmutex.owner, "mutex still owned");
+}
+
 static void *mutex_api_tests_setup(void)
 {
 #ifdef CONFIG_USERSPACE
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Tests for the Pipe claim / commit API
+ * @ingroup kernel_pipe_tests
+ * @{
+ */
+
+#include <zephyr/ztest.h>
+
+#define CLAIM_PIPE_SIZE 16
+#define CLAIM_STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+static unsigned char __aligned(4) claim_pipe_buf[CLAIM_PIPE_SIZE];
+static struct k_pipe claim_pipe;
+static struct k_pipe claim_bufferless_pipe;
+
+static K_THREAD_STACK_DEFINE(claim_stack, CLAIM_STACK_SIZE);
+static struct k_thread claim_thread;
+static K_SEM_DEFINE(claim_done, 0, 1);
+static int claim_result;
+static size_t claim_size;
+static unsigned char claim_buf[CLAIM_PIPE_SIZE];
+
+static void put_bytes(unsigned char first, size_t count)
+{
+	void *data;
+	size_t size = count;
+
+	zassert_ok(k_pipe_put_claim(&claim_pipe, &data, &size, K_NO_WAIT));
+	zassert_equal(size, count, "Claimed %zu bytes, not %zu", size, count);
+	for (size_t i = 0; i < size; i++) {
+		((unsigned char *)data)[i] = first + i;
+	}
+	zassert_ok(k_pipe_put_commit(&claim_pipe, size));
+}
+
+static void claim_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Start every test with the read and write indexes at 0 */
+	k_pipe_init(&claim_pipe, claim_pipe_buf, sizeof(claim_pipe_buf));
+	k_pipe_init(&claim_bufferless_pipe, NULL, 0);
+}
+
+/**
+ * @brief Data written in place is read back in place and with k_pipe_get()
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_put_get)
+{
+	unsigned char *data;
+	size_t bytes_read;
+	size_t size;
+
+	put_bytes(0, 10);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 10);
+
+	size = CLAIM_PIPE_SIZE;
+	zassert_ok(k_pipe_get_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_equal(size, 10);
+	for (int i = 0; i < size; i++) {
+		zassert_equal(data[i], i);
+	}
+	zassert_ok(k_pipe_get_commit(&claim_pipe, 4));
+
+	zassert_ok(k_pipe_get(&claim_pipe, claim_buf, 6, &bytes_read, 6, K_NO_WAIT));
+	for (int i = 0; i < 6; i++) {
+		zassert_equal(claim_buf[i], 4 + i);
+	}
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0);
+}
+
+/**
+ * @brief Claimed regions stop at the end of the buffer
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_wrap)
+{
+	unsigned char *data;
+	size_t size;
+
+	put_bytes(0, 10);
+	size = 10;
+	zassert_ok(k_pipe_get_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_ok(k_pipe_get_commit(&claim_pipe, size));
+
+	/* Only the 6 bytes up to the end of the buffer are contiguous */
+	size = CLAIM_PIPE_SIZE;
+	zassert_ok(k_pipe_put_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_equal(size, CLAIM_PIPE_SIZE - 10);
+	zassert_ok(k_pipe_put_commit(&claim_pipe, size));
+	put_bytes(6, 10);
+	zassert_equal(k_pipe_write_avail(&claim_pipe), 0);
+
+	size = CLAIM_PIPE_SIZE;
+	zassert_ok(k_pipe_get_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_equal(size, CLAIM_PIPE_SIZE - 10);
+	zassert_ok(k_pipe_get_commit(&claim_pipe, size));
+
+	size = CLAIM_PIPE_SIZE;
+	zassert_ok(k_pipe_get_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_equal(size, 10);
+	zassert_equal(data[0], 6);
+	zassert_ok(k_pipe_get_commit(&claim_pipe, size));
+}
+
+/**
+ * @brief Invalid claims and commits are rejected
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_fail)
+{
+	void *data;
+	void *other;
+	size_t size = 4;
+
+	zassert_equal(k_pipe_put_claim(&claim_bufferless_pipe, &data, &size, K_NO_WAIT),
+		      -EINVAL);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, 0), -EINVAL);
+	zassert_equal(k_pipe_get_commit(&claim_pipe, 0), -EINVAL);
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, &size, K_NO_WAIT), -EIO);
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, &size, K_MSEC(10)), -EAGAIN);
+
+	zassert_ok(k_pipe_put_claim(&claim_pipe, &data, &size, K_NO_WAIT));
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &other, &size, K_NO_WAIT), -EBUSY);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, CLAIM_PIPE_SIZE + 1), -EINVAL);
+	zassert_ok(k_pipe_put_commit(&claim_pipe, 0));
+}
+
+static void claim_reader(void *p1, void *p2, void *p3)
+{
+	void *data;
+
+	claim_size = CLAIM_PIPE_SIZE;
+	claim_result = k_pipe_get_claim(&claim_pipe, &data, &claim_size, K_FOREVER);
+	if (claim_result == 0) {
+		claim_result = k_pipe_get_commit(&claim_pipe, claim_size);
+	}
+	k_sem_give(&claim_done);
+}
+
+static void pipe_reader(void *p1, void *p2, void *p3)
+{
+	size_t bytes_read;
+
+	claim_result = k_pipe_get(&claim_pipe, claim_buf, 8, &bytes_read, 8, K_FOREVER);
+	claim_size = bytes_read;
+	k_sem_give(&claim_done);
+}
+
+/**
+ * @brief Committing data wakes up readers waiting for a claim or in k_pipe_get()
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_wakeup)
+{
+	k_thread_create(&claim_thread, claim_stack, CLAIM_STACK_SIZE, claim_reader,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+	zassert_equal(k_sem_take(&claim_done, K_NO_WAIT), -EBUSY, "Reader didn't wait");
+
+	put_bytes(0, 5);
+	zassert_ok(k_sem_take(&claim_done, K_MSEC(100)));
+	zassert_ok(claim_result);
+	zassert_equal(claim_size, 5);
+	k_thread_join(&claim_thread, K_FOREVER);
+
+	k_thread_create(&claim_thread, claim_stack, CLAIM_STACK_SIZE, pipe_reader,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+
+	put_bytes(0, 8);
+	zassert_ok(k_sem_take(&claim_done, K_MSEC(100)));
+	zassert_ok(claim_result);
+	zassert_equal(claim_size, 8);
+	zassert_equal(claim_buf[7], 7);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0);
+	k_thread_join(&claim_thread, K_FOREVER);
+}
+
+/**
+ * @brief Committing space wakes up writers waiting for a claim
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_writer_wakeup)
+{
+	void *data;
+	size_t size = CLAIM_PIPE_SIZE;
+
+	put_bytes(0, CLAIM_PIPE_SIZE);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, &size, K_NO_WAIT), -EIO);
+
+	k_thread_create(&claim_thread, claim_stack, CLAIM_STACK_SIZE, claim_reader,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_MSEC(10));
+
+	/* Woken up once the reader consumed the whole buffer */
+	zassert_ok(k_pipe_put_claim(&claim_pipe, &data, &size, K_MSEC(100)));
+	zassert_equal(size, CLAIM_PIPE_SIZE);
+	zassert_ok(k_pipe_put_commit(&claim_pipe, 0));
+
+	zassert_ok(k_sem_take(&claim_done, K_MSEC(100)));
+	zassert_ok(claim_result);
+	k_thread_join(&claim_thread, K_FOREVER);
+}
+
+/**
+ * @brief Flushing the pipe leaves the claimed regions alone
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_flush)
+{
+	unsigned char *data;
+	size_t bytes_read;
+	size_t size;
+
+	put_bytes(0, 10);
+	size = CLAIM_PIPE_SIZE;
+	zassert_ok(k_pipe_get_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_equal(size, 10);
+
+	k_pipe_buffer_flush(&claim_pipe);
+	k_pipe_flush(&claim_pipe);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 10);
+	for (int i = 0; i < size; i++) {
+		zassert_equal(data[i], i);
+	}
+	zassert_ok(k_pipe_get_commit(&claim_pipe, size));
+
+	put_bytes(10, 4);
+	size = CLAIM_PIPE_SIZE;
+	zassert_ok(k_pipe_put_claim(&claim_pipe, (void **)&data, &size, K_NO_WAIT));
+	zassert_equal(size, 2);
+	data[0] = 0xaa;
+	data[1] = 0xbb;
+
+	/* Discards the 4 committed bytes, not the claimed space */
+	k_pipe_buffer_flush(&claim_pipe);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0);
+	zassert_ok(k_pipe_put_commit(&claim_pipe, size));
+
+	zassert_ok(k_pipe_get(&claim_pipe, claim_buf, 2, &bytes_read, 2, K_NO_WAIT));
+	zassert_equal(claim_buf[0], 0xaa);
+	zassert_equal(claim_buf[1], 0xbb);
+}
+
+/**
+ * @brief Committing data signals pollers
+ */
+ZTEST(pipe_api_claim, test_pipe_claim_poll)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_PIPE_DATA_AVAILABLE,
+							     K_POLL_MODE_NOTIFY_ONLY,
+							     &claim_pipe);
+
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), -EAGAIN);
+
+	put_bytes(0, 1);
+	zassert_ok(k_poll(&event, 1, K_NO_WAIT));
+	zassert_equal(event.state, K_POLL_STATE_PIPE_DATA_AVAILABLE);
+}
+
+ZTEST_SUITE(pipe_api_claim, NULL, NULL, claim_before, NULL, NULL);
+
+/**
+ * @}
+ */
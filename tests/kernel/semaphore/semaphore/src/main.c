@@ -501,6 +501,36 @@ ZTEST_USER(semaphore, test_sem_take_timeout_fails)
 	}
 }
 
+/**
+ * @brief Test giving a semaphore after a take timed out
+ * @details
+ * - Take an unavailable semaphore and let the wait time out.
+ * - Check the count is zero, then give the semaphore up to and past its limit.
+ * - Check the count only goes up to the limit and all units can be taken.
+ * @ingroup kernel_semaphore_tests
+ * @see k_sem_take(), k_sem_give()
+ */
+ZTEST_USER(semaphore, test_sem_give_after_take_timeout)
+{
+	k_sem_reset(&simple_sem);
+
+	expect_k_sem_take_nomsg(&simple_sem, SEM_TIMEOUT, -EAGAIN);
+	expect_k_sem_count_get_nomsg(&simple_sem, 0);
+
+	k_sem_give(&simple_sem);
+	expect_k_sem_count_get_nomsg(&simple_sem, 1);
+
+	for (int i = 0; i < SEM_MAX_VAL; i++) {
+		k_sem_give(&simple_sem);
+	}
+	expect_k_sem_count_get_nomsg(&simple_sem, SEM_MAX_VAL);
+
+	for (int i = 0; i < SEM_MAX_VAL; i++) {
+		expect_k_sem_take_nomsg(&simple_sem, K_NO_WAIT, 0);
+	}
+	expect_k_sem_take_nomsg(&simple_sem, K_NO_WAIT, -EBUSY);
+}
+
 /**
  * @brief Test the semaphore take operation with specified timeout
  * @details
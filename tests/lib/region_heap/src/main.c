@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/region_heap.h>
+
+#define ATTR_FAST BIT(0)
+#define ATTR_DMA  BIT(1)
+
+enum {
+	REGION_TCM,
+	REGION_SRAM,
+	REGION_PSRAM,
+};
+
+#define TCM_MAX_ALLOC  256
+#define TCM_SLAB_BLOCK 32
+#define TCM_SLAB_NUM   8
+
+static uint8_t tcm_mem[1024] __aligned(8);
+static uint8_t sram_mem[4096] __aligned(8);
+static uint8_t psram_mem[8192] __aligned(8);
+
+static const struct sys_region_heap_config regions[] = {
+	[REGION_TCM] = {
+		.addr = (uintptr_t)tcm_mem,
+		.size = sizeof(tcm_mem),
+		.attr = ATTR_FAST,
+		.max_alloc = TCM_MAX_ALLOC,
+		.slab_block_size = TCM_SLAB_BLOCK,
+		.slab_num_blocks = TCM_SLAB_NUM,
+		.fallback = REGION_SRAM,
+	},
+	[REGION_SRAM] = {
+		.addr = (uintptr_t)sram_mem,
+		.size = sizeof(sram_mem),
+		.attr = ATTR_FAST | ATTR_DMA,
+		.fallback = REGION_PSRAM,
+	},
+	[REGION_PSRAM] = {
+		.addr = (uintptr_t)psram_mem,
+		.size = sizeof(psram_mem),
+		.attr = ATTR_DMA,
+		.fallback = SYS_REGION_HEAP_NONE,
+	},
+};
+
+static struct sys_region_heap rheap;
+
+static int alloc_region(uint32_t attr, size_t bytes)
+{
+	void *block = sys_region_heap_alloc(&rheap, attr, bytes);
+
+	zassert_not_null(block, "allocation of %zu bytes failed", bytes);
+
+	return sys_region_heap_region_get(&rheap, block);
+}
+
+ZTEST(region_heap, test_placement)
+{
+	zassert_equal(alloc_region(ATTR_FAST, 64), REGION_TCM);
+	zassert_equal(alloc_region(0, 64), REGION_TCM);
+	zassert_equal(alloc_region(ATTR_DMA, 64), REGION_SRAM);
+	zassert_equal(alloc_region(ATTR_FAST | ATTR_DMA, 64), REGION_SRAM);
+
+	/* Larger than the largest TCM allocation */
+	zassert_equal(alloc_region(ATTR_FAST, TCM_MAX_ALLOC + 1), REGION_SRAM);
+	zassert_equal(alloc_region(ATTR_DMA, 3000), REGION_SRAM);
+
+	/* No region provides the attribute */
+	zassert_is_null(sys_region_heap_alloc(&rheap, BIT(2), 64));
+	zassert_is_null(sys_region_heap_alloc(&rheap, SYS_REGION_HEAP_ATTR_MASKS, 64));
+	zassert_is_null(sys_region_heap_alloc(&rheap, ATTR_FAST, 0));
+}
+
+ZTEST(region_heap, test_slab)
+{
+	struct sys_region_heap_stats stats;
+	void *blocks[TCM_SLAB_NUM + 1];
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		blocks[i] = sys_region_heap_alloc(&rheap, ATTR_FAST, TCM_SLAB_BLOCK);
+		zassert_not_null(blocks[i]);
+		zassert_equal(sys_region_heap_region_get(&rheap, blocks[i]), REGION_TCM);
+	}
+
+	/* The last allocation does not fit in the slab cache */
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_TCM, &stats));
+	zassert_equal(stats.slab_blocks, TCM_SLAB_NUM);
+	zassert_equal(stats.slab_used, TCM_SLAB_NUM);
+	zassert_true(stats.heap_allocated >= TCM_SLAB_BLOCK);
+	zassert_equal(stats.allocs, TCM_SLAB_NUM + 1);
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		sys_region_heap_free(&rheap, blocks[i]);
+	}
+
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_TCM, &stats));
+	zassert_equal(stats.slab_used, 0);
+	zassert_equal(stats.heap_allocated, 0);
+}
+
+ZTEST(region_heap, test_aligned)
+{
+	void *block = sys_region_heap_aligned_alloc(&rheap, ATTR_FAST, 64, 16);
+	struct sys_region_heap_stats stats;
+
+	zassert_not_null(block);
+	zassert_equal((uintptr_t)block % 64, 0);
+	zassert_equal(sys_region_heap_region_get(&rheap, block), REGION_TCM);
+
+	/* The slab cache does not provide the alignment */
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_TCM, &stats));
+	zassert_equal(stats.slab_used, 0);
+
+	sys_region_heap_free(&rheap, block);
+}
+
+ZTEST(region_heap, test_fallback)
+{
+	struct sys_region_heap_stats stats;
+	int region;
+
+	/* Exhaust the TCM heap, the allocations then go to SRAM */
+	do {
+		region = alloc_region(ATTR_FAST, 200);
+		zassert_true(region == REGION_TCM || region == REGION_SRAM);
+	} while (region == REGION_TCM);
+
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_TCM, &stats));
+	zassert_equal(stats.fallbacks, 1);
+	zassert_equal(stats.failures, 0);
+
+	/* Exhaust SRAM, the DMA allocations then go to PSRAM, never to TCM */
+	do {
+		region = alloc_region(ATTR_DMA, 1024);
+		zassert_true(region == REGION_SRAM || region == REGION_PSRAM);
+	} while (region == REGION_SRAM);
+
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_SRAM, &stats));
+	zassert_equal(stats.fallbacks, 1);
+
+	/* FAST allocations have nowhere left to go */
+	zassert_is_null(sys_region_heap_alloc(&rheap, ATTR_FAST, 1024));
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_SRAM, &stats));
+	zassert_equal(stats.failures, 1);
+}
+
+ZTEST(region_heap, test_free)
+{
+	struct sys_region_heap_stats stats;
+	void *block;
+
+	block = sys_region_heap_alloc(&rheap, ATTR_DMA, 2048);
+	zassert_not_null(block);
+
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_SRAM, &stats));
+	zassert_true(stats.heap_allocated >= 2048);
+
+	sys_region_heap_free(&rheap, block);
+	sys_region_heap_free(&rheap, NULL);
+
+	zassert_ok(sys_region_heap_stats_get(&rheap, REGION_SRAM, &stats));
+	zassert_equal(stats.heap_allocated, 0);
+	zassert_equal(stats.allocs, 1);
+}
+
+ZTEST(region_heap, test_multi_heap)
+{
+	void *block = sys_multi_heap_alloc(&rheap.mheap, (void *)ATTR_DMA, 64);
+
+	zassert_not_null(block);
+	zassert_equal(sys_region_heap_region_get(&rheap, block), REGION_SRAM);
+
+	sys_region_heap_free(&rheap, block);
+}
+
+ZTEST(region_heap, test_region_get)
+{
+	int local;
+
+	zassert_equal(sys_region_heap_region_get(&rheap, &local), -ENOENT);
+	zassert_equal(sys_region_heap_stats_get(&rheap, ARRAY_SIZE(regions), NULL), -EINVAL);
+	zassert_equal(sys_region_heap_stats_get(&rheap, -1, NULL), -EINVAL);
+}
+
+ZTEST(region_heap, test_invalid_config)
+{
+	static struct sys_region_heap bad;
+	struct sys_region_heap_config cfg[2] = {regions[REGION_SRAM], regions[REGION_PSRAM]};
+
+	zassert_equal(sys_region_heap_init(&bad, cfg, 0), -EINVAL);
+
+	/* Fallback to a region that does not exist */
+	zassert_equal(sys_region_heap_init(&bad, cfg, ARRAY_SIZE(cfg)), -EINVAL);
+
+	cfg[0].fallback = 1;
+	cfg[1].attr = SYS_REGION_HEAP_ATTR_MASKS;
+	zassert_equal(sys_region_heap_init(&bad, cfg, ARRAY_SIZE(cfg)), -EINVAL);
+}
+
+static void region_heap_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(sys_region_heap_init(&rheap, regions, ARRAY_SIZE(regions)));
+}
+
+ZTEST_SUITE(region_heap, NULL, NULL, region_heap_before, NULL, NULL);
@@ -27,7 +27,7 @@ ZTEST(net_dns_cache_test, test_simple_cache_entry)
 
 	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
 		   "Cache entry adding should work.");
-	zassert_equal(1, dns_cache_find(&test_dns_cache, query, &info_read, 1));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, &info_read, 1));
 	zassert_equal(AF_INET, info_read.ai_family);
 }
 
@@ -36,7 +36,7 @@ ZTEST(net_dns_cache_test, test_not_cached)
 	struct dns_addrinfo info_read = {0};
 	const char *query = "example.com";
 
-	zassert_equal(0, dns_cache_find(&test_dns_cache, query, &info_read, 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, &info_read, 1));
 	zassert_equal(0, info_read.ai_family);
 }
 
@@ -51,8 +51,8 @@ ZTEST(net_dns_cache_test, test_fill_cache)
 					 TEST_DNS_CACHE_DEFAULT_TTL),
 			   "Cache entry adding should work.");
 	}
-	zassert_equal(TEST_DNS_CACHE_SIZE,
-		      dns_cache_find(&test_dns_cache, query, info_read, TEST_DNS_CACHE_SIZE));
+	zassert_equal(TEST_DNS_CACHE_SIZE, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+							  info_read, TEST_DNS_CACHE_SIZE));
 	zassert_equal(AF_INET, info_read[TEST_DNS_CACHE_SIZE - 1].ai_family);
 }
 
@@ -68,7 +68,8 @@ ZTEST(net_dns_cache_test, test_flush)
 			   "Cache entry adding should work.");
 	}
 	zassert_ok(dns_cache_flush(&test_dns_cache));
-	zassert_equal(0, dns_cache_find(&test_dns_cache, query, info_read, TEST_DNS_CACHE_SIZE));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read,
+					TEST_DNS_CACHE_SIZE));
 	zassert_equal(0, info_read[TEST_DNS_CACHE_SIZE - 1].ai_family);
 }
 
@@ -83,8 +84,8 @@ ZTEST(net_dns_cache_test, test_fill_cache_to_small)
 					 TEST_DNS_CACHE_DEFAULT_TTL),
 			   "Cache entry adding should work.");
 	}
-	zassert_equal(-ENOSR,
-		      dns_cache_find(&test_dns_cache, query, info_read, TEST_DNS_CACHE_SIZE - 1));
+	zassert_equal(-ENOSR, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read,
+					     TEST_DNS_CACHE_SIZE - 1));
 	zassert_equal(AF_INET, info_read[TEST_DNS_CACHE_SIZE - 2].ai_family);
 }
 
@@ -103,7 +104,8 @@ ZTEST(net_dns_cache_test, test_closest_expiry_removed)
 					 TEST_DNS_CACHE_DEFAULT_TTL),
 			   "Cache entry adding should work.");
 	}
-	zassert_equal(0, dns_cache_find(&test_dns_cache, closest_expiry, &info_read, 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, closest_expiry, DNS_QUERY_TYPE_A,
+					&info_read, 1));
 	zassert_equal(0, info_read.ai_family);
 }
 
@@ -121,15 +123,88 @@ ZTEST(net_dns_cache_test, test_expired_entries_removed)
 	zassert_ok(
 		dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL * 3),
 		"Cache entry adding should work.");
-	zassert_equal(3, dns_cache_find(&test_dns_cache, query, info_read, 3));
+	zassert_equal(3, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 3));
 	zassert_equal(AF_INET, info_read[0].ai_family);
 	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 + 1));
-	zassert_equal(2, dns_cache_find(&test_dns_cache, query, info_read, 3));
+	zassert_equal(2, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 3));
 	zassert_equal(AF_INET, info_read[0].ai_family);
 	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 + 1));
-	zassert_equal(1, dns_cache_find(&test_dns_cache, query, info_read, 3));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 3));
 	zassert_equal(AF_INET, info_read[0].ai_family);
 	k_sleep(K_MSEC(1));
-	zassert_equal(1, dns_cache_find(&test_dns_cache, query, info_read, 3));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 3));
 	zassert_equal(AF_INET, info_read[0].ai_family);
 }
+
+ZTEST(net_dns_cache_test, test_query_type)
+{
+	struct dns_addrinfo info_write4 = {.ai_family = AF_INET};
+	struct dns_addrinfo info_write6 = {.ai_family = AF_INET6};
+	struct dns_addrinfo info_read[2] = {0};
+	const char *query = "example.com";
+
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write4, TEST_DNS_CACHE_DEFAULT_TTL));
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write6, TEST_DNS_CACHE_DEFAULT_TTL));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 2));
+	zassert_equal(AF_INET, info_read[0].ai_family);
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA, info_read, 2));
+	zassert_equal(AF_INET6, info_read[0].ai_family);
+
+	zassert_ok(dns_cache_remove(&test_dns_cache, query));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 2));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA, info_read, 2));
+}
+
+ZTEST(net_dns_cache_test, test_negative_entry)
+{
+	struct dns_addrinfo info_write = {.ai_family = AF_INET};
+	struct dns_addrinfo info_read = {0};
+	const char *query = "example.com";
+
+	zassert_ok(dns_cache_add_negative(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA,
+					  TEST_DNS_CACHE_DEFAULT_TTL));
+	zassert_equal(-ENODATA,
+		      dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA, &info_read, 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, &info_read, 1));
+
+	/* An address replaces the negative entry */
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL));
+	zassert_ok(dns_cache_add_negative(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+					  TEST_DNS_CACHE_DEFAULT_TTL * 2));
+	zassert_equal(-ENODATA,
+		      dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, &info_read, 1));
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, &info_read, 1));
+
+	/* Negative entries expire too */
+	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 + 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA, &info_read, 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A, &info_read, 1));
+}
+
+ZTEST(net_dns_cache_test, test_many_queries)
+{
+	struct dns_addrinfo info_write = {.ai_family = AF_INET};
+	struct dns_addrinfo info_read = {0};
+	char query[16];
+
+	/* Each entry expires after the previous one, the oldest are replaced */
+	for (int i = 0; i < TEST_DNS_CACHE_SIZE * 2; i++) {
+		snprintk(query, sizeof(query), "host%d.com", i);
+		info_write.ai_addrlen = i;
+		zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write,
+					 TEST_DNS_CACHE_DEFAULT_TTL + i));
+	}
+
+	for (int i = 0; i < TEST_DNS_CACHE_SIZE * 2; i++) {
+		snprintk(query, sizeof(query), "host%d.com", i);
+		if (i < TEST_DNS_CACHE_SIZE) {
+			zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+							&info_read, 1));
+		} else {
+			zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+							&info_read, 1));
+			zassert_equal(i, info_read.ai_addrlen);
+		}
+	}
+}
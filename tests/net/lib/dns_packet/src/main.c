@@ -1242,6 +1242,50 @@ ZTEST(dns_packet, test_dns_flags_len)
 		      "DNS message length check failed (%d)", ret);
 }
 
+/* Domain: www.example.com
+ * Type: standard query (IPv6)
+ * Transaction ID: 0x1234
+ * Answer counter: 0
+ * Authority: SOA of example.com, TTL 3600, minimum TTL 300
+ */
+static uint8_t resp_nodata_ipv6[] = {
+	0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x00,
+	0x00, 0x01, 0x00, 0x00, 0x03, 0x77, 0x77, 0x77,
+	0x07, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65,
+	0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x1c, 0x00,
+	0x01, 0xc0, 0x10, 0x00, 0x06, 0x00, 0x01, 0x00,
+	0x00, 0x0e, 0x10, 0x00, 0x20, 0x02, 0x6e, 0x73,
+	0xc0, 0x10, 0x04, 0x68, 0x6f, 0x73, 0x74, 0xc0,
+	0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x1c,
+	0x20, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x12, 0x75,
+	0x00, 0x00, 0x00, 0x01, 0x2c
+};
+
+ZTEST(dns_packet, test_dns_negative_ttl)
+{
+	struct dns_msg_t dns_msg = { 0 };
+	uint32_t ttl = 0;
+	int ret;
+
+	dns_msg.msg = resp_nodata_ipv6;
+	dns_msg.msg_size = sizeof(resp_nodata_ipv6);
+
+	ret = dns_unpack_response_header(&dns_msg, 0x1234);
+	zassert_equal(ret, 0, "Response without answers but with authority failed (%d)", ret);
+
+	ret = dns_unpack_response_query(&dns_msg);
+	zassert_equal(ret, 0, "Cannot unpack the query (%d)", ret);
+
+	ret = dns_unpack_negative_ttl(&dns_msg, &ttl);
+	zassert_equal(ret, 0, "Cannot find the SOA record (%d)", ret);
+	zassert_equal(ttl, 300, "Invalid negative TTL %u", ttl);
+
+	/* Truncated SOA record */
+	dns_msg.msg_size = sizeof(resp_nodata_ipv6) - 1;
+	ret = dns_unpack_negative_ttl(&dns_msg, &ttl);
+	zassert_equal(ret, -EINVAL, "Truncated SOA record accepted (%d)", ret);
+}
+
 ZTEST_SUITE(dns_packet, NULL, NULL, NULL, NULL, NULL);
 /* TODO:
  *	1) add malformed DNS data (mostly done)
@@ -483,4 +483,76 @@ ZTEST(net_pkt_filter_test_suite, test_npf_ipv6_address_filtering)
 	net_pkt_unref(pkt_v4);
 }
 
+/*
+ * Rule order with rules on different interfaces and Ethernet types
+ */
+
+static NPF_IFACE_MATCH(match_iface_b, &dummy_iface_b);
+static NPF_ETH_TYPE_MATCH(arp_packet, NET_ETH_PTYPE_ARP);
+
+static NPF_RULE(drop_big_iface_a, NET_DROP, match_iface_a, minsize_201);
+static NPF_RULE(accept_ip_iface_b, NET_OK, match_iface_b, ip_packet);
+static NPF_RULE(drop_arp, NET_DROP, arp_packet);
+static NPF_RULE(accept_small, NET_OK, maxsize_200);
+static NPF_RULE(accept_arp_iface_b, NET_OK, arp_packet, match_iface_b);
+
+static bool recv_ok(int type, int size, struct net_if *iface)
+{
+	struct net_pkt *pkt = build_test_pkt(type, size, iface);
+	bool result = net_pkt_filter_recv_ok(pkt);
+
+	net_pkt_unref(pkt);
+	return result;
+}
+
+ZTEST(net_pkt_filter_test_suite, test_npf_rule_order)
+{
+	npf_append_recv_rule(&drop_big_iface_a);
+	npf_append_recv_rule(&accept_ip_iface_b);
+	npf_append_recv_rule(&drop_arp);
+	npf_append_recv_rule(&accept_small);
+	npf_append_recv_rule(&accept_arp_iface_b);
+	npf_append_recv_rule(&npf_default_drop);
+
+	zassert_false(recv_ok(NET_ETH_PTYPE_IP, 300, &dummy_iface_a), "");
+	zassert_true(recv_ok(NET_ETH_PTYPE_IP, 100, &dummy_iface_a), "");
+	zassert_true(recv_ok(NET_ETH_PTYPE_IP, 300, &dummy_iface_b), "");
+	zassert_false(recv_ok(NET_ETH_PTYPE_ARP, 100, &dummy_iface_a), "");
+
+	/* the ARP drop rule comes before the interface B rule */
+	zassert_false(recv_ok(NET_ETH_PTYPE_ARP, 300, &dummy_iface_b), "");
+	zassert_true(npf_remove_recv_rule(&drop_arp), "");
+	zassert_true(recv_ok(NET_ETH_PTYPE_ARP, 300, &dummy_iface_b), "");
+	zassert_false(recv_ok(NET_ETH_PTYPE_ARP, 300, &dummy_iface_a), "");
+
+	/* a rule inserted first takes precedence over the keyed ones */
+	npf_insert_recv_rule(&drop_arp);
+	zassert_false(recv_ok(NET_ETH_PTYPE_ARP, 100, &dummy_iface_b), "");
+	zassert_true(recv_ok(NET_ETH_PTYPE_IP, 100, &dummy_iface_b), "");
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+	zassert_true(recv_ok(NET_ETH_PTYPE_IP, 300, &dummy_iface_a), "");
+}
+
+/*
+ * Ethernet type rules on packets without an Ethernet header at their head
+ */
+
+ZTEST(net_pkt_filter_test_suite, test_npf_eth_type_no_header)
+{
+	struct net_pkt *pkt = build_test_pkt(NET_ETH_PTYPE_IP, 100, &dummy_iface_a);
+
+	npf_append_recv_rule(&small_ip_pkt);
+	npf_append_recv_rule(&npf_default_drop);
+
+	zassert_true(net_pkt_filter_recv_ok(pkt), "");
+
+	/* once the L2 stripped the header, no Ethernet type rule matches */
+	net_pkt_set_l2_processed(pkt, true);
+	zassert_false(net_pkt_filter_recv_ok(pkt), "");
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+	net_pkt_unref(pkt);
+}
+
 ZTEST_SUITE(net_pkt_filter_test_suite, NULL, test_npf_iface, NULL, NULL, NULL);
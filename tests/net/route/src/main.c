@@ -544,6 +544,66 @@ static void test_route_preference(void)
 	net_route_del(route_entry);
 }
 
+static void test_route_longest_prefix(void)
+{
+	struct in6_addr prefix_32 = { { { 0x20, 0x01, 0x0d, 0xb8 } } };
+	struct in6_addr prefix_48 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 1 } } };
+	struct in6_addr prefix_64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 2 } } };
+	struct in6_addr dst_64 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 2,
+				       0, 0, 0, 0, 0, 0, 0, 5 } } };
+	struct in6_addr dst_48 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 3,
+				       0, 0, 0, 0, 0, 0, 0, 5 } } };
+	struct in6_addr dst_32 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 2, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 1 } } };
+	struct in6_addr dst_none = { { { 0x20, 0x01, 0x0d, 0xb9, 0, 1, 0, 2,
+					 0, 0, 0, 0, 0, 0, 0, 5 } } };
+	struct net_route_entry *route_32, *route_48, *route_64;
+
+	/* Add the most specific route first, so that it is not found
+	 * by the insertion order.
+	 */
+	route_64 = net_route_add(my_iface, &prefix_64, 64, &peer_addr,
+				 NET_IPV6_ND_INFINITE_LIFETIME,
+				 NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_64, "Route add failed");
+
+	route_32 = net_route_add(my_iface, &prefix_32, 32, &peer_addr,
+				 NET_IPV6_ND_INFINITE_LIFETIME,
+				 NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_32, "Route add failed");
+
+	route_48 = net_route_add(my_iface, &prefix_48, 48, &peer_addr,
+				 NET_IPV6_ND_INFINITE_LIFETIME,
+				 NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_48, "Route add failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dst_64), route_64,
+			  "/64 route not found");
+	zassert_equal_ptr(net_route_lookup(NULL, &dst_64), route_64,
+			  "/64 route not found on any interface");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dst_48), route_48,
+			  "/48 route not found");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dst_32), route_32,
+			  "/32 route not found");
+	zassert_is_null(net_route_lookup(my_iface, &dst_none),
+			"Route found for unrouted address");
+	zassert_is_null(net_route_lookup(peer_iface, &dst_64),
+			"Route found on other interface");
+
+	zassert_ok(net_route_del(route_48), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dst_48), route_32,
+			  "/32 route not found after /48 removal");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dst_64), route_64,
+			  "/64 route not found after /48 removal");
+
+	zassert_ok(net_route_del(route_64), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dst_64), route_32,
+			  "/32 route not found after /64 removal");
+
+	zassert_ok(net_route_del(route_32), "Route del failed");
+	zassert_is_null(net_route_lookup(my_iface, &dst_32),
+			"Route found after removal");
+}
 
 /*test case main entry*/
 ZTEST(route_test_suite, test_route)
@@ -566,6 +626,7 @@ ZTEST(route_test_suite, test_route)
 	test_route_del_many();
 	test_route_lifetime();
 	test_route_preference();
+	test_route_longest_prefix();
 }
 
 ZTEST_SUITE(route_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_rtio.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/ztest.h>
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+#define WAIT_TIME   K_MSEC(500)
+
+SOCKET_RTIO_IODEV_DEFINE(server_iodev);
+SOCKET_RTIO_IODEV_DEFINE(client_iodev);
+SOCKET_RTIO_IODEV_DEFINE(conn_iodev);
+
+RTIO_DEFINE_WITH_MEMPOOL(test_rtio, 8, 8, 8, 64, 4);
+
+static const char test_msg[] = "socket rtio test";
+static uint8_t rx_buf[64];
+
+static struct sockaddr_in server_addr;
+static struct sockaddr_in client_addr;
+
+static void test_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr->sin_addr), 1);
+}
+
+/* Wait for the next completion, which must belong to the given submission */
+static int wait_cqe(void *userdata)
+{
+	k_timepoint_t end = sys_timepoint_calc(WAIT_TIME);
+	struct rtio_cqe *cqe;
+	int result;
+
+	while ((cqe = rtio_cqe_consume(&test_rtio)) == NULL) {
+		zassert_false(sys_timepoint_expired(end), "No completion");
+		k_sleep(K_MSEC(1));
+	}
+
+	zassert_equal_ptr(cqe->userdata, userdata, "Unexpected completion");
+	result = cqe->result;
+	rtio_cqe_release(&test_rtio, cqe);
+
+	return result;
+}
+
+static void assert_no_cqe(void)
+{
+	k_sleep(K_MSEC(50));
+	zassert_is_null(rtio_cqe_consume(&test_rtio), "Unexpected completion");
+}
+
+static void submit_read(const struct rtio_iodev *iodev, void *userdata)
+{
+	struct rtio_sqe *sqe = rtio_sqe_acquire(&test_rtio);
+
+	zassert_not_null(sqe);
+	rtio_sqe_prep_read(sqe, iodev, RTIO_PRIO_NORM, rx_buf, sizeof(rx_buf), userdata);
+	zassert_ok(rtio_submit(&test_rtio, 0));
+}
+
+static void submit_write(const struct rtio_iodev *iodev, void *userdata)
+{
+	struct rtio_sqe *sqe = rtio_sqe_acquire(&test_rtio);
+
+	zassert_not_null(sqe);
+	rtio_sqe_prep_write(sqe, iodev, RTIO_PRIO_NORM, (const uint8_t *)test_msg,
+			    sizeof(test_msg), userdata);
+	zassert_ok(rtio_submit(&test_rtio, 0));
+}
+
+static void submit_connect(const struct rtio_iodev *iodev, const struct sockaddr_in *addr,
+			   void *userdata)
+{
+	struct rtio_sqe *sqe = rtio_sqe_acquire(&test_rtio);
+
+	zassert_not_null(sqe);
+	socket_rtio_prep_connect(sqe, iodev, (const struct sockaddr *)addr, sizeof(*addr),
+				 userdata);
+	zassert_ok(rtio_submit(&test_rtio, 0));
+}
+
+static void submit_accept(const struct rtio_iodev *iodev, const struct rtio_iodev *conn,
+			  void *userdata)
+{
+	struct rtio_sqe *sqe = rtio_sqe_acquire(&test_rtio);
+
+	zassert_not_null(sqe);
+	socket_rtio_prep_accept(sqe, iodev, conn, userdata);
+	zassert_ok(rtio_submit(&test_rtio, 0));
+}
+
+static void assert_received(int result)
+{
+	zassert_equal(result, sizeof(test_msg), "Received %d bytes", result);
+	zassert_mem_equal(rx_buf, test_msg, sizeof(test_msg));
+	memset(rx_buf, 0, sizeof(rx_buf));
+}
+
+ZTEST(net_socket_rtio, test_udp_send_receive)
+{
+	int rx_token, tx_token, connect_token;
+
+	zassert_ok(socket_rtio_open(&server_iodev, AF_INET, SOCK_DGRAM, 0));
+	zassert_ok(socket_rtio_bind(&server_iodev, (struct sockaddr *)&server_addr,
+				    sizeof(server_addr)));
+	zassert_ok(socket_rtio_open(&client_iodev, AF_INET, SOCK_DGRAM, 0));
+	zassert_ok(socket_rtio_bind(&client_iodev, (struct sockaddr *)&client_addr,
+				    sizeof(client_addr)));
+
+	submit_connect(&client_iodev, &server_addr, &connect_token);
+	zassert_ok(wait_cqe(&connect_token));
+
+	/* The receive is parked until a datagram arrives */
+	submit_read(&server_iodev, &rx_token);
+	assert_no_cqe();
+
+	submit_write(&client_iodev, &tx_token);
+	zassert_equal(wait_cqe(&tx_token), sizeof(test_msg));
+	assert_received(wait_cqe(&rx_token));
+
+	/* A datagram arriving before the receive is submitted is kept */
+	submit_write(&client_iodev, &tx_token);
+	zassert_equal(wait_cqe(&tx_token), sizeof(test_msg));
+	k_sleep(K_MSEC(50));
+	submit_read(&server_iodev, &rx_token);
+	assert_received(wait_cqe(&rx_token));
+
+	zassert_ok(socket_rtio_close(&client_iodev));
+	zassert_ok(socket_rtio_close(&server_iodev));
+}
+
+ZTEST(net_socket_rtio, test_tcp_send_receive)
+{
+	int accept_token, connect_token, rx_token, tx_token;
+
+	zassert_ok(socket_rtio_open(&server_iodev, AF_INET, SOCK_STREAM, 0));
+	zassert_ok(socket_rtio_bind(&server_iodev, (struct sockaddr *)&server_addr,
+				    sizeof(server_addr)));
+	zassert_ok(socket_rtio_listen(&server_iodev, 1));
+	zassert_ok(socket_rtio_open(&client_iodev, AF_INET, SOCK_STREAM, 0));
+
+	submit_accept(&server_iodev, &conn_iodev, &accept_token);
+	submit_connect(&client_iodev, &server_addr, &connect_token);
+
+	/* Completion order of the two sides is not defined */
+	for (int i = 0; i < 2; i++) {
+		struct rtio_cqe *cqe = rtio_cqe_consume_block(&test_rtio);
+
+		zassert_true(cqe->userdata == &accept_token || cqe->userdata == &connect_token);
+		zassert_ok(cqe->result, "Connection failed: %d", cqe->result);
+		rtio_cqe_release(&test_rtio, cqe);
+	}
+
+	submit_read(&conn_iodev, &rx_token);
+	submit_write(&client_iodev, &tx_token);
+	zassert_equal(wait_cqe(&tx_token), sizeof(test_msg));
+	assert_received(wait_cqe(&rx_token));
+
+	/* The peer closing the connection completes the receive with 0 */
+	zassert_ok(socket_rtio_close(&client_iodev));
+	submit_read(&conn_iodev, &rx_token);
+	zassert_equal(wait_cqe(&rx_token), 0);
+
+	zassert_ok(socket_rtio_close(&conn_iodev));
+	zassert_ok(socket_rtio_close(&server_iodev));
+}
+
+ZTEST(net_socket_rtio, test_errors)
+{
+	struct rtio_sqe *sqe;
+	int token;
+
+	/* Submissions to an unused iodev */
+	submit_read(&server_iodev, &token);
+	zassert_equal(wait_cqe(&token), -EBADF);
+	submit_write(&server_iodev, &token);
+	zassert_equal(wait_cqe(&token), -EBADF);
+	zassert_equal(socket_rtio_close(&server_iodev), -EBADF);
+
+	zassert_ok(socket_rtio_open(&server_iodev, AF_INET, SOCK_DGRAM, 0));
+	zassert_equal(socket_rtio_open(&server_iodev, AF_INET, SOCK_DGRAM, 0), -EBUSY);
+	zassert_ok(socket_rtio_bind(&server_iodev, (struct sockaddr *)&server_addr,
+				    sizeof(server_addr)));
+
+	/* Accepting needs a listening socket */
+	submit_accept(&server_iodev, &conn_iodev, &token);
+	zassert_equal(wait_cqe(&token), -EINVAL);
+
+	sqe = rtio_sqe_acquire(&test_rtio);
+	zassert_not_null(sqe);
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->op = RTIO_OP_I2C_RECOVER;
+	sqe->iodev = &server_iodev;
+	sqe->userdata = &token;
+	zassert_ok(rtio_submit(&test_rtio, 0));
+	zassert_equal(wait_cqe(&token), -ENOTSUP);
+
+	/* Closing cancels the pending receives */
+	submit_read(&server_iodev, &token);
+	assert_no_cqe();
+	zassert_ok(socket_rtio_close(&server_iodev));
+	zassert_equal(wait_cqe(&token), -ECANCELED);
+}
+
+static void *setup(void)
+{
+	test_addr(&server_addr, SERVER_PORT);
+	test_addr(&client_addr, CLIENT_PORT);
+
+	return NULL;
+}
+
+ZTEST_SUITE(net_socket_rtio, NULL, setup, NULL, NULL, NULL);
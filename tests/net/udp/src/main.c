@@ -671,4 +671,92 @@ ZTEST(udp_fn_tests, test_udp)
 	zassert_false(test_failed, "udp tests failed");
 }
 
+/* Send a datagram that must not be delivered to any connection */
+static void send_ipv4_udp_unmatched(struct net_if *iface, struct in_addr *src,
+				    struct in_addr *dst, uint16_t src_port,
+				    uint16_t dst_port)
+{
+	returned_ud = NULL;
+
+	(void)send_ipv4_udp_msg(iface, src, dst, src_port, dst_port, NULL, true);
+
+	zassert_is_null(returned_ud, "Datagram from port %u delivered", src_port);
+}
+
+ZTEST(udp_fn_tests, test_udp_conn_update)
+{
+	static struct ud ud = {
+		.test = "conn-update",
+	};
+	struct in_addr in4addr_my = { { { 192, 0, 2, 1 } } };
+	struct in_addr in4addr_peer = { { { 192, 0, 2, 9 } } };
+	struct sockaddr_in my_addr4 = {
+		.sin_family = AF_INET,
+		.sin_port = htons(4242),
+	};
+	struct sockaddr_in peer_addr4 = {
+		.sin_family = AF_INET,
+		.sin_port = htons(1000),
+	};
+	struct net_conn_handle *handle;
+	struct net_if *iface;
+	uint16_t port;
+	int ret;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(net_if_ipv4_addr_add(iface, &in4addr_my, NET_ADDR_MANUAL, 0),
+			 "Cannot add the local address");
+
+	k_sem_init(&recv_lock, 0, UINT_MAX);
+
+	net_ipaddr_copy(&my_addr4.sin_addr, &in4addr_my);
+	net_ipaddr_copy(&peer_addr4.sin_addr, &in4addr_peer);
+
+	ret = net_udp_register(AF_INET, (struct sockaddr *)&peer_addr4,
+			       (struct sockaddr *)&my_addr4, 1000, 4242,
+			       NULL, test_ok, &ud, &handle);
+	zassert_ok(ret, "UDP register failed (%d)", ret);
+	ud.handle = handle;
+
+	/* The shard of a connection depends on its remote port, so with
+	 * several shards some of these updates move it to another one.
+	 */
+	for (port = 1000; port < 1016; port++) {
+		peer_addr4.sin_port = htons(port);
+
+		ret = net_conn_update(handle, test_ok, &ud, (struct sockaddr *)&peer_addr4,
+				      port);
+		zassert_ok(ret, "Connection update failed (%d)", ret);
+
+		zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my, port, 4242,
+					       &ud, false),
+			     "Datagram from port %u not delivered", port);
+
+		if (port > 1000) {
+			send_ipv4_udp_unmatched(iface, &in4addr_peer, &in4addr_my, port - 1,
+						4242);
+		}
+	}
+
+	/* Without a remote, the connection matches any remote endpoint */
+	ret = net_conn_update(handle, test_ok, &ud, NULL, 0);
+	zassert_ok(ret, "Connection update failed (%d)", ret);
+
+	zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my, 2000, 4242, &ud,
+				       false),
+		     "Datagram not delivered to the connection without remote");
+
+	/* And back to a single remote endpoint */
+	peer_addr4.sin_port = htons(1000);
+	ret = net_conn_update(handle, test_ok, &ud, (struct sockaddr *)&peer_addr4, 1000);
+	zassert_ok(ret, "Connection update failed (%d)", ret);
+
+	zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my, 1000, 4242, &ud,
+				       false),
+		     "Datagram from port 1000 not delivered");
+	send_ipv4_udp_unmatched(iface, &in4addr_peer, &in4addr_my, 2000, 4242);
+
+	zassert_ok(net_udp_unregister(handle), "UDP unregister failed");
+}
+
 ZTEST_SUITE(udp_fn_tests, NULL, NULL, NULL, NULL, NULL);
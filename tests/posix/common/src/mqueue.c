@@ -96,6 +96,85 @@ ZTEST(mqueue, test_mqueue)
 	zassert_false(mq_unlink(queue), "Not able to unlink Queue");
 }
 
+ZTEST(mqueue, test_mqueue_priority)
+{
+	mqd_t mqd;
+	struct mq_attr attrs = {
+		.mq_msgsize = MESSAGE_SIZE,
+		.mq_maxmsg = MESG_COUNT_PERMQ,
+	};
+	static const struct {
+		const char *data;
+		unsigned int prio;
+	} msgs[] = {
+		{"low", 1},
+		{"high first", MQ_PRIO_MAX - 1},
+		{"medium", 3},
+		{"high second", MQ_PRIO_MAX - 1},
+	};
+	/* Expected order of reception, as indexes into msgs */
+	static const int order[] = {1, 3, 2, 0};
+	unsigned int prio;
+	int32_t mode = 0777;
+	int flags = O_RDWR | O_CREAT;
+
+	mqd = mq_open(queue, flags, mode, &attrs);
+	zassert_not_equal(mqd, (mqd_t)-1, "Unable to open message queue");
+
+	zassert_not_ok(mq_send(mqd, send_data, MESSAGE_SIZE, MQ_PRIO_MAX));
+	zassert_equal(errno, EINVAL);
+
+	for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+		zassert_ok(mq_send(mqd, msgs[i].data, strlen(msgs[i].data) + 1, msgs[i].prio),
+			   "Unable to send message %d", i);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(order); i++) {
+		const char *exp = msgs[order[i]].data;
+
+		zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, &prio), strlen(exp) + 1,
+			      "Unexpected length of message %d", i);
+		zassert_equal(prio, msgs[order[i]].prio);
+		zassert_str_equal(rec_data, exp);
+	}
+
+	zassert_ok(mq_close(mqd), "Unable to close message queue descriptor.");
+	zassert_ok(mq_unlink(queue), "Unable to unlink queue");
+}
+
+ZTEST(mqueue, test_mqueue_unlink_open)
+{
+	mqd_t mqd, new_mqd;
+	struct mq_attr attrs = {
+		.mq_msgsize = MESSAGE_SIZE,
+		.mq_maxmsg = MESG_COUNT_PERMQ,
+	};
+	struct mq_attr stat;
+	int32_t mode = 0777;
+	int flags = O_RDWR | O_CREAT;
+
+	mqd = mq_open(queue, flags, mode, &attrs);
+	zassert_not_equal(mqd, (mqd_t)-1, "Unable to open message queue");
+	zassert_ok(mq_send(mqd, send_data, MESSAGE_SIZE, 0));
+
+	/* The name is gone, the open queue is still usable */
+	zassert_ok(mq_unlink(queue), "Unable to unlink queue");
+	zassert_equal(mq_open(queue, O_RDWR), (mqd_t)-1, "Unlinked queue was opened");
+	zassert_not_ok(mq_unlink(queue), "Queue was unlinked twice");
+
+	new_mqd = mq_open(queue, flags, mode, &attrs);
+	zassert_not_equal(new_mqd, (mqd_t)-1, "Unable to create message queue");
+	zassert_ok(mq_getattr(new_mqd, &stat));
+	zassert_equal(stat.mq_curmsgs, 0, "New queue has messages of the unlinked one");
+
+	zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, NULL), MESSAGE_SIZE);
+	zassert_str_equal(rec_data, send_data);
+
+	zassert_ok(mq_close(mqd), "Unable to close message queue descriptor.");
+	zassert_ok(mq_close(new_mqd), "Unable to close message queue descriptor.");
+	zassert_ok(mq_unlink(queue), "Unable to unlink queue");
+}
+
 static bool notification_executed;
 
 void notify_function_basic(union sigval val)
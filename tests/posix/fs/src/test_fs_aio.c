@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <zephyr/posix/aio.h>
+#include <zephyr/posix/fcntl.h>
+#include <zephyr/posix/unistd.h>
+#include "test_fs.h"
+
+#ifdef CONFIG_POSIX_ASYNCHRONOUS_IO
+
+#define TEST_AIO_FILE  FATFS_MNTP "/aio.dat"
+#define AIO_CHUNK_SIZE 512
+#define AIO_CHUNKS     32
+#define AIO_FILE_SIZE  (AIO_CHUNK_SIZE * AIO_CHUNKS)
+#define AIO_DEPTH      MIN(8, AIO_LISTIO_MAX)
+
+static uint8_t aio_data[AIO_FILE_SIZE];
+static uint8_t aio_bufs[AIO_DEPTH][AIO_CHUNK_SIZE];
+static struct aiocb aio_cbs[AIO_DEPTH];
+static int aio_fd = -1;
+
+static K_SEM_DEFINE(aio_notified, 0, AIO_DEPTH);
+
+static void aio_notify_cb(union sigval val)
+{
+	zassert_equal(val.sival_int, 42);
+	k_sem_give(&aio_notified);
+}
+
+static ssize_t aio_wait(struct aiocb *cb)
+{
+	const struct aiocb *const list[] = {cb};
+
+	while (aio_error(cb) == EINPROGRESS) {
+		zassert_ok(aio_suspend(list, 1, NULL));
+	}
+
+	return aio_return(cb);
+}
+
+static void aio_prep(struct aiocb *cb, void *buf, size_t len, off_t offset)
+{
+	*cb = (struct aiocb) {
+		.aio_fildes = aio_fd,
+		.aio_offset = offset,
+		.aio_buf = buf,
+		.aio_nbytes = len,
+		.aio_sigevent.sigev_notify = SIGEV_NONE,
+	};
+}
+
+static void before_fn(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	for (size_t i = 0; i < sizeof(aio_data); i++) {
+		aio_data[i] = (uint8_t)(i * 7 + i / AIO_CHUNK_SIZE);
+	}
+
+	aio_fd = open(TEST_AIO_FILE, O_CREAT | O_RDWR, 0660);
+	zassert_true(aio_fd >= 0, "Failed creating test file: %d", errno);
+	zassert_equal(write(aio_fd, aio_data, sizeof(aio_data)), sizeof(aio_data));
+	zassert_equal(lseek(aio_fd, 0, SEEK_SET), 0);
+}
+
+static void after_fn(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	zassert_ok(close(aio_fd));
+	aio_fd = -1;
+	zassert_ok(unlink(TEST_AIO_FILE));
+}
+
+ZTEST_SUITE(posix_fs_aio_test, NULL, test_mount, before_fn, after_fn, test_unmount);
+
+/**
+ * @brief Test aio_read() and aio_write() at explicit offsets
+ *
+ * @details The file position must not be changed by the requests.
+ */
+ZTEST(posix_fs_aio_test, test_aio_read_write)
+{
+	struct aiocb *cb = &aio_cbs[0];
+
+	memset(aio_bufs[0], 0xa5, AIO_CHUNK_SIZE);
+	aio_prep(cb, aio_bufs[0], AIO_CHUNK_SIZE, 3 * AIO_CHUNK_SIZE);
+	zassert_ok(aio_write(cb));
+	zassert_equal(aio_wait(cb), AIO_CHUNK_SIZE);
+
+	/* Status was reaped by aio_return() */
+	zassert_equal(aio_error(cb), -1);
+	zassert_equal(errno, EINVAL);
+
+	memset(aio_bufs[1], 0, AIO_CHUNK_SIZE);
+	aio_prep(cb, aio_bufs[1], AIO_CHUNK_SIZE, 3 * AIO_CHUNK_SIZE);
+	zassert_ok(aio_read(cb));
+	zassert_equal(aio_wait(cb), AIO_CHUNK_SIZE);
+	zassert_mem_equal(aio_bufs[1], aio_bufs[0], AIO_CHUNK_SIZE);
+
+	/* Reading past the end of the file returns 0 */
+	aio_prep(cb, aio_bufs[1], AIO_CHUNK_SIZE, AIO_FILE_SIZE);
+	zassert_ok(aio_read(cb));
+	zassert_equal(aio_wait(cb), 0);
+
+	zassert_equal(lseek(aio_fd, 0, SEEK_CUR), 0, "File position changed");
+}
+
+/**
+ * @brief Test lio_listio() in LIO_WAIT mode
+ */
+ZTEST(posix_fs_aio_test, test_aio_listio_wait)
+{
+	struct aiocb *list[AIO_DEPTH];
+
+	for (int i = 0; i < AIO_DEPTH; i++) {
+		aio_prep(&aio_cbs[i], aio_bufs[i], AIO_CHUNK_SIZE, (AIO_DEPTH - i) * AIO_CHUNK_SIZE);
+		aio_cbs[i].aio_lio_opcode = LIO_READ;
+		list[i] = &aio_cbs[i];
+	}
+	aio_cbs[0].aio_lio_opcode = LIO_NOP;
+
+	zassert_ok(lio_listio(LIO_WAIT, list, AIO_DEPTH, NULL));
+
+	for (int i = 1; i < AIO_DEPTH; i++) {
+		zassert_equal(aio_error(&aio_cbs[i]), 0);
+		zassert_equal(aio_return(&aio_cbs[i]), AIO_CHUNK_SIZE);
+		zassert_mem_equal(aio_bufs[i], &aio_data[(AIO_DEPTH - i) * AIO_CHUNK_SIZE],
+				  AIO_CHUNK_SIZE);
+	}
+}
+
+/**
+ * @brief Test the status of lio_listio() requests which failed to queue
+ */
+ZTEST(posix_fs_aio_test, test_aio_listio_error)
+{
+	struct aiocb *list[3];
+
+	for (int i = 0; i < ARRAY_SIZE(list); i++) {
+		aio_prep(&aio_cbs[i], aio_bufs[i], AIO_CHUNK_SIZE, i * AIO_CHUNK_SIZE);
+		aio_cbs[i].aio_lio_opcode = LIO_READ;
+		list[i] = &aio_cbs[i];
+	}
+	aio_cbs[1].aio_reqprio = -1;
+	aio_cbs[2].aio_lio_opcode = -1;
+
+	zassert_equal(lio_listio(LIO_WAIT, list, ARRAY_SIZE(list), NULL), -1);
+	zassert_equal(errno, EIO);
+
+	zassert_equal(aio_error(&aio_cbs[0]), 0);
+	zassert_equal(aio_return(&aio_cbs[0]), AIO_CHUNK_SIZE);
+
+	for (int i = 1; i < ARRAY_SIZE(list); i++) {
+		zassert_equal(aio_error(&aio_cbs[i]), EINVAL, "Request %d", i);
+		zassert_equal(aio_return(&aio_cbs[i]), -1, "Request %d", i);
+		zassert_equal(errno, EINVAL);
+	}
+}
+
+/**
+ * @brief Test aio_fsync() and SIGEV_THREAD notification
+ */
+ZTEST(posix_fs_aio_test, test_aio_fsync_notify)
+{
+	struct aiocb *cb = &aio_cbs[0];
+
+	aio_prep(cb, NULL, 0, 0);
+	cb->aio_sigevent = (struct sigevent) {
+		.sigev_notify = SIGEV_THREAD,
+		.sigev_notify_function = aio_notify_cb,
+		.sigev_value.sival_int = 42,
+	};
+
+	k_sem_reset(&aio_notified);
+	zassert_ok(aio_fsync(aio_fd, cb));
+	zassert_ok(k_sem_take(&aio_notified, K_SECONDS(1)));
+	zassert_equal(aio_return(cb), 0);
+}
+
+/**
+ * @brief Test invalid requests
+ */
+ZTEST(posix_fs_aio_test, test_aio_invalid)
+{
+	struct aiocb *cb = &aio_cbs[0];
+
+	aio_prep(cb, aio_bufs[0], AIO_CHUNK_SIZE, 0);
+	cb->aio_sigevent.sigev_notify = SIGEV_SIGNAL;
+	zassert_equal(aio_read(cb), -1);
+	zassert_equal(errno, ENOSYS);
+
+	aio_prep(cb, aio_bufs[0], AIO_CHUNK_SIZE, -1);
+	zassert_equal(aio_read(cb), -1);
+	zassert_equal(errno, EINVAL);
+
+	zassert_equal(aio_return(cb), -1);
+	zassert_equal(errno, EINVAL);
+
+	zassert_equal(aio_cancel(aio_fd, NULL), AIO_ALLDONE);
+}
+
+/**
+ * @brief Compare reading the file with a queue of aio_read() requests and with read()
+ */
+ZTEST(posix_fs_aio_test, test_aio_read_throughput)
+{
+	const struct aiocb *list[AIO_DEPTH];
+	uint32_t start, aio_ms, sync_ms;
+	int next = 0, done = 0;
+
+	start = k_uptime_get_32();
+	for (int i = 0; i < AIO_DEPTH && next < AIO_CHUNKS; i++, next++) {
+		aio_prep(&aio_cbs[i], aio_bufs[i], AIO_CHUNK_SIZE, next * AIO_CHUNK_SIZE);
+		zassert_ok(aio_read(&aio_cbs[i]));
+		list[i] = &aio_cbs[i];
+	}
+	while (done < AIO_CHUNKS) {
+		zassert_ok(aio_suspend(list, AIO_DEPTH, NULL));
+		for (int i = 0; i < AIO_DEPTH; i++) {
+			if (list[i] == NULL || aio_error(&aio_cbs[i]) == EINPROGRESS) {
+				continue;
+			}
+			zassert_equal(aio_return(&aio_cbs[i]), AIO_CHUNK_SIZE);
+			zassert_mem_equal(aio_bufs[i], &aio_data[aio_cbs[i].aio_offset],
+					  AIO_CHUNK_SIZE);
+			done++;
+			list[i] = NULL;
+			if (next < AIO_CHUNKS) {
+				aio_prep(&aio_cbs[i], aio_bufs[i], AIO_CHUNK_SIZE,
+					 next++ * AIO_CHUNK_SIZE);
+				zassert_ok(aio_read(&aio_cbs[i]));
+				list[i] = &aio_cbs[i];
+			}
+		}
+	}
+	aio_ms = k_uptime_get_32() - start;
+
+	start = k_uptime_get_32();
+	for (int i = 0; i < AIO_CHUNKS; i++) {
+		zassert_equal(read(aio_fd, aio_bufs[0], AIO_CHUNK_SIZE), AIO_CHUNK_SIZE);
+	}
+	sync_ms = k_uptime_get_32() - start;
+
+	TC_PRINT("%d KiB with %d aio_read() in flight: %u ms, with read(): %u ms\n",
+		 AIO_FILE_SIZE / 1024, AIO_DEPTH, aio_ms, sync_ms);
+}
+
+#endif /* CONFIG_POSIX_ASYNCHRONOUS_IO */
@@ -863,6 +863,9 @@ ZTEST_F(nvs, test_nvs_cache_gc)
 	size_t num;
 	uint16_t data = 0;
 
+	/* The sectors are filled without taking their summary into account */
+	Z_TEST_SKIP_IFDEF(CONFIG_NVS_SECTOR_SUMMARY);
+
 	fixture->fs.sector_count = 3;
 	err = nvs_mount(&fixture->fs);
 	zassert_true(err == 0, "nvs_mount call failure: %d", err);
@@ -959,3 +962,62 @@ ZTEST_F(nvs, test_nvs_cache_hash_quality)
 
 #endif
 }
+
+/*
+ * Test that closed sectors get a summary, and that the lookup cache rebuilt
+ * from the summaries on nvs_mount() is the same as the one updated on writes.
+ */
+ZTEST_F(nvs, test_nvs_sector_summary)
+{
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	uint32_t cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	struct nvs_ate close_ate, summary_ate;
+	struct nvs_summary summary;
+	const uint16_t max_id = 10;
+	off_t sector_offset;
+	int err;
+
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	/* Close the first two sectors */
+	write_content(max_id, 0, 60, &fixture->fs);
+	zassert_equal(fixture->fs.ate_wra >> ADDR_SECT_SHIFT, 2, "unexpected write sector");
+
+	for (uint16_t i = 0; i < 2; i++) {
+		sector_offset = fixture->fs.offset + i * fixture->fs.sector_size;
+
+		err = flash_read(fixture->fs.flash_device,
+				 sector_offset + fixture->fs.sector_size - sizeof(struct nvs_ate),
+				 &close_ate, sizeof(close_ate));
+		zassert_true(err == 0, "flash_read failed: %d", err);
+
+		err = flash_read(fixture->fs.flash_device,
+				 sector_offset + close_ate.offset - sizeof(struct nvs_ate),
+				 &summary_ate, sizeof(summary_ate));
+		zassert_true(err == 0, "flash_read failed: %d", err);
+		zassert_equal(summary_ate.id, 0xffff, "no summary in sector %u", i);
+		zassert_equal(summary_ate.part, NVS_SUMMARY_PART, "no summary in sector %u", i);
+		zassert_equal(summary_ate.len, sizeof(summary), "invalid summary length");
+
+		err = flash_read(fixture->fs.flash_device, sector_offset + summary_ate.offset,
+				 &summary, sizeof(summary));
+		zassert_true(err == 0, "flash_read failed: %d", err);
+		zassert_equal(summary.ate_last, close_ate.offset, "invalid summary");
+		zassert_equal(summary.crc32,
+			      crc32_ieee((const uint8_t *)&summary,
+					 offsetof(struct nvs_summary, crc32)),
+			      "invalid summary crc");
+	}
+
+	memcpy(cache, fixture->fs.lookup_cache, sizeof(cache));
+	memset(fixture->fs.lookup_cache, 0xAA, sizeof(fixture->fs.lookup_cache));
+
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	zassert_mem_equal(cache, fixture->fs.lookup_cache, sizeof(cache),
+			  "cache rebuilt from summaries differs");
+	check_content(max_id, &fixture->fs);
+#endif
+}
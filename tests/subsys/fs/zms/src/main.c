@@ -390,6 +390,122 @@ ZTEST_F(zms, test_zms_gc_3sectors)
 	check_content(max_id, &fixture->fs);
 }
 
+/*
+ * Test that an incremental GC can be moved forward with zms_gc_step() and
+ * that the content is kept while the GC is pending and after a remount.
+ */
+ZTEST_F(zms, test_zms_gc_incremental)
+{
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+	int err;
+	int pressure;
+	int steps;
+	const uint16_t max_id = 10;
+	/* 41st write will trigger 1st GC. */
+	const uint16_t max_writes = 41;
+	/* 61st write will trigger 2nd GC. */
+	const uint16_t max_writes_2 = 41 + 20;
+
+	fixture->fs.sector_count = 3;
+
+	err = zms_mount(&fixture->fs);
+	zassert_true(err == 0, "zms_mount call failure: %d", err);
+
+	err = zms_gc_step(&fixture->fs);
+	zassert_true(err == 0, "unexpected pending gc: %d", err);
+	zassert_true(zms_gc_pressure(&fixture->fs) == 0, "unexpected gc pressure");
+
+	/* Trigger 1st GC */
+	write_content(max_id, 0, max_writes, &fixture->fs);
+	check_content(max_id, &fixture->fs);
+
+	/* The write only ran the steps it needed to make room for its entry */
+	pressure = zms_gc_pressure(&fixture->fs);
+	zassert_between_inclusive(pressure, 1, 100, "unexpected gc pressure %d", pressure);
+
+	err = zms_gc_step(&fixture->fs);
+	zassert_equal(err, 1, "expected the gc to be pending: %d", err);
+
+	/* Remount while the gc is still pending */
+	err = zms_mount(&fixture->fs);
+	zassert_true(err == 0, "zms_mount call failure: %d", err);
+
+	zassert_equal(fixture->fs.ate_wra >> ADDR_SECT_SHIFT, 2, "unexpected write sector");
+	zassert_true(zms_gc_pressure(&fixture->fs) == 0, "unexpected gc pressure");
+	check_content(max_id, &fixture->fs);
+
+	/* Trigger 2nd GC and complete it in steps */
+	write_content(max_id, max_writes, max_writes_2, &fixture->fs);
+
+	for (steps = 0; steps < 100; steps++) {
+		err = zms_gc_step(&fixture->fs);
+		zassert_true(err >= 0, "zms_gc_step call failure: %d", err);
+		if (err == 0) {
+			break;
+		}
+		check_content(max_id, &fixture->fs);
+	}
+
+	zassert_true(err == 0, "gc was not completed after %d steps", steps);
+	zassert_true(zms_gc_pressure(&fixture->fs) == 0, "unexpected gc pressure");
+	zassert_equal(fixture->fs.ate_wra >> ADDR_SECT_SHIFT, 0, "unexpected write sector");
+	check_content(max_id, &fixture->fs);
+
+	err = zms_mount(&fixture->fs);
+	zassert_true(err == 0, "zms_mount call failure: %d", err);
+
+	zassert_equal(fixture->fs.ate_wra >> ADDR_SECT_SHIFT, 0, "unexpected write sector");
+	check_content(max_id, &fixture->fs);
+#endif
+}
+
+/*
+ * Test that entries written while an incremental GC is pending are kept when
+ * the GC is resumed on mount.
+ */
+ZTEST_F(zms, test_zms_gc_incremental_remount)
+{
+#ifdef CONFIG_ZMS_GC_INCREMENTAL
+	int err;
+	ssize_t len;
+	uint8_t rd_buf[32];
+	uint8_t buf[32];
+	const uint16_t max_id = 10;
+	/* 41st write will trigger 1st GC. */
+	const uint16_t max_writes = 41;
+
+	fixture->fs.sector_count = 3;
+
+	err = zms_mount(&fixture->fs);
+	zassert_true(err == 0, "zms_mount call failure: %d", err);
+
+	write_content(max_id, 0, max_writes, &fixture->fs);
+	zassert_true(zms_gc_pressure(&fixture->fs) > 0, "expected the gc to be pending");
+
+	/* This write moves the gc forward by one step only */
+	write_content(max_id, max_writes, max_writes + 1, &fixture->fs);
+	zassert_true(zms_gc_pressure(&fixture->fs) > 0, "expected the gc to be pending");
+
+	/* The write sector is kept and the gc is completed on mount */
+	err = zms_mount(&fixture->fs);
+	zassert_true(err == 0, "zms_mount call failure: %d", err);
+
+	zassert_equal(fixture->fs.ate_wra >> ADDR_SECT_SHIFT, 2, "unexpected write sector");
+	zassert_true(zms_gc_pressure(&fixture->fs) == 0, "unexpected gc pressure");
+	check_content(max_id, &fixture->fs);
+
+	/* The entries written while the gc was pending are the most recent ones */
+	for (int i = max_writes - 1; i <= max_writes; i++) {
+		len = zms_read(&fixture->fs, i % max_id, rd_buf, sizeof(rd_buf));
+		zassert_true(len == sizeof(rd_buf), "zms_read unexpected failure: %d", len);
+
+		memset(buf, i, sizeof(buf));
+		zassert_mem_equal(buf, rd_buf, sizeof(rd_buf), "unexpected data of id %d",
+				  i % max_id);
+	}
+#endif
+}
+
 static int flash_sim_max_len_find(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off)
 {
 	if (!strcmp(name, "max_len")) {
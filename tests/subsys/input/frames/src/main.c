@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/input/input.h>
+#include <zephyr/ztest.h>
+#include <zephyr/device.h>
+
+static const struct device fake_dev;
+static const struct device other_dev;
+
+#define MAX_RECORDS 32
+
+struct record {
+	int cb;
+	struct input_event evt;
+};
+
+static struct record records[MAX_RECORDS];
+static int record_count;
+static int other_count;
+
+static K_SEM_DEFINE(evt_sem, 0, MAX_RECORDS);
+
+static void record_event(int cb, struct input_event *evt)
+{
+	if (record_count < MAX_RECORDS) {
+		records[record_count].cb = cb;
+		records[record_count].evt = *evt;
+		record_count++;
+	}
+}
+
+static void input_cb_dev(struct input_event *evt, void *user_data)
+{
+	record_event(0, evt);
+}
+INPUT_CALLBACK_DEFINE(&fake_dev, input_cb_dev, NULL);
+
+static void input_cb_any(struct input_event *evt, void *user_data)
+{
+	record_event(1, evt);
+	k_sem_give(&evt_sem);
+}
+INPUT_CALLBACK_DEFINE(NULL, input_cb_any, NULL);
+
+static void input_cb_other(struct input_event *evt, void *user_data)
+{
+	other_count++;
+}
+INPUT_CALLBACK_DEFINE(&other_dev, input_cb_other, NULL);
+
+static void wait_events(int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_ok(k_sem_take(&evt_sem, K_SECONDS(1)), "event %d not delivered", i);
+	}
+
+	/* Nothing else is delivered */
+	zassert_equal(k_sem_take(&evt_sem, K_MSEC(50)), -EAGAIN);
+}
+
+static void report_touch(int32_t x, int32_t y, bool pressed)
+{
+	zassert_ok(input_report_abs(&fake_dev, INPUT_ABS_X, x, false, K_FOREVER));
+	zassert_ok(input_report_abs(&fake_dev, INPUT_ABS_Y, y, false, K_FOREVER));
+	zassert_ok(input_report_key(&fake_dev, INPUT_BTN_TOUCH, pressed, true, K_FOREVER));
+}
+
+static void check_record(int idx, int cb, uint8_t type, uint16_t code, int32_t value, bool sync)
+{
+	const struct record *rec = &records[idx];
+
+	zassert_equal(rec->cb, cb, "record %d", idx);
+	zassert_equal(rec->evt.dev, &fake_dev, "record %d", idx);
+	zassert_equal(rec->evt.type, type, "record %d", idx);
+	zassert_equal(rec->evt.code, code, "record %d", idx);
+	zassert_equal(rec->evt.value, value, "record %d", idx);
+	zassert_equal(rec->evt.sync, sync, "record %d", idx);
+}
+
+ZTEST(input_frames, test_frame_delivery)
+{
+	report_touch(10, 20, true);
+	wait_events(3);
+
+	zassert_equal(record_count, 6);
+	zassert_equal(other_count, 0);
+
+	/* Each callback gets the whole frame in a row */
+	for (int i = 0; i < 2; i++) {
+		int cb = records[i * 3].cb;
+
+		check_record(i * 3, cb, INPUT_EV_ABS, INPUT_ABS_X, 10, false);
+		check_record(i * 3 + 1, cb, INPUT_EV_ABS, INPUT_ABS_Y, 20, false);
+		check_record(i * 3 + 2, cb, INPUT_EV_KEY, INPUT_BTN_TOUCH, 1, true);
+	}
+	zassert_not_equal(records[0].cb, records[3].cb);
+}
+
+ZTEST(input_frames, test_partial_frame)
+{
+	/* A frame without sync is delivered once the queue is empty */
+	zassert_ok(input_report_key(&fake_dev, INPUT_KEY_A, 1, false, K_FOREVER));
+	zassert_ok(input_report_key(&fake_dev, INPUT_KEY_B, 1, false, K_FOREVER));
+	wait_events(2);
+
+	zassert_equal(record_count, 4);
+	zassert_equal(other_count, 0);
+}
+
+ZTEST(input_frames, test_device_change)
+{
+	/* Events of other devices end the frame */
+	zassert_ok(input_report_key(&fake_dev, INPUT_KEY_A, 1, false, K_FOREVER));
+	zassert_ok(input_report_key(&other_dev, INPUT_KEY_B, 1, true, K_FOREVER));
+	zassert_ok(input_report_key(&fake_dev, INPUT_KEY_A, 0, true, K_FOREVER));
+	wait_events(3);
+
+	zassert_equal(other_count, 1);
+	zassert_equal(records[0].evt.code, INPUT_KEY_A);
+	zassert_equal(records[0].evt.value, 1);
+	zassert_equal(records[record_count - 1].evt.code, INPUT_KEY_A);
+	zassert_equal(records[record_count - 1].evt.value, 0);
+}
+
+ZTEST(input_frames, test_coalescing)
+{
+	int cb;
+
+	for (int i = 0; i < 3; i++) {
+		report_touch(i, 2 * i, true);
+	}
+	report_touch(3, 6, false);
+
+	if (!IS_ENABLED(CONFIG_INPUT_FRAME_COALESCING)) {
+		wait_events(12);
+		zassert_equal(record_count, 24);
+		return;
+	}
+
+	/* The press frames are merged, the release one is not */
+	wait_events(6);
+	zassert_equal(record_count, 12);
+
+	cb = records[0].cb;
+	check_record(0, cb, INPUT_EV_ABS, INPUT_ABS_X, 2, false);
+	check_record(1, cb, INPUT_EV_ABS, INPUT_ABS_Y, 4, false);
+	check_record(2, cb, INPUT_EV_KEY, INPUT_BTN_TOUCH, 1, true);
+
+	cb = records[6].cb;
+	check_record(6, cb, INPUT_EV_ABS, INPUT_ABS_X, 3, false);
+	check_record(7, cb, INPUT_EV_ABS, INPUT_ABS_Y, 6, false);
+	check_record(8, cb, INPUT_EV_KEY, INPUT_BTN_TOUCH, 0, true);
+}
+
+ZTEST(input_frames, test_coalescing_rel)
+{
+	for (int i = 0; i < 3; i++) {
+		zassert_ok(input_report_rel(&fake_dev, INPUT_REL_X, 5, true, K_FOREVER));
+	}
+
+	if (!IS_ENABLED(CONFIG_INPUT_FRAME_COALESCING)) {
+		wait_events(3);
+		return;
+	}
+
+	/* Relative values are added up */
+	wait_events(1);
+	check_record(0, records[0].cb, INPUT_EV_REL, INPUT_REL_X, 15, true);
+	check_record(1, records[1].cb, INPUT_EV_REL, INPUT_REL_X, 15, true);
+}
+
+static void input_frames_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(records, 0, sizeof(records));
+	record_count = 0;
+	other_count = 0;
+	k_sem_reset(&evt_sem);
+}
+
+ZTEST_SUITE(input_frames, NULL, NULL, input_frames_before, NULL, NULL);
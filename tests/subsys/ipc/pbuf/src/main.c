@@ -183,6 +183,78 @@ ZTEST(test_pbuf, test_retcodes)
 	zassert_equal(pbuf_read(&pb2, read_buf, 10), 0);
 }
 
+/* In place read tests. */
+ZTEST(test_pbuf, test_rx_in_place)
+{
+	uint8_t read_buf[MEM_AREA_SZ] = {0};
+	uint8_t write_buf[MEM_AREA_SZ];
+	const char *data;
+	uint32_t wr_idx;
+	int ret;
+
+	/* TODO: Use PBUF_DEFINE().
+	 * The user should use PBUF_DEFINE() macro to define the buffer,
+	 * however for the purpose of this test PBUF_CFG_INIT() is used in
+	 * order to avoid clang complains about memory_area not being constant
+	 * expression.
+	 */
+	static PBUF_MAYBE_CONST struct pbuf_cfg cfg = PBUF_CFG_INIT(memory_area, MEM_AREA_SZ, 0);
+
+	static struct pbuf pb = {
+		.cfg = &cfg,
+	};
+
+	for (size_t i = 0; i < MEM_AREA_SZ; i++) {
+		write_buf[i] = i+1;
+	}
+
+	zassert_equal(pbuf_tx_init(&pb), 0);
+
+	zassert_equal(pbuf_get_rx_buffer(NULL, &data), -EINVAL);
+	zassert_equal(pbuf_get_rx_buffer(&pb, NULL), -EINVAL);
+	zassert_equal(pbuf_release_rx_buffer(NULL, 0), -EINVAL);
+
+	/* Nothing to read from empty buffer. */
+	zassert_equal(pbuf_get_rx_buffer(&pb, &data), 0);
+
+	/* The reader is idle. */
+	wr_idx = pb.data.wr_idx;
+	ret = pbuf_write(&pb, write_buf, MSGA_SZ);
+	zassert_equal(ret, MSGA_SZ);
+	zassert_true(pbuf_tx_consumed(&pb, wr_idx));
+
+	/* The reader has not read the previous packet yet. */
+	wr_idx = pb.data.wr_idx;
+	ret = pbuf_write(&pb, write_buf+MSGA_SZ, MSGB_SZ);
+	zassert_equal(ret, MSGB_SZ);
+	zassert_false(pbuf_tx_consumed(&pb, wr_idx));
+
+	/* Packets are accessed in place and stay in the buffer until released. */
+	ret = pbuf_get_rx_buffer(&pb, &data);
+	zassert_equal(ret, MSGA_SZ);
+	zassert_mem_equal(data, write_buf, ret);
+	zassert_equal(pbuf_get_rx_buffer(&pb, &data), MSGA_SZ);
+	zassert_ok(pbuf_release_rx_buffer(&pb, ret));
+
+	/* Reader has read the packets written before the second one. */
+	zassert_true(pbuf_tx_consumed(&pb, wr_idx));
+
+	ret = pbuf_get_rx_buffer(&pb, &data);
+	zassert_equal(ret, MSGB_SZ);
+	zassert_mem_equal(data, write_buf+MSGA_SZ, ret);
+	zassert_ok(pbuf_release_rx_buffer(&pb, ret));
+
+	zassert_equal(pbuf_get_rx_buffer(&pb, &data), 0);
+
+	/* Wrapped packet can not be accessed in place, but it can be read. */
+	ret = pbuf_write(&pb, write_buf, MPS);
+	zassert_equal(ret, MPS);
+	zassert_equal(pbuf_get_rx_buffer(&pb, &data), -ENOTSUP);
+	ret = pbuf_read(&pb, read_buf, MPS);
+	zassert_equal(ret, MPS);
+	zassert_mem_equal(write_buf, read_buf, MPS);
+}
+
 #define STRESS_LEN_MOD (44)
 #define STRESS_LEN_MIN (20)
 #define STRESS_LEN_MAX (STRESS_LEN_MIN + STRESS_LEN_MOD)
@@ -265,6 +265,66 @@ LLEXT_LOAD_UNLOAD(hello_world,
 	.kernel_only = true
 )
 
+#define REPEATED_LOAD_COUNT 10
+
+/*
+ * Load and unload the same extension several times, reporting the average
+ * time taken by each operation and the peak memory used by sections. With
+ * the image cache enabled, every load must revive the same relocated image.
+ */
+ZTEST(llext, test_load_unload_repeated)
+{
+	struct llext *first = NULL;
+	struct sys_memory_stats stats;
+	uint64_t load_cycles = 0;
+	uint64_t unload_cycles = 0;
+	uint32_t start;
+
+	if (IS_ENABLED(CONFIG_LLEXT_STORAGE_WRITABLE)) {
+		/* Relocating the same writable ELF buffer twice corrupts it, and
+		 * images used in place are never cached.
+		 */
+		ztest_test_skip();
+	}
+
+	for (int i = 0; i < REPEATED_LOAD_COUNT; i++) {
+		struct llext_buf_loader buf_loader =
+			LLEXT_BUF_LOADER(hello_world_ext, sizeof(hello_world_ext));
+		struct llext_load_param ldr_parm = LLEXT_LOAD_PARAM_DEFAULT;
+		struct llext *ext = NULL;
+
+		start = k_cycle_get_32();
+		zassert_ok(llext_load(&buf_loader.loader, "hello_world", &ext, &ldr_parm),
+			   "load %d should succeed", i);
+		load_cycles += k_cycle_get_32() - start;
+
+		zassert_not_null(llext_find_sym(&ext->exp_tab, "test_entry"),
+				 "test_entry should be an exported symbol");
+
+		if (IS_ENABLED(CONFIG_LLEXT_IMAGE_CACHE)) {
+			if (first == NULL) {
+				first = ext;
+			}
+			zassert_equal_ptr(ext, first, "load %d should revive the cached image", i);
+		}
+
+		start = k_cycle_get_32();
+		llext_unload(&ext);
+		unload_cycles += k_cycle_get_32() - start;
+	}
+
+	TC_PRINT("%d loads: avg load %llu us, avg unload %llu us\n", REPEATED_LOAD_COUNT,
+		 k_cyc_to_us_floor64(load_cycles / REPEATED_LOAD_COUNT),
+		 k_cyc_to_us_floor64(unload_cycles / REPEATED_LOAD_COUNT));
+
+	if (llext_get_section_mem_stats(&stats) == 0) {
+		TC_PRINT("section memory: %zu bytes peak, %zu bytes in use\n",
+			 stats.max_allocated_bytes, stats.allocated_bytes);
+	}
+
+	llext_cache_flush();
+}
+
 #ifndef CONFIG_LLEXT_TYPE_ELF_SHAREDLIB
 static LLEXT_CONST uint8_t init_fini_ext[] ELF_ALIGN = {
 	#include "init_fini.inc"
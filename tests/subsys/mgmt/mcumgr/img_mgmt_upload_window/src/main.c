@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/mgmt/mcumgr/mgmt/mgmt.h>
+#include <zephyr/mgmt/mcumgr/transport/smp_dummy.h>
+#include <zephyr/mgmt/mcumgr/grp/img_mgmt/img_mgmt.h>
+#include <zcbor_common.h>
+#include <zcbor_decode.h>
+#include <zcbor_encode.h>
+#include <mgmt/mcumgr/util/zcbor_bulk.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <smp_internal.h>
+
+#define SMP_RESPONSE_WAIT_TIME 3
+#define ZCBOR_BUFFER_SIZE 128
+#define ZCBOR_HISTORY_ARRAY_SIZE 10
+
+#define CHUNK_SIZE 64
+#define NUM_CHUNKS 8
+#define IMAGE_SIZE (CHUNK_SIZE * NUM_CHUNKS)
+#define CHUNK_OFF(i) ((i) * CHUNK_SIZE)
+#define WINDOW CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNKS
+#define SLOT_ID FIXED_PARTITION_ID(slot1_partition)
+
+BUILD_ASSERT(WINDOW == 2, "The test overflows a window of two chunks");
+BUILD_ASSERT(CHUNK_SIZE <= CONFIG_MCUMGR_GRP_IMG_UPLOAD_WINDOW_CHUNK_SIZE,
+	     "Chunks are larger than the chunks held by the server");
+
+struct upload_rsp {
+	uint32_t off;
+	uint32_t win;
+	uint32_t sack[WINDOW + 1];
+	size_t sack_len;
+};
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t read_buf[CHUNK_SIZE];
+
+static bool decode_sack(zcbor_state_t *state, void *user_data)
+{
+	struct upload_rsp *rsp = (struct upload_rsp *)user_data;
+
+	if (!zcbor_list_start_decode(state)) {
+		return false;
+	}
+
+	while (!zcbor_array_at_end(state)) {
+		if (rsp->sack_len == ARRAY_SIZE(rsp->sack) ||
+		    !zcbor_uint32_decode(state, &rsp->sack[rsp->sack_len])) {
+			return false;
+		}
+
+		rsp->sack_len++;
+	}
+
+	return zcbor_list_end_decode(state);
+}
+
+/* Send the upload request of a chunk of the image and decode the response */
+static void upload_chunk(size_t index, struct upload_rsp *rsp)
+{
+	uint8_t buffer[ZCBOR_BUFFER_SIZE];
+	uint8_t buffer_out[sizeof(struct smp_hdr) + ZCBOR_BUFFER_SIZE];
+	zcbor_state_t zse[ZCBOR_HISTORY_ARRAY_SIZE] = { 0 };
+	zcbor_state_t zsd[ZCBOR_HISTORY_ARRAY_SIZE] = { 0 };
+	uint32_t off = CHUNK_OFF(index);
+	struct smp_hdr *header;
+	struct net_buf *nb;
+	size_t decoded = 0;
+	uint16_t buffer_size;
+	bool received;
+	bool ok;
+
+	struct zcbor_map_decode_key_val output_decode[] = {
+		ZCBOR_MAP_DECODE_KEY_DECODER("off", zcbor_uint32_decode, &rsp->off),
+		ZCBOR_MAP_DECODE_KEY_DECODER("win", zcbor_uint32_decode, &rsp->win),
+		ZCBOR_MAP_DECODE_KEY_DECODER("sack", decode_sack, rsp),
+	};
+
+	memset(rsp, 0, sizeof(*rsp));
+
+	/* Ask for a larger window than the server holds */
+	zcbor_new_encode_state(zse, ARRAY_SIZE(zse), buffer, sizeof(buffer), 0);
+
+	ok = zcbor_map_start_encode(zse, 4)				&&
+	     zcbor_tstr_put_lit(zse, "off")				&&
+	     zcbor_uint32_put(zse, off)					&&
+	     zcbor_tstr_put_lit(zse, "data")				&&
+	     zcbor_bstr_encode_ptr(zse, &image[off], CHUNK_SIZE)	&&
+	     zcbor_tstr_put_lit(zse, "win")				&&
+	     zcbor_uint32_put(zse, WINDOW + 2);
+
+	if (off == 0) {
+		ok = ok && zcbor_tstr_put_lit(zse, "len")		&&
+		     zcbor_uint32_put(zse, IMAGE_SIZE);
+	}
+
+	ok = ok && zcbor_map_end_encode(zse, 4);
+	zassert_true(ok, "Expected packet creation to be successful");
+
+	buffer_size = zse->payload_mut - buffer;
+
+	header = (struct smp_hdr *)buffer_out;
+	*header = (struct smp_hdr) {
+		.nh_len = sys_cpu_to_be16(buffer_size),
+		.nh_flags = 0,
+		.nh_op = MGMT_OP_WRITE,
+		.nh_group = sys_cpu_to_be16(MGMT_GROUP_ID_IMAGE),
+		.nh_seq = index,
+		.nh_id = IMG_MGMT_ID_UPLOAD,
+		.nh_version = 1,
+	};
+	memcpy(&buffer_out[sizeof(struct smp_hdr)], buffer, buffer_size);
+	buffer_size += sizeof(struct smp_hdr);
+
+	smp_dummy_enable();
+	smp_dummy_clear_state();
+
+	(void)smp_dummy_tx_pkt(buffer_out, buffer_size);
+	smp_dummy_add_data();
+
+	received = smp_dummy_wait_for_data(SMP_RESPONSE_WAIT_TIME);
+	zassert_true(received, "Expected to receive data but timed out");
+
+	nb = smp_dummy_get_outgoing();
+	smp_dummy_disable();
+
+	header = net_buf_pull_mem(nb, sizeof(struct smp_hdr));
+	zassert_equal(header->nh_op, MGMT_OP_WRITE_RSP, "SMP header operation mismatch");
+	zassert_equal(header->nh_group, sys_cpu_to_be16(MGMT_GROUP_ID_IMAGE),
+		      "SMP header group mismatch");
+	zassert_equal(header->nh_id, IMG_MGMT_ID_UPLOAD, "SMP header command ID mismatch");
+
+	zcbor_new_decode_state(zsd, ARRAY_SIZE(zsd), nb->data, nb->len, 1, NULL, 0);
+	ok = zcbor_map_decode_bulk(zsd, output_decode, ARRAY_SIZE(output_decode), &decoded) == 0;
+
+	net_buf_unref(nb);
+
+	zassert_true(ok, "Expected decode to be successful");
+	zassert_equal(decoded, 3, "Expected off, win and sack in the response of chunk %zu",
+		      index);
+}
+
+/* Upload a chunk and check the offset and the held chunks acknowledged */
+static void upload_check(size_t index, uint32_t off, const uint32_t *sack, size_t sack_len)
+{
+	struct upload_rsp rsp;
+
+	upload_chunk(index, &rsp);
+
+	zassert_equal(rsp.off, off, "Chunk %zu: expected offset %u, got %u", index, off,
+		      rsp.off);
+	zassert_equal(rsp.win, WINDOW, "Chunk %zu: expected the window to be capped", index);
+	zassert_equal(rsp.sack_len, sack_len, "Chunk %zu: expected %zu held chunks, got %zu",
+		      index, sack_len, rsp.sack_len);
+
+	/* The held chunks are listed in no particular order */
+	for (size_t i = 0; i < sack_len; i++) {
+		bool found = false;
+
+		for (size_t j = 0; j < rsp.sack_len; j++) {
+			found = found || rsp.sack[j] == sack[i];
+		}
+
+		zassert_true(found, "Chunk %zu: expected offset %u to be held", index, sack[i]);
+	}
+}
+
+ZTEST(img_mgmt_upload_window, test_upload_out_of_order)
+{
+	const uint32_t held_2[] = { CHUNK_OFF(2) };
+	const uint32_t held_2_3[] = { CHUNK_OFF(2), CHUNK_OFF(3) };
+	const uint32_t held_5[] = { CHUNK_OFF(5) };
+	const uint32_t held_7[] = { CHUNK_OFF(7) };
+	const struct flash_area *fa;
+
+	upload_check(0, CHUNK_OFF(1), NULL, 0);
+
+	/* Chunks ahead of the expected offset are held, once */
+	upload_check(2, CHUNK_OFF(1), held_2, ARRAY_SIZE(held_2));
+	upload_check(2, CHUNK_OFF(1), held_2, ARRAY_SIZE(held_2));
+	upload_check(3, CHUNK_OFF(1), held_2_3, ARRAY_SIZE(held_2_3));
+
+	/* A full window does not acknowledge more chunks */
+	upload_check(4, CHUNK_OFF(1), held_2_3, ARRAY_SIZE(held_2_3));
+
+	/* The missing chunk drains the held ones */
+	upload_check(1, CHUNK_OFF(4), NULL, 0);
+
+	/* A chunk already written is not written again */
+	upload_check(1, CHUNK_OFF(4), NULL, 0);
+
+	/* The last chunk of the image may be held as well */
+	upload_check(5, CHUNK_OFF(4), held_5, ARRAY_SIZE(held_5));
+	upload_check(4, CHUNK_OFF(6), NULL, 0);
+	upload_check(7, CHUNK_OFF(6), held_7, ARRAY_SIZE(held_7));
+	upload_check(6, IMAGE_SIZE, NULL, 0);
+
+	zassert_ok(flash_area_open(SLOT_ID, &fa), "Expected the slot to open");
+
+	for (size_t off = 0; off < IMAGE_SIZE; off += sizeof(read_buf)) {
+		zassert_ok(flash_area_read(fa, off, read_buf, sizeof(read_buf)),
+			   "Expected the slot to be read");
+		zassert_mem_equal(read_buf, &image[off], sizeof(read_buf),
+				  "Image mismatch at offset %zu", off);
+	}
+
+	flash_area_close(fa);
+}
+
+static void *setup_image(void)
+{
+	struct image_header *hdr = (struct image_header *)image;
+
+	for (size_t i = 0; i < sizeof(image); i++) {
+		image[i] = (uint8_t)(i * 7 + i / CHUNK_SIZE);
+	}
+
+	/* The server checks the magic of the image header in the first chunk */
+	hdr->ih_magic = IMAGE_MAGIC;
+
+	return NULL;
+}
+
+ZTEST_SUITE(img_mgmt_upload_window, NULL, setup_image, NULL, NULL, NULL);
@@ -466,7 +466,9 @@ ZTEST(modem_ppp, test_ip_frame_send_multiple)
 
 ZTEST(modem_ppp, test_ip_frame_send_large)
 {
+	static const uint8_t header[] = {0xFF, 0x03};
 	struct net_pkt *pkt;
+	uint16_t fcs;
 	size_t size;
 	int ret;
 
@@ -493,6 +495,11 @@ ZTEST(modem_ppp, test_ip_frame_send_large)
 	/* Validate data */
 	zassert_true(test_modem_ppp_validate_fill(&unwrapped_buffer[2], (size - 2)) == true,
 		     "Incorrect data received");
+
+	/* Validate FCS over address, control, protocol, data and FCS */
+	fcs = crc16_ccitt(0xFFFF, header, sizeof(header));
+	fcs = crc16_ccitt(fcs, unwrapped_buffer, (size + 2));
+	zassert_true(fcs == 0xF0B8, "Incorrect FCS");
 }
 
 ZTEST(modem_ppp, test_ip_frame_receive_large)
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/debug/symtab.h>
+#include <zephyr/profiling/perf.h>
+
+#define SAMPLE_FREQUENCY 1000
+
+struct profile {
+	uint32_t total;
+	uint32_t hot;
+	uint32_t cold;
+};
+
+void __noinline perf_hot_function(void)
+{
+	k_busy_wait(USEC_PER_MSEC * 400);
+}
+
+void __noinline perf_cold_function(void)
+{
+	k_busy_wait(USEC_PER_MSEC * 50);
+}
+
+static bool stack_has(const struct perf_stack *stack, const char *name)
+{
+	uint32_t offset;
+
+	for (int i = 0; i < stack->depth; i++) {
+		/* Return addresses, except the innermost frame, may point past the call */
+		uintptr_t addr = i == 0 ? stack->frames[i] : stack->frames[i] - 1;
+
+		if (strcmp(symtab_find_symbol_name(addr, &offset), name) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void count_stack(const struct perf_stack *stack, void *user_data)
+{
+	struct profile *profile = user_data;
+
+	if (stack->tid != k_current_get()) {
+		return;
+	}
+
+	zassert_not_null(stack->thread, "Thread name not recorded");
+	zassert_equal(stack->cpu, 0);
+
+	profile->total += stack->count;
+	if (stack_has(stack, "perf_hot_function")) {
+		profile->hot += stack->count;
+	}
+	if (stack_has(stack, "perf_cold_function")) {
+		profile->cold += stack->count;
+	}
+}
+
+ZTEST(perf_continuous, test_hot_function_dominates)
+{
+	struct perf_continuous_stats stats;
+	struct profile profile = {0};
+
+	zassert_ok(perf_continuous_start(SAMPLE_FREQUENCY));
+	zassert_equal(perf_continuous_start(SAMPLE_FREQUENCY), -EINPROGRESS);
+
+	for (int i = 0; i < 2; i++) {
+		perf_hot_function();
+		perf_cold_function();
+	}
+
+	zassert_equal(perf_continuous_reset(), -EINPROGRESS);
+	perf_continuous_stop();
+
+	perf_continuous_stats_get(&stats);
+	perf_continuous_foreach(count_stack, &profile);
+
+	TC_PRINT("samples %u, stacks %u, dropped %u, test thread %u: hot %u, cold %u\n",
+		 stats.samples, stats.stacks, stats.dropped, profile.total, profile.hot,
+		 profile.cold);
+
+	zassert_true(profile.total > 0, "No samples of the test thread");
+	/* The hot function runs 8 times longer than the cold one */
+	zassert_true(profile.hot > profile.cold * 4, "Hot function doesn't dominate");
+	zassert_true(profile.hot * 4 > profile.total * 3, "Hot function under 75%% of samples");
+}
+
+ZTEST(perf_continuous, test_bounded_table)
+{
+	struct perf_continuous_stats stats;
+
+	zassert_ok(perf_continuous_start(SAMPLE_FREQUENCY));
+	/* Run long enough to sample far more than the table holds */
+	for (int i = 0; i < 5; i++) {
+		perf_cold_function();
+	}
+	perf_continuous_stop();
+
+	perf_continuous_stats_get(&stats);
+	zassert_true(stats.stacks <= CONFIG_PROFILING_PERF_CONTINUOUS_STACKS);
+	zassert_true(stats.samples + stats.dropped > CONFIG_PROFILING_PERF_CONTINUOUS_STACKS);
+}
+
+static void perf_continuous_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(perf_continuous_reset());
+}
+
+ZTEST_SUITE(perf_continuous, NULL, NULL, perf_continuous_before, NULL, NULL);
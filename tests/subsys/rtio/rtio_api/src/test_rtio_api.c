@@ -746,6 +746,223 @@ ZTEST(rtio_api, test_rtio_callback_chaining)
 	test_rtio_callback_chaining_(&r_callback_chaining);
 }
 
+RTIO_DEFINE(r_timeout, SQE_POOL_SIZE, CQE_POOL_SIZE);
+RTIO_IODEV_TEST_DEFINE(iodev_test_timeout);
+
+/**
+ * @brief Test timeout submissions
+ *
+ * Ensures a timeout completes once it expired, and reports how late it was.
+ */
+ZTEST(rtio_api, test_rtio_timeout)
+{
+	int32_t userdata = 0;
+	struct rtio_sqe *sqe;
+	struct rtio_cqe *cqe;
+	int64_t start, elapsed;
+
+	sqe = rtio_sqe_acquire(&r_timeout);
+	zassert_not_null(sqe, "Expected a valid sqe");
+	rtio_sqe_prep_timeout(sqe, K_FOREVER, &userdata);
+	zassert_ok(rtio_submit(&r_timeout, 1));
+	cqe = rtio_cqe_consume(&r_timeout);
+	zassert_not_null(cqe, "Expected a valid cqe");
+	zassert_equal(cqe->result, -EINVAL, "Waiting forever should be rejected");
+	rtio_cqe_release(&r_timeout, cqe);
+
+	for (int i = 1; i <= TEST_REPEATS; i++) {
+		sqe = rtio_sqe_acquire(&r_timeout);
+		zassert_not_null(sqe, "Expected a valid sqe");
+		rtio_sqe_prep_timeout(sqe, K_MSEC(10 * i), &userdata);
+
+		start = k_uptime_ticks();
+		zassert_ok(rtio_submit(&r_timeout, 0));
+		cqe = rtio_cqe_consume_block(&r_timeout);
+		elapsed = k_uptime_ticks() - start;
+
+		zassert_ok(cqe->result, "Result should be ok");
+		zassert_equal_ptr(cqe->userdata, &userdata, "Expected userdata back");
+		rtio_cqe_release(&r_timeout, cqe);
+
+		zassert_true(elapsed >= k_ms_to_ticks_floor64(10 * i),
+			     "Timeout completed early");
+		TC_PRINT("%d ms timeout completed after %lld us\n", 10 * i,
+			 k_ticks_to_us_floor64(elapsed));
+	}
+}
+
+/**
+ * @brief Test linked timeout submissions
+ *
+ * Ensures a linked timeout cancels the submission it bounds on expiry, and is
+ * itself canceled when the submission completes in time.
+ */
+ZTEST(rtio_api, test_rtio_link_timeout)
+{
+	int32_t userdata[2] = {0, 1};
+	struct rtio_sqe *sqe;
+	struct rtio_cqe *cqe;
+	struct rtio_cqe cqe_out;
+
+	rtio_iodev_test_init(&iodev_test_timeout);
+
+	/* The test iodev takes 10 ms per request */
+	sqe = rtio_sqe_acquire(&r_timeout);
+	zassert_not_null(sqe, "Expected a valid sqe");
+	rtio_sqe_prep_nop(sqe, &iodev_test_timeout, &userdata[0]);
+	sqe->flags |= RTIO_SQE_CHAINED;
+	sqe = rtio_sqe_acquire(&r_timeout);
+	zassert_not_null(sqe, "Expected a valid sqe");
+	rtio_sqe_prep_link_timeout(sqe, K_MSEC(2), &userdata[1]);
+
+	zassert_ok(rtio_submit(&r_timeout, 0));
+	cqe = rtio_cqe_consume_block(&r_timeout);
+	zassert_equal(cqe->result, -ETIME, "Expected the timeout to expire");
+	zassert_equal_ptr(cqe->userdata, &userdata[1], "Expected timeout userdata");
+	rtio_cqe_release(&r_timeout, cqe);
+
+	/* The canceled request produces no completion once the iodev is done with it */
+	zassert_equal(rtio_cqe_copy_out(&r_timeout, &cqe_out, 1, K_MSEC(30)), 0,
+		      "Expected no completion for the canceled request");
+
+	sqe = rtio_sqe_acquire(&r_timeout);
+	zassert_not_null(sqe, "Expected a valid sqe");
+	rtio_sqe_prep_nop(sqe, &iodev_test_timeout, &userdata[0]);
+	sqe->flags |= RTIO_SQE_CHAINED;
+	sqe = rtio_sqe_acquire(&r_timeout);
+	zassert_not_null(sqe, "Expected a valid sqe");
+	rtio_sqe_prep_link_timeout(sqe, K_MSEC(100), &userdata[1]);
+
+	zassert_ok(rtio_submit(&r_timeout, 0));
+	for (int i = 0; i < 2; i++) {
+		cqe = rtio_cqe_consume_block(&r_timeout);
+		zassert_equal_ptr(cqe->userdata, &userdata[i], "Expected completions in order");
+		zassert_equal(cqe->result, i == 0 ? 0 : -ECANCELED, "Unexpected result");
+		rtio_cqe_release(&r_timeout, cqe);
+	}
+}
+
+BUILD_ASSERT(CONFIG_RTIO_TIMEOUT_COUNT < SQE_POOL_SIZE);
+
+/**
+ * @brief Test timeouts submitted while all the timers are in use
+ *
+ * Ensures a timeout that finds no free timer fails right away, and that the
+ * timers are released once their timeouts expired.
+ */
+ZTEST(rtio_api, test_rtio_timeout_pool)
+{
+	int32_t userdata[2] = {0, 1};
+	struct rtio_sqe *sqe;
+	struct rtio_cqe *cqe;
+
+	for (int round = 0; round < 2; round++) {
+		for (int i = 0; i <= CONFIG_RTIO_TIMEOUT_COUNT; i++) {
+			sqe = rtio_sqe_acquire(&r_timeout);
+			zassert_not_null(sqe, "Expected a valid sqe");
+			rtio_sqe_prep_timeout(sqe, K_MSEC(10),
+					      &userdata[i == CONFIG_RTIO_TIMEOUT_COUNT]);
+		}
+		zassert_ok(rtio_submit(&r_timeout, 0));
+
+		cqe = rtio_cqe_consume_block(&r_timeout);
+		zassert_equal_ptr(cqe->userdata, &userdata[1], "Expected the extra timeout first");
+		zassert_equal(cqe->result, -ENOMEM, "Expected no timer left");
+		rtio_cqe_release(&r_timeout, cqe);
+
+		for (int i = 0; i < CONFIG_RTIO_TIMEOUT_COUNT; i++) {
+			cqe = rtio_cqe_consume_block(&r_timeout);
+			zassert_equal_ptr(cqe->userdata, &userdata[0], "Unexpected completion");
+			zassert_ok(cqe->result, "Result should be ok");
+			rtio_cqe_release(&r_timeout, cqe);
+		}
+	}
+}
+
+#define BATCH_ITERS 10000
+#define BATCH_SIZE  4
+RTIO_DEFINE(r_batch, SQE_POOL_SIZE, CQE_POOL_SIZE);
+
+static uint64_t batch_reap_ns(struct rtio *r, bool batched)
+{
+	struct rtio_cqe *cqes[BATCH_SIZE];
+	timing_t start_time, end_time;
+	struct rtio_sqe *sqe;
+	size_t count;
+
+	start_time = timing_counter_get();
+
+	for (uint32_t i = 0; i < BATCH_ITERS; i++) {
+		for (int j = 0; j < BATCH_SIZE; j++) {
+			sqe = rtio_sqe_acquire(r);
+			rtio_sqe_prep_nop(sqe, NULL, NULL);
+		}
+		rtio_submit(r, 0);
+
+		if (batched) {
+			count = rtio_cqe_consume_batch(r, cqes, BATCH_SIZE);
+			zassert_equal(count, BATCH_SIZE, "Expected a full batch");
+			rtio_cqe_release_batch(r, cqes, count);
+		} else {
+			for (count = 0; count < BATCH_SIZE; count++) {
+				cqes[count] = rtio_cqe_consume(r);
+				zassert_not_null(cqes[count], "Expected a completion");
+			}
+			for (size_t j = 0; j < count; j++) {
+				rtio_cqe_release(r, cqes[j]);
+			}
+		}
+	}
+
+	end_time = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&start_time, &end_time));
+}
+
+/**
+ * @brief Test batched consumption of completions
+ *
+ * Checks a batch stops at the completions available, then compares reaping
+ * completions one at a time with reaping them in batches.
+ */
+ZTEST(rtio_api, test_rtio_cqe_consume_batch)
+{
+	struct rtio_cqe *cqes[BATCH_SIZE];
+	uint64_t single_ns, batch_ns;
+	struct rtio_sqe *sqe;
+	size_t count;
+
+	zassert_equal(rtio_cqe_consume_batch(&r_batch, cqes, BATCH_SIZE), 0,
+		      "Expected no completions");
+
+	for (int i = 0; i < BATCH_SIZE - 1; i++) {
+		sqe = rtio_sqe_acquire(&r_batch);
+		rtio_sqe_prep_nop(sqe, NULL, &cqes[i]);
+	}
+	zassert_ok(rtio_submit(&r_batch, BATCH_SIZE - 1));
+
+	count = rtio_cqe_consume_batch(&r_batch, cqes, BATCH_SIZE);
+	zassert_equal(count, BATCH_SIZE - 1, "Expected the completions available");
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal_ptr(cqes[i]->userdata, &cqes[i], "Expected completions in order");
+	}
+	rtio_cqe_release_batch(&r_batch, cqes, count);
+
+	zassert_equal(rtio_cqe_consume_batch(&r_batch, cqes, BATCH_SIZE), 0,
+		      "Expected no completions left");
+
+	timing_init();
+	timing_start();
+
+	single_ns = batch_reap_ns(&r_batch, false);
+	batch_ns = batch_reap_ns(&r_batch, true);
+
+	TC_PRINT("%d completions, %llu ns per completion reaped one at a time, "
+		 "%llu ns per completion reaped in batches of %d\n",
+		 BATCH_ITERS * BATCH_SIZE, single_ns / (BATCH_ITERS * BATCH_SIZE),
+		 batch_ns / (BATCH_ITERS * BATCH_SIZE), BATCH_SIZE);
+}
+
 static void *rtio_api_setup(void)
 {
 #ifdef CONFIG_USERSPACE
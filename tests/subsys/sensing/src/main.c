@@ -9,6 +9,7 @@
 #include <zephyr/ztest.h>
 #include <zephyr/sensing/sensing.h>
 #include <zephyr/sensing/sensing_sensor.h>
+#include <zephyr/sys/atomic.h>
 
 #define DT_DRV_COMPAT	zephyr_sensing
 #define MAX_SENSOR_TYPES 2
@@ -89,4 +90,119 @@ ZTEST(sensing_tests, test_sensing_get_sensors)
 	}
 }
 
+#define TEST_INTERVAL_US 1000
+#define TEST_LATENCY_US  20000
+
+static atomic_t data_events;
+static atomic_t data_readings;
+
+static void test_on_data_event(sensing_sensor_handle_t handle, const void *buf, void *context)
+{
+	const struct sensing_sensor_value_header *header = buf;
+
+	ARG_UNUSED(handle);
+	ARG_UNUSED(context);
+
+	atomic_inc(&data_events);
+	atomic_add(&data_readings, header->reading_count);
+}
+
+static struct sensing_callback_list test_cb_list = {
+	.on_data_event = test_on_data_event,
+};
+
+static const struct sensing_sensor_info *get_accel_info(void)
+{
+	const struct sensing_sensor_info *info;
+	int num;
+
+	zassert_ok(sensing_get_sensors(&num, &info));
+
+	for (int i = 0; i < num; ++i) {
+		if (info[i].type == SENSING_SENSOR_TYPE_MOTION_ACCELEROMETER_3D &&
+		    strcmp(info[i].name, DT_NODE_FULL_NAME(DT_NODELABEL(base_accel_gyro))) == 0) {
+			return &info[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void stream_for_one_second(uint64_t latency, uint32_t *events, uint32_t *readings)
+{
+	const struct sensing_sensor_info *info = get_accel_info();
+	struct sensing_sensor_config configs[] = {
+		{.attri = SENSING_SENSOR_ATTRIBUTE_LATENCY, .latency = latency},
+		{.attri = SENSING_SENSOR_ATTRIBUTE_INTERVAL, .interval = TEST_INTERVAL_US},
+	};
+	sensing_sensor_handle_t handle;
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+	k_thread_runtime_stats_t start, end;
+#endif
+
+	zassert_not_null(info, "Accelerometer not found");
+	zassert_ok(sensing_open_sensor(info, &test_cb_list, &handle));
+	zassert_ok(sensing_set_config(handle, configs, ARRAY_SIZE(configs)));
+
+	/* let the sensor be configured and the stream settle */
+	k_msleep(100);
+
+	atomic_clear(&data_events);
+	atomic_clear(&data_readings);
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+	k_thread_runtime_stats_all_get(&start);
+#endif
+	k_sleep(K_SECONDS(1));
+	*events = atomic_get(&data_events);
+	*readings = atomic_get(&data_readings);
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+	k_thread_runtime_stats_all_get(&end);
+#endif
+
+	/* stop the stream and let the last batch be reported before closing */
+	configs[1].interval = 0;
+	zassert_ok(sensing_set_config(handle, &configs[1], 1));
+	k_msleep(2 * TEST_LATENCY_US / USEC_PER_MSEC);
+	zassert_ok(sensing_close_sensor(&handle));
+
+	TC_PRINT("latency %llu us: %u data events/s, %u readings/s\n", latency, *events,
+		 *readings);
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+	TC_PRINT("latency %llu us: CPU load %llu%%\n", latency,
+		 (end.total_cycles - start.total_cycles) * 100 /
+			 MAX(end.execution_cycles - start.execution_cycles, 1));
+#endif
+}
+
+/**
+ * @brief Test batched reporting
+ *
+ * This test verifies that readings are coalesced into fewer data events when a client
+ * configures a latency, and reports the rates of both modes.
+ */
+ZTEST(sensing_tests, test_sensing_batching)
+{
+	const struct sensing_sensor_info *info = get_accel_info();
+	struct sensing_sensor_config config = {.attri = SENSING_SENSOR_ATTRIBUTE_LATENCY};
+	sensing_sensor_handle_t handle;
+	uint32_t events, readings, batched_events, batched_readings;
+
+	zassert_not_null(info, "Accelerometer not found");
+	zassert_ok(sensing_open_sensor(info, &test_cb_list, &handle));
+	config.latency = TEST_LATENCY_US;
+	zassert_ok(sensing_set_config(handle, &config, 1));
+	config.latency = 0;
+	zassert_ok(sensing_get_config(handle, &config, 1));
+	zassert_equal(config.latency, TEST_LATENCY_US, "Latency not applied");
+	zassert_ok(sensing_close_sensor(&handle));
+
+	stream_for_one_second(0, &events, &readings);
+	zassert_true(readings > 0, "No readings reported");
+	zassert_equal(events, readings, "Readings batched without latency");
+
+	stream_for_one_second(TEST_LATENCY_US, &batched_events, &batched_readings);
+	zassert_true(batched_readings > 0, "No readings reported");
+	zassert_true(batched_events * 2 <= batched_readings, "Readings not batched");
+}
+
 ZTEST_SUITE(sensing_tests, NULL, NULL, NULL, NULL, NULL);
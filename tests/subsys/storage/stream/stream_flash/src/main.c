@@ -497,6 +497,170 @@ ZTEST(lib_stream_flash, test_stream_flash_buffered_write_whole_page)
 }
 #endif
 
+#ifdef CONFIG_STREAM_FLASH_VERIFY
+ZTEST(lib_stream_flash, test_stream_flash_verify)
+{
+	int rc;
+
+	init_target();
+
+	struct device fake_dev = *ctx.fdev;
+	struct flash_driver_api fake_api = *(struct flash_driver_api *)ctx.fdev->api;
+
+	/* A write that does not reach the flash is caught by verification */
+	fake_api.write = fake_write;
+	fake_dev.api = &fake_api;
+	ctx.fdev = &fake_dev;
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, false);
+	zassert_equal(rc, -EIO, "expected failure from verification");
+	zassert_equal(stream_flash_bytes_written(&ctx), 0, "Expected no bytes written");
+}
+#else
+ZTEST(lib_stream_flash, test_stream_flash_verify)
+{
+	ztest_test_skip();
+}
+#endif
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+static uint8_t async_buf[BUF_LEN];
+
+static void init_target_async(void)
+{
+	int rc;
+
+	init_target();
+
+	rc = stream_flash_set_async(&ctx, async_buf, BUF_LEN);
+	zassert_equal(rc, 0, "expected success");
+}
+
+ZTEST(lib_stream_flash, test_stream_flash_async_write)
+{
+	int rc;
+	size_t total = 0;
+
+	init_target();
+
+	rc = stream_flash_set_async(&ctx, async_buf, BUF_LEN / 2);
+	zassert_equal(rc, -EINVAL, "should fail as buffer sizes differ");
+
+	rc = stream_flash_set_async(&ctx, NULL, BUF_LEN);
+	zassert_equal(rc, -EFAULT, "should fail as buffer is NULL");
+
+	init_target_async();
+
+	/* Write in chunks that do not match the buffer size */
+	while (total < BUF_LEN * 3 + 128) {
+		rc = stream_flash_buffered_write(&ctx, write_buf, 100, false);
+		zassert_equal(rc, 0, "expected success");
+		total += 100;
+	}
+
+	/* Buffers in flight are counted as written */
+	zassert_equal(stream_flash_bytes_written(&ctx), BUF_LEN * 3,
+		      "Expected the full buffers to be written");
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+
+	zassert_equal(stream_flash_bytes_written(&ctx), total, "Expected all bytes written");
+	VERIFY_WRITTEN(0, total);
+}
+
+ZTEST(lib_stream_flash, test_stream_flash_async_write_multi_page)
+{
+	int rc;
+
+	init_target_async();
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, page_size * 2 + 128, true);
+	zassert_equal(rc, 0, "expected success");
+
+	VERIFY_WRITTEN(0, page_size * 2 + 128);
+}
+
+ZTEST(lib_stream_flash, test_stream_flash_async_failure)
+{
+	int rc;
+
+	struct device fake_dev = *fdev;
+	struct flash_driver_api fake_api = *(struct flash_driver_api *)fdev->api;
+
+	fake_api.write = bad_write;
+	fake_dev.api = &fake_api;
+
+	erase_flash();
+
+	rc = stream_flash_init(&ctx, &fake_dev, generic_buf, BUF_LEN, FLASH_BASE, 0, NULL);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_set_async(&ctx, async_buf, BUF_LEN);
+	zassert_equal(rc, 0, "expected success");
+
+	/* The buffer is programmed in the background, the failure is
+	 * returned on flush.
+	 */
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, false);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, -EINVAL, "expected failure from flash_write");
+	zassert_equal(stream_flash_bytes_written(&ctx), 0, "Expected no bytes written");
+}
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+ZTEST(lib_stream_flash, test_stream_flash_async_erase_ahead)
+{
+	struct k_work_sync sync;
+	int rc;
+
+	init_target_async();
+
+	/* First fill two pages with data */
+	rc = stream_flash_buffered_write(&ctx, write_buf, page_size * 2, true);
+	zassert_equal(rc, 0, "expected success");
+
+	/* Write all bytes of a page, verify that next page is not erased
+	 * ahead as no data is written to it.
+	 */
+	memset(&ctx, 0, sizeof(ctx));
+	rc = stream_flash_init(&ctx, fdev, generic_buf, BUF_LEN, FLASH_BASE, 0,
+			       stream_flash_callback);
+	zassert_equal(rc, 0, "expected success");
+	rc = stream_flash_set_async(&ctx, async_buf, BUF_LEN);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, page_size, true);
+	zassert_equal(rc, 0, "expected success");
+
+	VERIFY_WRITTEN(page_size, page_size);
+
+	/* Start the next page and verify that it is erased before the
+	 * buffer is flushed.
+	 */
+	rc = stream_flash_buffered_write(&ctx, write_buf, 1, false);
+	zassert_equal(rc, 0, "expected success");
+
+	/* Wait for the erase only, the buffer is still being filled */
+	(void)k_work_flush(&ctx.async.erase_work, &sync);
+	VERIFY_ERASED(page_size, page_size);
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+
+	VERIFY_WRITTEN(page_size, 1);
+	VERIFY_ERASED(page_size + BUF_LEN, page_size - BUF_LEN);
+}
+#else
+ZTEST(lib_stream_flash, test_stream_flash_async_erase_ahead)
+{
+	ztest_test_skip();
+}
+#endif
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
 static size_t write_and_save_progress(size_t bytes, const char *save_key)
 {
 	int rc;